@@ -0,0 +1,520 @@
+#include "const_eval.hpp"
+#include "interpreter.hpp"
+#include "typer.hpp"
+#include "typer_op_eval.hpp"
+#include "types/type.hpp"
+#include "parser/ast/ast_common.hpp"
+
+extern mu::types::Type* type_i64;
+extern mu::types::Type* type_u64;
+
+// a call deeper than this is a recursion that doesn't end, or one that would need more
+// stack than the compiler has.
+static const u64 MAX_DEPTH = 256;
+
+// mutable only qualifies a type, its values are the same as the type it qualifies.
+static mu::types::Type* strip(mu::types::Type* type) {
+    while(type and type->kind() == mu::types::MutableType)
+        type = type->as<mu::types::Mutable>()->get_inner();
+    return type;
+}
+
+static bool is_value_type(mu::types::Type* type) {
+    type = strip(type);
+    return type and type->is_primative() and !type->is_ptr();
+}
+
+// the value of a constant converted to type.
+static mu::Val value_of(const mu::Val& val, mu::types::Type* type) {
+    mu::Val value = val;
+    if(!value.type)
+        value.type = type;
+    else if(value.type != type)
+        value.cast_to(type);
+    return value;
+}
+
+static mu::TokenKind compound_operator(mu::TokenKind op) {
+    switch(op) {
+        case mu::Tkn_PlusEqual: return mu::Tkn_Plus;
+        case mu::Tkn_MinusEqual: return mu::Tkn_Minus;
+        case mu::Tkn_AstrickEqual: return mu::Tkn_Astrick;
+        case mu::Tkn_SlashEqual: return mu::Tkn_Slash;
+        case mu::Tkn_PercentEqual: return mu::Tkn_Percent;
+        case mu::Tkn_AstrickAstrickEqual: return mu::Tkn_AstrickAstrick;
+        case mu::Tkn_LessLessEqual: return mu::Tkn_LessLess;
+        case mu::Tkn_GreaterGreaterEqual: return mu::Tkn_GreaterGreater;
+        case mu::Tkn_AmpersandEqual: return mu::Tkn_Ampersand;
+        case mu::Tkn_PipeEqual: return mu::Tkn_Pipe;
+        case mu::Tkn_CarrotEqual: return mu::Tkn_Carrot;
+        default: return op;
+    }
+}
+
+// the value a literal pattern matches.
+static bool pattern_value(ast::Pattern* pattern, i64& value) {
+    switch(pattern->kind) {
+        case ast::ast_int_pattern: value = pattern->as<ast::IntPattern>()->value; return true;
+        case ast::ast_char_pattern: value = pattern->as<ast::CharPattern>()->value; return true;
+        case ast::ast_bool_pattern: value = pattern->as<ast::BoolPattern>()->value; return true;
+        default: return false;
+    }
+}
+
+// compares two constants of an integer type, -1, 0 or 1.
+static int compare(const mu::Val& lhs, const mu::Val& rhs, mu::types::Type* type) {
+    if(type->is_signed()) {
+        auto l = value_of(value_of(lhs, type), type_i64)._I64;
+        auto r = value_of(value_of(rhs, type), type_i64)._I64;
+        return l < r ? -1 : (l > r ? 1 : 0);
+    }
+    auto l = value_of(value_of(lhs, type), type_u64)._U64;
+    auto r = value_of(value_of(rhs, type), type_u64)._U64;
+    return l < r ? -1 : (l > r ? 1 : 0);
+}
+
+static bool is_zero(const mu::Val& val, mu::types::Type* type) {
+    return type->is_integer() and value_of(value_of(val, type), type_u64)._U64 == 0;
+}
+
+namespace mu {
+
+    ConstEval::ConstEval(Typer *typer, u64 budget) : typer(typer), budget(budget) {
+    }
+
+    ConstEval::Status ConstEval::call(mu::Function *function, const std::vector<Val> &args, Val &result) {
+        steps = 0;
+        depth = 0;
+        status = Done;
+        reason.clear();
+
+        if(invoke(function, args, result) == Stop)
+            return status;
+        return Done;
+    }
+
+    ConstEval::Flow ConstEval::invoke(mu::Function *function, const std::vector<Val> &args, Val &result) {
+        auto decl = function->get_decl();
+        if(!decl or decl->kind != ast::ast_procedure)
+            return stop(NotConstant, pos, "this function can not be evaluated at compile time");
+
+        if(!function->is_comptime() or function->is_foreign() or !decl->as<ast::Procedure>()->body)
+            return stop(NotConstant, decl->pos(), Interpreter::format("'%s' is not a const function",
+                                                                      function->get_name()->value().c_str()));
+
+        if(depth >= MAX_DEPTH)
+            return stop(OutOfSteps, decl->pos(), Interpreter::format("'%s' recursed more than %lu calls deep",
+                                                                     function->get_name()->value().c_str(), MAX_DEPTH));
+
+        Frame callee{function, {}, Val()};
+        for(u64 i = 0; i < function->num_params() and i < args.size(); ++i) {
+            auto param = function->get_param(i);
+            if(!is_value_type(param->get_type()))
+                return stop(NotConstant, decl->pos(), "only functions of numbers, characters and booleans can be evaluated at compile time");
+            callee.locals[param] = value_of(args[i], strip(param->get_type()));
+        }
+
+        auto ret = strip(function->get_ret_type());
+        if(!is_value_type(ret))
+            return stop(NotConstant, decl->pos(), "only functions of numbers, characters and booleans can be evaluated at compile time");
+
+        auto caller = frame;
+        frame = &callee;
+        depth++;
+
+        // the value of the body is the result unless the function returned.
+        Val value;
+        auto flow = eval(decl->as<ast::Procedure>()->body, value);
+
+        depth--;
+        frame = caller;
+
+        if(flow == Stop)
+            return Stop;
+        if(flow == Return)
+            value = callee.result;
+        if(!value.is_constant)
+            return stop(NotConstant, decl->pos(), "the function doesn't return a value");
+
+        result = value_of(value, ret);
+        return Next;
+    }
+
+    ConstEval::Flow ConstEval::eval(ast::Expr *expr, Val &out) {
+        if(!expr) {
+            out = Val();
+            return Next;
+        }
+
+        if(++steps > budget)
+            return stop(OutOfSteps, expr->pos(), Interpreter::format("it ran for more than %lu steps", budget));
+
+        switch(expr->kind) {
+            case ast::ast_integer:
+            case ast::ast_fl:
+            case ast::ast_ch:
+            case ast::ast_bool:
+                out = value_of(expr->operand.val, strip(expr->type));
+                return Next;
+            case ast::ast_unit_expr:
+                out = Val();
+                return Next;
+            case ast::ast_name:
+                return eval_name(expr, out);
+            case ast::ast_binary:
+                return eval_binary(expr->as<ast::Binary>(), out);
+            case ast::ast_unary:
+                return eval_unary(expr->as<ast::Unary>(), out);
+            case ast::ast_cast_expr: {
+                // the spec of the cast hides the type of the expression.
+                auto cast = expr->as<ast::Cast>();
+                auto type = strip(cast->Expr::type);
+                if(!is_value_type(type))
+                    break;
+
+                Val value;
+                auto flow = eval(cast->operand, value);
+                if(flow != Next)
+                    return flow;
+                out = value_of(value_of(value, strip(cast->operand->type)), type);
+                return Next;
+            }
+            case ast::ast_call:
+                return eval_call(expr->as<ast::Call>(), out);
+            case ast::ast_block:
+                return eval_block(expr->as<ast::Block>(), out);
+            case ast::ast_if_expr: {
+                auto if_expr = expr->as<ast::If>();
+                Val cond;
+                auto flow = eval(if_expr->cond, cond);
+                if(flow != Next)
+                    return flow;
+
+                if(value_of(cond, strip(if_expr->cond->type))._Bool)
+                    return eval(if_expr->body, out);
+                return eval(if_expr->else_if, out);
+            }
+            case ast::ast_while_expr: {
+                auto while_expr = expr->as<ast::While>();
+                out = Val();
+                while(true) {
+                    Val cond, body;
+                    auto flow = eval(while_expr->cond, cond);
+                    if(flow != Next or !value_of(cond, strip(while_expr->cond->type))._Bool)
+                        return flow;
+
+                    flow = eval(while_expr->body, body);
+                    if(flow != Next)
+                        return flow;
+                }
+            }
+            case ast::ast_for_expr:
+                out = Val();
+                return eval_for(expr->as<ast::For>());
+            case ast::ast_match_expr:
+                return eval_match(expr->as<ast::Match>(), out);
+            case ast::ast_return: {
+                auto ret = expr->as<ast::Return>();
+                auto flow = eval(ret->body, frame->result);
+                return flow == Next ? Return : flow;
+            }
+            case ast::ast_assign:
+                out = Val();
+                return eval_assign(expr->as<ast::Assign>());
+            default:
+                break;
+        }
+        return stop(NotConstant, expr->pos(), "this expression can not be evaluated at compile time");
+    }
+
+    ConstEval::Flow ConstEval::eval_name(ast::Expr *expr, Val &out) {
+        auto entity = expr->operand.entity;
+        if(entity and is_value_type(expr->type)) {
+            auto type = strip(expr->type);
+            if(entity->kind() == ConstantEntity) {
+                out = value_of(entity->as<Constant>()->get_value(), type);
+                return Next;
+            }
+
+            auto iter = frame->locals.find(entity);
+            if(iter != frame->locals.end()) {
+                out = value_of(iter->second, type);
+                return Next;
+            }
+
+            // an immutable global is a constant once its initializer has been folded.
+            auto decl = entity->get_decl();
+            if(entity->kind() == GlobalEntity and decl and decl->kind == ast::ast_global) {
+                auto init = decl->as<ast::Global>()->init;
+                if(init and init->operand.val.is_constant) {
+                    out = value_of(value_of(init->operand.val, strip(init->type)), type);
+                    return Next;
+                }
+            }
+        }
+
+        auto name = entity ? entity->get_name()->value() : std::string("this name");
+        return stop(NotConstant, expr->pos(), Interpreter::format("'%s' is not a constant", name.c_str()));
+    }
+
+    ConstEval::Flow ConstEval::eval_binary(ast::Binary *expr, Val &out) {
+        Val lhs;
+        auto flow = eval(expr->lhs, lhs);
+        if(flow != Next)
+            return flow;
+
+        // the right side is only evaluated when the left side doesn't decide the result.
+        if(expr->op == Tkn_And or expr->op == Tkn_Or) {
+            auto value = value_of(lhs, strip(expr->lhs->type))._Bool;
+            if(value == (expr->op == Tkn_Or)) {
+                out = value_of(Val(value), strip(expr->type));
+                return Next;
+            }
+
+            Val rhs;
+            flow = eval(expr->rhs, rhs);
+            if(flow == Next)
+                out = value_of(rhs, strip(expr->type));
+            return flow;
+        }
+
+        Val rhs;
+        flow = eval(expr->rhs, rhs);
+        if(flow != Next)
+            return flow;
+        return apply(expr->op, expr->lhs, lhs, expr->rhs, rhs, expr, out);
+    }
+
+    ConstEval::Flow ConstEval::eval_unary(ast::Unary *expr, Val &out) {
+        if(expr->op == Tkn_Ampersand or expr->op == Tkn_Astrick)
+            return stop(NotConstant, expr->pos(), "pointers can not be used at compile time");
+
+        Val value;
+        auto flow = eval(expr->expr, value);
+        if(flow != Next)
+            return flow;
+
+        auto type = strip(expr->expr->type);
+        auto result = eval_unary_op(typer, expr->op, Operand(type, expr->expr, value_of(value, type)), expr, strip(expr->type));
+        if(!result.val.is_constant)
+            return stop(NotConstant, expr->pos(), Interpreter::format("'%s' can not be evaluated at compile time",
+                                                                      Token::get_string(expr->op).c_str()));
+        out = value_of(result.val, strip(expr->type));
+        return Next;
+    }
+
+    ConstEval::Flow ConstEval::eval_call(ast::Call *expr, Val &out) {
+        auto entity = expr->name->operand.entity;
+        if(!entity or !entity->is_function() or !entity->as<mu::Function>()->is_comptime())
+            return stop(NotConstant, expr->pos(), "only const functions can be called at compile time");
+
+        std::vector<Val> args;
+        for(auto actual : expr->actuals) {
+            Val value;
+            auto flow = eval(actual, value);
+            if(flow != Next)
+                return flow;
+            args.push_back(value_of(value, strip(actual->type)));
+        }
+
+        return invoke(entity->as<mu::Function>(), args, out);
+    }
+
+    ConstEval::Flow ConstEval::eval_block(ast::Block *expr, Val &out) {
+        out = Val();
+        for(auto stmt : expr->elements) {
+            Flow flow = Next;
+            switch(stmt->kind) {
+                case ast::ast_expr:
+                    // the value of the block is the value of its last expression.
+                    flow = eval(stmt->as<ast::ExprStmt>()->expr, out);
+                    break;
+                case ast::ast_decl:
+                    out = Val();
+                    flow = eval_local(stmt->as<ast::DeclStmt>()->decl);
+                    break;
+                default:
+                    break;
+            }
+            if(flow != Next)
+                return flow;
+        }
+        return Next;
+    }
+
+    ConstEval::Flow ConstEval::eval_for(ast::For *expr) {
+        if(expr->expr->kind != ast::ast_range)
+            return stop(NotConstant, expr->pos(), "only a range can be iterated at compile time");
+
+        auto range = expr->expr->as<ast::Range>();
+        auto type = strip(range->type);
+        if(!is_value_type(type) or !type->is_integer())
+            return stop(NotConstant, expr->pos(), "only a range of integers can be iterated at compile time");
+
+        // the bounds are evaluated once, before the first iteration.
+        Val counter, end, step = value_of(Val((i64) 1), type);
+        auto flow = eval(range->start, counter);
+        if(flow == Next)
+            flow = eval(range->end, end);
+        if(flow == Next and range->step)
+            flow = eval(range->step, step);
+        if(flow != Next)
+            return flow;
+
+        Entity* local = nullptr;
+        if(expr->pattern->kind == ast::ast_ident_pattern)
+            local = expr->pattern->as<ast::IdentPattern>()->entity;
+
+        while(compare(counter, end, type) < 0) {
+            if(local)
+                frame->locals[local] = value_of(counter, type);
+
+            Val body;
+            flow = eval(expr->body, body);
+            if(flow != Next)
+                return flow;
+
+            // the counter wraps the same as it does when the program runs.
+            auto next = value_of(value_of(counter, type), type_u64)._U64 + value_of(value_of(step, type), type_u64)._U64;
+            counter = value_of(Val(next), type);
+
+            if(++steps > budget)
+                return stop(OutOfSteps, expr->pos(), Interpreter::format("it ran for more than %lu steps", budget));
+        }
+        return Next;
+    }
+
+    ConstEval::Flow ConstEval::eval_match(ast::Match *expr, Val &out) {
+        auto type = strip(expr->cond->type);
+        if(!is_value_type(type) or !type->is_integer())
+            return stop(NotConstant, expr->pos(), "only integers can be matched at compile time");
+
+        Val value;
+        auto flow = eval(expr->cond, value);
+        if(flow != Next)
+            return flow;
+        value = value_of(value, type);
+
+        // the arms are tested in order, an arm with alternatives matches if any of them do.
+        for(auto member : expr->members) {
+            auto arm = member->as<ast::MatchArm>();
+
+            bool matched = false;
+            for(auto pattern : arm->patterns) {
+                i64 literal = 0;
+                if(pattern_value(pattern, literal))
+                    matched = compare(Val(literal), value, type) == 0;
+                else if(pattern->kind == ast::ast_range_pattern) {
+                    // a range includes both of its bounds.
+                    auto range = pattern->as<ast::RangePattern>();
+                    i64 start = 0, end = 0;
+                    if(!pattern_value(range->start, start) or !pattern_value(range->end, end))
+                        return stop(NotConstant, pattern->pos(), "this pattern can not be evaluated at compile time");
+                    matched = compare(Val(start), value, type) <= 0 and compare(value, Val(end), type) <= 0;
+                }
+                else if(pattern->kind == ast::ast_ignore_pattern or pattern->kind == ast::ast_ident_pattern)
+                    matched = true;
+                else
+                    return stop(NotConstant, pattern->pos(), "this pattern can not be evaluated at compile time");
+
+                if(matched)
+                    break;
+            }
+
+            if(!matched)
+                continue;
+
+            // a name is bound to the value being matched.
+            for(auto pattern : arm->patterns)
+                if(pattern->kind == ast::ast_ident_pattern)
+                    frame->locals[pattern->as<ast::IdentPattern>()->entity] = value;
+            return eval(arm->body, out);
+        }
+
+        out = Val();
+        return Next;
+    }
+
+    ConstEval::Flow ConstEval::eval_assign(ast::Assign *expr) {
+        auto lvalue = expr->lvalue;
+        auto entity = lvalue->kind == ast::ast_name ? lvalue->operand.entity : nullptr;
+        if(!entity or !frame->locals.count(entity))
+            return stop(NotConstant, lvalue->pos(), "only the locals of a const function can be assigned at compile time");
+
+        Val value;
+        auto flow = eval(expr->rvalue, value);
+        if(flow != Next)
+            return flow;
+
+        auto type = strip(lvalue->type);
+        if(expr->op == Tkn_Equal) {
+            frame->locals[entity] = value_of(value, type);
+            return Next;
+        }
+
+        Val result;
+        flow = apply(compound_operator(expr->op), lvalue, frame->locals[entity], expr->rvalue, value, lvalue, result);
+        if(flow == Next)
+            frame->locals[entity] = value_of(result, type);
+        return flow;
+    }
+
+    ConstEval::Flow ConstEval::eval_local(ast::DeclPtr decl) {
+        ast::PatternPtr pattern = nullptr;
+        ast::ExprPtr init = nullptr;
+        if(decl->kind == ast::ast_mutable) {
+            pattern = decl->as<ast::Mutable>()->names;
+            init = decl->as<ast::Mutable>()->init;
+        }
+        else if(decl->kind == ast::ast_local) {
+            pattern = decl->as<ast::Local>()->names;
+            init = decl->as<ast::Local>()->init;
+        }
+        else
+            return stop(NotConstant, decl->pos(), "this declaration can not be evaluated at compile time");
+
+        if(pattern->kind != ast::ast_ident_pattern)
+            return stop(NotConstant, pattern->pos(), "only a single name can be declared at compile time");
+
+        auto local = pattern->as<ast::IdentPattern>()->entity;
+        auto type = strip(local->get_type());
+        if(!is_value_type(type))
+            return stop(NotConstant, pattern->pos(), "only numbers, characters and booleans can be declared at compile time");
+
+        // a local declared without a value starts zeroed.
+        Val value = value_of(Val((u64) 0), type);
+        if(init) {
+            auto flow = eval(init, value);
+            if(flow != Next)
+                return flow;
+        }
+        frame->locals[local] = value_of(value, type);
+        return Next;
+    }
+
+    ConstEval::Flow ConstEval::apply(mu::TokenKind op, ast::Expr *lhs, const Val &lv, ast::Expr *rhs, const Val &rv,
+                                     ast::Expr *expr, Val &out) {
+        auto lhs_type = strip(lhs->type);
+        auto rhs_type = strip(rhs->type);
+        auto type = strip(expr->type);
+
+        // the operators are evaluated by the typer, it doesn't divide by zero.
+        if((op == Tkn_Slash or op == Tkn_Percent) and is_zero(rv, rhs_type))
+            return stop(Trapped, expr->pos(), "division by zero");
+
+        auto result = eval_binary_op(typer, op, Operand(lhs_type, lhs, value_of(lv, lhs_type)),
+                                     Operand(rhs_type, rhs, value_of(rv, rhs_type)), expr, type);
+        if(!result.val.is_constant)
+            return stop(NotConstant, expr->pos(), Interpreter::format("'%s' can not be evaluated at compile time",
+                                                                      Token::get_string(op).c_str()));
+        out = value_of(result.val, type);
+        return Next;
+    }
+
+    ConstEval::Flow ConstEval::stop(ConstEval::Status status, const mu::Pos &pos, const std::string &reason) {
+        this->status = status;
+        this->pos = pos;
+        this->reason = reason;
+        return Stop;
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef MU_CONST_EVAL_HPP
+#define MU_CONST_EVAL_HPP
+
+#include "common.hpp"
+#include "entity.hpp"
+#include "value.hpp"
+#include "parser/ast/expr.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mu {
+    class Typer;
+
+    // Runs the functions marked 'const' or '@comptime' while the module is compiled.
+    //
+    // The functions are interpreted over their resolved ast with the same constant
+    // values the typer folds with, so only primitive values can be computed. Every
+    // expression that is evaluated is a step, a call that runs out of steps is left to
+    // run with the program so a loop that doesn't end can't hang the compiler.
+    class ConstEval {
+    public:
+        enum Status {
+            Done,
+            NotConstant,    // it uses something that can only be known when the program runs.
+            OutOfSteps,
+            Trapped,        // it would trap when the program runs, the call is left to do so.
+        };
+
+        ConstEval(Typer* typer, u64 budget = 1 << 20);
+
+        // calls function with constant arguments, result is its value converted to the
+        // return type of the function.
+        Status call(mu::Function* function, const std::vector<Val>& args, Val& result);
+
+        // why the last call couldn't be evaluated.
+        inline const std::string& get_reason() { return reason; }
+        inline const mu::Pos& get_pos() { return pos; }
+
+        inline u64 get_budget() { return budget; }
+        inline u64 get_steps() { return steps; }
+
+    private:
+        enum Flow {
+            Next,
+            Return,
+            Stop,
+        };
+
+        struct Frame {
+            mu::Function* function;
+            std::unordered_map<Entity*, Val> locals;
+            Val result;
+        };
+
+        Flow invoke(mu::Function* function, const std::vector<Val>& args, Val& result);
+
+        Flow eval(ast::Expr* expr, Val& out);
+
+        Flow eval_name(ast::Expr* expr, Val& out);
+
+        Flow eval_binary(ast::Binary* expr, Val& out);
+
+        Flow eval_unary(ast::Unary* expr, Val& out);
+
+        Flow eval_call(ast::Call* expr, Val& out);
+
+        Flow eval_block(ast::Block* expr, Val& out);
+
+        Flow eval_for(ast::For* expr);
+
+        Flow eval_match(ast::Match* expr, Val& out);
+
+        Flow eval_assign(ast::Assign* expr);
+
+        Flow eval_local(ast::DeclPtr decl);
+
+        // applies a binary operator to the values of two expressions.
+        Flow apply(mu::TokenKind op, ast::Expr* lhs, const Val& lv, ast::Expr* rhs, const Val& rv,
+                   ast::Expr* expr, Val& out);
+
+        Flow stop(Status status, const mu::Pos& pos, const std::string& reason);
+
+        Typer* typer{nullptr};
+        u64 budget{0};
+        u64 steps{0};
+        u64 depth{0};
+
+        Status status{Done};
+        std::string reason;
+        mu::Pos pos;
+
+        Frame* frame{nullptr};
+    };
+}
+
+#endif //MU_CONST_EVAL_HPP
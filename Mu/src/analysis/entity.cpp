@@ -117,7 +117,7 @@ namespace mu {
     }
 
     ast::AstNode *Entity::node() {
-        return decl.get();
+        return decl;
     }
 
     ast::Ident *Entity::get_name() {
@@ -202,7 +202,8 @@ namespace mu {
 
     Local::Local(ast::Ident *name, types::Type *type, AddressType addr_type, ScopePtr p, ast::DeclPtr decl) :
         Entity(name, p, LocalEntity, decl), addr_type(addr_type) {
-        if(decl->kind == ast::ast_mut)
+        // the names bound by for loops and match arms don't have a declaration.
+        if(decl and decl->kind == ast::ast_mutable)
             set_mutable();
         this->type = type;
     }
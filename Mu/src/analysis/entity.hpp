@@ -180,7 +180,7 @@ namespace mu {
         types::Type* type;          // the type of this entity.
         ScopePtr parent;            // the scope this entity belongs.
         ast::Ident* name{nullptr};  // name of the entity
-        ast::DeclPtr decl;          // the source declaration where this entity is created.
+        ast::DeclPtr decl{nullptr};          // the source declaration where this entity is created.
         EntityStatus resolved{Incomplete};       // flag for whether the entity has been resolved by the typer.
         bool used{false};           // Uses to determine if the entity has been used or not.
     };
@@ -304,6 +304,8 @@ namespace mu {
 
         bool is_constant() override { return true; }
 
+        inline const mu::Val& get_value() { return val; }
+
         Entity* resolve(Typer* typer) override;
 
         void debug_print(std::ostream& out) override;
@@ -349,6 +351,7 @@ namespace mu {
         Variadic = 8,
         Method = 16, // this is called through an instance
         Static = 32, // this is called from the struct itself.
+        ComptimeFunction = 64, // 'const' or '@comptime', calls with constant arguments are evaluated by the compiler.
     };
 
     class Function : public Entity {
@@ -380,6 +383,7 @@ namespace mu {
         inline bool is_variadic() { return flags & Variadic; }
         inline bool is_static() { return flags & Static; }
         inline bool is_method() { return flags & Method; }
+        inline bool is_comptime() { return flags & ComptimeFunction; }
         inline void set_foreign(const std::string &name) {
             foreign_name = name;
             flags |= ForeignFunction;
@@ -390,6 +394,7 @@ namespace mu {
         inline void set_variadic() { flags |= Variadic; }
         inline void set_inline() { flags |= InlineFunction; }
         inline void set_no_body() { flags |= NoBody; }
+        inline void set_comptime() { flags |= ComptimeFunction; }
         const std::string& get_foreign_name() { return foreign_name; }
 
         Local* get_param(u64 i);
@@ -398,6 +403,13 @@ namespace mu {
 
         u64 get_index_of_param(Local* param);
 
+        // counted while the function is interpreted, the tiered engine compiles the
+        // functions that are called or loop the most.
+        inline u64 count_invocation() { return ++invocations; }
+        inline u64 count_back_edge() { return ++back_edges; }
+        inline u64 get_invocations() { return invocations; }
+        inline u64 get_back_edges() { return back_edges; }
+
 
     private:
         std::vector<Local*> params;
@@ -406,6 +418,9 @@ namespace mu {
 
         u32 flags{0};
         std::string foreign_name;
+
+        u64 invocations{0};
+        u64 back_edges{0};
     };
 
     class Alias : public Entity {
@@ -0,0 +1,601 @@
+#include "folder.hpp"
+#include "interpreter.hpp"
+#include "typer.hpp"
+#include "typer_op_eval.hpp"
+#include "types/type.hpp"
+#include "parser/ast/ast_common.hpp"
+#include "parser/ast/clone.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+extern mu::types::Type* type_i64;
+extern mu::types::Type* type_u64;
+extern mu::types::Type* type_f64;
+extern mu::types::Type* type_unit;
+
+// mutable only qualifies a type, its values are the same as the type it qualifies.
+static mu::types::Type* strip(mu::types::Type* type) {
+    while(type and type->kind() == mu::types::MutableType)
+        type = type->as<mu::types::Mutable>()->get_inner();
+    return type;
+}
+
+// only the values that fit in a register are made into literals.
+static bool is_foldable(mu::types::Type* type) {
+    type = strip(type);
+    return type and type->is_primative() and !type->is_ptr();
+}
+
+// the typer knows the value of expr, it may still have statements to run.
+static bool has_value(ast::Expr* expr) {
+    return expr and !expr->operand.error and expr->operand.val.is_constant and is_foldable(expr->type);
+}
+
+// expr can be replaced by a literal of its value.
+static bool is_constant(ast::Expr* expr) {
+    return has_value(expr) and mu::is_constant_expr(expr);
+}
+
+// the value of a constant converted to type.
+static mu::Val value_of(const mu::Val& val, mu::types::Type* type) {
+    mu::Val value = val;
+    if(!value.type)
+        value.type = type;
+    else if(value.type != type)
+        value.cast_to(type);
+    return value;
+}
+
+static bool is_literal(ast::Expr* expr) {
+    switch(expr->kind) {
+        case ast::ast_integer:
+        case ast::ast_fl:
+        case ast::ast_ch:
+        case ast::ast_bool:
+            return true;
+        case ast::ast_unary:
+            // a negative number is the negation of its magnitude.
+            return expr->as<ast::Unary>()->op == mu::Tkn_Minus and is_literal(expr->as<ast::Unary>()->expr);
+        default:
+            return false;
+    }
+}
+
+// the value a literal pattern matches.
+static bool pattern_value(ast::Pattern* pattern, i64& value) {
+    switch(pattern->kind) {
+        case ast::ast_int_pattern: value = pattern->as<ast::IntPattern>()->value; return true;
+        case ast::ast_char_pattern: value = pattern->as<ast::CharPattern>()->value; return true;
+        case ast::ast_bool_pattern: value = pattern->as<ast::BoolPattern>()->value; return true;
+        default: return false;
+    }
+}
+
+// compares two constants of an integer type, -1, 0 or 1.
+static int compare(const mu::Val& lhs, const mu::Val& rhs, mu::types::Type* type) {
+    if(type->is_signed()) {
+        auto l = value_of(value_of(lhs, type), type_i64)._I64;
+        auto r = value_of(value_of(rhs, type), type_i64)._I64;
+        return l < r ? -1 : (l > r ? 1 : 0);
+    }
+    auto l = value_of(value_of(lhs, type), type_u64)._U64;
+    auto r = value_of(value_of(rhs, type), type_u64)._U64;
+    return l < r ? -1 : (l > r ? 1 : 0);
+}
+
+namespace mu {
+
+    Folder::Folder(Typer *typer) : typer(typer), evaluator(typer) {
+    }
+
+    u64 Folder::fold(const std::vector<Entity *> &entities) {
+        std::vector<ast::Procedure*> bodies;
+        for(auto entity : entities) {
+            if(!entity or !entity->is_resolved())
+                continue;
+
+            switch(entity->kind()) {
+                case FunctionEntity: {
+                    auto decl = entity->get_decl();
+                    if(decl and decl->kind == ast::ast_procedure)
+                        bodies.push_back(decl->as<ast::Procedure>());
+                } break;
+                case TypeEntity: {
+                    auto type = entity->as<Type>();
+                    if(!type->is_struct())
+                        break;
+
+                    for(auto block : type->get_impls())
+                        for(auto decl : block->as<ast::Impl>()->methods)
+                            if(decl->kind == ast::ast_procedure)
+                                bodies.push_back(decl->as<ast::Procedure>());
+                } break;
+                case GlobalEntity:
+                case ConstantEntity: {
+                    auto decl = entity->get_decl();
+                    if(decl and decl->kind == ast::ast_global and decl->as<ast::Global>()->init) {
+                        auto init = fold(decl->as<ast::Global>()->init);
+                        decl->as<ast::Global>()->init = init;
+
+                        // a global initialized with other constants, 'let B i32 = A * 2'.
+                        if(entity->kind() == GlobalEntity and is_constant(init) and is_foldable(entity->get_type()))
+                            values[entity] = value_of(init->operand.val, strip(init->type));
+                    }
+                    else if(decl and decl->kind == ast::ast_global_mut and decl->as<ast::GlobalMut>()->init)
+                        decl->as<ast::GlobalMut>()->init = fold(decl->as<ast::GlobalMut>()->init);
+                } break;
+                default:
+                    break;
+            }
+        }
+
+        for(auto procedure : bodies) {
+            // a method that wasn't resolved doesn't have types to fold with.
+            if(procedure->body and procedure->body->type)
+                procedure->body = fold(procedure->body);
+        }
+
+        values.clear();
+        return folded;
+    }
+
+    ast::ExprPtr Folder::fold(ast::ExprPtr expr) {
+        if(!expr or !expr->type or expr->operand.error or is_literal(expr))
+            return expr;
+
+        switch(expr->kind) {
+            case ast::ast_name:
+                return fold_name(expr);
+            case ast::ast_binary:
+                return fold_binary(expr->as<ast::Binary>());
+            case ast::ast_unary:
+                return fold_unary(expr->as<ast::Unary>());
+            case ast::ast_cast_expr:
+                return fold_cast(expr->as<ast::Cast>());
+            case ast::ast_if_expr:
+                return fold_if(expr->as<ast::If>());
+            case ast::ast_while_expr:
+                return fold_while(expr->as<ast::While>());
+            case ast::ast_match_expr:
+                return fold_match(expr->as<ast::Match>());
+            case ast::ast_block:
+                fold_block(expr->as<ast::Block>());
+                break;
+            case ast::ast_tuple_expr:
+                for(auto& element : expr->as<ast::TupleExpr>()->elements)
+                    element = fold(element);
+                break;
+            case ast::ast_struct_expr:
+                for(auto& member : expr->as<ast::StructExpr>()->members)
+                    member = fold(member);
+                break;
+            case ast::ast_list:
+                for(auto& element : expr->as<ast::List>()->elements)
+                    element = fold(element);
+                break;
+            case ast::ast_expr_binding: {
+                auto binding = expr->as<ast::BindingExpr>();
+                binding->expr = fold(binding->expr);
+            } break;
+            case ast::ast_accessor:
+            case ast::ast_tuple_accessor:
+                return fold_place(expr);
+            case ast::ast_call:
+                return fold_call(expr->as<ast::Call>());
+            case ast::ast_method: {
+                // the receiver is passed by its address.
+                auto& actuals = expr->as<ast::Method>()->actuals;
+                for(u64 i = 0; i < actuals.size(); ++i)
+                    actuals[i] = i == 0 ? fold_place(actuals[i]) : fold(actuals[i]);
+            } break;
+            case ast::ast_for_expr:
+                return fold_for(expr->as<ast::For>());
+            case ast::ast_range: {
+                auto range = expr->as<ast::Range>();
+                range->start = fold(range->start);
+                range->end = fold(range->end);
+                range->step = fold(range->step);
+            } break;
+            case ast::ast_defer_expr: {
+                auto defer = expr->as<ast::Defer>();
+                defer->body = fold(defer->body);
+            } break;
+            case ast::ast_return: {
+                auto ret = expr->as<ast::Return>();
+                ret->body = fold(ret->body);
+            } break;
+            case ast::ast_assign: {
+                auto assign = expr->as<ast::Assign>();
+                assign->lvalue = fold_place(assign->lvalue);
+                assign->rvalue = fold(assign->rvalue);
+            } break;
+            default:
+                break;
+        }
+        return expr;
+    }
+
+    ast::ExprPtr Folder::fold_name(ast::ExprPtr expr) {
+        if(is_constant(expr))
+            return literal(expr->operand.val, expr->type, expr->pos());
+
+        auto entity = expr->operand.entity;
+        if(!entity or !is_foldable(expr->type))
+            return expr;
+
+        if(entity->kind() == ConstantEntity)
+            return literal(entity->as<Constant>()->get_value(), expr->type, expr->pos());
+
+        auto iter = values.find(entity);
+        if(iter != values.end())
+            return literal(iter->second, expr->type, expr->pos());
+        return expr;
+    }
+
+    ast::ExprPtr Folder::fold_binary(ast::Binary *expr) {
+        // the typer already computed the value, only the expression has to be replaced.
+        if(is_constant(expr))
+            return literal(expr->operand.val, expr->type, expr->pos());
+
+        expr->lhs = fold(expr->lhs);
+
+        // the right side isn't evaluated when the left side decides the result.
+        if((expr->op == Tkn_And or expr->op == Tkn_Or) and is_constant(expr->lhs)) {
+            auto lhs = value_of(expr->lhs->operand.val, strip(expr->lhs->type))._Bool;
+            if(lhs == (expr->op == Tkn_Or))
+                return literal(Val(lhs), expr->type, expr->pos());
+            // 'true and x' is x.
+            expr->rhs = fold(expr->rhs);
+            return strip(expr->rhs->type) == strip(expr->type) ? expr->rhs : expr;
+        }
+
+        expr->rhs = fold(expr->rhs);
+        if(!is_constant(expr->lhs) or !is_constant(expr->rhs) or !is_foldable(expr->type))
+            return expr;
+
+        auto result = eval_binary_op(typer, expr->op, expr->lhs->operand, expr->rhs->operand, expr, strip(expr->type));
+        if(!result.val.is_constant)
+            return expr;
+        return literal(result.val, expr->type, expr->pos());
+    }
+
+    ast::ExprPtr Folder::fold_unary(ast::Unary *expr) {
+        switch(expr->op) {
+            case Tkn_Ampersand:
+                expr->expr = fold_place(expr->expr);
+                return expr;
+            case Tkn_Astrick:
+                expr->expr = fold(expr->expr);
+                return expr;
+            default:
+                break;
+        }
+
+        if(is_constant(expr))
+            return literal(expr->operand.val, expr->type, expr->pos());
+
+        expr->expr = fold(expr->expr);
+        if(!is_constant(expr->expr) or !is_foldable(expr->type))
+            return expr;
+
+        auto result = eval_unary_op(typer, expr->op, expr->expr->operand, expr, strip(expr->type));
+        if(!result.val.is_constant)
+            return expr;
+        return literal(result.val, expr->type, expr->pos());
+    }
+
+    ast::ExprPtr Folder::fold_cast(ast::Cast *expr) {
+        // the spec of the cast hides the type of the expression.
+        auto type = expr->Expr::type;
+
+        expr->operand = fold(expr->operand);
+        if(!is_constant(expr->operand) or !is_foldable(type))
+            return expr;
+
+        auto value = value_of(expr->operand->operand.val, strip(expr->operand->type));
+        value.cast_to(strip(type));
+        return literal(value, type, expr->pos());
+    }
+
+    ast::ExprPtr Folder::fold_call(ast::Call *expr) {
+        // an array is indexed by calling it, only the index is a value.
+        auto callee = strip(expr->name->type);
+        if(callee and callee->is_array()) {
+            expr->name = fold_place(expr->name);
+            for(auto& actual : expr->actuals)
+                actual = fold(actual);
+            return expr;
+        }
+
+        bool constant_args = true;
+        for(auto& actual : expr->actuals) {
+            actual = fold(actual);
+            constant_args = constant_args and is_constant(actual);
+        }
+
+        auto entity = expr->name->operand.entity;
+        if(!constant_args or !entity or !entity->is_function() or !is_foldable(expr->type))
+            return expr;
+
+        auto function = entity->as<Function>();
+        if(!function->is_comptime())
+            return expr;
+
+        std::vector<Val> args;
+        for(auto actual : expr->actuals)
+            args.push_back(value_of(actual->operand.val, strip(actual->type)));
+
+        Val result;
+        switch(evaluator.call(function, args, result)) {
+            case ConstEval::Done:
+                return literal(result, expr->type, expr->pos());
+            case ConstEval::OutOfSteps:
+                // the call still runs with the program, it is only slower to start.
+                typer->get_interp()->message("'%s' is evaluated when the program runs, %s",
+                                             function->get_name()->value().c_str(), evaluator.get_reason().c_str());
+                return expr;
+            default:
+                return expr;
+        }
+    }
+
+    ast::ExprPtr Folder::fold_if(ast::If *expr) {
+        expr->cond = fold(expr->cond);
+        expr->body = fold(expr->body);
+        expr->else_if = fold(expr->else_if);
+        if(!is_constant(expr->cond))
+            return expr;
+
+        // the branch that is taken replaces the if when it has the value of the if.
+        auto taken = value_of(expr->cond->operand.val, strip(expr->cond->type))._Bool ? expr->body : expr->else_if;
+        if(!taken) {
+            if(strip(expr->type) != type_unit)
+                return expr;
+            folded++;
+            return unit(expr->pos());
+        }
+
+        if(strip(taken->type) != strip(expr->type))
+            return expr;
+        folded++;
+        return taken;
+    }
+
+    ast::ExprPtr Folder::fold_while(ast::While *expr) {
+        expr->cond = fold(expr->cond);
+        expr->body = fold(expr->body);
+
+        if(is_constant(expr->cond) and !value_of(expr->cond->operand.val, strip(expr->cond->type))._Bool) {
+            folded++;
+            return unit(expr->pos());
+        }
+        return expr;
+    }
+
+    ast::ExprPtr Folder::fold_match(ast::Match *expr) {
+        expr->cond = fold(expr->cond);
+        for(auto& member : expr->members) {
+            auto arm = member->as<ast::MatchArm>();
+            arm->body = fold(arm->body);
+        }
+
+        auto type = strip(expr->cond->type);
+        if(!is_constant(expr->cond) or !type->is_integer())
+            return expr;
+
+        // the first arm that matches is taken, a pattern that binds a name needs the arm to stay.
+        auto value = value_of(expr->cond->operand.val, type);
+        for(auto member : expr->members) {
+            auto arm = member->as<ast::MatchArm>();
+
+            for(auto pattern : arm->patterns) {
+                bool matched = false;
+                i64 literal = 0;
+                if(pattern_value(pattern, literal))
+                    matched = compare(Val(literal), value, type) == 0;
+                else if(pattern->kind == ast::ast_range_pattern) {
+                    auto range = pattern->as<ast::RangePattern>();
+                    i64 start = 0, end = 0;
+                    if(!pattern_value(range->start, start) or !pattern_value(range->end, end))
+                        return expr;
+                    matched = compare(Val(start), value, type) <= 0 and compare(value, Val(end), type) <= 0;
+                }
+                else if(pattern->kind == ast::ast_ignore_pattern)
+                    matched = true;
+                else
+                    return expr;
+
+                if(matched) {
+                    if(!arm->body or strip(arm->body->type) != strip(expr->type))
+                        return expr;
+                    folded++;
+                    return arm->body;
+                }
+            }
+        }
+        return expr;
+    }
+
+    ast::ExprPtr Folder::fold_for(ast::For *expr) {
+        expr->expr = fold(expr->expr);
+        expr->body = fold(expr->body);
+
+        auto limit = typer->get_interp()->unroll_limit();
+        if(expr->expr->kind != ast::ast_range or !expr->body)
+            return expr;
+
+        auto range = expr->expr->as<ast::Range>();
+        auto type = strip(range->type);
+        if(!is_constant(range->start) or !is_constant(range->end) or (range->step and !is_constant(range->step)))
+            return expr;
+
+        // the iterations are counted the way the loop runs them, the counter wraps like the type.
+        auto counter = value_of(range->start->operand.val, type);
+        auto end = value_of(range->end->operand.val, type);
+        auto step = range->step ? value_of(range->step->operand.val, type) : value_of(Val(CAST(i64, 1)), type);
+        if(compare(step, value_of(Val(CAST(i64, 0)), type), type) <= 0)
+            return expr;
+
+        std::vector<Val> iterations;
+        while(compare(counter, end, type) < 0) {
+            if(iterations.size() == limit)
+                return expr;
+            iterations.push_back(counter);
+
+            Val next;
+            if(type->is_signed())
+                next = Val(value_of(counter, type_i64)._I64 + value_of(step, type_i64)._I64);
+            else
+                next = Val(value_of(counter, type_u64)._U64 + value_of(step, type_u64)._U64);
+            next.type = type->is_signed() ? type_i64 : type_u64;
+            next.cast_to(type);
+            counter = next;
+        }
+
+        Entity* variable = nullptr;
+        if(expr->pattern->kind == ast::ast_ident_pattern)
+            variable = expr->pattern->as<ast::IdentPattern>()->entity;
+
+        // each iteration is a copy of the body, its declarations bind the same locals in order.
+        auto save = pinned;
+        pinned = false;
+        unrolling.push_back(variable);
+
+        ast::NodeList<ast::StmtPtr> elements;
+        for(auto& value : iterations) {
+            if(variable)
+                values[variable] = value;
+            auto body = fold(ast::copy(expr->body));
+            elements.push_back(ast::make_stmt<ast::ExprStmt>(body, body->pos()));
+        }
+
+        unrolling.pop_back();
+        if(variable)
+            values.erase(variable);
+        auto keep = pinned;
+        pinned = save;
+        if(keep)
+            return expr;
+
+        folded++;
+        auto node = ast::make_expr<ast::Block>(elements, expr->pos());
+        node->type = type_unit;
+        node->operand = Operand(type_unit, node, RValue);
+        return node;
+    }
+
+    void Folder::fold_block(ast::Block *expr) {
+        for(auto stmt : expr->elements) {
+            switch(stmt->kind) {
+                case ast::ast_expr: {
+                    auto expr_stmt = stmt->as<ast::ExprStmt>();
+                    expr_stmt->expr = fold(expr_stmt->expr);
+                } break;
+                case ast::ast_decl:
+                    fold_local(stmt->as<ast::DeclStmt>()->decl);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    void Folder::fold_local(ast::DeclPtr decl) {
+        switch(decl->kind) {
+            case ast::ast_mutable: {
+                auto local = decl->as<ast::Mutable>();
+                local->init = fold(local->init);
+            } break;
+            case ast::ast_local: {
+                auto local = decl->as<ast::Local>();
+                local->init = fold(local->init);
+
+                // every use of an immutable local with a constant value is replaced by the value.
+                // the copies of an unrolled body declare the same local, each with its own value.
+                // the initializer still runs where the local is declared, only its value is used.
+                if(local->names->kind == ast::ast_ident_pattern) {
+                    auto entity = local->names->as<ast::IdentPattern>()->entity;
+                    if(entity and local->init and has_value(local->init) and is_foldable(entity->get_type()))
+                        values[entity] = value_of(local->init->operand.val, strip(local->init->type));
+                    else
+                        values.erase(entity);
+                }
+            } break;
+            default:
+                break;
+        }
+    }
+
+    ast::ExprPtr Folder::fold_place(ast::ExprPtr expr) {
+        if(!expr)
+            return expr;
+
+        switch(expr->kind) {
+            case ast::ast_name:
+                if(expr->operand.entity and
+                   std::find(unrolling.begin(), unrolling.end(), expr->operand.entity) != unrolling.end())
+                    pinned = true;
+                return expr;
+            case ast::ast_self_expr:
+                return expr;
+            case ast::ast_accessor: {
+                auto accessor = expr->as<ast::Accessor>();
+                accessor->operand = fold_place(accessor->operand);
+            } return expr;
+            case ast::ast_tuple_accessor: {
+                auto accessor = expr->as<ast::TupleAcessor>();
+                accessor->operand = fold_place(accessor->operand);
+            } return expr;
+            default:
+                return fold(expr);
+        }
+    }
+
+    ast::ExprPtr Folder::literal(const Val &val, types::Type *type, const mu::Pos &pos) {
+        auto base = strip(type);
+        auto value = value_of(val, base);
+
+        ast::ExprPtr node = nullptr;
+        bool negative = false;
+        Val magnitude;
+        if(base->is_bool())
+            node = ast::make_expr<ast::Bool>(value._Bool, pos);
+        else if(base->kind() == types::Primitive_Char)
+            node = ast::make_expr<ast::Char>(value._Char, pos);
+        else if(base->is_float()) {
+            auto number = value_of(value, type_f64)._F64;
+            negative = std::signbit(number) and !std::isnan(number);
+            magnitude = value_of(Val(std::fabs(number)), base);
+            node = ast::make_expr<ast::Float>(std::fabs(number), pos);
+        }
+        else if(base->is_signed()) {
+            auto number = value_of(value, type_i64)._I64;
+            negative = number < 0;
+            auto bits = negative ? 0 - CAST(u64, number) : CAST(u64, number);
+            magnitude = value_of(Val(bits), base);
+            node = ast::make_expr<ast::Integer>(bits, pos);
+        }
+        else
+            node = ast::make_expr<ast::Integer>(value_of(value, type_u64)._U64, pos);
+
+        node->type = type;
+        if(negative) {
+            // the magnitude is a literal of its own, '-(5)'.
+            node->operand = Operand(type, node, magnitude);
+            node = ast::make_expr<ast::Unary>(Tkn_Minus, node, pos);
+            node->type = type;
+        }
+        node->operand = Operand(type, node, value);
+
+        folded++;
+        return node;
+    }
+
+    ast::ExprPtr Folder::unit(const mu::Pos &pos) {
+        auto node = ast::make_expr<ast::Unit>(pos);
+        node->type = type_unit;
+        node->operand = Operand(type_unit, node, RValue);
+        return node;
+    }
+}
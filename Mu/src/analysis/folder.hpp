@@ -0,0 +1,82 @@
+#ifndef MU_FOLDER_HPP
+#define MU_FOLDER_HPP
+
+#include "common.hpp"
+#include "const_eval.hpp"
+#include "entity.hpp"
+#include "value.hpp"
+#include "parser/ast/expr.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace mu {
+    class Typer;
+
+    // Replaces the constant expressions of a resolved module with literals.
+    //
+    // The typer computes the value of an expression of literals but leaves the
+    // expression in the tree. The folder rewrites it to a literal, and goes further by
+    // folding through constant globals, immutable locals with a constant value, casts
+    // and the conditions of branches, runs the calls of const functions with
+    // constant arguments and unrolls short loops over constant ranges, '[T; N]' with
+    // a small N. Every stage after the typer sees the folded tree.
+    class Folder {
+    public:
+        Folder(Typer* typer);
+
+        // folds the bodies and initializers of the entities of a module.
+        // returns the number of expressions that were replaced.
+        u64 fold(const std::vector<Entity*>& entities);
+
+    private:
+        // returns the expression that replaces expr, which can be expr itself.
+        ast::ExprPtr fold(ast::ExprPtr expr);
+
+        ast::ExprPtr fold_name(ast::ExprPtr expr);
+
+        ast::ExprPtr fold_binary(ast::Binary* expr);
+
+        ast::ExprPtr fold_unary(ast::Unary* expr);
+
+        ast::ExprPtr fold_cast(ast::Cast* expr);
+
+        // a call of a const function with constant arguments is replaced by its value.
+        ast::ExprPtr fold_call(ast::Call* expr);
+
+        ast::ExprPtr fold_if(ast::If* expr);
+
+        ast::ExprPtr fold_while(ast::While* expr);
+
+        ast::ExprPtr fold_match(ast::Match* expr);
+
+        // a loop over a constant range of a few iterations is replaced by a copy of its body
+        // for each iteration, with the loop variable folded to the value of the iteration.
+        ast::ExprPtr fold_for(ast::For* expr);
+
+        void fold_block(ast::Block* expr);
+
+        void fold_local(ast::DeclPtr decl);
+
+        // the storage an expression refers to is kept, only the values used to find it are folded.
+        ast::ExprPtr fold_place(ast::ExprPtr expr);
+
+        ast::ExprPtr literal(const Val& val, types::Type* type, const mu::Pos& pos);
+
+        ast::ExprPtr unit(const mu::Pos& pos);
+
+        Typer* typer{nullptr};
+        ConstEval evaluator;
+
+        // the values of the immutable globals and locals that are initialized by a constant.
+        std::unordered_map<Entity*, Val> values;
+
+        // the variables of the loops being unrolled, they don't have storage once the loop is gone.
+        // pinned is set when one is used as a place, '&i', the loop is kept.
+        std::vector<Entity*> unrolling;
+        bool pinned{false};
+        u64 folded{0};
+    };
+}
+
+#endif //MU_FOLDER_HPP
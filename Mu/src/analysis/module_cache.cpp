@@ -0,0 +1,167 @@
+#include "module_cache.hpp"
+#include "types/type.hpp"
+#include "utils/atom_table.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+// bumped whenever the format of a summary or the meaning of a type string changes.
+const u64 CACHE_VERSION = 1;
+
+const std::string CACHE_DIRECTORY = ".mu-cache";
+
+static const char* entity_kinds[] = {
+        "local",
+        "global",
+        "const",
+        "function",
+        "alias",
+        "type",
+        "module",
+};
+
+namespace mu {
+
+    ModuleCache::ModuleCache() : directory(CACHE_DIRECTORY) {
+    }
+
+    u64 ModuleCache::content_hash(io::File* file) {
+        if(!file->load())
+            return 0;
+
+        return content_hash(file->value());
+    }
+
+    u64 ModuleCache::content_hash(std::string_view content) {
+        return AtomTable::hash(content) ^ CACHE_VERSION;
+    }
+
+    bool ModuleCache::lookup(io::File* file, ModuleSummary& summary) {
+        summary = ModuleSummary();
+        summary.hash = content_hash(file);
+
+        std::ifstream in(summary_path(file));
+        if(!in)
+            return false;
+
+        u64 version = 0, hash = 0;
+        std::string word;
+        if(!(in >> word >> version) or word != "mu-cache" or version != CACHE_VERSION)
+            return false;
+
+        if(!(in >> word >> std::hex >> hash >> std::dec) or word != "hash" or hash != summary.hash)
+            return false;
+
+        std::string line;
+        while(in >> word) {
+            if(word == "dependency") {
+                u64 dep_hash = 0;
+                in >> std::hex >> dep_hash >> std::dec >> std::ws;
+                std::getline(in, line);
+
+                // a dependency that changed makes this summary stale as well.
+                io::File dependency(line);
+                if(content_hash(&dependency) != dep_hash)
+                    return false;
+                summary.dependencies.emplace_back(line, dep_hash);
+            }
+            else if(word == "export") {
+                ModuleSummary::Export ex;
+                std::string kind;
+                in >> kind >> ex.name;
+
+                u64 k = 0;
+                while(k < sizeof(entity_kinds) / sizeof(entity_kinds[0]) and kind != entity_kinds[k])
+                    ++k;
+                if(k == sizeof(entity_kinds) / sizeof(entity_kinds[0]))
+                    return false;
+                ex.kind = CAST(EntityKind, k);
+
+                // the type is the rest of the line, it can have spaces.
+                std::getline(in, line);
+                ex.type = line.empty() ? line : line.substr(1);
+                summary.exports.push_back(ex);
+            }
+            else
+                return false;
+        }
+        return true;
+    }
+
+    void ModuleCache::store(io::File* file, u64 hash, const std::vector<Entity*>& entities) {
+        if(!directory.create_directory())
+            return;
+
+        std::stringstream out;
+        out << "mu-cache " << CACHE_VERSION << std::endl;
+        out << "hash " << std::hex << hash << std::dec << std::endl;
+
+        // modules can't use each other yet so there are no dependencies to record.
+
+        for(auto entity : entities) {
+            auto type = entity->get_type();
+            out << "export " << entity_kinds[entity->kind()] << " " << entity->get_name()->value()
+                << " " << (type ? type->str() : "") << std::endl;
+        }
+        write_file(summary_path(file), out.str());
+    }
+
+    bool ModuleCache::has_object(io::File* file, u64 hash, const std::string& object_path) {
+        std::ifstream in(object_stamp_path(file));
+        if(!in)
+            return false;
+
+        u64 version = 0, source = 0, object = 0;
+        std::string word;
+        if(!(in >> word >> version) or word != "mu-object" or version != CACHE_VERSION)
+            return false;
+        if(!(in >> std::hex >> source >> object) or source != hash)
+            return false;
+
+        // an object that was rebuilt by something else or removed isn't the one recorded.
+        return object != 0 and file_hash(object_path) == object;
+    }
+
+    void ModuleCache::store_object(io::File* file, u64 hash, const std::string& object_path) {
+        if(!directory.create_directory())
+            return;
+
+        std::stringstream out;
+        out << "mu-object " << CACHE_VERSION << std::endl;
+        out << std::hex << hash << " " << file_hash(object_path) << std::endl;
+        write_file(object_stamp_path(file), out.str());
+    }
+
+    std::string ModuleCache::summary_path(io::File* file) {
+        std::stringstream ss;
+        ss << directory.string() << io::DIR_SEP << std::hex << io::IO::hash_name(file->path()) << ".summary";
+        return ss.str();
+    }
+
+    std::string ModuleCache::object_stamp_path(io::File* file) {
+        std::stringstream ss;
+        ss << directory.string() << io::DIR_SEP << std::hex << io::IO::hash_name(file->path()) << ".object";
+        return ss.str();
+    }
+
+    u64 ModuleCache::file_hash(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if(!in)
+            return 0;
+        std::string content{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        return AtomTable::hash(content);
+    }
+
+    void ModuleCache::write_file(const std::string& path, const std::string& content) {
+        // written next to the file then renamed over it.
+        auto temp = path + ".tmp";
+        {
+            std::ofstream out(temp, std::ios::trunc);
+            if(!out or !(out << content))
+                return;
+        }
+        std::rename(temp.c_str(), path.c_str());
+    }
+}
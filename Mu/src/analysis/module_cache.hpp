@@ -0,0 +1,73 @@
+#ifndef MU_MODULE_CACHE_HPP
+#define MU_MODULE_CACHE_HPP
+
+#include "common.hpp"
+#include "entity.hpp"
+#include "utils/file.hpp"
+
+namespace mu {
+
+    // What other modules can see of a module file, this is what is written to the cache.
+    struct ModuleSummary {
+        struct Export {
+            EntityKind kind;
+            std::string name;
+            // the resolved type as written by Type::str(), empty if it wasn't resolved.
+            std::string type;
+        };
+
+        // the content hash of the file.
+        u64 hash{0};
+
+        // the absolute path and content hash of every file this module depends on.
+        std::vector<std::pair<std::string, u64>> dependencies;
+
+        std::vector<Export> exports;
+    };
+
+    // On disk cache of module summaries, kept in '.mu-cache' of the working directory.
+    //
+    // There is one summary per source file, named by the hash of its absolute path. A file
+    // that was built also has an object stamp next to its summary.
+    // A summary is only used if the content of the file and of every file it depends on
+    // are unchanged, otherwise the file has to be parsed and resolved again.
+    class ModuleCache {
+    public:
+        ModuleCache();
+
+        static u64 content_hash(io::File* file);
+
+        static u64 content_hash(std::string_view content);
+
+        // loads the summary of file. Returns false if there isn't one or it is out of date,
+        // summary.hash is the current hash of the file either way.
+        bool lookup(io::File* file, ModuleSummary& summary);
+
+        // writes the summary of a module whose top level entities have been resolved.
+        // hash is the content hash the module was parsed from.
+        void store(io::File* file, u64 hash, const std::vector<Entity*>& entities);
+
+        // whether the object at object_path was built from the content with hash and hasn't
+        // been changed since. A summary alone doesn't mean there is an object, build-all
+        // stores summaries without building.
+        bool has_object(io::File* file, u64 hash, const std::string& object_path);
+
+        // records that the object at object_path was built from the content with hash.
+        void store_object(io::File* file, u64 hash, const std::string& object_path);
+
+    private:
+        std::string summary_path(io::File* file);
+
+        std::string object_stamp_path(io::File* file);
+
+        // the hash of the bytes of the file at path, 0 if it can't be read.
+        static u64 file_hash(const std::string& path);
+
+        // writes content to path through a temporary, a reader never sees half a file.
+        static void write_file(const std::string& path, const std::string& content);
+
+        io::Path directory;
+    };
+}
+
+#endif //MU_MODULE_CACHE_HPP
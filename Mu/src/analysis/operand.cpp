@@ -3,6 +3,7 @@
 //
 
 #include "operand.hpp"
+#include "parser/ast/expr.hpp"
 
 namespace mu {
     Operand::Operand(mu::types::Type *type, ast::Expr *expr,
@@ -24,4 +25,30 @@ namespace mu {
 
     Operand::Operand(ast::Expr* expr) :
 		type(nullptr), expr(expr), error(true), entity(nullptr) {}
+
+    // an expression without side effects, evaluating it only gives its value.
+    static bool is_pure(ast::Expr* expr) {
+        switch(expr->kind) {
+            case ast::ast_integer:
+            case ast::ast_fl:
+            case ast::ast_ch:
+            case ast::ast_bool:
+            case ast::ast_name:
+            case ast::ast_name_generic:
+            case ast::ast_self_expr:
+                return true;
+            case ast::ast_unary:
+                return is_pure(expr->as<ast::Unary>()->expr);
+            case ast::ast_binary:
+                return is_pure(expr->as<ast::Binary>()->lhs) and is_pure(expr->as<ast::Binary>()->rhs);
+            case ast::ast_cast_expr:
+                return is_pure(expr->as<ast::Cast>()->operand);
+            default:
+                return false;
+        }
+    }
+
+    bool is_constant_expr(ast::Expr* expr) {
+        return expr and expr->operand.val.is_constant and is_pure(expr);
+    }
 }
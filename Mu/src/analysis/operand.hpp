@@ -58,5 +58,10 @@ namespace mu {
         // this is so the error can be propagated
         explicit Operand(ast::Expr *expr);
     };
+
+    // whether expr can be replaced by its constant value. Only literals, names and the operators
+    // and casts of those qualify. A block, branch or call whose value is known still has
+    // statements that run, only its value can be taken from the operand.
+    bool is_constant_expr(ast::Expr* expr);
 }
 #endif //MU_OPERAND_HPP
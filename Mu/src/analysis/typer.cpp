@@ -6,6 +6,11 @@
 #include "typer.hpp"
 
 #include "typer_op_eval.hpp"
+#include "folder.hpp"
+
+#include "parser/ast/clone.hpp"
+
+#include <algorithm>
 
 
 #define report(pos, msg, ...) { \
@@ -52,6 +57,151 @@ extern mu::types::Type* type_string;
 
 namespace mu {
 
+    // the generic names of a polymorphic struct or function, null if it is concrete.
+    static ast::GenericGroup* generics_of(Entity* entity) {
+        if(!entity or !entity->get_decl())
+            return nullptr;
+
+        ast::DeclPtr generics{nullptr};
+        auto decl = entity->get_decl();
+        switch(decl->kind) {
+            case ast::ast_structure:
+                generics = decl->as<ast::Structure>()->generics;
+                break;
+            case ast::ast_procedure:
+                generics = decl->as<ast::Procedure>()->signiture->generics;
+                break;
+            default:
+                break;
+        }
+        return generics ? generics->as<ast::GenericGroup>() : nullptr;
+    }
+
+    static ast::Ident* generic_name(ast::DeclPtr generic) {
+        if(generic->kind == ast::ast_bounded_generic)
+            return generic->as<ast::BoundedGeneric>()->name;
+        return generic->as<ast::Generic>()->name;
+    }
+
+    // whether a generic name is used by a parameter type, 'T' or the 'N' of '[T; N]'.
+    static bool mentions_generic(ast::Spec* spec, ast::Ident* generic) {
+        if(!spec)
+            return false;
+
+        switch(spec->kind) {
+            case ast::ast_expr_type: {
+                auto named = spec->as<ast::ExprSpec>()->type;
+                return named->kind == ast::ast_name and named->as<ast::Name>()->name->val == generic->val;
+            }
+            case ast::ast_list_spec: {
+                auto list = spec->as<ast::ListSpec>();
+                if(list->size and list->size->kind == ast::ast_name and list->size->as<ast::Name>()->name->val == generic->val)
+                    return true;
+                return mentions_generic(list->type, generic);
+            }
+            case ast::ast_mut:
+                return mentions_generic(spec->as<ast::MutSpec>()->type, generic);
+            case ast::ast_ptr:
+                return mentions_generic(spec->as<ast::PtrSpec>()->type, generic);
+            default:
+                return false;
+        }
+    }
+
+    // the argument of a generic found in the type of an actual given for a parameter declared
+    // with spec, a '[f32; 3]' given for '[T; N]' is 'T = f32' and 'N = 3'. A generic bounded by
+    // an integer type is a length.
+    static bool match_generic(ast::Spec* spec, types::Type* type, ast::Ident* generic, types::Type* bound,
+                              GenericArg& arg) {
+        while(type and type->kind() == types::MutableType)
+            type = type->as<types::Mutable>()->get_inner();
+        if(!spec or !type)
+            return false;
+
+        switch(spec->kind) {
+            case ast::ast_expr_type: {
+                auto named = spec->as<ast::ExprSpec>()->type;
+                if(bound or named->kind != ast::ast_name or named->as<ast::Name>()->name->val != generic->val)
+                    return false;
+                arg.type = type;
+                return true;
+            }
+            case ast::ast_list_spec: {
+                if(!type->is_array())
+                    return false;
+
+                auto list = spec->as<ast::ListSpec>();
+                auto array = type->as<types::Array>();
+                if(bound and list->size and list->size->kind == ast::ast_name and
+                   list->size->as<ast::Name>()->name->val == generic->val) {
+                    arg.type = bound;
+                    arg.is_value = true;
+                    arg.value = array->num_elements();
+                    return true;
+                }
+                return match_generic(list->type, array->get_element_type(), generic, bound, arg);
+            }
+            case ast::ast_mut:
+                return match_generic(spec->as<ast::MutSpec>()->type, type, generic, bound, arg);
+            case ast::ast_ptr:
+                if(!type->is_ptr())
+                    return false;
+                return match_generic(spec->as<ast::PtrSpec>()->type, type->base_type(), generic, bound, arg);
+            default:
+                return false;
+        }
+    }
+
+    // the value of a constant integer that is a length, false if it isn't one or it is negative.
+    static bool constant_length(const Operand& operand, u64& length) {
+        auto type = operand.type;
+        while(type and type->kind() == types::MutableType)
+            type = type->as<types::Mutable>()->get_inner();
+
+        if(operand.error or !operand.val.is_constant or !type or !type->is_integer() or type->is_bool())
+            return false;
+
+        Val value = operand.val;
+        if(!value.type)
+            value.type = type;
+        if(type->is_signed()) {
+            value.cast_to(type_i64);
+            if(value._I64 < 0)
+                return false;
+            length = CAST(u64, value._I64);
+        }
+        else {
+            value.cast_to(type_u64);
+            length = value._U64;
+        }
+        return true;
+    }
+
+    // the binary operator of a compound assignment, '+=' is '+'.
+    static TokenKind compound_operator(TokenKind op) {
+        switch(op) {
+            case Tkn_PlusEqual: return Tkn_Plus;
+            case Tkn_MinusEqual: return Tkn_Minus;
+            case Tkn_AstrickEqual: return Tkn_Astrick;
+            case Tkn_SlashEqual: return Tkn_Slash;
+            case Tkn_PercentEqual: return Tkn_Percent;
+            case Tkn_AstrickAstrickEqual: return Tkn_AstrickAstrick;
+            case Tkn_LessLessEqual: return Tkn_LessLess;
+            case Tkn_GreaterGreaterEqual: return Tkn_GreaterGreater;
+            case Tkn_AmpersandEqual: return Tkn_Ampersand;
+            case Tkn_PipeEqual: return Tkn_Pipe;
+            case Tkn_CarrotEqual: return Tkn_Carrot;
+            default: return op;
+        }
+    }
+
+    // the array an operand of an element-wise operator is, nullptr if it is a single value.
+    static types::Array* array_operand(const Operand& operand) {
+        auto type = operand.type;
+        while(type and type->kind() == types::MutableType)
+            type = type->as<types::Mutable>()->get_inner();
+        return type and type->is_array() ? type->as<types::Array>() : nullptr;
+    }
 
     Typer::Typer(Interpreter *interp) : interp(interp), prelude(interp->get_prelude()), renderer(true, interp->out_stream()) {
     }
@@ -119,7 +269,7 @@ namespace mu {
     Local* Typer::new_padding(const std::string& name, u32 size) {
         auto padding_atom = interp->find_name(name);
         auto padding_type = interp->checked_new_type<types::Array>(type_u8, size);
-        auto entity = interp->new_entity<mu::Local>(new ast::Ident(padding_atom, mu::Pos((u64) 0, (u64) 0, (u64) 0, interp->current_file()->id())), padding_type,
+        auto entity = interp->new_entity<mu::Local>(ast::make_ident(padding_atom, mu::Pos(interp->current_file()->base(), 0)), padding_type,
             Reference, active_scope(), context.active_entity->get_decl());
 
         entity->resolve_to(padding_type);
@@ -129,6 +279,9 @@ namespace mu {
     }
 
     Module * Typer::resolve_main_module(ast::ModuleFile *main_module) {
+        // nodes made while resolving belong to the module.
+        mem::Arena::Scope scope(main_module->get_arena());
+
         // this will become the executable name.
         auto name = main_module->get_name();
 
@@ -137,15 +290,17 @@ namespace mu {
         push_scope(module_scope);
 
 
-        std::vector<Entity*> entities;
-        std::vector<ast::DeclPtr> impl_blocks;
+        top_level.clear();
+        instances.clear();
+        instance_order.clear();
+        ast::NodeList<ast::DeclPtr> impl_blocks;
         for(auto& decl : *main_module) {
             if(decl->kind == ast::ast_impl)
                 impl_blocks.push_back(decl);
             else {
                 auto entity = build_top_level_entity(decl);
                 add_entity(entity);
-                entities.emplace_back(entity);
+                top_level.emplace_back(entity);
             }
         }
 
@@ -164,12 +319,24 @@ namespace mu {
             }
         }
 
-        for(auto entity : entities) {
+        for(auto entity : top_level) {
             auto e = resolve_entity(entity);
     
             if(e) e->debug_print(interp->out_stream());
         }
 
+        // the polymorphic entities are only templates, the stages after the typer
+        // see their instances instead.
+        top_level.erase(std::remove_if(top_level.begin(), top_level.end(), generics_of), top_level.end());
+        top_level.insert(top_level.end(), instance_order.begin(), instance_order.end());
+
+        // every stage after the typer sees the constant expressions as literals.
+        if(!has_error()) {
+            Folder folder(this);
+            auto folded = folder.fold(top_level);
+            interp->debug("Folded %lu constant expressions", folded);
+        }
+
         pop_scope();
 
 //        auto main_module_type = interp->new_type<ModuleType>();
@@ -275,6 +442,22 @@ namespace mu {
         return e;
     }
 
+    Entity *Typer::resolve_dependency(Entity *entity, Entity *owner) {
+        if(entity->status() != Incomplete)
+            return entity;
+
+        // the entity is resolved in the scope it was declared, not where it is used.
+        auto saved = context;
+        context = Context();
+        context.current_scope = entity->scope();
+        context.impl_block_entity = owner;
+
+        auto e = resolve_entity(entity);
+
+        context = saved;
+        return e;
+    }
+
     Entity *Typer::resolve(Global *global) {
         
         ast::Ident* name{nullptr};
@@ -285,8 +468,8 @@ namespace mu {
             auto declaration = global->get_decl_as<ast::GlobalMut>();
 
             name = declaration->name;
-            spec = declaration->type.get();
-            init = declaration->init.get();
+            spec = declaration->type;
+            init = declaration->init;
 
             if(!spec and !init) {
                 report(name->pos, "global '%s' must have a type or be initialized", name->value().c_str());
@@ -296,8 +479,8 @@ namespace mu {
             auto declaration = global->get_decl_as<ast::Global>();
 
             name = declaration->name;
-            spec = declaration->type.get();
-            init = declaration->init.get();
+            spec = declaration->type;
+            init = declaration->init;
 
             if(!init) {
                 report(name->pos, "constant global '%s' must be initialized", name->value().c_str());
@@ -346,6 +529,9 @@ namespace mu {
             constant->resolve_to(resolved_type);
             
             active_scope()->replace_name(constant->get_name(), constant);
+
+            // the module refers to the constant from now on.
+            std::replace(top_level.begin(), top_level.end(), CAST(Entity*, global), CAST(Entity*, constant));
             return constant;
         }
         else {
@@ -395,7 +581,7 @@ namespace mu {
                     if(p->pattern->kind == ast::ast_ident_pattern) {
                         auto name = p->pattern->as<ast::IdentPattern>();
                         types::Type* type = nullptr;
-                        Operand operand(p->init.get());
+                        Operand operand(p->init);
 
                         if(is_redeclaration(name->name)) {
                             report(name->pos(), "parameter '%s' is redeclared in this scope", name->name->value().c_str());
@@ -403,10 +589,10 @@ namespace mu {
                         }
 
                         if(p->type)
-                            type = resolve_spec(p->type.get());
+                            type = resolve_spec(p->type);
 
                         if(p->init) {
-                            operand = resolve_expr(p->init.get(), type);
+                            operand = resolve_expr(p->init, type);
                         }
 
                         // this is an actual error.
@@ -467,7 +653,7 @@ namespace mu {
                         mut = context.impl_block_entity->get_type();
 
                     auto type = interp->checked_new_type<types::Pointer>(mut);
-                    auto ident = new ast::Ident(interp->find_name("self"), p->pos());
+                    auto ident = ast::make_ident(interp->find_name("self"), p->pos());
                     auto local = interp->new_entity<Local>(ident, nullptr, Reference, active_scope(), param);
                     local->resolve_to(type);
                     local->set_parameter();
@@ -497,7 +683,7 @@ namespace mu {
                     auto var = param->as<ast::VariadicParameter>();
                     auto name =  var->pattern->as<ast::IdentPattern>();
 
-                    auto type = resolve_spec(var->type.get());
+                    auto type = resolve_spec(var->type);
 
                     if(type == nullptr and var->type->kind == ast::ast_infer_type) {
                         report_str(var->type->pos(), "unable to infer typed variadic parameters (at this time)");
@@ -536,6 +722,9 @@ namespace mu {
         }
 
         auto function_decl = funct->get_decl_as<ast::Procedure>();
+        if(function_decl->signiture->generics)
+            return resolve_poly_function(funct, function_decl);
+
         ast::Ident *foreign_name{nullptr};
 
         for (auto &attr : function_decl->attributeList.attributes) {
@@ -543,12 +732,23 @@ namespace mu {
                 funct->set_foreign(attr.value);
                 foreign_name = attr.attr;
             }
+            else if (attr.attr->val == interp->find_name("comptime"))
+                funct->set_comptime();
+        }
+
+        for (auto modifier : function_decl->modifiers)
+            if (modifier == ast::Mod_Const)
+                funct->set_comptime();
+
+        if (funct->is_comptime() and (funct->is_foreign() or !function_decl->body)) {
+            report(function_decl->pos(), "'%s' can not be evaluated at compile time, it doesn't have a body",
+                   funct->get_name()->value().c_str());
         }
 
         auto params_scope = make_scope<ParameterScope>(function_decl, active_scope());
         push_scope(params_scope);
 
-        auto [params, valid] = resolve_function_members(function_decl->signiture.get());
+        auto [params, valid] = resolve_function_members(function_decl->signiture);
         std::vector<types::Type*> param_types;
         if(!valid) {
             // the error has already been reported.
@@ -570,8 +770,20 @@ namespace mu {
 
         funct->set_param_info(params, params_scope);
 
+        // if we are resolving an impl block
+        if(context.impl_block_entity) {
+          if(params.size() >= 1)
+            // since the first parameter is a self, then this is a method.
+            if(params.front()->is_self())
+              funct->set_method();
+          // since this is a impl block function and the first parameter is not a self
+          // this is a static function
+          if(!funct->is_method())
+            funct->set_static();
+        }
+
         types::Type* ret_type{nullptr};
-        Operand expr_ret(function_decl->body.get());
+        Operand expr_ret(function_decl->body);
 
         if(function_decl->signiture->ret) {
             auto ret = function_decl->signiture->ret;
@@ -584,9 +796,14 @@ namespace mu {
                 return nullptr;
             }
             else
-                ret_type = resolve_spec(ret.get());
+                ret_type = resolve_spec(ret);
         }
 
+        // with a given return type the function type is known before the body,
+        // this lets the body call the function.
+        if(ret_type and function_decl->body)
+            funct->resolve_to(interp->checked_new_type<types::FunctionType>(param_types, ret_type));
+
         if(function_decl->body) {
             if(funct->is_foreign()) {
                 report_str(foreign_name->pos, "function is foreign and has a body");
@@ -594,7 +811,9 @@ namespace mu {
             }
             else {
                 push_context_state(function_body, true)
-                expr_ret = resolve_expr(function_decl->body.get(), ret_type);
+                push_context_state(return_type, ret_type)
+                expr_ret = resolve_expr(function_decl->body, ret_type);
+                pop_context_state(return_type)
                 pop_context_state(function_body)
 
                 if(expr_ret.error) {
@@ -609,6 +828,12 @@ namespace mu {
                 return nullptr;
             }
             else {
+                pop_scope();
+
+                // a foreign function without a return type returns unit.
+                if(!ret_type)
+                    ret_type = type_unit;
+
                 // are there any special cases in regards to foreign functions and trait functions?
                 auto type = interp->checked_new_type<types::FunctionType>(param_types, ret_type);
                 funct->resolve_to(type);
@@ -630,18 +855,7 @@ namespace mu {
               interp->print_file_section(p->get_decl()->pos());
             }
         }
-    
-        // if we are resolving an impl block
-        if(context.impl_block_entity) {
-          if(params.size() >= 1)
-            // since the first parameter is a self, then this is a method.
-            if(params.front()->is_self())
-              funct->set_method();
-          // since this is a impl block function and the first parameter is not a self
-          // this is a static function
-          if(!funct->is_method())
-            funct->set_static();
-        }
+
 
         auto type = interp->checked_new_type<types::FunctionType>(param_types, ret_type);
         funct->resolve_to(type);
@@ -656,12 +870,12 @@ namespace mu {
         return constant;
     }
 
-    std::tuple<u64, u64, std::vector<ast::Ident*>> Typer::construct_member_order(std::vector<Entity*>& member) {
+    std::tuple<u64, u64, ast::NodeList<ast::Ident*>> Typer::construct_member_order(std::vector<Entity*>& member) {
         u64 size = 0;
         if(member.empty()) {
-            return std::make_tuple(0, 0, std::vector<ast::Ident*>({}));
+            return std::make_tuple(0, 0, ast::NodeList<ast::Ident*>({}));
         }
-        std::vector<ast::Ident*> order;
+        ast::NodeList<ast::Ident*> order;
 
         u32 num_paddings = 0;
         u64 largest_align = 0;
@@ -787,7 +1001,10 @@ namespace mu {
 		}
     }
 
+    // a polymorphic struct doesn't have a layout, each use with type arguments is
+    // resolved as its own struct, see instantiate.
     Entity* Typer::resolve_poly_struct(Type* entity, ast::DeclPtr decl_ptr) {
+        interp->debug("'%s' is resolved when it is given type arguments", entity->get_name()->value().c_str());
         return entity;
     }
 
@@ -846,10 +1063,200 @@ namespace mu {
 //        return entity;
 //    }
 //
-//    Entity* Typer::resolve_poly_function(Type* entity, ast::DeclPtr decl_ptr) {
-//
-//        return entity;
-//    }
+    // the body of a polymorphic function is checked for each instance, see instantiate.
+    Entity* Typer::resolve_poly_function(Function* entity, ast::DeclPtr decl_ptr) {
+        interp->debug("'%s' is resolved when it is given type arguments", entity->get_name()->value().c_str());
+        return entity;
+    }
+
+    types::Type* Typer::value_generic_type(ast::DeclPtr generic, ScopePtr scope) {
+        if(generic->kind != ast::ast_bounded_generic)
+            return nullptr;
+
+        // a value is bounded by a single integer type.
+        auto& bounds = generic->as<ast::BoundedGeneric>()->bounds.type_bounds;
+        if(bounds.size() != 1 or bounds.front()->kind != ast::ast_expr_type)
+            return nullptr;
+
+        auto name = bounds.front()->as<ast::ExprSpec>()->type;
+        if(name->kind != ast::ast_name)
+            return nullptr;
+
+        auto entity = search_scope(scope, name->as<ast::Name>()->name);
+        if(!entity)
+            entity = search_scope(prelude, name->as<ast::Name>()->name);
+        if(!entity or !entity->is_type() or !entity->get_type())
+            return nullptr;
+
+        auto type = entity->get_type();
+        return type->is_integer() and !type->is_bool() ? type : nullptr;
+    }
+
+    bool Typer::resolve_generic_value(ast::Spec* spec, types::Type* type, GenericArg& arg) {
+        if(spec->kind != ast::ast_expr_type) {
+            report(spec->pos(), "expecting a constant of type '%s'", type->str().c_str());
+            return false;
+        }
+
+        auto value = resolve_expr(spec->as<ast::ExprSpec>()->type);
+        if(value.error)
+            return false;
+
+        u64 length = 0;
+        if(!constant_length(value, length)) {
+            report(spec->pos(), "expecting a constant of type '%s'", type->str().c_str());
+            return false;
+        }
+
+        // the value has to be the same after it is converted to the bound.
+        Val bounded(length);
+        bounded.cast_to(type);
+        bounded.cast_to(type_u64);
+        if(bounded._U64 != length) {
+            report(spec->pos(), "'%lu' does not fit in '%s'", length, type->str().c_str());
+            return false;
+        }
+
+        arg.type = type;
+        arg.is_value = true;
+        arg.value = length;
+        return true;
+    }
+
+    Entity* Typer::instantiate(Entity* poly, const std::vector<GenericArg>& args, const mu::Pos& pos) {
+        auto group = generics_of(poly);
+        if(!group) {
+            report(pos, "'%s' doesn't take type arguments", poly->get_name()->value().c_str());
+            return nullptr;
+        }
+
+        if(group->generics.size() != args.size()) {
+            report(pos, "'%s' expects %lu type arguments, found %lu", poly->get_name()->value().c_str(),
+                   (u64) group->generics.size(), (u64) args.size());
+            return nullptr;
+        }
+
+        auto key = std::make_pair(poly, args);
+        auto iter = instances.find(key);
+        if(iter != instances.end())
+            return iter->second;
+
+        // the instance is named by its arguments, 'Pair[i32]' or 'Vec[f32, 3]'.
+        std::string name = poly->get_name()->value() + "[";
+        for(u64 i = 0; i < args.size(); ++i)
+            name += (i ? ", " : "") + (args[i].is_value ? std::to_string(args[i].value) : args[i].type->str());
+        name += "]";
+        auto ident = ast::make_ident(interp->find_name(name), poly->get_name()->pos);
+
+        // the typer annotates the tree it resolves, every instance gets its own copy.
+        auto decl = ast::clone(poly->get_decl());
+
+        // the instance is resolved in the scope of the polymorphic entity with the
+        // generic names bound to the arguments in a const block.
+        auto saved = context;
+        context = Context();
+        context.current_scope = poly->scope();
+
+        auto const_block = make_scope<ConstBlockScope>(ident, decl, active_scope());
+        push_scope(const_block);
+
+        for(u64 i = 0; i < args.size(); ++i) {
+            auto generic = group->generics[i];
+            auto generic_ident = generic_name(generic);
+            if(is_redeclaration(generic_ident)) {
+                report(generic->pos(), "generic '%s' is declared more than once", generic_ident->value().c_str());
+                context = saved;
+                return nullptr;
+            }
+
+            // a value is a constant of its bound, 'N' is the length of '[T; N]'.
+            Entity* bound{nullptr};
+            if(args[i].is_value) {
+                Val value(args[i].value);
+                value.cast_to(args[i].type);
+                bound = interp->new_entity<Constant>(generic_ident, args[i].type, value, active_scope(), (ast::DeclPtr) nullptr);
+            }
+            else
+                bound = interp->new_entity<Type>(generic_ident, active_scope(), (ast::DeclPtr) nullptr);
+            bound->resolve_to(args[i].type);
+            add_entity(bound);
+        }
+
+        Entity* instance{nullptr};
+        if(decl->kind == ast::ast_structure) {
+            auto structure = decl->as<ast::Structure>();
+            structure->name = ident;
+            structure->generics = nullptr;
+
+            auto type = interp->new_entity<Type>(ident, active_scope(), decl);
+            for(auto block : poly->as<Type>()->get_impls())
+                type->add_impl(ast::clone(block));
+            instance = type;
+        }
+        else {
+            auto procedure = decl->as<ast::Procedure>();
+            procedure->name = ident;
+            procedure->signiture->generics = nullptr;
+
+            instance = interp->new_entity<Function>(ident, active_scope(), decl);
+        }
+
+        // the instance is found by a use in its own declaration.
+        instances.emplace(key, instance);
+        instance_order.push_back(instance);
+
+        interp->debug("Instantiating %s", name.c_str());
+        auto e = resolve_entity(instance);
+        context = saved;
+
+        if(!e) {
+            instances[key] = nullptr;
+            interp->message("in the instance '%s' used here:", name.c_str());
+            interp->print_file_section(pos);
+            return nullptr;
+        }
+
+        e->debug_print(interp->out_stream());
+        return e;
+    }
+
+    Function* Typer::infer_instance(Function* poly, ast::Call* call) {
+        auto procedure = poly->get_decl_as<ast::Procedure>();
+        auto& params = procedure->signiture->parameters;
+
+        std::vector<GenericArg> args;
+        for(auto generic : generics_of(poly)->generics) {
+            auto generic_ident = generic_name(generic);
+            auto bound = value_generic_type(generic, poly->scope());
+
+            // the first parameter declared with the generic name gives its argument.
+            GenericArg arg;
+            bool found = false;
+            for(u64 i = 0; i < params.size() and i < call->actuals.size() and !found; ++i) {
+                if(params[i]->kind != ast::ast_procedure_parameter)
+                    continue;
+
+                auto spec = params[i]->as<ast::ProcedureParameter>()->type;
+                if(!mentions_generic(spec, generic_ident))
+                    continue;
+
+                auto actual = resolve_expr(call->actuals[i]);
+                if(actual.error)
+                    return nullptr;
+                found = match_generic(spec, actual.type, generic_ident, bound, arg);
+            }
+
+            if(!found) {
+                report(call->pos(), "unable to infer '%s' of '%s', the type arguments must be given",
+                       generic_ident->value().c_str(), poly->get_name()->value().c_str());
+                return nullptr;
+            }
+            args.push_back(arg);
+        }
+
+        auto instance = instantiate(poly, args, call->pos());
+        return instance ? instance->as<Function>() : nullptr;
+    }
 
     Entity* Typer::resolve_sumtype(Type* entity, ast::DeclPtr decl_ptr) {
 
@@ -884,7 +1291,7 @@ namespace mu {
         types::Type* type{nullptr};
 
         if(member->type)
-            type = resolve_spec(member->type.get());
+            type = resolve_spec(member->type);
 
 
         if(num_names == num_exprs) {
@@ -892,7 +1299,7 @@ namespace mu {
 
             // resolve the type of the expression
             for(auto& i : member->init) {
-                auto op = resolve_expr(i.get(), type);
+                auto op = resolve_expr(i, type);
 
                 if(op.error) {
 					interp->debug("Error resolving expression");
@@ -920,7 +1327,7 @@ namespace mu {
 
         }
         else if(num_exprs == 1) {
-            auto op = resolve_expr(member->init.front().get(), type);
+            auto op = resolve_expr(member->init.front(), type);
 
             for(u32 i = 0; i < num_names; ++i) {
                 auto e = interp->new_entity<Local>(member->names[i], op.type,
@@ -981,9 +1388,9 @@ namespace mu {
     }
 
     void Typer::resolve_local_from_decl(ast::DeclPtr decl_ptr, bool mut) {
-        ast::PatternPtr pattern;
-        ast::SpecPtr spec;
-        ast::ExprPtr init;
+        ast::PatternPtr pattern = nullptr;
+        ast::SpecPtr spec = nullptr;
+        ast::ExprPtr init = nullptr;
         push_context_state(resolving_local, true);
 
         if(mut) {
@@ -1005,20 +1412,20 @@ namespace mu {
             }
         }
 
-        if(spec->kind != ast::ast_infer_type and !init) {
+        if(spec->kind == ast::ast_infer_type and !init) {
             report_str(decl_ptr->pos(), "local variable requires a type annotation or initialization expression")
             pop_context_state(resolving_local);
             return;
         }
 
         types::Type* type = nullptr;
-        Operand result(nullptr, init.get(), RValue);
+        Operand result(nullptr, init, RValue);
 
         if(spec)
-            type = resolve_spec(spec.get());
+            type = resolve_spec(spec);
 
         if(init)
-            result = resolve_expr(init.get(), type);
+            result = resolve_expr(init, type);
 
         auto expected_type = (type ? type : result.type);
         Operand op = result;
@@ -1026,7 +1433,7 @@ namespace mu {
         op.error = false;
         op.type= expected_type;
 
-        resolve_pattern(pattern.get(), op, decl_ptr);
+        resolve_pattern(pattern, op, decl_ptr);
         pop_context_state(resolving_local);
     }
 
@@ -1055,12 +1462,15 @@ namespace mu {
             case ast::ast_unary:
                 result = resolve_unary(expr->as<ast::Unary>(), nullptr);
                 break;
+            case ast::ast_cast_expr:
+                result = resolve_cast(expr->as<ast::Cast>());
+                break;
             case ast::ast_tuple_expr: {
                 auto t = expr->as<ast::TupleExpr>();
                 u64 sz = 0;
                 std::vector<types::Type*> types;
                 for(auto& element : t->elements) {
-                    auto op = resolve_expr(element.get());
+                    auto op = resolve_expr(element);
                     if(op.error)
                         return Operand(expr);
 
@@ -1074,6 +1484,9 @@ namespace mu {
                 break;
 
             }
+            case ast::ast_list:
+                result = resolve_list(expr, expected_type);
+                break;
             case ast::ast_accessor:
                 result = resolve_accessor(expr);
                 break;
@@ -1103,18 +1516,50 @@ namespace mu {
 				}
 				else {
 					entity->set_used();
-					return Operand(entity->get_type(), expr, SelfAccess, entity);
+					result = Operand(entity->get_type(), expr, SelfAccess, entity);
 				}
             } break;
 			// this needs to be implemented in resolve_expr
 			case ast::ast_method: {
 				result = resolve_method_call(expr);
 			} break;
+            case ast::ast_if_expr:
+                result = resolve_if(expr);
+                break;
+            case ast::ast_while_expr:
+                result = resolve_while(expr);
+                break;
+            case ast::ast_for_expr:
+                result = resolve_for(expr);
+                break;
+            case ast::ast_match_expr:
+                result = resolve_match(expr, expected_type);
+                break;
+            case ast::ast_defer_expr:
+                result = resolve_defer(expr);
+                break;
+            case ast::ast_return:
+                result = resolve_return(expr);
+                break;
+            case ast::ast_assign:
+                result = resolve_assign(expr);
+                break;
             default:
                 break;
         }
 
-        if(expected_type) {
+        // a constant takes the type expected of it as long as it is the same kind of number,
+        // otherwise 'let x u64 = 1' would be an error because the literal is an i32.
+        if(expected_type and !result.error and result.val.is_constant and result.type) {
+            bool both_integers = result.type->is_integer() and expected_type->is_integer();
+            bool both_floats = result.type->is_float() and expected_type->is_float();
+            if(both_integers or both_floats) {
+                result.val.cast_to(expected_type);
+                result.type = expected_type;
+            }
+        }
+
+        if(expected_type and !result.error) {
             // check for compatibility of thr resulting type and the expected type.
              if(!compatible_types(expected_type, result.type)) {
                  report(expr->pos(), "incompitable type: '%s' expected: '%s'",
@@ -1141,8 +1586,8 @@ namespace mu {
 
     Operand Typer::resolve_binary(ast::Binary *expr, types::Type *expected_type) {
         // resolve sub expression
-        auto lhs = resolve_expr(expr->lhs.get());
-        auto rhs = resolve_expr(expr->rhs.get());
+        auto lhs = resolve_expr(expr->lhs);
+        auto rhs = resolve_expr(expr->rhs);
 
         // check for errors.
         if(lhs.error)
@@ -1150,13 +1595,36 @@ namespace mu {
         else if(rhs.error)
             return rhs;
 
-        if(lhs.type->is_arithmetic() and lhs.type->is_primative()) {
-            return resolve_arithmetic_binary(expr->op, lhs, rhs, expr, expected_type);
+        // the operators are applied to each element of an array, 'a + b' or 'v * 2.0'.
+        if(array_operand(lhs) or array_operand(rhs))
+            return resolve_array_binary(expr->op, lhs, rhs, expr);
+
+        // a constant takes the type of the other side, 'x == 20' where x is an i64.
+        auto same_kind = (lhs.type->is_integer() and rhs.type->is_integer() and
+                          !lhs.type->is_bool() and !rhs.type->is_bool()) or
+                         (lhs.type->is_float() and rhs.type->is_float());
+        if(same_kind and lhs.type != rhs.type) {
+            if(rhs.val.is_constant and !lhs.val.is_constant)
+                rhs = resolve_expr(expr->rhs, lhs.type);
+            else if(lhs.val.is_constant and !rhs.val.is_constant)
+                lhs = resolve_expr(expr->lhs, rhs.type);
+
+            if(lhs.error)
+                return lhs;
+            else if(rhs.error)
+                return rhs;
         }
-        else if(lhs.type->is_ptr()) {
 
+        if((lhs.type->is_arithmetic() and lhs.type->is_primative()) or lhs.type->is_ptr()) {
+            return resolve_arithmetic_binary(expr->op, lhs, rhs, expr, expected_type);
+        }
+        else {
+            report(expr->pos(), "invalid operands for binary operation '%s' with types: '%s' and '%s'",
+                   Token::get_string(expr->op).c_str(),
+                   lhs.type->str().c_str(),
+                   rhs.type->str().c_str())
+            return Operand(expr);
         }
-        else return resolve_binary_overload(Tkn_Mut, rhs, lhs, nullptr, nullptr);
     }
 
     Operand Typer::resolve_arithmetic_binary(TokenKind op, Operand lhs, Operand rhs, ast::Expr *expr,
@@ -1183,6 +1651,18 @@ namespace mu {
                     break;
             }
         }
+        else if(lhs_type->is_bool() and rhs_type->is_bool()) {
+            switch(op) {
+                // boolean logic
+                case mu::Tkn_And:
+                case mu::Tkn_Or:
+                case mu::Tkn_EqualEqual:
+                case mu::Tkn_BangEqual:
+                    return eval_binary_op(this, op, lhs, rhs, expr, type_bool);
+                default:
+                    break;
+            }
+        }
         else if(!invalid_lhs and rhs_type->is_arithmetic() and rhs_type->is_primative()) {
             switch(op) {
                // standard arithmitic
@@ -1194,23 +1674,22 @@ namespace mu {
                     // translate this to a call to powf
                 case mu::Tkn_Percent:
                     // translate this to a call to modf
-                // equality operations
+                    if(lhs_type->kind() == rhs_type->kind()) {
+                        return eval_binary_op(this, op, lhs, rhs, expr, lhs_type);
+                    }
+                    break;
+                // equality operations, these result in a bool.
                 case mu::Tkn_EqualEqual:
                 case mu::Tkn_BangEqual:
+                case mu::Tkn_Less:
+                case mu::Tkn_Greater:
                 case mu::Tkn_LessEqual:
                 case mu::Tkn_GreaterEqual:
                     if(lhs_type->kind() == rhs_type->kind()) {
-                        return eval_binary_op(this, op, lhs, rhs, expr, lhs_type);
+                        return eval_binary_op(this, op, lhs, rhs, expr, type_bool);
                     }
                     break;
 
-                // boolean logic
-                case mu::Tkn_And:
-                case mu::Tkn_Or:
-                    if(lhs_type->is_bool() and rhs_type->is_bool()) {
-                        return eval_binary_op(this, op, lhs, rhs, expr, lhs_type);
-                    }
-                    break;
                 // bitwise operations
                 case mu::Tkn_LessLess:
                 case mu::Tkn_GreaterGreater:
@@ -1218,7 +1697,7 @@ namespace mu {
                 case mu::Tkn_Pipe:
                     if(lhs_type->is_integer() and rhs_type->is_integer()) {
                         if(lhs_type->kind() == rhs_type->kind()) {
-                            return eval_binary_op(this, op, lhs, rhs, nullptr, lhs_type);
+                            return eval_binary_op(this, op, lhs, rhs, expr, lhs_type);
                         }
                     }
                     else {
@@ -1240,23 +1719,81 @@ namespace mu {
         return Operand(expr);
     }
 
+    Operand Typer::resolve_array_binary(TokenKind op, Operand lhs, Operand rhs, ast::Expr *expr) {
+        auto array = array_operand(lhs) ? array_operand(lhs) : array_operand(rhs);
+        auto element = array->get_element_type();
+
+        bool valid_op = false;
+        switch(op) {
+            case mu::Tkn_Plus:
+            case mu::Tkn_Minus:
+            case mu::Tkn_Astrick:
+            case mu::Tkn_Slash:
+            case mu::Tkn_Percent:
+                valid_op = element->is_arithmetic() and element->is_primative() and !element->is_bool() and
+                           !element->is_char() and !element->is_ptr();
+                break;
+            case mu::Tkn_LessLess:
+            case mu::Tkn_GreaterGreater:
+            case mu::Tkn_Ampersand:
+            case mu::Tkn_Pipe:
+            case mu::Tkn_Carrot:
+                valid_op = element->is_integer() and !element->is_bool() and !element->is_char();
+                break;
+            default:
+                break;
+        }
+
+        // a single value is applied to every element, a constant takes the type of the elements.
+        for(auto side : {&lhs, &rhs}) {
+            if(!valid_op)
+                break;
+            if(array_operand(*side)) {
+                valid_op = interp->equivalent_types(array_operand(*side), array);
+                continue;
+            }
+            if(side->val.is_constant and side->expr and !interp->equivalent_types(side->type, element)) {
+                *side = resolve_expr(side->expr, element);
+                if(side->error)
+                    return Operand(expr);
+            }
+            auto type = side->type;
+            while(type and type->kind() == types::MutableType)
+                type = type->as<types::Mutable>()->get_inner();
+            valid_op = type and interp->equivalent_types(type, element);
+        }
+
+        if(!valid_op) {
+            report(expr->pos(), "invalid operands for element-wise operation '%s' with types: '%s' and '%s'",
+                   Token::get_string(op).c_str(),
+                   lhs.type->str().c_str(),
+                   rhs.type->str().c_str())
+            return Operand(expr);
+        }
+        return Operand(array, expr, RValue);
+    }
+
     Operand Typer::resolve_binary_overload(TokenKind op, Operand rhs, Operand lhs, ast::Expr *expr,
                                            types::Type *expected_type) {
         return Operand(nullptr, nullptr, LValue);
     }
 
     Operand Typer::resolve_unary(ast::Unary *expr, types::Type *expected_type) {
-        auto operand = resolve_expr(expr->expr.get(), nullptr);
+        auto operand = resolve_expr(expr->expr, nullptr);
+        if(operand.error)
+            return operand;
+
+        // the address can be taken of anything that has storage.
+        if(expr->op == mu::Tkn_Ampersand and !operand.val.is_constant) {
+            auto type = interp->checked_new_type<types::Pointer>(operand.type);
+            return Operand(type, expr, RValue);
+        }
+
         if(operand.type->is_ptr()) {
             switch(expr->op) {
                 case mu::Tkn_Bang: {
                     return Operand(type_bool, expr, RValue);
                 } break;
-                case mu::Tkn_Ampersand: {
-                    auto type = interp->checked_new_type<types::Pointer>(operand.type);
-                    // I think
-                    return Operand(type, expr, LValue);
-                } break;
                 case mu::Tkn_Astrick: {
                     return Operand(operand.type->base_type(), expr, LValue);
                 } break;
@@ -1312,12 +1849,10 @@ namespace mu {
                     break;
             }
         }
-        else {
-            report(expr->pos(), "invalid type for unary operation '%s' and type '%s'",
-                   Token::get_string(op).c_str(),
-                   operand.type->str().c_str());
-            return Operand(expr);
-        }
+        report(expr->pos(), "invalid type for unary operation '%s' and type '%s'",
+               Token::get_string(op).c_str(),
+               operand.type->str().c_str());
+        return Operand(expr);
     }
 
     Operand Typer::resolve_unary_overload(TokenKind op, Operand operand, ast::Expr *expr, types::Type *expected_type) {
@@ -1368,6 +1903,14 @@ namespace mu {
                     return Operand(expr);
                 }
                 entity->set_used();
+
+                // a global used before it is declared, it can become a constant once it is resolved.
+                if(entity->kind() == GlobalEntity) {
+                    entity = resolve_dependency(entity, nullptr);
+                    if(!entity)
+                        return Operand(expr);
+                }
+
                 if(entity->is_variable()) {
                     bool is_initialized = false;
                     switch(entity->kind()) {
@@ -1390,7 +1933,16 @@ namespace mu {
                         return Operand(expr);
                     }
 					entity->set_used();
-                    return Operand(entity->get_type(), expr, LValue, entity);
+
+                    // the error of its initializer was already reported.
+                    if(!entity->get_type())
+                        return Operand(expr);
+
+                    // the value of a constant is known, it can be the length of an array.
+                    Operand result(entity->get_type(), expr, LValue, entity);
+                    if(entity->kind() == ConstantEntity)
+                        result.val = entity->as<Constant>()->get_value();
+                    return result;
                 }
                 else {
                     switch(entity->kind()) {
@@ -1401,6 +1953,21 @@ namespace mu {
                             return Operand(entity->get_type(), expr, TypeAccess, entity);
                         case FunctionEntity:
 							entity->set_used();
+                            // the instance is chosen by the call.
+                            if(generics_of(entity)) {
+                                if(context.resolving_callee)
+                                    return Operand(nullptr, expr, FunctionAccess, entity);
+                                report(expr->pos(), "'%s' is generic, its type arguments must be given",
+                                       name->name->value().c_str());
+                                return Operand(expr);
+                            }
+                            if(!resolve_dependency(entity, nullptr))
+                                return Operand(expr);
+                            if(!entity->get_type()) {
+                                report(expr->pos(), "'%s' is used in its own body, its return type must be given",
+                                       name->name->value().c_str());
+                                return Operand(expr);
+                            }
                             return Operand(entity->get_type(), expr, FunctionAccess, entity);
                         default:
                             return Operand(expr);
@@ -1408,10 +1975,10 @@ namespace mu {
                 }
             }
             case ast::ast_name_generic: {
-                interp->debug("Generics are not implemented at this time");
-               auto [op, entity] = resolve_name_generic_expr(expr->as<ast::NameGeneric>());
-				entity->set_used();
-               return op;
+                auto [op, entity] = resolve_name_generic_expr(expr->as<ast::NameGeneric>());
+                if(entity)
+                    entity->set_used();
+                return op;
             }
             default:
                 interp->fatal("Invalid name expression");
@@ -1424,7 +1991,46 @@ namespace mu {
     }
 
     std::tuple<Operand, Entity *> Typer::resolve_name_generic_expr(ast::NameGeneric *expr) {
-        return std::make_tuple(Operand(expr), (Entity*) nullptr);
+        auto entity = search_active_scope(expr->name);
+        if(!entity)
+            return std::make_tuple(Operand(expr), (Entity*) nullptr);
+
+        auto group = generics_of(entity);
+        std::vector<GenericArg> args;
+        for(u64 i = 0; i < expr->type_params.size(); ++i) {
+            auto spec = expr->type_params[i];
+
+            GenericArg arg;
+            auto bound = group and i < group->generics.size() ? value_generic_type(group->generics[i], entity->scope()) : nullptr;
+            if(bound) {
+                if(!resolve_generic_value(spec, bound, arg))
+                    return std::make_tuple(Operand(expr), (Entity*) nullptr);
+            }
+            else {
+                arg.type = resolve_spec(spec);
+                if(!arg.type)
+                    return std::make_tuple(Operand(expr), (Entity*) nullptr);
+            }
+            args.push_back(arg);
+        }
+
+        auto instance = instantiate(entity, args, expr->pos());
+        if(!instance)
+            return std::make_tuple(Operand(expr), (Entity*) nullptr);
+
+        switch(instance->kind()) {
+            case TypeEntity:
+                return std::make_tuple(Operand(instance->get_type(), expr, TypeAccess, instance), instance);
+            case FunctionEntity:
+                if(!instance->get_type()) {
+                    report(expr->pos(), "'%s' is used in its own body, its return type must be given",
+                           instance->get_name()->value().c_str());
+                    return std::make_tuple(Operand(expr), (Entity*) nullptr);
+                }
+                return std::make_tuple(Operand(instance->get_type(), expr, FunctionAccess, instance), instance);
+            default:
+                return std::make_tuple(Operand(expr), (Entity*) nullptr);
+        }
     }
 
 
@@ -1435,7 +2041,7 @@ namespace mu {
             interp->fatal("Compiler Error: invalid ast");
         }
 
-        auto operand = resolve_expr(accessor->operand.get());
+        auto operand = resolve_expr(accessor->operand);
         if(operand.error)
             return operand;
 
@@ -1447,6 +2053,10 @@ namespace mu {
             type = type->base_type();
         }
 
+        // the members of a mutable struct are accessed the same way.
+        if(type->kind() == types::MutableType)
+            type = type->as<types::Mutable>()->get_inner();
+
 
 
         // I will allow trait and sum types to be included.
@@ -1544,7 +2154,7 @@ namespace mu {
             interp->fatal("Compiler Error: invalid ast");
         }
 
-        auto operand = resolve_expr(accessor->operand.get());
+        auto operand = resolve_expr(accessor->operand);
 
         if(operand.error) {
             return operand;
@@ -1579,7 +2189,7 @@ namespace mu {
             interp->fatal("Compiler Error: invalid ast");
         }
 
-        auto type = resolve_spec(str->spec.get()); 
+        auto type = resolve_spec(str->spec); 
 
         if(!type)
             return Operand(expr);
@@ -1604,7 +2214,7 @@ namespace mu {
                 case ast::ast_expr_binding: {
                     auto bind = member->as<ast::BindingExpr>();
                     auto name = bind->name;
-                    auto binded_expr = bind->expr.get();
+                    auto binded_expr = bind->expr;
 
                     auto [member, valid] = scope->find(name);
 
@@ -1628,7 +2238,7 @@ namespace mu {
                     // gets the expected member of the struct considering where it is
                     // in the expresion list.
                     auto member_entity = struct_type->get_member(member_count);
-                    auto expr = resolve_expr(member.get(), member_entity->get_type());
+                    auto expr = resolve_expr(member, member_entity->get_type());
 
                     // if there was an error resolving the expression, the return an error operand.
                     if(expr.error)
@@ -1669,7 +2279,7 @@ namespace mu {
     }
 
     std::tuple<std::vector<Operand>, bool>
-    Typer::resolve_call_actuals(Function *fn, const std::vector<ast::ExprPtr> &actuals, const mu::Pos &call_pos) {
+    Typer::resolve_call_actuals(Function *fn, const ast::NodeList<ast::ExprPtr> &actuals, const mu::Pos &call_pos) {
 //        auto type = fn->get_type();
         auto scope_param = fn->get_param_scope();
         // if the function is variadic then ignore the last one for now.
@@ -1686,7 +2296,7 @@ namespace mu {
 
         u64 actual_count = 0;
         for(u32 i = 0; i < num_params; ++i) {
-            ast::Expr* actual = actuals[i].get();
+            ast::Expr* actual = actuals[i];
 
             switch(actual->kind) {
                 case ast::ast_expr_binding: {
@@ -1696,7 +2306,7 @@ namespace mu {
 
                     auto bind = actual->as<ast::BindingExpr>();
                     auto name = bind->name;
-                    auto binded_expr = bind->expr.get();
+                    auto binded_expr = bind->expr;
 
                     auto [param, valid] = scope_param->find(name);
 
@@ -1796,7 +2406,7 @@ namespace mu {
             }
 
             for(u32 i = num_params; i < actuals.size(); ++i) {
-                auto operand = resolve_expr(actuals[i].get(), expected_type);
+                auto operand = resolve_expr(actuals[i], expected_type);
                 if(operand.error) {
                     return std::make_tuple(resolved_actuals, false);
                 }
@@ -1808,7 +2418,7 @@ namespace mu {
     }
 
     std::tuple<std::vector<Operand>, bool>
-    Typer::resolve_actuals(types::FunctionType *fn, const std::vector<ast::ExprPtr> &actuals, const mu::Pos &call_pos) {
+    Typer::resolve_actuals(types::FunctionType *fn, const ast::NodeList<ast::ExprPtr> &actuals, const mu::Pos &call_pos) {
 //        if(!fn->is_variadic()) {
 //            if(actuals.size() > fn->num_params()) {
 //                report(call_pos, "unexpected number of parameters, %u given, %u expected",
@@ -1833,7 +2443,7 @@ namespace mu {
                     // gets the expected member of the struct considering where it is
                     // in the expresion list.
                     auto param_type = fn->get_param(param_count);
-                    auto expr = resolve_expr(actual.get(), param_type);
+                    auto expr = resolve_expr(actual, param_type);
 
                     // if there was an error resolving the expression, the return an error operand.
                     if(expr.error)
@@ -1863,14 +2473,14 @@ namespace mu {
 		types::FunctionType* function_type = nullptr;
 		Function* method = nullptr;
 
-		auto result = resolve_expr(actuals[0].get());
+		auto result = resolve_expr(actuals[0]);
 		if(result.error)
 			return std::make_tuple(resolved_actuals, nullptr, result);
 
 		resolved_actuals.push_back(result);
 
 		// this parameter determines the how this is processed.	
-		auto [mem, is_static, valid] = resolve_member_from_operand(result, name.get());
+		auto [mem, is_static, valid] = resolve_member_from_operand(result, name);
 		
 		interp->debug("resolve_method_from_operand: %s", (valid ? "true" : "false"));
 		// the error is reported by the previous method.
@@ -1878,17 +2488,43 @@ namespace mu {
 			return std::make_tuple(resolved_actuals, nullptr, result);
 		
 		static_call = is_static;
+
+		if(!mem) {
+			report(name->pos(), "'%s' is not a member of '%s'",
+					name->as<ast::Name>()->name->value().c_str(),
+					result.type->str().c_str());
+			return std::make_tuple(resolved_actuals, nullptr, Operand(m));
+		}
 		
 		interp->debug("Is static: %s", (static_call ? "true" : "false"));
 
 		auto type = result.type;
-		// if it is not a pointer, take a pointer to it.
-		if(!type->is_ptr())
+		// if it is not a pointer, take a pointer to it. A mutable variable gives a mutable pointer.
+		if(!type->is_ptr()) {
+			auto entity = result.entity;
+			if(entity and ((entity->is_local() and entity->as<Local>()->is_mutable()) or
+			               (entity->is_global() and entity->as<Global>()->is_mutable())))
+				type = interp->checked_new_type<types::Mutable>(type);
 			type = interp->checked_new_type<types::Pointer>(type);
+		}
 		
 		interp->debug("");
 		if(mem->is_function()) {
 			method = mem->as<Function>(); // gets the function entity
+
+			// the method can be called before its impl block is resolved.
+			auto owner_type = result.type->is_ptr() ? result.type->base_type() : result.type;
+			owner_type = owner_type->base_type();
+			auto struct_type = owner_type->as<types::StructType>();
+			auto owner = struct_type ? struct_type->get_entity() : nullptr;
+			if(!resolve_dependency(method, owner))
+				return std::make_tuple(resolved_actuals, nullptr, Operand(m));
+
+			if(!method->get_type()) {
+				report(name->pos(), "'%s' is used in its own body, its return type must be given",
+						method->get_name()->value().c_str());
+				return std::make_tuple(resolved_actuals, nullptr, Operand(m));
+			}
 			function_type = method->get_type()->as<types::FunctionType>(); // gets the function type
 			// the found function is static but is being called from an lvalue.
 			if(method->is_static() and !is_static) {
@@ -1899,6 +2535,13 @@ namespace mu {
 			else if(method->is_method()) {
 				// the first element should be check
 				auto self = function_type->get_param(0);
+
+				// a mutable receiver can be given to a method that doesn't mutate it.
+				if(!self->base_type()->is_mutable() and type->base_type()->kind() == types::MutableType) {
+					auto inner = type->base_type()->as<types::Mutable>()->get_inner();
+					type = interp->checked_new_type<types::Pointer>(inner);
+				}
+
 				if(!compatible_types(self, type)) {
 					report(result.expr->pos(), "expected receiver '%s' received type '%s'",
 							self->str().c_str(), type->str().c_str());
@@ -1907,13 +2550,27 @@ namespace mu {
 				}
 			}
 		}
+		else {
+			// the elements of an array member are taken by calling the member itself.
+			auto mem_type = mem->get_type();
+			auto member = name->as<ast::Name>()->name->value();
+			if(mem_type and mem_type->is_array()) {
+				report(name->pos(), "'%s' is an array member, it is indexed as '(value.%s)(i)'",
+						member.c_str(), member.c_str());
+			}
+			else {
+				report(name->pos(), "attempting to call a non-function type, found type '%s'",
+						mem_type ? mem_type->str().c_str() : "unknown");
+			}
+			return std::make_tuple(resolved_actuals, nullptr, Operand(m));
+		}
 
 		for(u32 i = 1; i < actuals.size(); ++i) {
 			u32 li = i;
 			if(static_call)
 				li--;
 			auto type = function_type->get_param(li);
-			auto result = resolve_expr(actuals[li].get(), type);
+			auto result = resolve_expr(actuals[i], type);
 			resolved_actuals.push_back(result);
 
 			if(result.error)
@@ -1988,12 +2645,37 @@ namespace mu {
 
 
     Operand Typer::resolve_call_or_curry(ast::Call *expr) {
-        auto res = resolve_expr(expr->name.get());
+        push_context_state(resolving_callee, true)
+        auto res = resolve_expr(expr->name);
+        pop_context_state(resolving_callee)
+
+        if(res.error)
+            return Operand(expr);
+
+        // the elements of an array are taken by calling it, the array doesn't have to be named.
+        auto callee_type = res.type;
+        while(callee_type and callee_type->kind() == types::MutableType)
+            callee_type = callee_type->as<types::Mutable>()->get_inner();
+        if(callee_type and callee_type->is_array())
+            return resolve_index(expr, res);
+
 		auto function = res.entity;
+        if(!function)
+            return Operand(expr);
 
         if(function->is_function()) {
             auto fn_entity = function->as<Function>();
 
+            // a generic function called without type arguments is instantiated for the actuals.
+            if(generics_of(fn_entity)) {
+                fn_entity = infer_instance(fn_entity, expr);
+                if(!fn_entity)
+                    return Operand(expr);
+
+                expr->name->type = fn_entity->get_type();
+                expr->name->operand = Operand(fn_entity->get_type(), expr->name, FunctionAccess, fn_entity);
+            }
+
             auto [actuals, valid] = resolve_call_actuals(fn_entity, expr->actuals, expr->pos());
 
             if(valid) {
@@ -2020,36 +2702,71 @@ namespace mu {
                     return Operand(expr);
                 }
             }
-            else if(type->is_array()) {
-                // TODO: Refactor this to be idiomatic
-                // The array type [f32; ..] will actually implement a trait
-                // called Apply[Index < Unsigned] which allows for the type to treated as a function.
-                // the trait will require the parameter to be an unsigned integer
-                // it will be simulated here.
+        }
+        report(expr->pos(), "attempting to call a non-function type, type found: '%s'", function->get_type()->str().c_str());
+        return Operand(expr);
+    }
 
-                // If there are zero actuals or there are more than 1
-                if(expr->actuals.size() == 0 or expr->actuals.size() > 1) {
-                    report(expr->pos(), "unexpected number of parameters, expected %u, recieved %u", (u64) 1, expr->actuals.size());
-                    return Operand(expr);
-                }
+    Operand Typer::resolve_index(ast::Call *expr, Operand array) {
+        if(expr->actuals.size() != 1) {
+            report(expr->pos(), "an array is indexed by 1 integer, found %lu arguments", (u64) expr->actuals.size());
+            return Operand(expr);
+        }
 
-                auto result = resolve_expr(expr->actuals.front().get());
-                if(result.error) {
-                    return result;
-                }
-                auto type = result.type;
-                if(type->is_integer() and type->is_unsigned()) {
-                    auto array_type = type->as<types::Array>();
-                    return Operand(array_type->base_type(), expr, LValue);
-                }
-                else {
-                    report(expr->actuals.front()->pos(), "expecting an unsigned integer as array index, found '%s'", type->str().c_str());
-                    return Operand(expr);
-                }
+        auto index = resolve_expr(expr->actuals.front());
+        if(index.error)
+            return Operand(expr);
+
+        auto index_type = index.type;
+        while(index_type and index_type->kind() == types::MutableType)
+            index_type = index_type->as<types::Mutable>()->get_inner();
+        if(!index_type or !index_type->is_integer() or index_type->is_bool()) {
+            report(expr->actuals.front()->pos(), "expecting an integer as array index, found '%s'",
+                   index.type ? index.type->str().c_str() : "unknown");
+            return Operand(expr);
+        }
+
+        auto type = array.type;
+        while(type->kind() == types::MutableType)
+            type = type->as<types::Mutable>()->get_inner();
+        auto array_type = type->as<types::Array>();
+
+        u64 position = 0;
+        if(index.val.is_constant) {
+            if(!constant_length(index, position) or position >= array_type->num_elements()) {
+                report(expr->actuals.front()->pos(), "index out of the bounds of '%s'", array_type->str().c_str());
+                return Operand(expr);
             }
         }
-        report(expr->pos(), "attempting to call a non-function type, type found: '%s'", function->get_type()->str().c_str());
-        return Operand(expr);
+
+        // the element of a named array can be assigned, the element of a temporary can not.
+        auto access = array.access == RValue ? RValue : LValue;
+        return Operand(array_type->get_element_type(), expr, access);
+    }
+
+    Operand Typer::resolve_list(ast::Expr *expr, types::Type *expected_type) {
+        auto list = expr->as<ast::List>();
+        if(list->elements.empty()) {
+            report_str(expr->pos(), "an array literal must have at least one element");
+            return Operand(expr);
+        }
+
+        auto expected = expected_type;
+        while(expected and expected->kind() == types::MutableType)
+            expected = expected->as<types::Mutable>()->get_inner();
+
+        // the elements are the type of the first unless another element type is expected.
+        types::Type* element_type = expected and expected->is_array() ? expected->as<types::Array>()->get_element_type() : nullptr;
+        for(auto& element : list->elements) {
+            auto op = resolve_expr(element, element_type);
+            if(op.error)
+                return Operand(expr);
+            if(!element_type)
+                element_type = op.type;
+        }
+
+        auto type = interp->checked_new_type<types::Array>(element_type, (u64) list->elements.size());
+        return Operand(type, expr, RValue);
     }
 
 	Operand Typer::resolve_method_call(ast::Expr* expr) {
@@ -2057,11 +2774,38 @@ namespace mu {
 		// the method that is called is dependent on the first actual
 		auto method = expr->as<ast::Method>();
 		auto [actuals, method_entity, res] = resolve_method_actuals(method);
+
+		// the name of the method refers to the function that is called.
+		if(method_entity and !res.error) {
+			method->name->type = method_entity->get_type();
+			method->name->operand = Operand(method_entity->get_type(), method->name, FunctionAccess, method_entity);
+		}
 		return res;
 	}
 
     Operand Typer::resolve_cast(ast::Cast *expr) {
-        return Operand(nullptr, nullptr, LValue);
+        auto operand = resolve_expr(expr->operand);
+        if(operand.error)
+            return operand;
+
+        auto type = resolve_spec(expr->type);
+        if(!type)
+            return Operand(expr);
+
+        // only numbers, characters and booleans can be converted to each other for now.
+        if(!operand.type->is_primative() or !type->is_primative() or operand.type->is_ptr() or type->is_ptr()) {
+            report(expr->pos(), "'%s' can not be cast to '%s'",
+                   operand.type->str().c_str(),
+                   type->str().c_str());
+            return Operand(expr);
+        }
+
+        if(operand.val.is_constant) {
+            auto val = operand.val;
+            val.cast_to(type);
+            return Operand(type, expr, val);
+        }
+        return Operand(type, expr, RValue);
     }
 
     Operand Typer::resolve_block(ast::Expr *expr) {
@@ -2076,7 +2820,7 @@ namespace mu {
             if(stmt->kind == ast::ast_empty)
                 continue;
 
-            res = resolve_stmt(stmt.get());
+            res = resolve_stmt(stmt);
             if(res.error)
                 break;
         }
@@ -2086,6 +2830,291 @@ namespace mu {
         return res;
     }
 
+    Operand Typer::resolve_if(ast::Expr *expr) {
+        auto if_expr = expr->as<ast::If>();
+
+        auto cond = resolve_expr(if_expr->cond);
+        if(cond.error)
+            return Operand(expr);
+
+        if(!cond.type->is_bool()) {
+            report(if_expr->cond->pos(), "if condition must be a bool, found '%s'", cond.type->str().c_str());
+            return Operand(expr);
+        }
+
+        auto body = resolve_expr(if_expr->body);
+        if(body.error)
+            return Operand(expr);
+
+        if(!if_expr->else_if)
+            return Operand(type_unit, expr, RValue);
+
+        auto else_body = resolve_expr(if_expr->else_if);
+        if(else_body.error)
+            return Operand(expr);
+
+        // the if only has a value when both branches agree on its type.
+        if(interp->equivalent_types(body.type, else_body.type))
+            return Operand(body.type, expr, RValue);
+        else
+            return Operand(type_unit, expr, RValue);
+    }
+
+    Operand Typer::resolve_while(ast::Expr *expr) {
+        auto while_expr = expr->as<ast::While>();
+
+        auto cond = resolve_expr(while_expr->cond);
+        if(cond.error)
+            return Operand(expr);
+
+        if(!cond.type->is_bool()) {
+            report(while_expr->cond->pos(), "while condition must be a bool, found '%s'", cond.type->str().c_str());
+            return Operand(expr);
+        }
+
+        push_context_state(resolving_loop, true)
+        auto body = resolve_expr(while_expr->body);
+        pop_context_state(resolving_loop)
+
+        if(body.error)
+            return Operand(expr);
+
+        return Operand(type_unit, expr, RValue);
+    }
+
+    Operand Typer::resolve_for(ast::Expr *expr) {
+        auto for_expr = expr->as<ast::For>();
+
+        if(for_expr->expr->kind != ast::ast_range) {
+            report_str(for_expr->expr->pos(), "only a range can be iterated at this time");
+            return Operand(expr);
+        }
+
+        auto range = for_expr->expr->as<ast::Range>();
+        auto start = resolve_expr(range->start);
+        auto end = resolve_expr(range->end);
+        if(start.error or end.error)
+            return Operand(expr);
+
+        // a constant bound takes the type of the other bound, 'for i in 0..n', a literal
+        // takes the type of a constant name, 'for i in 0..N'.
+        if(start.val.is_constant and (!end.val.is_constant or (range->start->kind == ast::ast_integer and end.entity)))
+            start = resolve_expr(range->start, end.type);
+        else if(end.val.is_constant and (!start.val.is_constant or (range->end->kind == ast::ast_integer and start.entity)))
+            end = resolve_expr(range->end, start.type);
+        if(start.error or end.error)
+            return Operand(expr);
+
+        auto type = start.type;
+        if(!type->is_integer() or type->is_bool() or !interp->equivalent_types(type, end.type)) {
+            report(range->pos(), "a range must be between two integers of the same type, found '%s' and '%s'",
+                   start.type->str().c_str(), end.type->str().c_str());
+            return Operand(expr);
+        }
+
+        if(range->step) {
+            auto step = resolve_expr(range->step, type);
+            if(step.error)
+                return Operand(expr);
+        }
+        range->type = type;
+
+        if(for_expr->pattern->kind != ast::ast_ident_pattern and for_expr->pattern->kind != ast::ast_ignore_pattern) {
+            report_str(for_expr->pattern->pos(), "a range can only be bound to a name");
+            return Operand(expr);
+        }
+
+        auto scope = make_scope<BlockScope>(expr, active_scope());
+        push_scope(scope);
+
+        resolve_pattern(for_expr->pattern, Operand(type, range, RValue), nullptr);
+
+        push_context_state(resolving_loop, true)
+        auto body = resolve_expr(for_expr->body);
+        pop_context_state(resolving_loop)
+
+        pop_scope();
+
+        if(body.error)
+            return Operand(expr);
+
+        return Operand(type_unit, expr, RValue);
+    }
+
+    Operand Typer::resolve_match(ast::Expr *expr, types::Type *expected_type) {
+        auto match = expr->as<ast::Match>();
+
+        auto cond = resolve_expr(match->cond);
+        if(cond.error)
+            return Operand(expr);
+
+        if(!cond.type->is_integer()) {
+            report(match->cond->pos(), "only integers, chars and bools can be matched at this time, found '%s'",
+                   cond.type->str().c_str());
+            return Operand(expr);
+        }
+
+        types::Type* result_type{nullptr};
+        bool has_default = false;
+        for(auto member : match->members) {
+            auto arm = member->as<ast::MatchArm>();
+
+            auto scope = make_scope<BlockScope>(member, active_scope());
+            push_scope(scope);
+
+            bool valid = true;
+            for(auto pattern : arm->patterns) {
+                valid = valid and resolve_match_pattern(pattern, cond, arm->patterns.size() > 1);
+                if(pattern->kind == ast::ast_ignore_pattern or pattern->kind == ast::ast_ident_pattern)
+                    has_default = true;
+            }
+
+            auto body = valid ? resolve_expr(arm->body, expected_type) : Operand(arm->body);
+            pop_scope();
+
+            if(!valid or body.error)
+                return Operand(expr);
+
+            member->type = body.type;
+            if(!result_type)
+                result_type = body.type;
+            else if(!interp->equivalent_types(result_type, body.type))
+                result_type = type_unit;
+        }
+
+        // the match only has a value when every value is matched and the arms agree on its type.
+        if(!has_default or !result_type)
+            result_type = type_unit;
+
+        return Operand(result_type, expr, RValue);
+    }
+
+    bool Typer::resolve_match_pattern(ast::Pattern *pattern, Operand value, bool has_alternatives) {
+        auto type = value.type;
+        bool valid = true;
+        switch(pattern->kind) {
+            case ast::ast_int_pattern:
+                valid = !type->is_bool() and !type->is_char();
+                break;
+            case ast::ast_char_pattern:
+                valid = type->is_char();
+                break;
+            case ast::ast_bool_pattern:
+                valid = type->is_bool();
+                break;
+            case ast::ast_range_pattern: {
+                auto range = pattern->as<ast::RangePattern>();
+                if(type->is_bool()) {
+                    report(pattern->pos(), "a range can not match a value of type '%s'", type->str().c_str());
+                    return false;
+                }
+                if(!resolve_match_pattern(range->start, value, true) or !resolve_match_pattern(range->end, value, true))
+                    return false;
+            } break;
+            case ast::ast_ignore_pattern:
+                break;
+            case ast::ast_ident_pattern:
+                if(has_alternatives) {
+                    report_str(pattern->pos(), "a name can not be bound in a pattern with alternatives");
+                    return false;
+                }
+                resolve_pattern(pattern, Operand(type, value.expr, RValue), nullptr);
+                break;
+            default:
+                report_str(pattern->pos(), "this pattern can not be matched at this time");
+                return false;
+        }
+
+        if(!valid) {
+            report(pattern->pos(), "pattern can not match a value of type '%s'", type->str().c_str());
+            return false;
+        }
+
+        pattern->type = type;
+        return true;
+    }
+
+    Operand Typer::resolve_defer(ast::Expr *expr) {
+        if(!context.function_body) {
+            report_str(expr->pos(), "defer outside of a function body");
+            return Operand(expr);
+        }
+
+        auto body = resolve_expr(expr->as<ast::Defer>()->body);
+        if(body.error)
+            return Operand(expr);
+
+        return Operand(type_unit, expr, RValue);
+    }
+
+    Operand Typer::resolve_return(ast::Expr *expr) {
+        auto ret = expr->as<ast::Return>();
+
+        if(!context.function_body) {
+            report_str(expr->pos(), "return outside of a function body");
+            return Operand(expr);
+        }
+
+        if(ret->body) {
+            auto value = resolve_expr(ret->body, context.return_type);
+            if(value.error)
+                return Operand(expr);
+        }
+        else if(context.return_type and !context.return_type->is_unit()) {
+            report(expr->pos(), "expecting a return value of type '%s'", context.return_type->str().c_str());
+            return Operand(expr);
+        }
+
+        return Operand(type_unit, expr, RValue);
+    }
+
+    Operand Typer::resolve_assign(ast::Expr *expr) {
+        auto assign = expr->as<ast::Assign>();
+
+        auto lvalue = resolve_expr(assign->lvalue);
+        if(lvalue.error)
+            return Operand(expr);
+
+        if(lvalue.access != LValue and lvalue.access != SelfAccess) {
+            report_str(assign->lvalue->pos(), "left side of an assignment is not assignable");
+            return Operand(expr);
+        }
+
+        // the elements of an array are assigned through the array.
+        auto assigned = assign->lvalue;
+        while(assigned->kind == ast::ast_call)
+            assigned = assigned->as<ast::Call>()->name;
+
+        auto entity = assigned->operand.entity;
+        if(entity and entity->is_local() and assigned->kind == ast::ast_name) {
+            auto local = entity->as<Local>();
+            if(!local->is_mutable()) {
+                report(assign->lvalue->pos(), "assigning to immutable variable '%s'", local->get_name()->value().c_str());
+                return Operand(expr);
+            }
+        }
+
+        auto rvalue = resolve_expr(assign->rvalue, lvalue.type);
+        if(rvalue.error)
+            return Operand(expr);
+
+        // a compound assignment has to be a valid binary operation as well.
+        if(assign->op != mu::Tkn_Equal and array_operand(lvalue)) {
+            if(resolve_array_binary(compound_operator(assign->op), lvalue, rvalue, expr).error)
+                return Operand(expr);
+        }
+        else if(assign->op != mu::Tkn_Equal) {
+            if(!lvalue.type->is_arithmetic()) {
+                report(expr->pos(), "invalid type for '%s', found '%s'",
+                       Token::get_string(assign->op).c_str(),
+                       lvalue.type->str().c_str());
+                return Operand(expr);
+            }
+        }
+
+        return Operand(type_unit, expr, RValue);
+    }
+
     // Some of my spec resolution can be reduced to resolving expression.
     // how to make sure multiple of the same type are not created
     types::Type *Typer::resolve_spec(ast::Spec *spec) {
@@ -2093,7 +3122,14 @@ namespace mu {
             case ast::ast_expr_type: {
                 auto e = spec->as<ast::ExprSpec>();
 
-                auto entity = resolve_expr_spec(e->type.get());
+                auto entity = resolve_expr_spec(e->type);
+                if(!entity)
+                    return nullptr;
+
+                if(generics_of(entity)) {
+                    report(e->pos(), "'%s' is generic, its type arguments must be given", entity->get_name()->value().c_str());
+                    return nullptr;
+                }
 
                 // this is for pointers and reference with in a struct to itself.
                 if(context.allow_incomplete_types and !entity->is_resolved()) {
@@ -2114,7 +3150,7 @@ namespace mu {
                 std::vector<types::Type*> types;
                 u64 sz = 0;
                 for(auto& t : s->elements) {
-                    auto e = resolve_spec(t.get());
+                    auto e = resolve_spec(t);
                     if(e) {
                         types.push_back(e);
                         e += e->size();
@@ -2124,7 +3160,23 @@ namespace mu {
                 return interp->checked_new_type<types::Tuple>(types, sz, types.front()->alignment());
             }
             case ast::ast_list_spec: {
+                auto s = spec->as<ast::ListSpec>();
+                auto element = resolve_spec(s->type);
+                if(!element)
+                    return nullptr;
 
+                // the length is known when the program is compiled, '[T; N]' in a generic is a constant.
+                auto size = resolve_expr(s->size);
+                if(size.error)
+                    return nullptr;
+
+                u64 length = 0;
+                if(!constant_length(size, length) or length == 0) {
+                    report(s->size->pos(), "the length of an array must be a positive constant integer, found '%s'",
+                           size.type ? size.type->str().c_str() : "unknown");
+                    return nullptr;
+                }
+                return interp->checked_new_type<types::Array>(element, length);
             }
             case ast::ast_list_spec_dyn:
                 break;
@@ -2133,7 +3185,7 @@ namespace mu {
 
                 push_context_state(allow_incomplete_types, true)
                 
-                auto base_type = resolve_spec(s->type.get());
+                auto base_type = resolve_spec(s->type);
 
                 pop_context_state(allow_incomplete_types);
 
@@ -2151,7 +3203,7 @@ namespace mu {
             // }
             case ast::ast_mut: {
                 auto s = spec->as<ast::MutSpec>();
-                auto base_type = resolve_spec(s->type.get());
+                auto base_type = resolve_spec(s->type);
                 return interp->checked_new_type<types::Mutable>(base_type);
             }
             case ast::ast_self_type: {
@@ -2163,9 +3215,9 @@ namespace mu {
             case ast::ast_procedure_spec: {
                 auto p = spec->as<ast::ProcedureSpec>();
                 std::vector<types::Type*> params;
-                types::Type* ret_type = resolve_spec(p->ret.get());
+                types::Type* ret_type = resolve_spec(p->ret);
                 for(auto pa : p->params) {
-                    auto t = resolve_spec(pa.get());
+                    auto t = resolve_spec(pa);
                     if(t) params.push_back(t);
                     else {
                         // the error should have been reported.
@@ -2202,7 +3254,7 @@ namespace mu {
     }
 
     Entity* Typer::resolve_accessor_spec(ast::Accessor* expr) {
-        auto root_entity = resolve_expr_spec(expr->operand.get());
+        auto root_entity = resolve_expr_spec(expr->operand);
 
         // if there was an error above then propogate it through the rest.
         if(!root_entity) return nullptr;
@@ -2253,7 +3305,7 @@ namespace mu {
         switch(stmt->kind) {
             case ast::ast_expr: {
                 auto expr = stmt->as<ast::ExprStmt>();
-                return resolve_expr(expr->expr.get());
+                return resolve_expr(expr->expr);
             }
             case ast::ast_decl: {
                 auto decl = stmt->as<ast::DeclStmt>();
@@ -2322,7 +3374,7 @@ namespace mu {
     }
 
 	Operand Typer::resolve_static_method(Entity* op, Entity* fn,
-			const std::vector<ast::ExprPtr>& actuals, Operand operand, ast::Expr* name) {
+			const ast::NodeList<ast::ExprPtr>& actuals, Operand operand, ast::Expr* name) {
 		if(!fn->is_function()) {
 			report(name->pos(), "'%s' is not a function of '%s'",
 					fn->get_name()->value().c_str(),
@@ -2351,7 +3403,7 @@ namespace mu {
 	}
 
 	Operand Typer::resolve_received_method(Entity* op, Entity* fn,
-			const std::vector<ast::ExprPtr>& actuals, Operand operand, ast::Expr* name) {
+			const ast::NodeList<ast::ExprPtr>& actuals, Operand operand, ast::Expr* name) {
 		if(fn->is_function()) {
 			/*
 				If the type of the operand is not a reference then
@@ -2420,7 +3472,10 @@ namespace mu {
                 auto entity = interp->new_entity<Local>(pat->name, type, get_addressing_by_type(type),
                         active_scope(), decl);
                 entity->resolve_to(type);
+                if(expected_type.expr)
+                    entity->set_initialized();
                 add_entity(entity);
+                pat->entity = entity;
                 entity->debug_print(interp->out_stream());
             } break;
             case ast::ast_tuple_desc: {
@@ -2429,7 +3484,7 @@ namespace mu {
                     auto tuple_type = type->as<types::Tuple>();
                     u32 sub_pattern_index = 0;
                     for(auto sub_pattern : pat->patterns) {
-                        resolve_pattern(sub_pattern.get(),
+                        resolve_pattern(sub_pattern,
                                 Operand(tuple_type->get_element_type(sub_pattern_index),
                                         expected_type.expr, expected_type.access),
                                         decl);
@@ -24,9 +24,24 @@ class Interpreter;
 #include "parser/ast/pattern.hpp"
 #include "parser/ast/renderer.hpp"
 
+#include <map>
+#include <tuple>
+
 
 namespace mu {
 
+    // an argument of a polymorphic entity, a type or the value of a generic bounded by
+    // an integer type, 'N < u8'. The type of a value is the type it is bounded by.
+    struct GenericArg {
+        types::Type* type{nullptr};
+        bool is_value{false};
+        u64 value{0};
+
+        bool operator<(const GenericArg& other) const {
+            return std::tie(type, is_value, value) < std::tie(other.type, other.is_value, other.value);
+        }
+    };
+
     class Typer {
         public:
             Typer(Interpreter* interp);
@@ -51,6 +66,13 @@ namespace mu {
             // processes the main file, it must have main function.
             Module * resolve_main_module(ast::ModuleFile *main_module);
 
+            // the top level entities of the last module resolved, in declaration order.
+            inline const std::vector<Entity*>& module_entities() { return top_level; }
+
+            inline bool has_error() { return errors_num > 0; }
+
+            inline Interpreter* get_interp() { return interp; }
+
             // loads a module according to given use declaration;
             // the function will check what type of use is given.
             void load_module(ast::Decl* use_decl);
@@ -76,6 +98,10 @@ namespace mu {
 
             Entity* resolve_entity(Entity* entity);
 
+            // resolves an entity that is used before it was resolved, such as a function
+            // declared later in the file. owner is the type if it is a method.
+            Entity* resolve_dependency(Entity* entity, Entity* owner);
+
             Entity* resolve(Global* global);
             Entity* resolve(Local* local);
             Entity* resolve(Type* type);
@@ -86,7 +112,7 @@ namespace mu {
 
             /*--------------------Declaration Handling-----------------------*/
 
-            std::tuple<u64, u64, std::vector<ast::Ident*>> construct_member_order(std::vector<Entity*>& members);
+            std::tuple<u64, u64, ast::NodeList<ast::Ident*>> construct_member_order(std::vector<Entity*>& members);
 
             Entity* resolve_struct(Type* entity, ast::DeclPtr decl_ptr);
             Entity* resolve_poly_struct(Type* entity, ast::DeclPtr decl_ptr);
@@ -97,7 +123,23 @@ namespace mu {
             std::tuple<std::vector<Local *>, bool> resolve_function_members(ast::ProcedureSigniture *sig);
 
             Entity* resolve_function(Type* entity,ast::DeclPtr decl_ptr); 
-            Entity* resolve_poly_function(Type* entity, ast::DeclPtr decl_ptr);
+            Entity* resolve_poly_function(Function* entity, ast::DeclPtr decl_ptr);
+
+            // returns the entity of a polymorphic struct or function for the given type arguments.
+            // each set of arguments is resolved once, from a copy of the declaration where the
+            // generic names are the concrete types.
+            Entity* instantiate(Entity* poly, const std::vector<GenericArg>& args, const mu::Pos& pos);
+
+            // the instance of a polymorphic function called without type arguments, they are
+            // taken from the actuals given for parameters declared with a generic name, the
+            // value of a generic is the length of an array, '[T; N]'.
+            Function* infer_instance(Function* poly, ast::Call* call);
+
+            // the integer type a generic is bounded by, nullptr if the generic is a type.
+            types::Type* value_generic_type(ast::DeclPtr generic, ScopePtr scope);
+
+            // the value given for a generic bounded by type, it must be a constant.
+            bool resolve_generic_value(ast::Spec* spec, types::Type* type, GenericArg& arg);
 
 
             Entity* resolve_sumtype(Type* entity, ast::DeclPtr decl_ptr);
@@ -129,6 +171,10 @@ namespace mu {
 
             // resolves binary expression when the lhs is not an arithmetic type.
             // this is for when a struct overloads a binary operator
+            // an arithmetic operator applied to each element of an array. The other operand is
+            // an array of the same type or a single value of the element type.
+            Operand resolve_array_binary(TokenKind op, Operand lhs, Operand rhs, ast::Expr* expr);
+
             Operand resolve_binary_overload(TokenKind op, Operand rhs, Operand lhs, ast::Expr *expr,
                                             types::Type *expected_type);
 
@@ -143,16 +189,22 @@ namespace mu {
 
             // this is used when the function entity is known.
             std::tuple<std::vector<Operand>, bool> resolve_call_actuals(Function *fn,
-                    const std::vector<ast::ExprPtr> &actuals, const mu::Pos &call_pos);
+                    const ast::NodeList<ast::ExprPtr> &actuals, const mu::Pos &call_pos);
 
             // this is used when calling a function pointer.
             std::tuple<std::vector<Operand>, bool> resolve_actuals(types::FunctionType* fn,
-                    const std::vector<ast::ExprPtr>& actuals, const mu::Pos& call_pos);
+                    const ast::NodeList<ast::ExprPtr>& actuals, const mu::Pos& call_pos);
 
             std::tuple<std::vector<Operand>, Entity*, Operand> resolve_method_actuals(ast::Method* method);
 
             Operand resolve_call_or_curry(ast::Call* expr);
 
+            // an element of an array, 'v(i)'. A constant index is checked against the length.
+            Operand resolve_index(ast::Call* expr, Operand array);
+
+            // an array literal, '[1.0, 2.0, 3.0]'. The elements take the element type expected of it.
+            Operand resolve_list(ast::Expr* expr, types::Type* expected_type);
+
 			Operand resolve_method_call(ast::Expr* expr);
 
 			std::tuple<Entity*, bool, bool> resolve_member_from_operand(Operand operand, ast::Expr* name);
@@ -161,14 +213,14 @@ namespace mu {
 			// resolves a static method of Entity owner 
 			// The owner is the function that has fn.
 			Operand resolve_static_method(Entity* owner, Entity* fn,
-					const std::vector<ast::ExprPtr>& actuals, Operand operand,
+					const ast::NodeList<ast::ExprPtr>& actuals, Operand operand,
 					ast::Expr* name);
 		
 			
 			// resolves a method 
 			// The receiver is the structure that is receive the function call.
 			Operand resolve_received_method(Entity* receiver, Entity* fn,
-					const std::vector<ast::ExprPtr>& actuals, Operand operand,
+					const ast::NodeList<ast::ExprPtr>& actuals, Operand operand,
 					ast::Expr* name);
 
             // a wrapper for 'resolve_name_expr' and 'resolve_name_generic_expr'
@@ -192,6 +244,25 @@ namespace mu {
 
             Operand resolve_block(ast::Expr* expr);
 
+            Operand resolve_if(ast::Expr* expr);
+
+            Operand resolve_while(ast::Expr* expr);
+
+            // only ranges of integers can be iterated at this time.
+            Operand resolve_for(ast::Expr* expr);
+
+            Operand resolve_match(ast::Expr* expr, types::Type* expected_type);
+
+            // checks a pattern of a match arm against the value being matched.
+            bool resolve_match_pattern(ast::Pattern* pattern, Operand value, bool has_alternatives);
+
+            Operand resolve_defer(ast::Expr* expr);
+
+            Operand resolve_return(ast::Expr* expr);
+
+            // the left side must be a mutable variable or a member of one.
+            Operand resolve_assign(ast::Expr* expr);
+
             /*--------------------------Stmt Handling----------------------------*/
 
             Operand resolve_stmt(ast::Stmt* stmt);
@@ -234,6 +305,8 @@ namespace mu {
                 bool function_body{false};              // resolving a function body, this is to be used when resolving parameter names.
                 bool resolving_local{false};            // resolving local, this is for pattern resolution
                 bool resolving_match{false};            // resolving match, this is for pattern resolution
+                types::Type* return_type{nullptr};      // the return type of the function being resolved, null if it is inferred.
+                bool resolving_callee{false};           // resolving the name of a call, a generic function can be named without its type arguments.
             };
 
             void increment_error();
@@ -246,6 +319,12 @@ namespace mu {
 
             u32 errors_num{0};              // the number of errors
 
+            std::vector<Entity*> top_level;  // the top level entities of the main module
+
+            // the instances of polymorphic entities by the entity and its type arguments.
+            std::map<std::pair<Entity*, std::vector<GenericArg>>, Entity*> instances;
+            std::vector<Entity*> instance_order; // the instances in the order they were made.
+
             ast::AstRenderer renderer;
     };
 }
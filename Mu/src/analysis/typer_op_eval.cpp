@@ -104,6 +104,12 @@
         case types::Primitive_Float64: \
             val = Val(lhs._F64 op rhs._F64); \
             break; \
+        case types::Primitive_Char: \
+            val = Val(lhs._Char op rhs._Char); \
+            break; \
+        case types::Primitive_Bool: \
+            val = Val(lhs._Bool op rhs._Bool); \
+            break; \
         default: \
             break; \
     } \
@@ -140,12 +146,23 @@
     } \
 }
 
+extern mu::types::Type* type_i64;
+
+// an integer divisor of zero, a float one is well defined.
+static bool is_zero(mu::Val val, mu::types::Type* type) {
+    if(!type->is_integer() or !val.type)
+        return false;
+    val.cast_to(type);
+    val.cast_to(type_i64);
+    return val._I64 == 0;
+}
+
 namespace mu {
     Operand eval_binary_op(Typer *typer, mu::TokenKind op, Operand lhs, Operand rhs, ast::Expr *expr,
                            types::Type *expected_type) {
         // the expected type is not always the type being used.
         if(lhs.val.is_constant and rhs.val.is_constant) {
-            Val val(expr);
+            Val val;
             switch(op) {
 
                 case mu::Tkn_Plus:
@@ -158,20 +175,32 @@ namespace mu {
                     BOPERATOR(*, lhs.val, rhs.val, expected_type)
                     break;
                 case mu::Tkn_Slash:
+                    // dividing by zero is left to happen when the program runs.
+                    if(is_zero(rhs.val, expected_type))
+                        return Operand(expected_type, expr, RValue);
                     BOPERATOR(/, lhs.val, rhs.val, expected_type)
                     break;
                 case mu::Tkn_AstrickAstrick:
                     // translate this to a call to powf
+                    return Operand(expected_type, expr, RValue);
                 case mu::Tkn_Percent:
-                    // translate this to a call to modf
-                    // equality operations
+                    if(!expected_type->is_integer() or is_zero(rhs.val, expected_type))
+                        return Operand(expected_type, expr, RValue);
+                    BOPERATOR_WITHOUTFLOAT(%, lhs.val, rhs.val, expected_type)
                     break;
+                    // equality operations
                 case mu::Tkn_EqualEqual:
                     BOPERATOR(==, lhs.val, rhs.val, lhs.type)
                     break;
                 case mu::Tkn_BangEqual:
                     BOPERATOR(!=, lhs.val, rhs.val, lhs.type);
                     break;
+                case mu::Tkn_Less:
+                    BOPERATOR(<, lhs.val, rhs.val, lhs.type);
+                    break;
+                case mu::Tkn_Greater:
+                    BOPERATOR(>, lhs.val, rhs.val, lhs.type);
+                    break;
                 case mu::Tkn_LessEqual:
                     BOPERATOR(<=, lhs.val, rhs.val, lhs.type);
                     break;
@@ -196,6 +225,9 @@ namespace mu {
                 case mu::Tkn_Pipe:
                     BOPERATOR_WITHOUTFLOAT(|, lhs.val, rhs.val, expected_type)
                     break;
+                case mu::Tkn_Carrot:
+                    BOPERATOR_WITHOUTFLOAT(^, lhs.val, rhs.val, expected_type)
+                    break;
                 default:
                     break;
             }
@@ -208,16 +240,19 @@ namespace mu {
 
     Operand eval_unary_op(Typer *typer, mu::TokenKind op, Operand operand, ast::Expr *expr, types::Type *expected_type) {
         if(operand.val.is_constant) {
-            Val val(expr);
+            Val val;
             switch(op) {
                 case mu::Tkn_Minus:
                     UOPERATOR(-, operand.val, expected_type)
                     break;
                 case mu::Tkn_Tilde:
-                    UOPERATOR_WITHOUTFLOAT(-, operand.val, expected_type)
+                    UOPERATOR_WITHOUTFLOAT(~, operand.val, expected_type)
                     break;
                 case mu::Tkn_Bang:
-                    UOPERATOR(-, operand.val, operand.type);
+                    if(operand.type->is_bool())
+                        val = Val(!operand.val._Bool);
+                    else
+                        UOPERATOR_WITHOUTFLOAT(~, operand.val, operand.type);
                     break;
                 case mu::Tkn_Ampersand:
                 case mu::Tkn_Astrick:
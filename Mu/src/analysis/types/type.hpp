@@ -207,6 +207,11 @@ namespace mu {
 
             bool is_unsigned() override;
 
+            // bool and char share this class with the integers.
+            bool is_bool() override { return kind() == Primitive_Bool; }
+
+            bool is_char() override { return kind() == Primitive_Char; }
+
             Type *base_type() override;
         };
 
@@ -344,6 +349,9 @@ namespace mu {
 
             Type *base_type() override;
 
+            inline Type* get_element_type() { return type; }
+            inline u64 num_elements() { return count; }
+
         private:
             Type* type;
             u64 count;
@@ -359,6 +367,8 @@ namespace mu {
 
             Type *base_type() override;
 
+            inline Type* get_element_type() { return type; }
+
         private:
             Type* type;
         };
@@ -373,6 +383,9 @@ namespace mu {
 
             Type *base_type() override;
 
+            // the type being qualified, base_type() strips every qualifier.
+            inline Type* get_inner() { return type; }
+
             inline bool is_mutable() override { return true; }
 
         private:
@@ -0,0 +1,137 @@
+#include "type_table.hpp"
+#include "analysis/entity.hpp"
+#include <algorithm>
+#include <ostream>
+
+namespace mu {
+    namespace types {
+
+        bool operator==(const TypeKey& k1, const TypeKey& k2) {
+            return k1.kind == k2.kind and
+                   k1.size == k2.size and
+                   k1.count == k2.count and
+                   k1.components == k2.components and
+                   k1.path == k2.path;
+        }
+
+        inline void hash_combine(u64& seed, u64 value) {
+            seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        }
+
+        u64 TypeKeyHasher::operator()(const TypeKey& key) const {
+            std::hash<void*> hasher;
+            u64 seed = key.kind;
+
+            hash_combine(seed, key.size);
+            hash_combine(seed, key.count);
+
+            for(auto t : key.components)
+                hash_combine(seed, hasher(t));
+
+            for(auto a : key.path)
+                hash_combine(seed, hasher(a));
+
+            return seed;
+        }
+
+        TypeTable::TypeTable() = default;
+
+        Type* TypeTable::intern(TypePtr type) {
+            TypeKey key{type->kind(), type->size(), 0, {}, {}};
+
+            if(!build_key(type.get(), key)) {
+                num_misses++;
+                types.push_back(type);
+                return type.get();
+            }
+
+            auto iter = table.find(key);
+            if(iter != table.end()) {
+                num_hits++;
+                return iter->second;
+            }
+
+            num_misses++;
+            types.push_back(type);
+            table.emplace(std::move(key), type.get());
+            return type.get();
+        }
+
+        void TypeTable::forget(Atom* scope) {
+            for(auto iter = table.begin(); iter != table.end();) {
+                // the last name of a path is the type, the names before it are its scopes.
+                auto& path = iter->first.path;
+                if(!path.empty() and std::find(path.begin(), path.end() - 1, scope) != path.end() - 1)
+                    iter = table.erase(iter);
+                else
+                    ++iter;
+            }
+        }
+
+        bool TypeTable::build_key(Type* type, TypeKey& key) {
+            // only valid for concrete types.
+            if(type->is_polymophic())
+                return false;
+
+            if(type->is_primative())
+                return true;
+
+            switch(type->kind()) {
+                case Unit_Type:
+                    return true;
+                case StructureType: {
+                    auto entity = type->as<StructType>()->get_entity();
+                    key.path = entity->full_path().path;
+                    return true;
+                }
+                case TraitAttributeType: {
+                    auto entity = type->as<TraitType>()->get_entity();
+                    key.path = entity->full_path().path;
+                    return true;
+                }
+                case FunctType: {
+                    auto function = type->as<FunctionType>();
+                    key.components.reserve(function->num_params() + 1);
+
+                    for(u64 i = 0; i < function->num_params(); ++i)
+                        key.components.push_back(function->get_param(i));
+                    key.components.push_back(function->get_ret());
+                    return true;
+                }
+                case TupleType: {
+                    auto tuple = type->as<Tuple>();
+                    key.components.reserve(tuple->num_elements());
+
+                    for(u64 i = 0; i < tuple->num_elements(); ++i)
+                        key.components.push_back(tuple->get_element_type(i));
+                    return true;
+                }
+                case PtrType:
+                    key.components.push_back(type->base_type());
+                    return true;
+                case ArrayType: {
+                    auto array = type->as<Array>();
+                    key.components.push_back(array->get_element_type());
+                    key.count = array->num_elements();
+                    return true;
+                }
+                case DynArrayType:
+                    key.components.push_back(type->as<DynArray>()->get_element_type());
+                    return true;
+                case MutableType:
+                    key.components.push_back(type->as<Mutable>()->get_inner());
+                    return true;
+                // sum types are not compared yet and modules should be compared by path.
+                case SType:
+                case ModType:
+                default:
+                    return false;
+            }
+        }
+
+        void TypeTable::print_stats(std::ostream& out) {
+            out << "Type Table: " << types.size() << " types, "
+                << num_hits << " hits, " << num_misses << " misses" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef MU_TYPE_TABLE_HPP
+#define MU_TYPE_TABLE_HPP
+
+#include "common.hpp"
+#include "type.hpp"
+#include <unordered_map>
+
+namespace mu {
+    namespace types {
+
+        // Structural identity of a type. Because every component type is itself interned,
+        // two structurally equivalent types will have identical component pointers. Named
+        // types (structures and traits) are identified by the full path of their declaration.
+        struct TypeKey {
+            TypeKind kind;
+            u64 size;
+            u64 count;
+            std::vector<Type*> components;
+            std::vector<Atom*> path;
+
+            friend bool operator==(const TypeKey& k1, const TypeKey& k2);
+        };
+
+        struct TypeKeyHasher {
+            u64 operator()(const TypeKey& key) const;
+        };
+
+        // Hash-consing table of every concrete type created by the typer.
+        // Types that can not be compared structurally (polymorphic types, sum types and modules)
+        // are never merged, they are only owned by the table.
+        class TypeTable {
+        public:
+            TypeTable();
+
+            // returns the canonical instance of type. If an equivalent type
+            // has already been interned then type is dropped.
+            Type* intern(TypePtr type);
+
+            // removes the named types declared under a scope named scope, they are still owned
+            // by the table. A module that is resolved again makes new types instead of finding
+            // the types of its previous content.
+            void forget(Atom* scope);
+
+            inline u64 hits() { return num_hits; }
+            inline u64 misses() { return num_misses; }
+            inline u64 size() { return types.size(); }
+
+            void print_stats(std::ostream& out);
+
+        private:
+            // builds the key of a given type, returns false if the type can not be interned.
+            bool build_key(Type* type, TypeKey& key);
+
+            std::unordered_map<TypeKey, Type*, TypeKeyHasher> table;
+            std::vector<TypePtr> types;
+
+            u64 num_hits{0};
+            u64 num_misses{0};
+        };
+    }
+}
+
+#endif //MU_TYPE_TABLE_HPP
@@ -0,0 +1,1568 @@
+#include "codegen.hpp"
+#include "analysis/types/type.hpp"
+#include "parser/ast/ast_common.hpp"
+
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/MC/TargetRegistry.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_os_ostream.h>
+#include <llvm/Target/TargetOptions.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+// mutable only qualifies a type, it is lowered the same as the type it qualifies.
+static mu::types::Type* strip(mu::types::Type* type) {
+    while(type and type->kind() == mu::types::MutableType)
+        type = type->as<mu::types::Mutable>()->get_inner();
+    return type;
+}
+
+static mu::TokenKind compound_operator(mu::TokenKind op) {
+    switch(op) {
+        case mu::Tkn_PlusEqual: return mu::Tkn_Plus;
+        case mu::Tkn_MinusEqual: return mu::Tkn_Minus;
+        case mu::Tkn_AstrickEqual: return mu::Tkn_Astrick;
+        case mu::Tkn_SlashEqual: return mu::Tkn_Slash;
+        case mu::Tkn_PercentEqual: return mu::Tkn_Percent;
+        case mu::Tkn_AstrickAstrickEqual: return mu::Tkn_AstrickAstrick;
+        case mu::Tkn_LessLessEqual: return mu::Tkn_LessLess;
+        case mu::Tkn_GreaterGreaterEqual: return mu::Tkn_GreaterGreater;
+        case mu::Tkn_AmpersandEqual: return mu::Tkn_Ampersand;
+        case mu::Tkn_PipeEqual: return mu::Tkn_Pipe;
+        case mu::Tkn_CarrotEqual: return mu::Tkn_Carrot;
+        default: return op;
+    }
+}
+
+// whether a call takes an element of an array, 'v(i)'.
+static bool is_index(ast::Expr* expr) {
+    if(expr->kind != ast::ast_call)
+        return false;
+    auto type = strip(expr->as<ast::Call>()->name->type);
+    return type and type->is_array();
+}
+
+// the initializer of a struct member when it isn't given in the struct expression.
+// the value a literal pattern matches.
+static bool pattern_value(ast::Pattern* pattern, i64& value) {
+    switch(pattern->kind) {
+        case ast::ast_int_pattern: value = pattern->as<ast::IntPattern>()->value; return true;
+        case ast::ast_char_pattern: value = pattern->as<ast::CharPattern>()->value; return true;
+        case ast::ast_bool_pattern: value = pattern->as<ast::BoolPattern>()->value; return true;
+        default: return false;
+    }
+}
+
+static ast::ExprPtr default_member_init(mu::Local* member) {
+    auto decl = member->get_decl();
+    if(!decl or decl->kind != ast::ast_member_variable)
+        return nullptr;
+
+    auto variable = decl->as<ast::MemberVariable>();
+    if(variable->init.size() == 1)
+        return variable->init[0];
+
+    for(u64 i = 0; i < variable->names.size() and i < variable->init.size(); ++i)
+        if(variable->names[i]->val == member->get_name()->val)
+            return variable->init[i];
+    return nullptr;
+}
+
+namespace mu {
+
+    CodeGen::CodeGen(Interpreter* interp) : interp(interp), context(std::make_unique<llvm::LLVMContext>()),
+        llvm_context(*context), builder(llvm_context) {
+    }
+
+    CodeGen::~CodeGen() = default;
+
+    bool CodeGen::generate(ast::ModuleFile* file_module, const std::vector<Entity*>& entities,
+                           const std::unordered_set<Function*>* only) {
+        module = std::make_unique<llvm::Module>(file_module->get_name()->value(), llvm_context);
+        internal_globals = only != nullptr;
+
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+
+        auto triple = llvm::sys::getDefaultTargetTriple();
+        std::string error;
+        if(auto target = llvm::TargetRegistry::lookupTarget(triple, error)) {
+            machine.reset(target->createTargetMachine(triple, "generic", "", llvm::TargetOptions(), llvm::Reloc::PIC_));
+            module->setDataLayout(machine->createDataLayout());
+            module->setTargetTriple(triple);
+        }
+
+        // everything is declared before any body is generated so the order of the
+        // declarations doesn't matter.
+        std::vector<Function*> bodies;
+        for(auto entity : entities) {
+            if(!entity or !entity->is_resolved())
+                continue;
+
+            switch(entity->kind()) {
+                case FunctionEntity: {
+                    auto function = entity->as<Function>();
+                    auto name = function->get_name()->value();
+                    if(function->is_foreign() and !function->get_foreign_name().empty())
+                        name = function->get_foreign_name();
+                    if(declare_function(function, name))
+                        bodies.push_back(function);
+                } break;
+                case TypeEntity: {
+                    auto type = entity->as<Type>();
+                    if(!type->is_struct())
+                        break;
+
+                    auto struct_type = type->get_type()->as<types::StructType>();
+                    lower_type(struct_type);
+
+                    // methods are named by their type, 'Point.new'.
+                    auto scope = struct_type->get_scope();
+                    for(auto block : type->get_impls()) {
+                        for(auto decl : block->as<ast::Impl>()->methods) {
+                            if(decl->kind != ast::ast_procedure)
+                                continue;
+
+                            auto [member, found] = scope->find(decl->as<ast::Procedure>()->name);
+                            if(!found or !member->is_function() or !member->is_resolved())
+                                continue;
+
+                            auto method = member->as<Function>();
+                            if(declare_function(method, type->get_name()->value() + "." + member->get_name()->value()))
+                                bodies.push_back(method);
+                        }
+                    }
+                } break;
+                case GlobalEntity:
+                    declare_global(entity->as<Global>());
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        for(auto function : bodies)
+            if(!only or only->count(function))
+                define_function(function);
+
+        if(has_error())
+            return false;
+
+        std::string message;
+        llvm::raw_string_ostream stream(message);
+        if(llvm::verifyModule(*module, &stream)) {
+            interp->message("Compiler Error: the generated module is invalid");
+            interp->out_stream() << stream.str() << std::endl;
+            errors_num++;
+            return false;
+        }
+        return true;
+    }
+
+    void CodeGen::print(std::ostream& out) {
+        llvm::raw_os_ostream stream(out);
+        module->print(stream, nullptr);
+    }
+
+    bool CodeGen::emit_object(const std::string& path) {
+        if(!machine) {
+            interp->message("Unable to write '%s', LLVM doesn't support this host", path.c_str());
+            return false;
+        }
+
+        std::error_code error;
+        llvm::raw_fd_ostream out(path, error, llvm::sys::fs::OF_None);
+        if(error) {
+            interp->message("Unable to open '%s': %s", path.c_str(), error.message().c_str());
+            return false;
+        }
+
+        llvm::legacy::PassManager passes;
+        if(machine->addPassesToEmitFile(passes, out, nullptr, llvm::CGFT_ObjectFile)) {
+            interp->message("Unable to write '%s', LLVM can't emit an object file for this host", path.c_str());
+            return false;
+        }
+
+        passes.run(*module);
+        out.flush();
+        return true;
+    }
+
+    llvm::orc::ThreadSafeModule CodeGen::take_module() {
+        return llvm::orc::ThreadSafeModule(std::move(module), std::move(context));
+    }
+
+    /*-----------------------------Types------------------------------*/
+
+    llvm::Type* CodeGen::lower_type(types::Type* type) {
+        auto iter = lowered_types.find(type);
+        if(iter != lowered_types.end())
+            return iter->second;
+
+        llvm::Type* result = nullptr;
+        switch(type->kind()) {
+            case types::Primitive_I8:
+            case types::Primitive_U8:
+            case types::Primitive_Char:
+                result = builder.getInt8Ty();
+                break;
+            case types::Primitive_I16:
+            case types::Primitive_U16:
+                result = builder.getInt16Ty();
+                break;
+            case types::Primitive_I32:
+            case types::Primitive_U32:
+                result = builder.getInt32Ty();
+                break;
+            case types::Primitive_I64:
+            case types::Primitive_U64:
+                result = builder.getInt64Ty();
+                break;
+            case types::Primitive_Bool:
+                result = builder.getInt1Ty();
+                break;
+            case types::Primitive_Float32:
+                result = builder.getFloatTy();
+                break;
+            case types::Primitive_Float64:
+                result = builder.getDoubleTy();
+                break;
+            case types::Unit_Type:
+                result = llvm::StructType::get(llvm_context);
+                break;
+            case types::StructureType:
+                return lower_struct(type->as<types::StructType>());
+            case types::TupleType: {
+                auto tuple = type->as<types::Tuple>();
+                std::vector<llvm::Type*> elements;
+                for(u64 i = 0; i < tuple->num_elements(); ++i)
+                    elements.push_back(lower_type(tuple->get_element_type(i)));
+                result = llvm::StructType::get(llvm_context, elements);
+            } break;
+            case types::ArrayType: {
+                auto array = type->as<types::Array>();
+                result = llvm::ArrayType::get(lower_type(array->get_element_type()), array->num_elements());
+            } break;
+            case types::PtrType: {
+                // there isn't a void, a pointer to unit is an untyped pointer.
+                auto base = strip(type->base_type());
+                result = (base->is_unit() ? builder.getInt8Ty() : lower_type(base))->getPointerTo();
+            } break;
+            case types::MutableType:
+                result = lower_type(strip(type));
+                break;
+            case types::FunctType:
+                result = lower_function_type(type->as<types::FunctionType>())->getPointerTo();
+                break;
+            default:
+                report(position, "the type '%s' can not be generated at this time", type->str().c_str());
+                result = builder.getInt8Ty();
+                break;
+        }
+
+        lowered_types.emplace(type, result);
+        return result;
+    }
+
+    llvm::Type* CodeGen::lower_struct(types::StructType* type) {
+        // created before the members are lowered so a member can point to the struct.
+        auto result = llvm::StructType::create(llvm_context, type->get_name()->value());
+        lowered_types.emplace(type, result);
+
+        std::vector<Local*> members;
+        for(u64 i = 0; i < type->num_members(); ++i)
+            members.push_back(type->get_member(i)->as<Local>());
+        std::stable_sort(members.begin(), members.end(), [](Local* a, Local* b) {
+            return a->get_offset() < b->get_offset();
+        });
+
+        auto byte = builder.getInt8Ty();
+        std::vector<llvm::Type*> body;
+        u64 offset = 0;
+        for(auto member : members) {
+            if(member->get_offset() > offset)
+                body.push_back(llvm::ArrayType::get(byte, member->get_offset() - offset));
+
+            fields[member] = body.size();
+            body.push_back(lower_type(member->get_type()));
+            offset = member->get_offset() + member->get_type()->size();
+        }
+
+        if(type->size() > offset)
+            body.push_back(llvm::ArrayType::get(byte, type->size() - offset));
+
+        result->setBody(body, true);
+        return result;
+    }
+
+    llvm::FunctionType* CodeGen::lower_function_type(types::FunctionType* type, bool is_main, bool is_variadic) {
+        // a c variadic function has the variadic parameter as its last parameter.
+        auto num_params = type->num_params() - (is_variadic ? 1 : 0);
+
+        std::vector<llvm::Type*> params;
+        for(u64 i = 0; i < num_params; ++i)
+            params.push_back(lower_type(type->get_param(i)));
+
+        // unit isn't returned, main always returns an exit code.
+        auto ret = type->get_ret();
+        llvm::Type* ret_type = nullptr;
+        if(!ret or ret->is_unit())
+            ret_type = is_main ? builder.getInt32Ty() : builder.getVoidTy();
+        else
+            ret_type = lower_type(ret);
+
+        return llvm::FunctionType::get(ret_type, params, is_variadic);
+    }
+
+    llvm::Value* CodeGen::unit_value() {
+        return llvm::ConstantStruct::getAnon(llvm_context, {});
+    }
+
+    /*---------------------------Entities-----------------------------*/
+
+    llvm::Function* CodeGen::declare_function(Function* function, const std::string& name) {
+        auto iter = functions.find(function);
+        if(iter != functions.end())
+            return iter->second;
+
+        auto pos = function->get_decl()->pos();
+        auto type = function->get_type()->as<types::FunctionType>();
+
+        bool c_variadic = false;
+        if(function->is_variadic()) {
+            auto last = function->get_param(function->num_params() - 1);
+            if(!last->is_cvariadic()) {
+                report(pos, "the variadic function '%s' can not be generated at this time", name.c_str());
+                return nullptr;
+            }
+            c_variadic = true;
+        }
+
+        auto fn_type = lower_function_type(type, name == "main", c_variadic);
+        auto llvm_function = llvm::Function::Create(fn_type, llvm::Function::ExternalLinkage, name, module.get());
+        for(u64 i = 0; i < llvm_function->arg_size(); ++i)
+            llvm_function->getArg(i)->setName(function->get_param(i)->get_name()->value());
+
+        functions.emplace(function, llvm_function);
+        return llvm_function;
+    }
+
+    void CodeGen::define_function(Function* function) {
+        if(function->no_body())
+            return;
+
+        auto llvm_function = functions[function];
+        auto decl = function->get_decl()->as<ast::Procedure>();
+
+        current_function = function;
+        current_llvm_function = llvm_function;
+        current_is_main = llvm_function->getName() == "main";
+        locals.clear();
+
+        auto entry = llvm::BasicBlock::Create(llvm_context, "entry", llvm_function);
+        builder.SetInsertPoint(entry);
+
+        // the parameters are stored so they can be used like any other local.
+        for(u64 i = 0; i < llvm_function->arg_size(); ++i) {
+            auto param = function->get_param(i);
+            auto slot = create_slot(param->get_type(), param->get_name()->value());
+            builder.CreateStore(llvm_function->getArg(i), slot);
+            locals[{param->get_decl(), param->get_name()->val}] = slot;
+        }
+
+        auto value = emit_expr(decl->body);
+
+        auto block = builder.GetInsertBlock();
+        auto ret = function->get_ret_type();
+        if(!value or (block != entry and llvm::pred_empty(block)))
+            builder.CreateUnreachable();
+        else if(!ret or ret->is_unit()) {
+            if(current_is_main)
+                builder.CreateRet(builder.getInt32(0));
+            else
+                builder.CreateRetVoid();
+        }
+        else
+            builder.CreateRet(value);
+
+        remove_dead_blocks(llvm_function);
+    }
+
+    void CodeGen::declare_global(Global* global) {
+        auto decl = global->get_decl();
+        auto init = global->is_mutable() ? decl->as<ast::GlobalMut>()->init : decl->as<ast::Global>()->init;
+        auto name = global->get_name()->value();
+        auto type = lower_type(global->get_type());
+
+        llvm::Constant* initializer = llvm::Constant::getNullValue(type);
+        if(init) {
+            if(mu::is_constant_expr(init))
+                initializer = llvm::cast<llvm::Constant>(emit_constant(init->operand.val, global->get_type()));
+            else
+                report(init->pos(), "global '%s' must be initialized by a constant", name.c_str());
+        }
+
+        auto linkage = internal_globals ? llvm::GlobalValue::InternalLinkage : llvm::GlobalValue::ExternalLinkage;
+        auto variable = new llvm::GlobalVariable(*module, type, !global->is_mutable(), linkage, initializer, name);
+        variable->setAlignment(llvm::Align(std::max<u64>(global->get_type()->alignment(), 1)));
+        globals.emplace(global, variable);
+    }
+
+    bool CodeGen::generate_entry(Function* function, const std::string& name) {
+        auto iter = functions.find(function);
+        if(iter == functions.end())
+            return false;
+
+        auto slots_type = builder.getInt64Ty()->getPointerTo();
+        auto type = llvm::FunctionType::get(builder.getVoidTy(), {slots_type, slots_type}, false);
+        auto entry = llvm::Function::Create(type, llvm::Function::ExternalLinkage, name, module.get());
+        builder.SetInsertPoint(llvm::BasicBlock::Create(llvm_context, "entry", entry));
+
+        u32 index = 0;
+        std::vector<llvm::Value*> args;
+        for(u64 i = 0; i < iter->second->arg_size(); ++i)
+            args.push_back(load_slots(function->get_param(i)->get_type(), entry->getArg(0), index));
+
+        auto result = builder.CreateCall(iter->second, args);
+        auto ret = function->get_ret_type();
+        index = 0;
+        if(ret and !ret->is_unit())
+            store_slots(ret, result, entry->getArg(1), index);
+        builder.CreateRetVoid();
+
+        if(has_error())
+            return false;
+
+        std::string message;
+        llvm::raw_string_ostream stream(message);
+        if(llvm::verifyFunction(*entry, &stream)) {
+            interp->message("Compiler Error: the entry of '%s' is invalid", name.c_str());
+            interp->out_stream() << stream.str() << std::endl;
+            errors_num++;
+            return false;
+        }
+        return true;
+    }
+
+    llvm::Value* CodeGen::load_slots(types::Type* type, llvm::Value* slots, u32& index) {
+        type = strip(type);
+        auto lowered = lower_type(type);
+
+        // integers are sign or zero extended to 64 bits and an f32 is stored as an f64.
+        if(type->is_primative()) {
+            auto slot = builder.CreateConstGEP1_64(builder.getInt64Ty(), slots, index++);
+            auto value = builder.CreateLoad(builder.getInt64Ty(), slot);
+            if(type->is_float()) {
+                auto wide = builder.CreateBitCast(value, builder.getDoubleTy());
+                return lowered->isDoubleTy() ? wide : builder.CreateFPTrunc(wide, lowered);
+            }
+            return builder.CreateTrunc(value, lowered);
+        }
+
+        llvm::Value* value = llvm::UndefValue::get(lowered);
+        if(type->kind() == types::TupleType) {
+            auto tuple = type->as<types::Tuple>();
+            for(u32 i = 0; i < tuple->num_elements(); ++i)
+                value = builder.CreateInsertValue(value, load_slots(tuple->get_element_type(i), slots, index), {i});
+        }
+        else if(type->kind() == types::StructureType) {
+            auto struct_type = type->as<types::StructType>();
+            for(u64 i = 0; i < struct_type->num_members(); ++i) {
+                auto member = struct_type->get_member(i);
+                value = builder.CreateInsertValue(value, load_slots(member->get_type(), slots, index), {fields[member]});
+            }
+        }
+        else if(type->kind() == types::ArrayType) {
+            auto array = type->as<types::Array>();
+            for(u32 i = 0; i < array->num_elements(); ++i)
+                value = builder.CreateInsertValue(value, load_slots(array->get_element_type(), slots, index), {i});
+        }
+        else if(!type->is_unit())
+            report(position, "a value of type '%s' can not be passed to generated code", type->str().c_str());
+        return value;
+    }
+
+    void CodeGen::store_slots(types::Type* type, llvm::Value* value, llvm::Value* slots, u32& index) {
+        type = strip(type);
+
+        if(type->is_primative()) {
+            auto slot = builder.CreateConstGEP1_64(builder.getInt64Ty(), slots, index++);
+            llvm::Value* wide = nullptr;
+            if(type->is_float())
+                wide = builder.CreateBitCast(builder.CreateFPCast(value, builder.getDoubleTy()), builder.getInt64Ty());
+            else if(type->is_signed())
+                wide = builder.CreateSExt(value, builder.getInt64Ty());
+            else
+                wide = builder.CreateZExt(value, builder.getInt64Ty());
+            builder.CreateStore(wide, slot);
+            return;
+        }
+
+        if(type->kind() == types::TupleType) {
+            auto tuple = type->as<types::Tuple>();
+            for(u32 i = 0; i < tuple->num_elements(); ++i)
+                store_slots(tuple->get_element_type(i), builder.CreateExtractValue(value, {i}), slots, index);
+        }
+        else if(type->kind() == types::StructureType) {
+            auto struct_type = type->as<types::StructType>();
+            for(u64 i = 0; i < struct_type->num_members(); ++i) {
+                auto member = struct_type->get_member(i);
+                store_slots(member->get_type(), builder.CreateExtractValue(value, {fields[member]}), slots, index);
+            }
+        }
+        else if(type->kind() == types::ArrayType) {
+            auto array = type->as<types::Array>();
+            for(u32 i = 0; i < array->num_elements(); ++i)
+                store_slots(array->get_element_type(), builder.CreateExtractValue(value, {i}), slots, index);
+        }
+        else if(!type->is_unit())
+            report(position, "a value of type '%s' can not be returned to the interpreter", type->str().c_str());
+    }
+
+    llvm::Value* CodeGen::local_slot(Local* local) {
+        auto iter = locals.find({local->get_decl(), local->get_name()->val});
+        if(iter != locals.end())
+            return iter->second;
+
+        // a local declared without a value, it starts zeroed.
+        auto slot = create_slot(local->get_type(), local->get_name()->value());
+        llvm::IRBuilder<> entry(slot->getParent(), std::next(slot->getIterator()));
+        entry.CreateStore(llvm::Constant::getNullValue(slot->getAllocatedType()), slot);
+
+        locals[{local->get_decl(), local->get_name()->val}] = slot;
+        return slot;
+    }
+
+    llvm::AllocaInst* CodeGen::create_slot(types::Type* type, const std::string& name) {
+        auto& entry = current_llvm_function->getEntryBlock();
+        llvm::IRBuilder<> builder(&entry, entry.begin());
+
+        auto lowered = lower_type(type);
+        auto slot = builder.CreateAlloca(lowered, nullptr, name);
+
+        // structs are packed so the alignment comes from the mu type.
+        auto align = module->getDataLayout().getABITypeAlign(lowered).value();
+        slot->setAlignment(llvm::Align(std::max<u64>(type->alignment(), align)));
+        return slot;
+    }
+
+    /*--------------------------Expressions---------------------------*/
+
+    llvm::Value* CodeGen::emit_expr(ast::Expr* expr) {
+        position = expr->pos();
+
+        auto type = strip(expr->type);
+        // a block, branch or call with a constant value still runs its statements.
+        if(mu::is_constant_expr(expr) and type and type->is_primative())
+            return emit_constant(expr->operand.val, type);
+
+        switch(expr->kind) {
+            case ast::ast_name:
+            case ast::ast_self_expr:
+                return emit_name(expr);
+            case ast::ast_unit_expr:
+                return unit_value();
+            case ast::ast_binary:
+                return emit_binary(expr->as<ast::Binary>());
+            case ast::ast_unary:
+                return emit_unary(expr->as<ast::Unary>());
+            case ast::ast_cast_expr:
+                return emit_cast(expr);
+            case ast::ast_tuple_expr:
+                return emit_tuple(expr->as<ast::TupleExpr>());
+            case ast::ast_struct_expr:
+                return emit_struct(expr->as<ast::StructExpr>());
+            case ast::ast_list:
+                return emit_list(expr->as<ast::List>());
+            case ast::ast_accessor:
+            case ast::ast_tuple_accessor:
+                return emit_accessor(expr);
+            case ast::ast_call:
+                if(is_index(expr))
+                    return emit_index(expr->as<ast::Call>());
+                return emit_call(expr->as<ast::Call>());
+            case ast::ast_method:
+                return emit_method(expr->as<ast::Method>());
+            case ast::ast_block:
+                return emit_block(expr->as<ast::Block>());
+            case ast::ast_if_expr:
+                return emit_if(expr->as<ast::If>());
+            case ast::ast_while_expr:
+                return emit_while(expr->as<ast::While>());
+            case ast::ast_for_expr:
+                return emit_for(expr->as<ast::For>());
+            case ast::ast_match_expr:
+                return emit_match(expr->as<ast::Match>());
+            case ast::ast_return:
+                return emit_return(expr->as<ast::Return>());
+            case ast::ast_assign:
+                return emit_assign(expr->as<ast::Assign>());
+            default:
+                report(expr->pos(), "this expression can not be generated at this time");
+                return nullptr;
+        }
+    }
+
+    llvm::Value* CodeGen::emit_address(ast::Expr* expr) {
+        switch(expr->kind) {
+            case ast::ast_name:
+            case ast::ast_self_expr: {
+                auto entity = expr->operand.entity;
+                if(entity and entity->is_local())
+                    return local_slot(entity->as<Local>());
+                if(entity and entity->is_global()) {
+                    auto iter = globals.find(entity->as<Global>());
+                    return iter == globals.end() ? nullptr : iter->second;
+                }
+                return nullptr;
+            }
+            case ast::ast_accessor:
+            case ast::ast_tuple_accessor: {
+                auto operand = expr->kind == ast::ast_accessor ? expr->as<ast::Accessor>()->operand :
+                               expr->as<ast::TupleAcessor>()->operand;
+                auto operand_type = strip(operand->type);
+
+                // a pointer is accessed through, otherwise the operand needs storage.
+                llvm::Value* base = nullptr;
+                if(operand_type->is_ptr()) {
+                    operand_type = strip(operand_type->base_type());
+                    base = emit_expr(operand);
+                }
+                else
+                    base = emit_address(operand);
+
+                if(!base)
+                    return nullptr;
+
+                auto lowered = lower_type(operand_type);
+                if(expr->kind == ast::ast_tuple_accessor)
+                    return builder.CreateStructGEP(lowered, base, expr->as<ast::TupleAcessor>()->value);
+
+                auto member = expr->operand.entity;
+                if(!member or !member->is_local())
+                    return nullptr;
+                return builder.CreateStructGEP(lowered, base, fields[member], member->get_name()->value());
+            }
+            case ast::ast_unary: {
+                auto unary = expr->as<ast::Unary>();
+                if(unary->op == Tkn_Astrick)
+                    return emit_expr(unary->expr);
+                return nullptr;
+            }
+            case ast::ast_call: {
+                if(!is_index(expr))
+                    return nullptr;
+
+                auto call = expr->as<ast::Call>();
+                auto base = emit_address(call->name);
+                return base ? emit_element_address(call, base) : nullptr;
+            }
+            default:
+                return nullptr;
+        }
+    }
+
+    llvm::Value* CodeGen::emit_spilled_address(ast::Expr* expr) {
+        if(auto address = emit_address(expr))
+            return address;
+
+        auto value = emit_expr(expr);
+        if(!value)
+            return nullptr;
+
+        auto slot = create_slot(expr->type, "tmp");
+        builder.CreateStore(value, slot);
+        return slot;
+    }
+
+    llvm::Value* CodeGen::emit_constant(const Val& val, types::Type* type) {
+        type = strip(type);
+        auto lowered = lower_type(type);
+
+        // the value is read by the type it was evaluated as, which can differ from the
+        // type of the expression before it was cast.
+        auto kind = val.type ? strip(val.type)->kind() : type->kind();
+        bool is_float = false;
+        i64 integer = 0;
+        f64 floating = 0;
+        switch(kind) {
+            case types::Primitive_I8: integer = val._I8; break;
+            case types::Primitive_I16: integer = val._I16; break;
+            case types::Primitive_I32: integer = val._I32; break;
+            case types::Primitive_I64: integer = val._I64; break;
+            case types::Primitive_U8: integer = val._U8; break;
+            case types::Primitive_U16: integer = val._U16; break;
+            case types::Primitive_U32: integer = val._U32; break;
+            case types::Primitive_U64: integer = CAST(i64, val._U64); break;
+            case types::Primitive_Char: integer = val._Char; break;
+            case types::Primitive_Bool: integer = val._Bool; break;
+            case types::Primitive_Float32: floating = val._F32; is_float = true; break;
+            case types::Primitive_Float64: floating = val._F64; is_float = true; break;
+            default:
+                report(position, "the constant of type '%s' can not be generated at this time", type->str().c_str());
+                return nullptr;
+        }
+
+        if(type->is_float())
+            return llvm::ConstantFP::get(lowered, is_float ? floating : CAST(f64, integer));
+        return llvm::ConstantInt::get(lowered, is_float ? CAST(u64, CAST(i64, floating)) : CAST(u64, integer),
+                                      type->is_signed());
+    }
+
+    llvm::Value* CodeGen::emit_name(ast::Expr* expr) {
+        auto entity = expr->operand.entity;
+        if(!entity) {
+            report(expr->pos(), "this name can not be generated at this time");
+            return nullptr;
+        }
+
+        auto name = entity->get_name()->value();
+        switch(entity->kind()) {
+            case LocalEntity: {
+                auto local = entity->as<Local>();
+                return builder.CreateLoad(lower_type(local->get_type()), local_slot(local), name);
+            }
+            case GlobalEntity: {
+                auto iter = globals.find(entity->as<Global>());
+                if(iter == globals.end())
+                    break;
+                return builder.CreateLoad(iter->second->getValueType(), iter->second, name);
+            }
+            case ConstantEntity: {
+                auto constant = entity->as<Constant>();
+                return emit_constant(constant->get_value(), constant->get_type());
+            }
+            case FunctionEntity: {
+                auto iter = functions.find(entity->as<Function>());
+                if(iter == functions.end())
+                    break;
+                return iter->second;
+            }
+            default:
+                break;
+        }
+
+        report(expr->pos(), "'%s' can not be generated at this time", name.c_str());
+        return nullptr;
+    }
+
+    llvm::Value* CodeGen::emit_binary(ast::Binary* expr) {
+        if(expr->op == Tkn_And or expr->op == Tkn_Or)
+            return emit_logical(expr);
+
+        auto lhs = emit_expr(expr->lhs);
+        if(!lhs)
+            return nullptr;
+
+        auto rhs = emit_expr(expr->rhs);
+        if(!rhs)
+            return nullptr;
+
+        position = expr->pos();
+        if(strip(expr->type)->is_array())
+            return emit_elements(expr->op, lhs, expr->lhs->type, rhs, expr->rhs->type);
+        return emit_binary_op(expr->op, lhs, rhs, expr->lhs->type);
+    }
+
+    llvm::Value* CodeGen::emit_elements(TokenKind op, llvm::Value* lhs, types::Type* lhs_type,
+                                        llvm::Value* rhs, types::Type* rhs_type) {
+        lhs_type = strip(lhs_type);
+        rhs_type = strip(rhs_type);
+        auto array = (lhs_type->is_array() ? lhs_type : rhs_type)->as<types::Array>();
+        auto element = strip(array->get_element_type());
+        auto lowered = lower_type(element);
+        auto count = array->num_elements();
+
+        // the operation is done once over a vector of a power of two lanes, the lanes past the
+        // last element are padding that is never read back. A divisor is padded with ones so an
+        // integer division of the padding can't trap.
+        auto lanes = (unsigned) llvm::PowerOf2Ceil(std::max<u64>(count, 1));
+        auto to_vector = [&](llvm::Value* value, types::Type* type, bool divisor) -> llvm::Value* {
+            if(!type->is_array())
+                return builder.CreateVectorSplat(lanes, value);
+            auto padding = divisor ? (element->is_float() ? llvm::ConstantFP::get(lowered, 1.0) : llvm::ConstantInt::get(lowered, 1))
+                                   : llvm::Constant::getNullValue(lowered);
+            llvm::Value* vector = llvm::ConstantVector::getSplat(llvm::ElementCount::getFixed(lanes), padding);
+            for(u64 i = 0; i < count; ++i)
+                vector = builder.CreateInsertElement(vector, builder.CreateExtractValue(value, {(unsigned) i}), i);
+            return vector;
+        };
+
+        auto divides = op == Tkn_Slash or op == Tkn_Percent;
+        auto result = emit_binary_op(op, to_vector(lhs, lhs_type, false), to_vector(rhs, rhs_type, divides), element);
+        if(!result)
+            return nullptr;
+
+        llvm::Value* value = llvm::UndefValue::get(lower_type(array));
+        for(u64 i = 0; i < count; ++i)
+            value = builder.CreateInsertValue(value, builder.CreateExtractElement(result, i), {(unsigned) i});
+        return value;
+    }
+
+    llvm::Value* CodeGen::emit_binary_op(TokenKind op, llvm::Value* lhs, llvm::Value* rhs, types::Type* type) {
+        type = strip(type);
+
+        if(type->is_ptr()) {
+            auto element = lower_type(strip(type->base_type()));
+            switch(op) {
+                case Tkn_Plus:
+                    return builder.CreateGEP(element, lhs, rhs);
+                case Tkn_Minus:
+                    return builder.CreateGEP(element, lhs, builder.CreateNeg(rhs));
+                case Tkn_EqualEqual:
+                    return builder.CreateICmpEQ(lhs, rhs);
+                case Tkn_BangEqual:
+                    return builder.CreateICmpNE(lhs, rhs);
+                default:
+                    report(position, "the operator '%s' can not be applied to a pointer", Token::get_string(op).c_str());
+                    return nullptr;
+            }
+        }
+
+        auto is_float = type->is_float();
+        auto is_signed = type->is_signed();
+        switch(op) {
+            case Tkn_Plus:
+                return is_float ? builder.CreateFAdd(lhs, rhs) : builder.CreateAdd(lhs, rhs);
+            case Tkn_Minus:
+                return is_float ? builder.CreateFSub(lhs, rhs) : builder.CreateSub(lhs, rhs);
+            case Tkn_Astrick:
+                return is_float ? builder.CreateFMul(lhs, rhs) : builder.CreateMul(lhs, rhs);
+            case Tkn_Slash:
+                if(is_float)
+                    return builder.CreateFDiv(lhs, rhs);
+                return is_signed ? builder.CreateSDiv(lhs, rhs) : builder.CreateUDiv(lhs, rhs);
+            case Tkn_Percent:
+                if(is_float)
+                    return builder.CreateFRem(lhs, rhs);
+                return is_signed ? builder.CreateSRem(lhs, rhs) : builder.CreateURem(lhs, rhs);
+            case Tkn_AstrickAstrick:
+                if(is_float)
+                    return builder.CreateBinaryIntrinsic(llvm::Intrinsic::pow, lhs, rhs);
+                break;
+            case Tkn_LessLess:
+                return builder.CreateShl(lhs, rhs);
+            case Tkn_GreaterGreater:
+                return is_signed ? builder.CreateAShr(lhs, rhs) : builder.CreateLShr(lhs, rhs);
+            case Tkn_Ampersand:
+                return builder.CreateAnd(lhs, rhs);
+            case Tkn_Pipe:
+                return builder.CreateOr(lhs, rhs);
+            case Tkn_Carrot:
+                return builder.CreateXor(lhs, rhs);
+            case Tkn_EqualEqual:
+                return is_float ? builder.CreateFCmpOEQ(lhs, rhs) : builder.CreateICmpEQ(lhs, rhs);
+            case Tkn_BangEqual:
+                return is_float ? builder.CreateFCmpUNE(lhs, rhs) : builder.CreateICmpNE(lhs, rhs);
+            case Tkn_Less:
+                if(is_float)
+                    return builder.CreateFCmpOLT(lhs, rhs);
+                return is_signed ? builder.CreateICmpSLT(lhs, rhs) : builder.CreateICmpULT(lhs, rhs);
+            case Tkn_Greater:
+                if(is_float)
+                    return builder.CreateFCmpOGT(lhs, rhs);
+                return is_signed ? builder.CreateICmpSGT(lhs, rhs) : builder.CreateICmpUGT(lhs, rhs);
+            case Tkn_LessEqual:
+                if(is_float)
+                    return builder.CreateFCmpOLE(lhs, rhs);
+                return is_signed ? builder.CreateICmpSLE(lhs, rhs) : builder.CreateICmpULE(lhs, rhs);
+            case Tkn_GreaterEqual:
+                if(is_float)
+                    return builder.CreateFCmpOGE(lhs, rhs);
+                return is_signed ? builder.CreateICmpSGE(lhs, rhs) : builder.CreateICmpUGE(lhs, rhs);
+            default:
+                break;
+        }
+
+        report(position, "the operator '%s' can not be applied to '%s' at this time",
+               Token::get_string(op).c_str(), type->str().c_str());
+        return nullptr;
+    }
+
+    llvm::Value* CodeGen::emit_logical(ast::Binary* expr) {
+        auto is_and = expr->op == Tkn_And;
+
+        auto lhs = emit_expr(expr->lhs);
+        if(!lhs)
+            return nullptr;
+
+        // the right side is only evaluated when the left side doesn't decide the result.
+        auto lhs_block = builder.GetInsertBlock();
+        auto rhs_block = llvm::BasicBlock::Create(llvm_context, is_and ? "and.rhs" : "or.rhs", current_llvm_function);
+        auto end_block = llvm::BasicBlock::Create(llvm_context, is_and ? "and.end" : "or.end");
+
+        if(is_and)
+            builder.CreateCondBr(lhs, rhs_block, end_block);
+        else
+            builder.CreateCondBr(lhs, end_block, rhs_block);
+
+        builder.SetInsertPoint(rhs_block);
+        auto rhs = emit_expr(expr->rhs);
+        if(!rhs)
+            return nullptr;
+        auto rhs_end = builder.GetInsertBlock();
+        builder.CreateBr(end_block);
+
+        end_block->insertInto(current_llvm_function);
+        builder.SetInsertPoint(end_block);
+        auto phi = builder.CreatePHI(builder.getInt1Ty(), 2);
+        phi->addIncoming(builder.getInt1(!is_and), lhs_block);
+        phi->addIncoming(rhs, rhs_end);
+        return phi;
+    }
+
+    llvm::Value* CodeGen::emit_unary(ast::Unary* expr) {
+        if(expr->op == Tkn_Ampersand)
+            return emit_spilled_address(expr->expr);
+
+        auto value = emit_expr(expr->expr);
+        if(!value)
+            return nullptr;
+
+        auto type = strip(expr->expr->type);
+        switch(expr->op) {
+            case Tkn_Astrick:
+                return builder.CreateLoad(lower_type(expr->type), value);
+            case Tkn_Minus:
+                return type->is_float() ? builder.CreateFNeg(value) : builder.CreateNeg(value);
+            case Tkn_Tilde:
+                return builder.CreateNot(value);
+            case Tkn_Bang:
+                return type->is_ptr() ? builder.CreateIsNull(value) : builder.CreateNot(value);
+            default:
+                report(expr->pos(), "the operator '%s' can not be generated at this time",
+                       Token::get_string(expr->op).c_str());
+                return nullptr;
+        }
+    }
+
+    llvm::Value* CodeGen::emit_cast(ast::Expr* expr) {
+        auto operand = expr->as<ast::Cast>()->operand;
+        auto value = emit_expr(operand);
+        if(!value)
+            return nullptr;
+
+        auto from = strip(operand->type);
+        auto to = strip(expr->type);
+        auto lowered = lower_type(to);
+        if(to->is_bool()) {
+            // any value other than zero is true, a NaN included.
+            auto zero = llvm::Constant::getNullValue(value->getType());
+            return from->is_float() ? builder.CreateFCmpUNE(value, zero) : builder.CreateICmpNE(value, zero);
+        }
+
+        if(to->is_float()) {
+            if(from->is_float())
+                return builder.CreateFPCast(value, lowered);
+            return from->is_signed() ? builder.CreateSIToFP(value, lowered) : builder.CreateUIToFP(value, lowered);
+        }
+
+        if(from->is_float())
+            return to->is_signed() ? builder.CreateFPToSI(value, lowered) : builder.CreateFPToUI(value, lowered);
+        return builder.CreateIntCast(value, lowered, from->is_signed());
+    }
+
+    llvm::Value* CodeGen::emit_tuple(ast::TupleExpr* expr) {
+        llvm::Value* value = llvm::UndefValue::get(lower_type(expr->type));
+        for(u32 i = 0; i < expr->elements.size(); ++i) {
+            auto element = emit_expr(expr->elements[i]);
+            if(!element)
+                return nullptr;
+            value = builder.CreateInsertValue(value, element, {i});
+        }
+        return value;
+    }
+
+    llvm::Value* CodeGen::emit_struct(ast::StructExpr* expr) {
+        auto struct_type = strip(expr->type)->as<types::StructType>();
+        auto lowered = lower_type(struct_type);
+
+        // the members are given in order or by name.
+        std::vector<ast::ExprPtr> inits(struct_type->num_members(), nullptr);
+        for(u64 i = 0; i < expr->members.size() and i < inits.size(); ++i) {
+            auto member = expr->members[i];
+            if(member->kind == ast::ast_expr_binding) {
+                auto binding = member->as<ast::BindingExpr>();
+                auto [entity, found] = struct_type->get_scope()->find(binding->name);
+                if(found)
+                    inits[struct_type->get_index_of_member(entity)] = binding->expr;
+            }
+            else
+                inits[i] = member;
+        }
+
+        // the padding is zeroed.
+        llvm::Value* value = llvm::Constant::getNullValue(lowered);
+        for(u64 i = 0; i < inits.size(); ++i) {
+            auto member = struct_type->get_member(i)->as<Local>();
+            auto init = inits[i] ? inits[i] : default_member_init(member);
+            if(!init) {
+                report(expr->pos(), "member '%s' of '%s' isn't given a value",
+                       member->get_name()->value().c_str(), struct_type->get_name()->value().c_str());
+                return nullptr;
+            }
+
+            auto element = emit_expr(init);
+            if(!element)
+                return nullptr;
+            value = builder.CreateInsertValue(value, element, {fields[member]});
+        }
+        return value;
+    }
+
+    llvm::Value* CodeGen::emit_accessor(ast::Expr* expr) {
+        if(auto address = emit_address(expr))
+            return builder.CreateLoad(lower_type(expr->type), address);
+
+        // the operand is a value without storage, the member is taken out of it.
+        auto operand = expr->kind == ast::ast_accessor ? expr->as<ast::Accessor>()->operand :
+                       expr->as<ast::TupleAcessor>()->operand;
+        auto value = emit_expr(operand);
+        if(!value)
+            return nullptr;
+
+        lower_type(strip(operand->type));
+        if(expr->kind == ast::ast_tuple_accessor)
+            return builder.CreateExtractValue(value, {CAST(u32, expr->as<ast::TupleAcessor>()->value)});
+
+        auto member = expr->operand.entity;
+        if(!member or !member->is_local()) {
+            report(expr->pos(), "this member can not be generated at this time");
+            return nullptr;
+        }
+        return builder.CreateExtractValue(value, {fields[member]});
+    }
+
+    llvm::Value* CodeGen::emit_list(ast::List* expr) {
+        llvm::Value* value = llvm::UndefValue::get(lower_type(expr->type));
+        for(u32 i = 0; i < expr->elements.size(); ++i) {
+            auto element = emit_expr(expr->elements[i]);
+            if(!element)
+                return nullptr;
+            value = builder.CreateInsertValue(value, element, {i});
+        }
+        return value;
+    }
+
+    llvm::Value* CodeGen::emit_index(ast::Call* expr) {
+        auto base = emit_spilled_address(expr->name);
+        if(!base)
+            return nullptr;
+
+        auto address = emit_element_address(expr, base);
+        if(!address)
+            return nullptr;
+        return builder.CreateLoad(lower_type(expr->type), address);
+    }
+
+    llvm::Value* CodeGen::emit_element_address(ast::Call* expr, llvm::Value* base) {
+        auto array = strip(expr->name->type)->as<types::Array>();
+        auto index_expr = expr->actuals.front();
+
+        auto index = emit_expr(index_expr);
+        if(!index)
+            return nullptr;
+        index = strip(index_expr->type)->is_signed() ? builder.CreateSExt(index, builder.getInt64Ty()) :
+                builder.CreateZExt(index, builder.getInt64Ty());
+
+        // the typer checked a constant index.
+        if(!index_expr->operand.val.is_constant) {
+            auto in_bounds = builder.CreateICmpULT(index, builder.getInt64(array->num_elements()));
+            auto fail_block = llvm::BasicBlock::Create(llvm_context, "index.fail", current_llvm_function);
+            auto ok_block = llvm::BasicBlock::Create(llvm_context, "index.ok", current_llvm_function);
+            builder.CreateCondBr(in_bounds, ok_block, fail_block);
+
+            builder.SetInsertPoint(fail_block);
+            builder.CreateCall(llvm::Intrinsic::getDeclaration(module.get(), llvm::Intrinsic::trap));
+            builder.CreateUnreachable();
+            builder.SetInsertPoint(ok_block);
+        }
+
+        return builder.CreateInBoundsGEP(lower_type(array), base, {builder.getInt64(0), index});
+    }
+
+    llvm::Value* CodeGen::emit_call(ast::Call* expr) {
+        auto callee = expr->name->operand.entity;
+        if(callee and callee->is_function()) {
+            std::vector<llvm::Value*> args;
+            return emit_direct_call(callee->as<Function>(), args, expr->actuals, 0);
+        }
+
+        // a call through a function pointer.
+        auto type = strip(expr->name->type);
+        if(!type or type->kind() != types::FunctType) {
+            report(expr->pos(), "this call can not be generated at this time");
+            return nullptr;
+        }
+
+        auto fn_type = type->as<types::FunctionType>();
+        auto pointer = emit_expr(expr->name);
+        if(!pointer)
+            return nullptr;
+
+        std::vector<llvm::Value*> args;
+        for(auto actual : expr->actuals) {
+            auto arg = emit_expr(actual);
+            if(!arg)
+                return nullptr;
+            args.push_back(arg);
+        }
+
+        auto call = builder.CreateCall(lower_function_type(fn_type), pointer, args);
+        auto ret = fn_type->get_ret();
+        return (!ret or ret->is_unit()) ? unit_value() : call;
+    }
+
+    llvm::Value* CodeGen::emit_method(ast::Method* expr) {
+        auto callee = expr->name->operand.entity;
+        if(!callee or !callee->is_function()) {
+            report(expr->pos(), "this method call can not be generated at this time");
+            return nullptr;
+        }
+
+        // the receiver is passed by address, the first actual is the receiver or the type
+        // of a static method.
+        auto function = callee->as<Function>();
+        std::vector<llvm::Value*> args;
+        if(!function->is_static()) {
+            auto receiver = expr->actuals[0];
+            auto self = strip(receiver->type)->is_ptr() ? emit_expr(receiver) : emit_spilled_address(receiver);
+            if(!self)
+                return nullptr;
+            args.push_back(self);
+        }
+
+        return emit_direct_call(function, args, expr->actuals, 1);
+    }
+
+    llvm::Value* CodeGen::emit_direct_call(Function* function, std::vector<llvm::Value*>& args,
+                                           const ast::NodeList<ast::ExprPtr>& actuals, u64 first_actual) {
+        auto iter = functions.find(function);
+        if(iter == functions.end()) {
+            report(position, "'%s' can not be called, it wasn't generated", function->get_name()->value().c_str());
+            return nullptr;
+        }
+        auto llvm_function = iter->second;
+
+        auto actual = first_actual;
+        for(u64 i = args.size(); i < llvm_function->arg_size(); ++i, ++actual) {
+            ast::ExprPtr init = actual < actuals.size() ? actuals[actual] : nullptr;
+            if(!init) {
+                auto decl = function->get_param(i)->get_decl();
+                if(decl->kind == ast::ast_procedure_parameter)
+                    init = decl->as<ast::ProcedureParameter>()->init;
+            }
+
+            if(!init) {
+                report(position, "parameter '%s' of '%s' isn't given a value",
+                       function->get_param(i)->get_name()->value().c_str(), function->get_name()->value().c_str());
+                return nullptr;
+            }
+
+            auto arg = emit_expr(init);
+            if(!arg)
+                return nullptr;
+            args.push_back(arg);
+        }
+
+        // the rest are c variadic arguments, they are promoted like c does.
+        for(; actual < actuals.size(); ++actual) {
+            auto arg = emit_expr(actuals[actual]);
+            if(!arg)
+                return nullptr;
+
+            auto type = strip(actuals[actual]->type);
+            if(type->kind() == types::Primitive_Float32)
+                arg = builder.CreateFPExt(arg, builder.getDoubleTy());
+            else if(type->is_integer() and type->size() < 4)
+                arg = builder.CreateIntCast(arg, builder.getInt32Ty(), type->is_signed());
+            args.push_back(arg);
+        }
+
+        auto call = builder.CreateCall(llvm_function, args);
+        auto ret = function->get_ret_type();
+        return (!ret or ret->is_unit()) ? unit_value() : call;
+    }
+
+    llvm::Value* CodeGen::emit_block(ast::Block* expr) {
+        llvm::Value* value = unit_value();
+        for(auto stmt : expr->elements) {
+            switch(stmt->kind) {
+                case ast::ast_expr:
+                    value = emit_expr(stmt->as<ast::ExprStmt>()->expr);
+                    if(!value)
+                        return nullptr;
+                    break;
+                case ast::ast_decl: {
+                    auto decl = stmt->as<ast::DeclStmt>()->decl;
+                    if(decl->kind != ast::ast_local and decl->kind != ast::ast_mutable) {
+                        report(decl->pos(), "this declaration can not be generated at this time");
+                        return nullptr;
+                    }
+                    if(!emit_local(decl))
+                        return nullptr;
+                    value = unit_value();
+                } break;
+                default:
+                    break;
+            }
+        }
+        return value;
+    }
+
+    llvm::Value* CodeGen::emit_if(ast::If* expr) {
+        auto cond = emit_expr(expr->cond);
+        if(!cond)
+            return nullptr;
+
+        auto then_block = llvm::BasicBlock::Create(llvm_context, "if.then", current_llvm_function);
+        auto else_block = expr->else_if ? llvm::BasicBlock::Create(llvm_context, "if.else") : nullptr;
+        auto end_block = llvm::BasicBlock::Create(llvm_context, "if.end");
+        builder.CreateCondBr(cond, then_block, else_block ? else_block : end_block);
+
+        builder.SetInsertPoint(then_block);
+        auto then_value = emit_expr(expr->body);
+        if(!then_value)
+            return nullptr;
+        auto then_end = builder.GetInsertBlock();
+        builder.CreateBr(end_block);
+
+        llvm::Value* else_value = nullptr;
+        llvm::BasicBlock* else_end = nullptr;
+        if(else_block) {
+            else_block->insertInto(current_llvm_function);
+            builder.SetInsertPoint(else_block);
+            else_value = emit_expr(expr->else_if);
+            if(!else_value)
+                return nullptr;
+            else_end = builder.GetInsertBlock();
+            builder.CreateBr(end_block);
+        }
+
+        end_block->insertInto(current_llvm_function);
+        builder.SetInsertPoint(end_block);
+
+        auto type = strip(expr->type);
+        if(!else_block or !type or type->is_unit())
+            return unit_value();
+
+        auto phi = builder.CreatePHI(lower_type(type), 2, "if.value");
+        phi->addIncoming(then_value, then_end);
+        phi->addIncoming(else_value, else_end);
+        return phi;
+    }
+
+    llvm::Value* CodeGen::emit_while(ast::While* expr) {
+        auto cond_block = llvm::BasicBlock::Create(llvm_context, "while.cond", current_llvm_function);
+        auto body_block = llvm::BasicBlock::Create(llvm_context, "while.body");
+        auto end_block = llvm::BasicBlock::Create(llvm_context, "while.end");
+
+        builder.CreateBr(cond_block);
+        builder.SetInsertPoint(cond_block);
+        auto cond = emit_expr(expr->cond);
+        if(!cond)
+            return nullptr;
+        builder.CreateCondBr(cond, body_block, end_block);
+
+        body_block->insertInto(current_llvm_function);
+        builder.SetInsertPoint(body_block);
+        if(!emit_expr(expr->body))
+            return nullptr;
+        builder.CreateBr(cond_block);
+
+        end_block->insertInto(current_llvm_function);
+        builder.SetInsertPoint(end_block);
+        return unit_value();
+    }
+
+    llvm::Value* CodeGen::emit_for(ast::For* expr) {
+        auto range = expr->expr->as<ast::Range>();
+        auto type = strip(range->type);
+        auto lowered = lower_type(type);
+
+        // the bounds are evaluated once, before the first iteration.
+        auto start = emit_expr(range->start);
+        if(!start)
+            return nullptr;
+        auto end = emit_expr(range->end);
+        if(!end)
+            return nullptr;
+        auto step = range->step ? emit_expr(range->step) : llvm::ConstantInt::get(lowered, 1);
+        if(!step)
+            return nullptr;
+
+        auto entry_block = builder.GetInsertBlock();
+        auto cond_block = llvm::BasicBlock::Create(llvm_context, "for.cond", current_llvm_function);
+        auto body_block = llvm::BasicBlock::Create(llvm_context, "for.body");
+        auto end_block = llvm::BasicBlock::Create(llvm_context, "for.end");
+
+        builder.CreateBr(cond_block);
+        builder.SetInsertPoint(cond_block);
+        auto counter = builder.CreatePHI(lowered, 2, "for.counter");
+        counter->addIncoming(start, entry_block);
+        auto cond = type->is_signed() ? builder.CreateICmpSLT(counter, end) : builder.CreateICmpULT(counter, end);
+        builder.CreateCondBr(cond, body_block, end_block);
+
+        body_block->insertInto(current_llvm_function);
+        builder.SetInsertPoint(body_block);
+        if(!bind_pattern(expr->pattern, counter, type, nullptr))
+            return nullptr;
+        if(!emit_expr(expr->body))
+            return nullptr;
+
+        // the counter wraps like any other integer of its type.
+        counter->addIncoming(builder.CreateAdd(counter, step, "for.next"), builder.GetInsertBlock());
+        builder.CreateBr(cond_block);
+
+        end_block->insertInto(current_llvm_function);
+        builder.SetInsertPoint(end_block);
+        return unit_value();
+    }
+
+    llvm::Value* CodeGen::emit_match(ast::Match* expr) {
+        auto value = emit_expr(expr->cond);
+        if(!value)
+            return nullptr;
+
+        auto cond_type = strip(expr->cond->type);
+        auto type = strip(expr->type);
+        auto has_value = type and !type->is_unit();
+
+        // the arms are tested in order, an arm with alternatives matches if any of them do.
+        auto end_block = llvm::BasicBlock::Create(llvm_context, "match.end");
+        std::vector<std::pair<llvm::Value*, llvm::BasicBlock*>> values;
+        bool exhaustive = false;
+        for(auto member : expr->members) {
+            auto arm = member->as<ast::MatchArm>();
+
+            llvm::Value* test = nullptr;
+            bool always = false;
+            for(auto pattern : arm->patterns) {
+                auto pattern_test = emit_pattern_test(pattern, value, cond_type);
+                if(!pattern_test) {
+                    if(has_error())
+                        return nullptr;
+                    always = true;
+                    break;
+                }
+                test = test ? builder.CreateOr(test, pattern_test) : pattern_test;
+            }
+
+            auto arm_block = llvm::BasicBlock::Create(llvm_context, "match.arm", current_llvm_function);
+            auto next_block = always ? nullptr : llvm::BasicBlock::Create(llvm_context, "match.next");
+            if(always)
+                builder.CreateBr(arm_block);
+            else
+                builder.CreateCondBr(test, arm_block, next_block);
+
+            builder.SetInsertPoint(arm_block);
+            for(auto pattern : arm->patterns)
+                if(pattern->kind == ast::ast_ident_pattern and !bind_pattern(pattern, value, cond_type, nullptr))
+                    return nullptr;
+
+            auto arm_value = emit_expr(arm->body);
+            if(!arm_value)
+                return nullptr;
+
+            // an arm that returns leaves a dead block behind, its value is never used.
+            if(has_value and arm_value->getType() != lower_type(type))
+                arm_value = llvm::UndefValue::get(lower_type(type));
+            values.emplace_back(arm_value, builder.GetInsertBlock());
+            builder.CreateBr(end_block);
+
+            // the arms after one that always matches are never reached.
+            if(always) {
+                exhaustive = true;
+                break;
+            }
+
+            next_block->insertInto(current_llvm_function);
+            builder.SetInsertPoint(next_block);
+        }
+
+        // a match with a value has a default arm so nothing falls through.
+        if(!exhaustive) {
+            if(has_value)
+                builder.CreateUnreachable();
+            else
+                builder.CreateBr(end_block);
+        }
+
+        end_block->insertInto(current_llvm_function);
+        builder.SetInsertPoint(end_block);
+        if(!has_value)
+            return unit_value();
+
+        auto phi = builder.CreatePHI(lower_type(type), values.size(), "match.value");
+        for(auto [arm_value, block] : values)
+            phi->addIncoming(arm_value, block);
+        return phi;
+    }
+
+    llvm::Value* CodeGen::emit_pattern_test(ast::Pattern* pattern, llvm::Value* value, types::Type* type) {
+        auto lowered = value->getType();
+        i64 literal = 0;
+        if(pattern_value(pattern, literal))
+            return builder.CreateICmpEQ(value, llvm::ConstantInt::get(lowered, literal, true));
+
+        switch(pattern->kind) {
+            case ast::ast_range_pattern: {
+                // a range includes both of its bounds.
+                auto range = pattern->as<ast::RangePattern>();
+                i64 start = 0, end = 0;
+                if(!pattern_value(range->start, start) or !pattern_value(range->end, end))
+                    break;
+
+                auto lower = llvm::ConstantInt::get(lowered, start, true);
+                auto upper = llvm::ConstantInt::get(lowered, end, true);
+                if(type->is_signed())
+                    return builder.CreateAnd(builder.CreateICmpSGE(value, lower), builder.CreateICmpSLE(value, upper));
+                return builder.CreateAnd(builder.CreateICmpUGE(value, lower), builder.CreateICmpULE(value, upper));
+            }
+            case ast::ast_ignore_pattern:
+            case ast::ast_ident_pattern:
+                return nullptr;
+            default:
+                break;
+        }
+
+        report(pattern->pos(), "this pattern can not be generated at this time");
+        return nullptr;
+    }
+
+    llvm::Value* CodeGen::emit_return(ast::Return* expr) {
+        llvm::Value* value = nullptr;
+        if(expr->body) {
+            value = emit_expr(expr->body);
+            if(!value)
+                return nullptr;
+        }
+
+        auto ret = current_function->get_ret_type();
+        if(!ret or ret->is_unit()) {
+            if(current_is_main)
+                builder.CreateRet(builder.getInt32(0));
+            else
+                builder.CreateRetVoid();
+        }
+        else
+            builder.CreateRet(value);
+
+        // anything after the return is dead, it is generated into a block that is removed later.
+        builder.SetInsertPoint(llvm::BasicBlock::Create(llvm_context, "return.dead", current_llvm_function));
+        return unit_value();
+    }
+
+    llvm::Value* CodeGen::emit_assign(ast::Assign* expr) {
+        auto address = emit_address(expr->lvalue);
+        if(!address) {
+            report(expr->lvalue->pos(), "this expression can not be assigned at this time");
+            return nullptr;
+        }
+
+        auto value = emit_expr(expr->rvalue);
+        if(!value)
+            return nullptr;
+
+        if(expr->op != Tkn_Equal) {
+            auto type = expr->lvalue->type;
+            auto current = builder.CreateLoad(lower_type(type), address);
+            position = expr->pos();
+            if(strip(type)->is_array())
+                value = emit_elements(compound_operator(expr->op), current, type, value, expr->rvalue->type);
+            else
+                value = emit_binary_op(compound_operator(expr->op), current, value, type);
+            if(!value)
+                return nullptr;
+        }
+
+        builder.CreateStore(value, address);
+        return unit_value();
+    }
+
+    bool CodeGen::emit_local(ast::DeclPtr decl) {
+        ast::PatternPtr pattern = nullptr;
+        ast::ExprPtr init = nullptr;
+        if(decl->kind == ast::ast_mutable) {
+            pattern = decl->as<ast::Mutable>()->names;
+            init = decl->as<ast::Mutable>()->init;
+        }
+        else {
+            pattern = decl->as<ast::Local>()->names;
+            init = decl->as<ast::Local>()->init;
+        }
+
+        // without a value the storage is created the first time the local is used.
+        if(!init)
+            return true;
+
+        auto value = emit_expr(init);
+        if(!value)
+            return false;
+        return bind_pattern(pattern, value, init->type, decl);
+    }
+
+    bool CodeGen::bind_pattern(ast::Pattern* pattern, llvm::Value* value, types::Type* type, ast::DeclPtr decl) {
+        switch(pattern->kind) {
+            case ast::ast_ident_pattern: {
+                // the copies of an unrolled loop body bind the local of the original declaration.
+                auto ident = pattern->as<ast::IdentPattern>();
+                auto name = ident->name;
+                auto slot = create_slot(type, name->value());
+                builder.CreateStore(value, slot);
+                locals[{ident->entity ? ident->entity->get_decl() : decl, name->val}] = slot;
+                return true;
+            }
+            case ast::ast_tuple_desc: {
+                auto tuple = strip(type)->as<types::Tuple>();
+                auto& patterns = pattern->as<ast::TuplePattern>()->patterns;
+                for(u32 i = 0; i < patterns.size(); ++i)
+                    if(!bind_pattern(patterns[i], builder.CreateExtractValue(value, {i}), tuple->get_element_type(i), decl))
+                        return false;
+                return true;
+            }
+            case ast::ast_ignore_pattern:
+                return true;
+            default:
+                report(pattern->pos(), "this pattern can not be generated at this time");
+                return false;
+        }
+    }
+
+    void CodeGen::remove_dead_blocks(llvm::Function* function) {
+        std::unordered_set<llvm::BasicBlock*> reachable;
+        std::vector<llvm::BasicBlock*> work = {&function->getEntryBlock()};
+        while(!work.empty()) {
+            auto block = work.back();
+            work.pop_back();
+            if(!reachable.insert(block).second)
+                continue;
+
+            if(auto terminator = block->getTerminator())
+                for(u32 i = 0; i < terminator->getNumSuccessors(); ++i)
+                    work.push_back(terminator->getSuccessor(i));
+        }
+
+        std::vector<llvm::BasicBlock*> dead;
+        for(auto& block : *function)
+            if(!reachable.count(&block))
+                dead.push_back(&block);
+
+        // the phis of the reachable blocks can't refer to a dead block.
+        for(auto block : dead)
+            if(auto terminator = block->getTerminator())
+                for(u32 i = 0; i < terminator->getNumSuccessors(); ++i)
+                    terminator->getSuccessor(i)->removePredecessor(block);
+
+        for(auto block : dead)
+            block->dropAllReferences();
+        for(auto block : dead)
+            block->eraseFromParent();
+    }
+}
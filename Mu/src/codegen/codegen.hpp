@@ -0,0 +1,206 @@
+#ifndef MU_CODEGEN_HPP
+#define MU_CODEGEN_HPP
+
+#include "common.hpp"
+#include "interpreter.hpp"
+
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include <map>
+#include <memory>
+#include <ostream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mu {
+
+    // Lowers a resolved module to LLVM IR.
+    //
+    // Nothing is resolved here, the lowering reads the types and operands the Typer
+    // left on the ast and the entities of the module. Everything that can't be lowered
+    // yet is reported as an error instead of guessing.
+    class CodeGen {
+    public:
+        CodeGen(Interpreter* interp);
+        ~CodeGen();
+
+        // builds the llvm module from the top level entities of a resolved module.
+        // Returns false if it failed, the errors have been reported.
+        //
+        // When only is given just the bodies of those functions are generated, the other
+        // functions are declared so the module can be linked against code generated before.
+        // The globals are then internal, every module has its own copy.
+        bool generate(ast::ModuleFile* module, const std::vector<Entity*>& entities,
+                      const std::unordered_set<Function*>* only = nullptr);
+
+        // adds 'void name(i64* args, i64* results)' which calls function with its arguments
+        // and results flattened into 64 bit slots, the way the vm stores values. It is how
+        // the interpreter calls generated code. Returns false if it failed.
+        bool generate_entry(Function* function, const std::string& name);
+
+        // prints the IR of the generated module.
+        void print(std::ostream& out);
+
+        // writes the generated module as an object file of the host.
+        bool emit_object(const std::string& path);
+
+        // gives up the generated module and its context, nothing can be generated afterwards.
+        llvm::orc::ThreadSafeModule take_module();
+
+        inline bool has_error() { return errors_num > 0; }
+
+    private:
+        /*-----------------------------Types------------------------------*/
+        llvm::Type* lower_type(types::Type* type);
+
+        // structs are packed with explicit padding so the members are at the offsets
+        // given by Typer::construct_member_order.
+        llvm::Type* lower_struct(types::StructType* type);
+
+        llvm::FunctionType* lower_function_type(types::FunctionType* type, bool is_main = false, bool is_variadic = false);
+
+        llvm::Value* unit_value();
+
+        /*---------------------------Entities-----------------------------*/
+        llvm::Function* declare_function(Function* function, const std::string& name);
+
+        void define_function(Function* function);
+
+        void declare_global(Global* global);
+
+        // builds a value of type from the slots starting at index, index is moved past them.
+        llvm::Value* load_slots(types::Type* type, llvm::Value* slots, u32& index);
+
+        void store_slots(types::Type* type, llvm::Value* value, llvm::Value* slots, u32& index);
+
+        // the storage of a local, it is created the first time it is needed.
+        llvm::Value* local_slot(Local* local);
+
+        // creates storage in the entry block of the current function.
+        llvm::AllocaInst* create_slot(types::Type* type, const std::string& name);
+
+        /*--------------------------Expressions---------------------------*/
+        llvm::Value* emit_expr(ast::Expr* expr);
+
+        // the address of an expression that has storage, null if it doesn't have any.
+        llvm::Value* emit_address(ast::Expr* expr);
+
+        // the address of the expression, rvalues are stored to a temporary first.
+        llvm::Value* emit_spilled_address(ast::Expr* expr);
+
+        llvm::Value* emit_constant(const Val& val, types::Type* type);
+
+        llvm::Value* emit_name(ast::Expr* expr);
+
+        llvm::Value* emit_binary(ast::Binary* expr);
+
+        llvm::Value* emit_binary_op(TokenKind op, llvm::Value* lhs, llvm::Value* rhs, types::Type* type);
+
+        // an element-wise operation on arrays, one side can be a scalar of the element type.
+        // It is lowered to vector instructions.
+        llvm::Value* emit_elements(TokenKind op, llvm::Value* lhs, types::Type* lhs_type,
+                                   llvm::Value* rhs, types::Type* rhs_type);
+
+        llvm::Value* emit_logical(ast::Binary* expr);
+
+        llvm::Value* emit_unary(ast::Unary* expr);
+
+        // 'x as T', the conversions are the same as C's.
+        llvm::Value* emit_cast(ast::Expr* expr);
+
+        llvm::Value* emit_tuple(ast::TupleExpr* expr);
+
+        llvm::Value* emit_struct(ast::StructExpr* expr);
+
+        llvm::Value* emit_accessor(ast::Expr* expr);
+
+        llvm::Value* emit_list(ast::List* expr);
+
+        // an element of an array, 'v(i)'.
+        llvm::Value* emit_index(ast::Call* expr);
+
+        // the address of an element of the array at base. An index that isn't a constant
+        // is checked against the length, the program traps when it is out of bounds.
+        llvm::Value* emit_element_address(ast::Call* expr, llvm::Value* base);
+
+        llvm::Value* emit_call(ast::Call* expr);
+
+        llvm::Value* emit_method(ast::Method* expr);
+
+        // calls function with the given arguments, the missing parameters are given their default value.
+        llvm::Value* emit_direct_call(Function* function, std::vector<llvm::Value*>& args,
+                                      const ast::NodeList<ast::ExprPtr>& actuals, u64 first_actual);
+
+        llvm::Value* emit_block(ast::Block* expr);
+
+        llvm::Value* emit_if(ast::If* expr);
+
+        llvm::Value* emit_while(ast::While* expr);
+
+        // a loop over a range, the counter is a phi and the pattern is bound to it in every iteration.
+        llvm::Value* emit_for(ast::For* expr);
+
+        // the arms are tested in order by a chain of comparisons.
+        llvm::Value* emit_match(ast::Match* expr);
+
+        // the condition a pattern matches value under, null when it always matches.
+        llvm::Value* emit_pattern_test(ast::Pattern* pattern, llvm::Value* value, types::Type* type);
+
+        llvm::Value* emit_return(ast::Return* expr);
+
+        llvm::Value* emit_assign(ast::Assign* expr);
+
+        bool emit_local(ast::DeclPtr decl);
+
+        // binds the names of a pattern to the parts of value.
+        bool bind_pattern(ast::Pattern* pattern, llvm::Value* value, types::Type* type, ast::DeclPtr decl);
+
+        // removes the blocks that can't be reached, they are left behind by return.
+        void remove_dead_blocks(llvm::Function* function);
+
+        template <typename... Args>
+        void report(const mu::Pos& pos, const std::string& fmt, Args... args) {
+            interp->report_error(pos, fmt, args...);
+            errors_num++;
+        }
+
+        Interpreter* interp{nullptr};
+
+        // the context is owned separately so it can be handed to the jit with the module.
+        std::unique_ptr<llvm::LLVMContext> context;
+        llvm::LLVMContext& llvm_context;
+        std::unique_ptr<llvm::Module> module;
+        std::unique_ptr<llvm::TargetMachine> machine;
+        llvm::IRBuilder<> builder;
+
+        std::unordered_map<types::Type*, llvm::Type*> lowered_types;
+
+        // the index of a struct member in the lowered struct, padding is not a member.
+        std::unordered_map<Entity*, u32> fields;
+
+        std::unordered_map<Function*, llvm::Function*> functions;
+        std::unordered_map<Global*, llvm::GlobalVariable*> globals;
+
+        // the storage of the locals of the current function. A local is known by its
+        // declaration and name because a pattern declares many locals.
+        std::map<std::pair<ast::AstNode*, Atom*>, llvm::Value*> locals;
+
+        // the globals are internal when only part of the module is generated.
+        bool internal_globals{false};
+
+        Function* current_function{nullptr};
+        llvm::Function* current_llvm_function{nullptr};
+        bool current_is_main{false};
+
+        // the position of the expression being lowered, used for errors.
+        mu::Pos position;
+
+        u32 errors_num{0};
+    };
+}
+
+#endif //MU_CODEGEN_HPP
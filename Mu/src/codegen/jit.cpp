@@ -0,0 +1,82 @@
+#include "jit.hpp"
+
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/Support/TargetSelect.h>
+
+#include <cstdio>
+#include <iostream>
+
+namespace mu {
+
+    Jit::Jit(Interpreter* interp) : interp(interp) {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+
+        auto created = llvm::orc::LLLazyJITBuilder().create();
+        if(!created) {
+            check(created.takeError(), "create the jit");
+            return;
+        }
+        jit = std::move(*created);
+
+        auto prefix = jit->getDataLayout().getGlobalPrefix();
+        auto process = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(prefix);
+        if(!process) {
+            check(process.takeError(), "search the process for symbols");
+            jit.reset();
+            return;
+        }
+        jit->getMainJITDylib().addGenerator(std::move(*process));
+    }
+
+    Jit::~Jit() = default;
+
+    bool Jit::add(llvm::orc::ThreadSafeModule module, bool lazy) {
+        if(!jit)
+            return false;
+
+        // the data layout of the jit is used, the generated one is for the object file.
+        module.withModuleDo([this](llvm::Module& m) { m.setDataLayout(jit->getDataLayout()); });
+        if(lazy)
+            return check(jit->addLazyIRModule(std::move(module)), "add the module to the jit");
+        return check(jit->addIRModule(std::move(module)), "add the module to the jit");
+    }
+
+    void* Jit::lookup(const std::string& name) {
+        if(!jit)
+            return nullptr;
+
+        auto symbol = jit->lookup(name);
+        if(!symbol) {
+            check(symbol.takeError(), ("find '" + name + "'").c_str());
+            return nullptr;
+        }
+        return llvm::jitTargetAddressToPointer<void*>(symbol->getAddress());
+    }
+
+    bool Jit::run_main(i32& exit_code) {
+        if(!jit)
+            return false;
+
+        auto symbol = jit->lookup("main");
+        if(!symbol)
+            return check(symbol.takeError(), "find main");
+
+        // the program writes to the same stdout as the compiler.
+        interp->out_stream().flush();
+
+        auto main = llvm::jitTargetAddressToFunction<i32 (*)()>(symbol->getAddress());
+        exit_code = main();
+
+        std::fflush(stdout);
+        return true;
+    }
+
+    bool Jit::check(llvm::Error error, const char* action) {
+        if(!error)
+            return true;
+
+        interp->message("Unable to %s: %s", action, llvm::toString(std::move(error)).c_str());
+        return false;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef MU_JIT_HPP
+#define MU_JIT_HPP
+
+#include "common.hpp"
+#include "interpreter.hpp"
+
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+
+#include <memory>
+
+namespace mu {
+
+    // Runs generated modules in the process of the compiler.
+    //
+    // A function is only compiled the first time it is called, so a program only pays
+    // for the functions it runs. Symbols that aren't defined by a module, such as the
+    // foreign functions, are looked up in the process.
+    class Jit {
+    public:
+        Jit(Interpreter* interp);
+        ~Jit();
+
+        // returns false if the module couldn't be added, the error has been reported.
+        // A module that isn't lazy is compiled whole the first time one of its symbols
+        // is looked up, on the thread looking it up.
+        bool add(llvm::orc::ThreadSafeModule module, bool lazy = true);
+
+        // the address of a symbol of the added modules, nullptr if it couldn't be found.
+        void* lookup(const std::string& name);
+
+        // calls the main of the added modules, exit_code is set to what it returns.
+        bool run_main(i32& exit_code);
+
+    private:
+        // reports the error if there is one, returns true if there wasn't.
+        bool check(llvm::Error error, const char* action);
+
+        Interpreter* interp{nullptr};
+        std::unique_ptr<llvm::orc::LLLazyJIT> jit;
+    };
+}
+
+#endif //MU_JIT_HPP
@@ -0,0 +1,355 @@
+#include "tiered.hpp"
+#include "codegen/codegen.hpp"
+#include "codegen/jit.hpp"
+#include "analysis/types/type.hpp"
+#include "parser/ast/ast_common.hpp"
+
+#include <sstream>
+
+static ast::ExprPtr accessor_operand(ast::Expr* expr) {
+    return expr->kind == ast::ast_accessor ? expr->as<ast::Accessor>()->operand :
+           expr->as<ast::TupleAcessor>()->operand;
+}
+
+// the first line of the diagnostics of a failed compile, without the colors.
+static std::string first_line(const std::string& text) {
+    std::string line;
+    for(u64 i = 0; i < text.size(); ++i) {
+        if(text[i] == '\033') {
+            while(i < text.size() and text[i] != 'm')
+                ++i;
+            continue;
+        }
+
+        if(text[i] == '\n') {
+            if(!line.empty())
+                break;
+            continue;
+        }
+
+        if(!line.empty() or (text[i] != '\t' and text[i] != ' '))
+            line.push_back(text[i]);
+    }
+    return line.empty() ? "unknown error" : line;
+}
+
+namespace mu {
+    namespace exec {
+
+        TieredEngine::TieredEngine(Interpreter *interp, ast::ModuleFile *module, const std::vector<Entity *> &entities,
+                                   u64 threshold) : interp(interp), module(module), entities(entities),
+                                   threshold(std::max<u64>(threshold, 1)), jit(std::make_unique<Jit>(interp)) {
+            // the functions are named the way the code generator names them.
+            for(auto entity : entities) {
+                if(!entity or !entity->is_resolved())
+                    continue;
+
+                if(entity->kind() == FunctionEntity) {
+                    auto function = entity->as<mu::Function>();
+                    tiers[function].name = function->get_name()->value();
+                    order.push_back(function);
+                }
+                else if(entity->kind() == TypeEntity and entity->as<Type>()->is_struct()) {
+                    auto type = entity->as<Type>();
+                    auto scope = type->get_type()->as<types::StructType>()->get_scope();
+                    for(auto block : type->get_impls()) {
+                        for(auto decl : block->as<ast::Impl>()->methods) {
+                            if(decl->kind != ast::ast_procedure)
+                                continue;
+
+                            auto [member, found] = scope->find(decl->as<ast::Procedure>()->name);
+                            if(!found or !member->is_function() or !member->is_resolved())
+                                continue;
+
+                            auto method = member->as<mu::Function>();
+                            tiers[method].name = type->get_name()->value() + "." + member->get_name()->value();
+                            order.push_back(method);
+                        }
+                    }
+                }
+            }
+
+            for(auto function : order)
+                if(!function->is_foreign() and !function->no_body())
+                    collect_uses(function->get_decl()->as<ast::Procedure>()->body, function);
+
+            for(auto function : order)
+                check_promotable(function, tiers[function]);
+        }
+
+        TieredEngine::~TieredEngine() {
+            pool.wait();
+        }
+
+        TieredEngine::NativeEntry TieredEngine::enter(mu::Function *function) {
+            auto iter = tiers.find(function);
+            if(iter == tiers.end())
+                return nullptr;
+
+            auto& tier = iter->second;
+            if(auto entry = tier.entry.load(std::memory_order_acquire)) {
+                if(tier.shown != Native)
+                    poll(function, tier);
+                tier.native_calls++;
+                return entry;
+            }
+
+            promote(function, tier);
+            return nullptr;
+        }
+
+        void TieredEngine::back_edge(mu::Function *function) {
+            auto iter = tiers.find(function);
+            if(iter != tiers.end())
+                promote(function, iter->second);
+        }
+
+        void TieredEngine::summary() {
+            interp->message("tier: %-24s %12s %8s %16s %11s", "function", "interpreted", "native",
+                            "loop iterations", "compile ms");
+            for(auto function : order) {
+                auto& tier = tiers[function];
+                if(function->get_invocations() == 0)
+                    continue;
+
+                auto compile_ms = tier.status.load(std::memory_order_acquire) == Native ?
+                                  Interpreter::format("%.2f", tier.compile_ms) : std::string("-");
+                interp->message("tier: %-24s %12lu %8lu %16lu %11s", tier.name.c_str(),
+                                function->get_invocations() - tier.native_calls, tier.native_calls,
+                                function->get_back_edges(), compile_ms.c_str());
+            }
+        }
+
+        void TieredEngine::collect_uses(ast::Expr *expr, mu::Function *function) {
+            if(!expr)
+                return;
+
+            switch(expr->kind) {
+                case ast::ast_name: {
+                    auto entity = expr->operand.entity;
+                    if(entity and entity->is_global() and entity->as<Global>()->is_mutable())
+                        mutable_globals.emplace(function, entity->as<Global>());
+                } break;
+                case ast::ast_binary:
+                    collect_uses(expr->as<ast::Binary>()->lhs, function);
+                    collect_uses(expr->as<ast::Binary>()->rhs, function);
+                    break;
+                case ast::ast_unary:
+                    collect_uses(expr->as<ast::Unary>()->expr, function);
+                    break;
+                case ast::ast_cast_expr:
+                    collect_uses(expr->as<ast::Cast>()->operand, function);
+                    break;
+                case ast::ast_tuple_expr:
+                    for(auto element : expr->as<ast::TupleExpr>()->elements)
+                        collect_uses(element, function);
+                    break;
+                case ast::ast_struct_expr:
+                    for(auto member : expr->as<ast::StructExpr>()->members)
+                        collect_uses(member->kind == ast::ast_expr_binding ? member->as<ast::BindingExpr>()->expr : member,
+                                     function);
+                    break;
+                case ast::ast_accessor:
+                case ast::ast_tuple_accessor:
+                    collect_uses(accessor_operand(expr), function);
+                    break;
+                case ast::ast_call:
+                case ast::ast_method: {
+                    auto name = expr->kind == ast::ast_call ? expr->as<ast::Call>()->name : expr->as<ast::Method>()->name;
+                    auto callee = name->operand.entity;
+                    if(callee and callee->is_function())
+                        callees[function].insert(callee->as<mu::Function>());
+
+                    auto& actuals = expr->kind == ast::ast_call ? expr->as<ast::Call>()->actuals :
+                                    expr->as<ast::Method>()->actuals;
+                    for(auto actual : actuals)
+                        collect_uses(actual, function);
+                } break;
+                case ast::ast_block:
+                    for(auto stmt : expr->as<ast::Block>()->elements) {
+                        if(stmt->kind == ast::ast_expr)
+                            collect_uses(stmt->as<ast::ExprStmt>()->expr, function);
+                        else if(stmt->kind == ast::ast_decl) {
+                            auto decl = stmt->as<ast::DeclStmt>()->decl;
+                            if(decl->kind == ast::ast_local)
+                                collect_uses(decl->as<ast::Local>()->init, function);
+                            else if(decl->kind == ast::ast_mutable)
+                                collect_uses(decl->as<ast::Mutable>()->init, function);
+                        }
+                    }
+                    break;
+                case ast::ast_if_expr:
+                    collect_uses(expr->as<ast::If>()->cond, function);
+                    collect_uses(expr->as<ast::If>()->body, function);
+                    collect_uses(expr->as<ast::If>()->else_if, function);
+                    break;
+                case ast::ast_while_expr:
+                    collect_uses(expr->as<ast::While>()->cond, function);
+                    collect_uses(expr->as<ast::While>()->body, function);
+                    break;
+                case ast::ast_for_expr:
+                    collect_uses(expr->as<ast::For>()->expr, function);
+                    collect_uses(expr->as<ast::For>()->body, function);
+                    break;
+                case ast::ast_range:
+                    collect_uses(expr->as<ast::Range>()->start, function);
+                    collect_uses(expr->as<ast::Range>()->end, function);
+                    collect_uses(expr->as<ast::Range>()->step, function);
+                    break;
+                case ast::ast_match_expr:
+                    collect_uses(expr->as<ast::Match>()->cond, function);
+                    for(auto member : expr->as<ast::Match>()->members)
+                        collect_uses(member->as<ast::MatchArm>()->body, function);
+                    break;
+                case ast::ast_defer_expr:
+                    collect_uses(expr->as<ast::Defer>()->body, function);
+                    break;
+                case ast::ast_return:
+                    collect_uses(expr->as<ast::Return>()->body, function);
+                    break;
+                case ast::ast_assign:
+                    collect_uses(expr->as<ast::Assign>()->lvalue, function);
+                    collect_uses(expr->as<ast::Assign>()->rvalue, function);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        std::vector<mu::Function*> TieredEngine::closure(mu::Function *function) {
+            std::vector<mu::Function*> reached = {function};
+            std::unordered_set<mu::Function*> seen = {function};
+            for(u64 i = 0; i < reached.size(); ++i) {
+                auto iter = callees.find(reached[i]);
+                if(iter == callees.end())
+                    continue;
+
+                for(auto callee : iter->second)
+                    if(seen.insert(callee).second)
+                        reached.push_back(callee);
+            }
+            return reached;
+        }
+
+        void TieredEngine::check_promotable(mu::Function *function, Tier &tier) {
+            tier.promotable = false;
+
+            // there is no way to move a running call to native code.
+            if(tier.name == "main") {
+                tier.reason = "main is already running when it is hot";
+                return;
+            }
+
+            if(function->is_foreign() or function->no_body()) {
+                tier.reason = "it doesn't have a body";
+                return;
+            }
+
+            // the native code is passed values, not pointers into the interpreter's stack.
+            for(u64 i = 0; i < function->num_params(); ++i) {
+                if(vm::num_registers(function->get_param(i)->get_type()) < 0) {
+                    tier.reason = "its parameters can't be passed to native code";
+                    return;
+                }
+            }
+
+            auto ret = function->get_ret_type();
+            if(ret and vm::num_registers(ret) < 0) {
+                tier.reason = "its result can't be returned from native code";
+                return;
+            }
+
+            // the native code has its own copy of the globals.
+            for(auto callee : closure(function)) {
+                auto iter = mutable_globals.find(callee);
+                if(iter != mutable_globals.end()) {
+                    tier.reason = Interpreter::format("'%s' uses the mutable global '%s'", callee->get_name()->value().c_str(),
+                                         iter->second->get_name()->value().c_str());
+                    return;
+                }
+            }
+
+            tier.promotable = true;
+        }
+
+        void TieredEngine::promote(mu::Function *function, Tier &tier) {
+            if(tier.status.load(std::memory_order_acquire) != Interpreted) {
+                poll(function, tier);
+                return;
+            }
+
+            auto invocations = function->get_invocations();
+            auto back_edges = function->get_back_edges();
+            if(invocations + back_edges < threshold or tier.shown_cold)
+                return;
+
+            if(!tier.promotable) {
+                interp->message("tier: '%s' stays interpreted, %s", tier.name.c_str(), tier.reason.c_str());
+                tier.shown_cold = true;
+                return;
+            }
+
+            interp->message("tier: '%s' is hot after %lu calls and %lu loop iterations, compiling", tier.name.c_str(),
+                            invocations, back_edges);
+            tier.status.store(Queued, std::memory_order_release);
+            tier.shown = Queued;
+            tier.queued = std::chrono::steady_clock::now();
+            pool.submit([this, function](u64) { compile(function); });
+        }
+
+        void TieredEngine::poll(mu::Function *function, Tier &tier) {
+            auto status = tier.status.load(std::memory_order_acquire);
+            if(status == tier.shown)
+                return;
+            tier.shown = status;
+
+            if(status == Native) {
+                auto waited = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - tier.queued);
+                interp->message("tier: '%s' runs natively from call %lu, compiled in %.2f ms (%.2f ms after it was hot)",
+                                tier.name.c_str(), function->get_invocations(), tier.compile_ms, waited.count());
+            }
+            else if(status == Failed)
+                interp->message("tier: '%s' stays interpreted, compiling it failed: %s", tier.name.c_str(),
+                                tier.reason.c_str());
+        }
+
+        void TieredEngine::compile(mu::Function *function) {
+            auto& tier = tiers.find(function)->second;
+            auto start = std::chrono::steady_clock::now();
+
+            // the diagnostics of a failed compile are kept for the interpreting thread to print.
+            std::ostringstream diagnostics;
+            NativeEntry entry = nullptr;
+            {
+                Interpreter::StreamScope scope(diagnostics);
+                try {
+                    // the functions it can reach that are already in the jit are only declared.
+                    std::unordered_set<mu::Function*> subset;
+                    for(auto callee : closure(function))
+                        if(!compiled.count(callee))
+                            subset.insert(callee);
+
+                    auto name = "mu.entry." + tier.name;
+                    CodeGen codegen(interp);
+                    if(codegen.generate(module, entities, &subset) and codegen.generate_entry(function, name) and
+                       jit->add(codegen.take_module(), false)) {
+                        compiled.insert(subset.begin(), subset.end());
+                        entry = reinterpret_cast<NativeEntry>(jit->lookup(name));
+                    }
+                }
+                catch(Interpreter::Abort&) {
+                }
+            }
+
+            tier.compile_ms = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if(entry) {
+                tier.entry.store(entry, std::memory_order_release);
+                tier.status.store(Native, std::memory_order_release);
+            }
+            else {
+                tier.reason = first_line(diagnostics.str());
+                tier.status.store(Failed, std::memory_order_release);
+            }
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef MU_TIERED_HPP
+#define MU_TIERED_HPP
+
+#include "common.hpp"
+#include "interpreter.hpp"
+#include "walker.hpp"
+#include "utils/thread_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mu {
+    class Jit;
+
+    namespace exec {
+
+        // Decides how each function of a module is run.
+        //
+        // Every function starts out interpreted by the walker. Once its calls and loop
+        // iterations reach the threshold it is lowered to LLVM with the functions it can
+        // reach and compiled on a background thread, the interpreter keeps running it until
+        // the native code is ready. A call that is already running isn't replaced, only the
+        // calls made after it is ready run natively.
+        class TieredEngine {
+        public:
+            // the arguments and results are flattened into registers, see CodeGen::generate_entry.
+            typedef void (*NativeEntry)(const Register* args, Register* results);
+
+            TieredEngine(Interpreter* interp, ast::ModuleFile* module, const std::vector<Entity*>& entities,
+                         u64 threshold = 1000);
+
+            // waits for the compilations that have been started.
+            ~TieredEngine();
+
+            // called before function is interpreted, returns the native code to call instead
+            // if it is ready.
+            NativeEntry enter(mu::Function* function);
+
+            // called for every iteration of a loop of an interpreted function.
+            void back_edge(mu::Function* function);
+
+            // prints how every function that was called has been run.
+            void summary();
+
+        private:
+            enum Status {
+                Interpreted,
+                Queued,
+                Native,
+                Failed,
+            };
+
+            struct Tier {
+                std::string name;
+
+                // why the function can't be compiled, or why compiling it failed.
+                bool promotable{true};
+                std::string reason;
+
+                // written by the compiling thread, status is stored last.
+                std::atomic<NativeEntry> entry{nullptr};
+                std::atomic<Status> status{Interpreted};
+                f64 compile_ms{0};
+
+                // the last status that was printed and the calls made to the native code.
+                Status shown{Interpreted};
+                bool shown_cold{false};
+                u64 native_calls{0};
+                std::chrono::steady_clock::time_point queued;
+            };
+
+            void collect_uses(ast::Expr* expr, mu::Function* function);
+
+            // the functions that can be reached from function, including itself.
+            std::vector<mu::Function*> closure(mu::Function* function);
+
+            void check_promotable(mu::Function* function, Tier& tier);
+
+            // queues function to be compiled once it is hot.
+            void promote(mu::Function* function, Tier& tier);
+
+            // prints the changes made by the compiling thread.
+            void poll(mu::Function* function, Tier& tier);
+
+            // runs on the compiling thread.
+            void compile(mu::Function* function);
+
+            Interpreter* interp{nullptr};
+            ast::ModuleFile* module{nullptr};
+            const std::vector<Entity*>& entities;
+            u64 threshold{1000};
+
+            std::unordered_map<mu::Function*, Tier> tiers;
+            std::vector<mu::Function*> order;
+            std::unordered_map<mu::Function*, std::unordered_set<mu::Function*>> callees;
+            std::unordered_map<mu::Function*, Global*> mutable_globals;
+
+            // only used by the compiling thread, the functions that are in the jit.
+            std::unique_ptr<Jit> jit;
+            std::unordered_set<mu::Function*> compiled;
+
+            // destroyed first so the compiling thread is done before anything it uses goes away.
+            ThreadPool pool{1};
+        };
+    }
+}
+
+#endif //MU_TIERED_HPP
@@ -0,0 +1,1322 @@
+#include "walker.hpp"
+#include "tiered.hpp"
+#include "analysis/types/type.hpp"
+#include "parser/ast/ast_common.hpp"
+
+#include <dlfcn.h>
+
+#include <cmath>
+#include <cstring>
+
+using mu::vm::Register;
+
+// mutable only qualifies a type, it is stored the same as the type it qualifies.
+static mu::types::Type* strip(mu::types::Type* type) {
+    while(type and type->kind() == mu::types::MutableType)
+        type = type->as<mu::types::Mutable>()->get_inner();
+    return type;
+}
+
+// a member access through a pointer is the member of the value it points to.
+static mu::types::Type* value_type(mu::types::Type* type) {
+    type = strip(type);
+    if(type and type->is_ptr())
+        type = strip(type->base_type());
+    return type;
+}
+
+// a pointer is a single register holding the address of the registers it points to.
+static i64 size_of(mu::types::Type* type) {
+    return mu::vm::num_registers(type, true);
+}
+
+static u32 offset_of(mu::types::Type* type, u64 index) {
+    return mu::vm::member_offset(value_type(type), index, true);
+}
+
+static mu::TokenKind compound_operator(mu::TokenKind op) {
+    switch(op) {
+        case mu::Tkn_PlusEqual: return mu::Tkn_Plus;
+        case mu::Tkn_MinusEqual: return mu::Tkn_Minus;
+        case mu::Tkn_AstrickEqual: return mu::Tkn_Astrick;
+        case mu::Tkn_SlashEqual: return mu::Tkn_Slash;
+        case mu::Tkn_PercentEqual: return mu::Tkn_Percent;
+        case mu::Tkn_AstrickAstrickEqual: return mu::Tkn_AstrickAstrick;
+        case mu::Tkn_LessLessEqual: return mu::Tkn_LessLess;
+        case mu::Tkn_GreaterGreaterEqual: return mu::Tkn_GreaterGreater;
+        case mu::Tkn_AmpersandEqual: return mu::Tkn_Ampersand;
+        case mu::Tkn_PipeEqual: return mu::Tkn_Pipe;
+        case mu::Tkn_CarrotEqual: return mu::Tkn_Carrot;
+        default: return op;
+    }
+}
+
+// the initializer of a struct member when it isn't given in the struct expression.
+static ast::ExprPtr default_member_init(mu::Local* member) {
+    auto decl = member->get_decl();
+    if(!decl or decl->kind != ast::ast_member_variable)
+        return nullptr;
+
+    auto variable = decl->as<ast::MemberVariable>();
+    if(variable->init.size() == 1)
+        return variable->init[0];
+
+    for(u64 i = 0; i < variable->names.size() and i < variable->init.size(); ++i)
+        if(variable->names[i]->val == member->get_name()->val)
+            return variable->init[i];
+    return nullptr;
+}
+
+static ast::ExprPtr accessor_operand(ast::Expr* expr) {
+    return expr->kind == ast::ast_accessor ? expr->as<ast::Accessor>()->operand :
+           expr->as<ast::TupleAcessor>()->operand;
+}
+
+// the index of the member or element an accessor refers to, -1 if it isn't known.
+static u64 accessor_index(ast::Expr* expr) {
+    if(expr->kind == ast::ast_tuple_accessor)
+        return expr->as<ast::TupleAcessor>()->value;
+
+    auto type = value_type(accessor_operand(expr)->type);
+    auto member = expr->operand.entity;
+    if(!member or type->kind() != mu::types::StructureType)
+        return (u64) -1;
+    return type->as<mu::types::StructType>()->get_index_of_member(member);
+}
+
+// whether a call takes an element of an array, 'v(i)'.
+static bool is_index(ast::Expr* expr) {
+    if(expr->kind != ast::ast_call)
+        return false;
+    auto type = strip(expr->as<ast::Call>()->name->type);
+    return type and type->is_array();
+}
+
+// the value a literal pattern matches.
+static bool pattern_value(ast::Pattern* pattern, i64& value) {
+    switch(pattern->kind) {
+        case ast::ast_int_pattern: value = pattern->as<ast::IntPattern>()->value; return true;
+        case ast::ast_char_pattern: value = pattern->as<ast::CharPattern>()->value; return true;
+        case ast::ast_bool_pattern: value = pattern->as<ast::BoolPattern>()->value; return true;
+        default: return false;
+    }
+}
+
+// the register of a constant converted to the type of the expression it is the value of.
+static Register constant(const mu::Val& val, mu::types::Type* type) {
+    type = strip(type);
+
+    mu::Val value = val;
+    if(!value.type)
+        value.type = type;
+    else if(value.type != type)
+        value.cast_to(type);
+    return mu::vm::constant_register(value);
+}
+
+// the registers hold 64 bit values, a smaller type is wrapped the same as the vm does.
+static void narrow(mu::types::Type* type, Register& reg) {
+    switch(strip(type)->kind()) {
+        case mu::types::Primitive_I8: reg.i = CAST(i8, reg.i); break;
+        case mu::types::Primitive_I16: reg.i = CAST(i16, reg.i); break;
+        case mu::types::Primitive_I32: reg.i = CAST(i32, reg.i); break;
+        case mu::types::Primitive_U8:
+        case mu::types::Primitive_Char: reg.u = CAST(u8, reg.u); break;
+        case mu::types::Primitive_U16: reg.u = CAST(u16, reg.u); break;
+        case mu::types::Primitive_U32: reg.u = CAST(u32, reg.u); break;
+        case mu::types::Primitive_Float32: reg.f = CAST(f32, reg.f); break;
+        default:
+            break;
+    }
+}
+
+enum OperatorResult {
+    Operator_Ok,
+    Operator_DivisionByZero,
+    Operator_Unsupported,
+};
+
+// applies a binary operator to registers of type, the integer operators wrap.
+static OperatorResult apply(mu::TokenKind op, mu::types::Type* type, Register lhs, Register rhs, Register& out) {
+    type = strip(type);
+    auto is_float = type->is_float();
+    auto is_signed = type->is_signed();
+
+    Register result;
+    result.u = 0;
+    switch(op) {
+        case mu::Tkn_Plus:
+            if(is_float) result.f = lhs.f + rhs.f;
+            else result.u = lhs.u + rhs.u;
+            break;
+        case mu::Tkn_Minus:
+            if(is_float) result.f = lhs.f - rhs.f;
+            else result.u = lhs.u - rhs.u;
+            break;
+        case mu::Tkn_Astrick:
+            if(is_float) result.f = lhs.f * rhs.f;
+            else result.u = lhs.u * rhs.u;
+            break;
+        case mu::Tkn_Slash:
+            if(is_float)
+                result.f = lhs.f / rhs.f;
+            else if(rhs.u == 0)
+                return Operator_DivisionByZero;
+            else if(is_signed)
+                result.u = rhs.i == -1 ? 0 - lhs.u : CAST(u64, lhs.i / rhs.i);
+            else
+                result.u = lhs.u / rhs.u;
+            break;
+        case mu::Tkn_Percent:
+            if(is_float)
+                result.f = std::fmod(lhs.f, rhs.f);
+            else if(rhs.u == 0)
+                return Operator_DivisionByZero;
+            else if(is_signed)
+                result.i = rhs.i == -1 ? 0 : lhs.i % rhs.i;
+            else
+                result.u = lhs.u % rhs.u;
+            break;
+        case mu::Tkn_AstrickAstrick:
+            if(!is_float)
+                return Operator_Unsupported;
+            result.f = std::pow(lhs.f, rhs.f);
+            break;
+        case mu::Tkn_LessLess:
+            if(is_float)
+                return Operator_Unsupported;
+            result.u = lhs.u << (rhs.u & 63);
+            break;
+        case mu::Tkn_GreaterGreater:
+            if(is_float)
+                return Operator_Unsupported;
+            if(is_signed) result.i = lhs.i >> (rhs.u & 63);
+            else result.u = lhs.u >> (rhs.u & 63);
+            break;
+        case mu::Tkn_Ampersand:
+            if(is_float)
+                return Operator_Unsupported;
+            result.u = lhs.u & rhs.u;
+            break;
+        case mu::Tkn_Pipe:
+            if(is_float)
+                return Operator_Unsupported;
+            result.u = lhs.u | rhs.u;
+            break;
+        case mu::Tkn_Carrot:
+            if(is_float)
+                return Operator_Unsupported;
+            result.u = lhs.u ^ rhs.u;
+            break;
+
+        // the comparisons are booleans, they aren't narrowed.
+        case mu::Tkn_EqualEqual:
+            out.i = is_float ? lhs.f == rhs.f : lhs.u == rhs.u;
+            return Operator_Ok;
+        case mu::Tkn_BangEqual:
+            out.i = is_float ? lhs.f != rhs.f : lhs.u != rhs.u;
+            return Operator_Ok;
+        case mu::Tkn_Less:
+            out.i = is_float ? lhs.f < rhs.f : (is_signed ? lhs.i < rhs.i : lhs.u < rhs.u);
+            return Operator_Ok;
+        case mu::Tkn_LessEqual:
+            out.i = is_float ? lhs.f <= rhs.f : (is_signed ? lhs.i <= rhs.i : lhs.u <= rhs.u);
+            return Operator_Ok;
+        case mu::Tkn_Greater:
+            out.i = is_float ? lhs.f > rhs.f : (is_signed ? lhs.i > rhs.i : lhs.u > rhs.u);
+            return Operator_Ok;
+        case mu::Tkn_GreaterEqual:
+            out.i = is_float ? lhs.f >= rhs.f : (is_signed ? lhs.i >= rhs.i : lhs.u >= rhs.u);
+            return Operator_Ok;
+        default:
+            return Operator_Unsupported;
+    }
+
+    narrow(type, result);
+    out = result;
+    return Operator_Ok;
+}
+
+// applies a binary operator to each element of an array, a single value is applied to every
+// element. The result has the type of the array operand.
+static OperatorResult apply_elements(mu::TokenKind op, mu::types::Type* lhs_type, mu::types::Type* rhs_type,
+                                     const Register* lhs, const Register* rhs, Register* out) {
+    auto lhs_array = strip(lhs_type)->is_array();
+    auto rhs_array = strip(rhs_type)->is_array();
+    auto array = strip(lhs_array ? lhs_type : rhs_type)->as<mu::types::Array>();
+    auto element = array->get_element_type();
+
+    for(u64 i = 0; i < array->num_elements(); ++i) {
+        auto result = apply(op, element, lhs[lhs_array ? i : 0], rhs[rhs_array ? i : 0], out[i]);
+        if(result != Operator_Ok)
+            return result;
+    }
+    return Operator_Ok;
+}
+
+namespace mu {
+    namespace exec {
+
+        Walker::Walker(Interpreter *interp, u64 stack_size) : interp(interp), stack(stack_size) {
+        }
+
+        bool Walker::load(const std::vector<Entity *> &entities) {
+            bool loaded = true;
+            for(auto entity : entities) {
+                if(!entity or !entity->is_resolved() or entity->kind() != GlobalEntity)
+                    continue;
+
+                auto global = entity->as<Global>();
+                auto type = strip(global->get_type());
+                auto count = size_of(type);
+                if(count < 0)
+                    continue;
+
+                // only a primitive global has an initial value, an aggregate starts zeroed.
+                auto decl = global->get_decl();
+                auto init = global->is_mutable() ? decl->as<ast::GlobalMut>()->init : decl->as<ast::Global>()->init;
+
+                if(init and type->is_primative() and !mu::is_constant_expr(init)) {
+                    interp->report_error(init->pos(), "global '%s' must be initialized by a constant",
+                                         global->get_name()->value().c_str());
+                    loaded = false;
+                }
+
+                globals.emplace(global, global_registers.size());
+                for(i64 i = 0; i < count; ++i) {
+                    Register reg;
+                    reg.u = 0;
+                    if(init and mu::is_constant_expr(init) and type->is_primative())
+                        reg = constant(init->operand.val, type);
+                    global_registers.push_back(reg);
+                }
+            }
+            return loaded;
+        }
+
+        bool Walker::call(mu::Function *function, const Register *args, Register *results) {
+            function->count_invocation();
+            if(engine) {
+                if(auto native = engine->enter(function)) {
+                    native(args, results);
+                    return true;
+                }
+            }
+
+            auto& layout = layout_of(function);
+            auto save = top;
+            auto slots = push(layout.size);
+            if(!slots) {
+                interp->report_error(function->get_decl()->pos(), "stack overflow calling '%s'",
+                                     function->get_name()->value().c_str());
+                return false;
+            }
+
+            // the parameters are the first slots of the frame.
+            u64 num_args = 0;
+            for(u64 i = 0; i < function->num_params(); ++i)
+                num_args += size_of(function->get_param(i)->get_type());
+            if(num_args)
+                std::memcpy(slots, args, num_args * sizeof(Register));
+
+            Frame current{function, slots, results, &layout};
+            auto previous = frame;
+            frame = &current;
+
+            auto mark = defers.size();
+            auto ret = function->get_ret_type();
+            auto body = function->get_decl()->as<ast::Procedure>()->body;
+            auto flow = ret and size_of(ret) > 0 ? eval_into(body, ret, results) : eval_effect(body);
+            defers.resize(mark);
+
+            frame = previous;
+            top = save;
+            return flow != Trap;
+        }
+
+        Walker::Layout& Walker::layout_of(mu::Function *function) {
+            auto iter = layouts.find(function);
+            if(iter != layouts.end())
+                return iter->second;
+
+            auto& layout = layouts[function];
+            for(u64 i = 0; i < function->num_params(); ++i) {
+                auto param = function->get_param(i);
+                layout.slots.emplace(param, layout.size);
+                layout.size += std::max<i64>(size_of(param->get_type()), 0);
+            }
+
+            collect(function->get_decl()->as<ast::Procedure>()->body, layout);
+            return layout;
+        }
+
+        void Walker::collect(ast::Expr *expr, Layout &layout) {
+            if(!expr)
+                return;
+
+            switch(expr->kind) {
+                case ast::ast_binary:
+                    collect(expr->as<ast::Binary>()->lhs, layout);
+                    collect(expr->as<ast::Binary>()->rhs, layout);
+                    break;
+                case ast::ast_unary:
+                    collect(expr->as<ast::Unary>()->expr, layout);
+                    break;
+                case ast::ast_cast_expr:
+                    collect(expr->as<ast::Cast>()->operand, layout);
+                    break;
+                case ast::ast_tuple_expr:
+                    for(auto element : expr->as<ast::TupleExpr>()->elements)
+                        collect(element, layout);
+                    break;
+                case ast::ast_struct_expr:
+                    for(auto member : expr->as<ast::StructExpr>()->members)
+                        collect(member->kind == ast::ast_expr_binding ? member->as<ast::BindingExpr>()->expr : member, layout);
+                    break;
+                case ast::ast_accessor:
+                case ast::ast_tuple_accessor:
+                    collect(accessor_operand(expr), layout);
+                    break;
+                case ast::ast_list:
+                    for(auto element : expr->as<ast::List>()->elements)
+                        collect(element, layout);
+                    break;
+                case ast::ast_call:
+                    collect(expr->as<ast::Call>()->name, layout);
+                    for(auto actual : expr->as<ast::Call>()->actuals)
+                        collect(actual, layout);
+                    break;
+                case ast::ast_method:
+                    for(auto actual : expr->as<ast::Method>()->actuals)
+                        collect(actual, layout);
+                    break;
+                case ast::ast_block:
+                    for(auto stmt : expr->as<ast::Block>()->elements) {
+                        if(stmt->kind == ast::ast_expr)
+                            collect(stmt->as<ast::ExprStmt>()->expr, layout);
+                        else if(stmt->kind == ast::ast_decl) {
+                            auto decl = stmt->as<ast::DeclStmt>()->decl;
+                            if(decl->kind == ast::ast_local) {
+                                collect_pattern(decl->as<ast::Local>()->names, layout);
+                                collect(decl->as<ast::Local>()->init, layout);
+                            }
+                            else if(decl->kind == ast::ast_mutable) {
+                                collect_pattern(decl->as<ast::Mutable>()->names, layout);
+                                collect(decl->as<ast::Mutable>()->init, layout);
+                            }
+                        }
+                    }
+                    break;
+                case ast::ast_if_expr:
+                    collect(expr->as<ast::If>()->cond, layout);
+                    collect(expr->as<ast::If>()->body, layout);
+                    collect(expr->as<ast::If>()->else_if, layout);
+                    break;
+                case ast::ast_while_expr:
+                    collect(expr->as<ast::While>()->cond, layout);
+                    collect(expr->as<ast::While>()->body, layout);
+                    break;
+                case ast::ast_for_expr:
+                    collect_pattern(expr->as<ast::For>()->pattern, layout);
+                    collect(expr->as<ast::For>()->expr, layout);
+                    collect(expr->as<ast::For>()->body, layout);
+                    break;
+                case ast::ast_range:
+                    collect(expr->as<ast::Range>()->start, layout);
+                    collect(expr->as<ast::Range>()->end, layout);
+                    collect(expr->as<ast::Range>()->step, layout);
+                    break;
+                case ast::ast_match_expr:
+                    collect(expr->as<ast::Match>()->cond, layout);
+                    for(auto member : expr->as<ast::Match>()->members) {
+                        for(auto pattern : member->as<ast::MatchArm>()->patterns)
+                            collect_pattern(pattern, layout);
+                        collect(member->as<ast::MatchArm>()->body, layout);
+                    }
+                    break;
+                case ast::ast_defer_expr:
+                    collect(expr->as<ast::Defer>()->body, layout);
+                    break;
+                case ast::ast_return:
+                    collect(expr->as<ast::Return>()->body, layout);
+                    break;
+                case ast::ast_assign:
+                    collect(expr->as<ast::Assign>()->lvalue, layout);
+                    collect(expr->as<ast::Assign>()->rvalue, layout);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        void Walker::collect_pattern(ast::Pattern *pattern, Layout &layout) {
+            if(!pattern)
+                return;
+
+            if(pattern->kind == ast::ast_ident_pattern) {
+                auto entity = pattern->as<ast::IdentPattern>()->entity;
+                if(entity and layout.slots.emplace(entity, layout.size).second)
+                    layout.size += std::max<i64>(size_of(entity->get_type()), 0);
+            }
+            else if(pattern->kind == ast::ast_tuple_desc) {
+                for(auto element : pattern->as<ast::TuplePattern>()->patterns)
+                    collect_pattern(element, layout);
+            }
+        }
+
+        Register* Walker::push(u64 count) {
+            if(top + count > stack.size())
+                return nullptr;
+
+            auto registers = stack.data() + top;
+            top += count;
+            return registers;
+        }
+
+        /*-----------------------------Expressions------------------------------*/
+
+        Walker::Flow Walker::eval(ast::Expr *expr, Register *out) {
+            auto type = strip(expr->type);
+            // a block, branch or call with a constant value still runs its statements.
+            if(mu::is_constant_expr(expr) and type and type->is_primative()) {
+                out[0] = constant(expr->operand.val, type);
+                return Next;
+            }
+
+            switch(expr->kind) {
+                case ast::ast_name:
+                case ast::ast_self_expr:
+                    return eval_name(expr, out);
+                case ast::ast_unit_expr:
+                    return Next;
+                case ast::ast_binary:
+                    return eval_binary(expr->as<ast::Binary>(), out);
+                case ast::ast_unary:
+                    return eval_unary(expr->as<ast::Unary>(), out);
+                case ast::ast_cast_expr:
+                    return eval_cast(expr, out);
+                case ast::ast_tuple_expr:
+                case ast::ast_struct_expr:
+                case ast::ast_list:
+                    return eval_aggregate(expr, out);
+                case ast::ast_accessor:
+                case ast::ast_tuple_accessor:
+                    return eval_accessor(expr, out);
+                case ast::ast_call: {
+                    auto call = expr->as<ast::Call>();
+                    if(is_index(expr))
+                        return eval_index(call, out);
+
+                    auto callee = call->name->operand.entity;
+                    if(!callee or !callee->is_function())
+                        return trap(expr->pos(), "only a function can be called by the interpreter");
+                    return eval_call(expr, callee->as<mu::Function>(), call->actuals, 0, out);
+                }
+                case ast::ast_method: {
+                    // the first actual is the receiver, or the type of a static method.
+                    auto method = expr->as<ast::Method>();
+                    auto callee = method->name->operand.entity;
+                    if(!callee or !callee->is_function())
+                        return trap(expr->pos(), "only a function can be called by the interpreter");
+
+                    auto function = callee->as<mu::Function>();
+                    return eval_call(expr, function, method->actuals, function->is_static() ? 1 : 0, out);
+                }
+                case ast::ast_block:
+                    return eval_block(expr->as<ast::Block>(), out);
+                case ast::ast_if_expr:
+                    return eval_if(expr->as<ast::If>(), out);
+                case ast::ast_while_expr:
+                    return eval_while(expr->as<ast::While>());
+                case ast::ast_for_expr:
+                    return eval_for(expr->as<ast::For>());
+                case ast::ast_match_expr:
+                    return eval_match(expr->as<ast::Match>(), out);
+                case ast::ast_defer_expr:
+                    defers.push_back(expr->as<ast::Defer>()->body);
+                    return Next;
+                case ast::ast_return:
+                    return eval_return(expr->as<ast::Return>());
+                case ast::ast_assign:
+                    return eval_assign(expr->as<ast::Assign>());
+                default:
+                    return trap(expr->pos(), "this expression can not be interpreted");
+            }
+        }
+
+        Walker::Flow Walker::eval_into(ast::Expr *expr, types::Type *type, Register *out) {
+            auto count = size_of(type);
+            if(count > 0 and size_of(expr->type) == count)
+                return eval(expr, out);
+            return eval_effect(expr);
+        }
+
+        Walker::Flow Walker::eval_effect(ast::Expr *expr) {
+            auto count = size_of(expr->type);
+            if(count < 0)
+                return trap(expr->pos(), "a value of type '%s' can not be interpreted",
+                            expr->type ? expr->type->str().c_str() : "unknown");
+
+            auto save = top;
+            auto value = push(count);
+            if(!value)
+                return trap(expr->pos(), "stack overflow");
+
+            auto flow = eval(expr, value);
+            top = save;
+            return flow;
+        }
+
+        Walker::Flow Walker::eval_place(ast::Expr *expr, Register *&place) {
+            place = nullptr;
+            switch(expr->kind) {
+                case ast::ast_name:
+                case ast::ast_self_expr: {
+                    auto entity = expr->operand.entity;
+                    if(!entity)
+                        return Next;
+
+                    if(entity->is_local()) {
+                        auto iter = frame->layout->slots.find(entity);
+                        if(iter != frame->layout->slots.end())
+                            place = frame->slots + iter->second;
+                    }
+                    else if(entity->is_global()) {
+                        auto iter = globals.find(entity->as<Global>());
+                        if(iter != globals.end())
+                            place = global_registers.data() + iter->second;
+                    }
+                    return Next;
+                }
+                case ast::ast_accessor:
+                case ast::ast_tuple_accessor: {
+                    auto operand = accessor_operand(expr);
+                    auto index = accessor_index(expr);
+                    if(index == (u64) -1)
+                        return Next;
+
+                    Register* base = nullptr;
+                    if(strip(operand->type)->is_ptr()) {
+                        // the member of the value the pointer points to.
+                        Register address;
+                        auto flow = eval(operand, &address);
+                        if(flow != Next)
+                            return flow;
+                        if(!address.u)
+                            return trap(expr->pos(), "null pointer dereference");
+                        base = reinterpret_cast<Register*>(address.u);
+                    }
+                    else {
+                        auto flow = eval_place(operand, base);
+                        if(flow != Next or !base)
+                            return flow;
+                    }
+
+                    place = base + offset_of(operand->type, index);
+                    return Next;
+                }
+                case ast::ast_call: {
+                    if(!is_index(expr))
+                        return Next;
+
+                    auto call = expr->as<ast::Call>();
+                    Register* base = nullptr;
+                    auto flow = eval_place(call->name, base);
+                    if(flow != Next or !base)
+                        return flow;
+
+                    Register index;
+                    flow = eval(call->actuals.front(), &index);
+                    if(flow != Next)
+                        return flow;
+
+                    auto array = strip(call->name->type)->as<types::Array>();
+                    if(index.u >= array->num_elements())
+                        return trap(expr->pos(), "index %ld is out of the bounds of '%s'", index.i, array->str().c_str());
+                    place = base + offset_of(array, index.u);
+                    return Next;
+                }
+                case ast::ast_unary: {
+                    auto unary = expr->as<ast::Unary>();
+                    if(unary->op != Tkn_Astrick)
+                        return Next;
+
+                    Register address;
+                    auto flow = eval(unary->expr, &address);
+                    if(flow != Next)
+                        return flow;
+                    if(!address.u)
+                        return trap(expr->pos(), "null pointer dereference");
+                    place = reinterpret_cast<Register*>(address.u);
+                    return Next;
+                }
+                default:
+                    return Next;
+            }
+        }
+
+        Walker::Flow Walker::eval_name(ast::Expr *expr, Register *out) {
+            auto entity = expr->operand.entity;
+            if(!entity)
+                return trap(expr->pos(), "this name can not be interpreted");
+
+            if(entity->kind() == ConstantEntity) {
+                auto constant_entity = entity->as<mu::Constant>();
+                if(strip(constant_entity->get_type())->is_primative()) {
+                    out[0] = constant(constant_entity->get_value(), constant_entity->get_type());
+                    return Next;
+                }
+            }
+            else {
+                Register* place = nullptr;
+                auto flow = eval_place(expr, place);
+                if(flow != Next)
+                    return flow;
+
+                auto count = size_of(expr->type);
+                if(place and count >= 0) {
+                    std::memmove(out, place, count * sizeof(Register));
+                    return Next;
+                }
+            }
+
+            return trap(expr->pos(), "'%s' can not be interpreted", entity->get_name()->value().c_str());
+        }
+
+        Walker::Flow Walker::eval_binary(ast::Binary *expr, Register *out) {
+            // the right side is only evaluated when the left side doesn't decide the result.
+            if(expr->op == Tkn_And or expr->op == Tkn_Or) {
+                auto flow = eval(expr->lhs, out);
+                if(flow != Next or (expr->op == Tkn_And) != CAST(bool, out[0].i))
+                    return flow;
+                return eval(expr->rhs, out);
+            }
+
+            if(strip(expr->type)->is_array())
+                return eval_elements(expr, out);
+
+            Register lhs, rhs;
+            auto flow = eval(expr->lhs, &lhs);
+            if(flow != Next)
+                return flow;
+            flow = eval(expr->rhs, &rhs);
+            if(flow != Next)
+                return flow;
+
+            switch(apply(expr->op, expr->lhs->type, lhs, rhs, out[0])) {
+                case Operator_Ok:
+                    return Next;
+                case Operator_DivisionByZero:
+                    return trap(expr->pos(), "division by zero");
+                default:
+                    return trap(expr->pos(), "the operator '%s' can not be applied to '%s' by the interpreter",
+                                Token::get_string(expr->op).c_str(), expr->lhs->type->str().c_str());
+            }
+        }
+
+        Walker::Flow Walker::eval_elements(ast::Binary *expr, Register *out) {
+            // the operands are evaluated to the stack, the result can be one of them.
+            auto save = top;
+            auto lhs = push(std::max<i64>(size_of(expr->lhs->type), 0));
+            auto rhs = push(std::max<i64>(size_of(expr->rhs->type), 0));
+            if(!lhs or !rhs) {
+                top = save;
+                return trap(expr->pos(), "stack overflow");
+            }
+
+            auto flow = eval(expr->lhs, lhs);
+            if(flow == Next)
+                flow = eval(expr->rhs, rhs);
+            if(flow == Next) {
+                switch(apply_elements(expr->op, expr->lhs->type, expr->rhs->type, lhs, rhs, out)) {
+                    case Operator_Ok:
+                        break;
+                    case Operator_DivisionByZero:
+                        flow = trap(expr->pos(), "division by zero");
+                        break;
+                    default:
+                        flow = trap(expr->pos(), "the operator '%s' can not be applied to '%s' by the interpreter",
+                                    Token::get_string(expr->op).c_str(), expr->type->str().c_str());
+                        break;
+                }
+            }
+
+            top = save;
+            return flow;
+        }
+
+        Walker::Flow Walker::eval_unary(ast::Unary *expr, Register *out) {
+            if(expr->op == Tkn_Ampersand) {
+                Register* place = nullptr;
+                auto flow = eval_place(expr->expr, place);
+                if(flow != Next)
+                    return flow;
+                if(!place)
+                    return trap(expr->pos(), "the address of this expression can not be taken by the interpreter");
+                out[0].u = reinterpret_cast<u64>(place);
+                return Next;
+            }
+
+            if(expr->op == Tkn_Astrick) {
+                Register* place = nullptr;
+                auto flow = eval_place(expr, place);
+                if(flow != Next)
+                    return flow;
+                std::memmove(out, place, std::max<i64>(size_of(expr->type), 0) * sizeof(Register));
+                return Next;
+            }
+
+            Register value;
+            auto flow = eval(expr->expr, &value);
+            if(flow != Next)
+                return flow;
+
+            auto type = strip(expr->expr->type);
+            switch(expr->op) {
+                case Tkn_Minus:
+                    if(type->is_float())
+                        out[0].f = -value.f;
+                    else
+                        out[0].u = 0 - value.u;
+                    narrow(type, out[0]);
+                    return Next;
+                case Tkn_Tilde:
+                    out[0].u = ~value.u;
+                    narrow(type, out[0]);
+                    return Next;
+                case Tkn_Bang:
+                    out[0].i = !value.i;
+                    return Next;
+                default:
+                    return trap(expr->pos(), "the operator '%s' can not be interpreted", Token::get_string(expr->op).c_str());
+            }
+        }
+
+        // the conversions of 'x as T' are the same as C's, and the same as the vm's.
+        Walker::Flow Walker::eval_cast(ast::Expr *expr, Register *out) {
+            auto operand = expr->as<ast::Cast>()->operand;
+            Register value;
+            auto flow = eval(operand, &value);
+            if(flow != Next)
+                return flow;
+
+            auto from = strip(operand->type);
+            auto to = strip(expr->type);
+            if(to->is_bool())
+                out[0].i = from->is_float() ? value.f != 0 : value.u != 0;
+            else if(to->is_float())
+                out[0].f = from->is_float() ? value.f : from->is_signed() ? CAST(f64, value.i) : CAST(f64, value.u);
+            else if(from->is_float())
+                out[0].u = to->is_signed() ? CAST(u64, CAST(i64, value.f)) : CAST(u64, value.f);
+            else
+                out[0].u = value.u;
+            narrow(to, out[0]);
+            return Next;
+        }
+
+        Walker::Flow Walker::eval_aggregate(ast::Expr *expr, Register *out) {
+            auto type = strip(expr->type);
+            if(expr->kind == ast::ast_list) {
+                auto& elements = expr->as<ast::List>()->elements;
+                for(u64 i = 0; i < elements.size(); ++i) {
+                    auto flow = eval(elements[i], out + offset_of(type, i));
+                    if(flow != Next)
+                        return flow;
+                }
+                return Next;
+            }
+
+            if(expr->kind == ast::ast_tuple_expr) {
+                auto& elements = expr->as<ast::TupleExpr>()->elements;
+                for(u64 i = 0; i < elements.size(); ++i) {
+                    auto flow = eval(elements[i], out + offset_of(type, i));
+                    if(flow != Next)
+                        return flow;
+                }
+                return Next;
+            }
+
+            auto struct_expr = expr->as<ast::StructExpr>();
+            auto struct_type = type->as<types::StructType>();
+
+            // the members are given in order or by name.
+            std::vector<ast::ExprPtr> inits(struct_type->num_members(), nullptr);
+            for(u64 i = 0; i < struct_expr->members.size() and i < inits.size(); ++i) {
+                auto member = struct_expr->members[i];
+                if(member->kind == ast::ast_expr_binding) {
+                    auto binding = member->as<ast::BindingExpr>();
+                    auto [entity, found] = struct_type->get_scope()->find(binding->name);
+                    if(found)
+                        inits[struct_type->get_index_of_member(entity)] = binding->expr;
+                }
+                else
+                    inits[i] = member;
+            }
+
+            for(u64 i = 0; i < inits.size(); ++i) {
+                auto member = struct_type->get_member(i)->as<Local>();
+                auto init = inits[i] ? inits[i] : default_member_init(member);
+                if(!init)
+                    return trap(expr->pos(), "member '%s' of '%s' isn't given a value",
+                                member->get_name()->value().c_str(), struct_type->get_name()->value().c_str());
+
+                auto flow = eval(init, out + offset_of(struct_type, i));
+                if(flow != Next)
+                    return flow;
+            }
+            return Next;
+        }
+
+        Walker::Flow Walker::eval_accessor(ast::Expr *expr, Register *out) {
+            auto count = size_of(expr->type);
+            if(count < 0)
+                return trap(expr->pos(), "a value of type '%s' can not be interpreted", expr->type->str().c_str());
+
+            Register* place = nullptr;
+            auto flow = eval_place(expr, place);
+            if(flow != Next)
+                return flow;
+            if(place) {
+                std::memmove(out, place, count * sizeof(Register));
+                return Next;
+            }
+
+            // the operand is a temporary, the member is copied out of it.
+            auto operand = accessor_operand(expr);
+            auto index = accessor_index(expr);
+            auto operand_count = size_of(operand->type);
+            if(index == (u64) -1 or operand_count < 0)
+                return trap(expr->pos(), "this member can not be interpreted");
+
+            auto save = top;
+            auto base = push(operand_count);
+            if(!base)
+                return trap(expr->pos(), "stack overflow");
+
+            flow = eval(operand, base);
+            if(flow == Next)
+                std::memmove(out, base + offset_of(operand->type, index), count * sizeof(Register));
+            top = save;
+            return flow;
+        }
+
+        Walker::Flow Walker::eval_index(ast::Call *expr, Register *out) {
+            auto count = size_of(expr->type);
+            if(count < 0)
+                return trap(expr->pos(), "a value of type '%s' can not be interpreted", expr->type->str().c_str());
+
+            Register* place = nullptr;
+            auto flow = eval_place(expr, place);
+            if(flow != Next or place) {
+                if(place)
+                    std::memmove(out, place, count * sizeof(Register));
+                return flow;
+            }
+
+            // the array is a temporary, the element is copied out of it.
+            auto array = strip(expr->name->type)->as<types::Array>();
+            auto save = top;
+            auto base = push(size_of(array));
+            if(!base)
+                return trap(expr->pos(), "stack overflow");
+
+            Register index;
+            flow = eval(expr->name, base);
+            if(flow == Next)
+                flow = eval(expr->actuals.front(), &index);
+            if(flow == Next) {
+                if(index.u >= array->num_elements())
+                    flow = trap(expr->pos(), "index %ld is out of the bounds of '%s'", index.i, array->str().c_str());
+                else
+                    std::memmove(out, base + offset_of(array, index.u), count * sizeof(Register));
+            }
+            top = save;
+            return flow;
+        }
+
+        Walker::Flow Walker::eval_call(ast::Expr *expr, mu::Function *callee, const ast::NodeList<ast::ExprPtr> &actuals,
+                                       u64 first_actual, Register *out) {
+            i64 num_args = 0;
+            for(u64 i = 0; i < callee->num_params(); ++i) {
+                auto count = size_of(callee->get_param(i)->get_type());
+                if(count < 0)
+                    return trap(expr->pos(), "'%s' can not be called by the interpreter", callee->get_name()->value().c_str());
+                num_args += count;
+            }
+
+            auto save = top;
+            auto args = push(num_args);
+            if(!args)
+                return trap(expr->pos(), "stack overflow");
+
+            auto offset = args;
+            auto actual = first_actual;
+            for(u64 i = 0; i < callee->num_params(); ++i, ++actual) {
+                auto param = callee->get_param(i);
+
+                ast::ExprPtr init = actual < actuals.size() ? actuals[actual] : nullptr;
+                if(!init and param->get_decl()->kind == ast::ast_procedure_parameter)
+                    init = param->get_decl()->as<ast::ProcedureParameter>()->init;
+
+                if(!init) {
+                    top = save;
+                    return trap(expr->pos(), "parameter '%s' of '%s' isn't given a value",
+                                param->get_name()->value().c_str(), callee->get_name()->value().c_str());
+                }
+
+                Flow flow = Next;
+                if(param->is_self() and expr->kind == ast::ast_method and !strip(init->type)->is_ptr()) {
+                    // self is the address of the receiver, a temporary receiver is spilled first.
+                    Register* place = nullptr;
+                    flow = eval_place(init, place);
+                    if(flow == Next and !place) {
+                        place = push(std::max<i64>(size_of(init->type), 0));
+                        flow = place ? eval(init, place) : trap(expr->pos(), "stack overflow");
+                    }
+                    if(flow == Next)
+                        offset->u = reinterpret_cast<u64>(place);
+                }
+                else
+                    flow = eval(init, offset);
+
+                if(flow != Next) {
+                    top = save;
+                    return flow;
+                }
+                offset += size_of(param->get_type());
+            }
+
+            Flow flow = Next;
+            if(callee->is_foreign() or callee->no_body())
+                flow = call_foreign(expr, callee, args, out);
+            else if(!call(callee, args, out))
+                flow = Trap;
+
+            top = save;
+            return flow;
+        }
+
+        Walker::Flow Walker::call_foreign(ast::Expr *expr, mu::Function *callee, const Register *args, Register *out) {
+            auto name = callee->get_foreign_name().empty() ? callee->get_name()->value() : callee->get_foreign_name();
+
+            // every argument is passed in an integer register, at most six of them.
+            auto ret = strip(callee->get_ret_type());
+            bool supported = callee->num_params() <= 6 and (!ret or ret->is_unit() or
+                             ((ret->is_primative() or ret->is_ptr()) and !ret->is_float()));
+            for(u64 i = 0; i < callee->num_params() and supported; ++i) {
+                auto type = strip(callee->get_param(i)->get_type());
+                supported = (type->is_primative() or type->is_ptr()) and !type->is_float();
+            }
+            if(!supported)
+                return trap(expr->pos(), "'%s' can not be called by the interpreter, only integers and pointers can be passed to c",
+                            name.c_str());
+
+            auto iter = foreign.find(callee);
+            if(iter == foreign.end())
+                iter = foreign.emplace(callee, dlsym(RTLD_DEFAULT, name.c_str())).first;
+            if(!iter->second)
+                return trap(expr->pos(), "unable to find '%s'", name.c_str());
+
+            typedef i64 (*Foreign)(i64, i64, i64, i64, i64, i64);
+            i64 values[6] = {0};
+            for(u64 i = 0; i < callee->num_params(); ++i)
+                values[i] = args[i].i;
+
+            // the function writes to the same stdout as the interpreter.
+            interp->out_stream().flush();
+            auto result = reinterpret_cast<Foreign>(iter->second)(values[0], values[1], values[2],
+                                                                  values[3], values[4], values[5]);
+            if(ret and !ret->is_unit()) {
+                out[0].i = result;
+                narrow(ret, out[0]);
+            }
+            return Next;
+        }
+
+        Walker::Flow Walker::eval_block(ast::Block *expr, Register *out) {
+            auto mark = defers.size();
+
+            Flow flow = Next;
+            for(u64 i = 0; i < expr->elements.size() and flow == Next; ++i) {
+                auto stmt = expr->elements[i];
+                switch(stmt->kind) {
+                    case ast::ast_expr: {
+                        auto value = stmt->as<ast::ExprStmt>()->expr;
+                        auto is_last = i + 1 == expr->elements.size();
+                        flow = is_last ? eval_into(value, expr->type, out) : eval_effect(value);
+                    } break;
+                    case ast::ast_decl: {
+                        auto decl = stmt->as<ast::DeclStmt>()->decl;
+                        if(decl->kind != ast::ast_local and decl->kind != ast::ast_mutable)
+                            flow = trap(decl->pos(), "this declaration can not be interpreted");
+                        else
+                            flow = eval_local(decl);
+                    } break;
+                    default:
+                        break;
+                }
+            }
+
+            // the value of the block is computed before the deferred expressions run, they
+            // also run when the function returns from inside the block.
+            if(flow != Trap and run_defers(mark) == Trap)
+                flow = Trap;
+            defers.resize(mark);
+            return flow;
+        }
+
+        Walker::Flow Walker::eval_if(ast::If *expr, Register *out) {
+            Register cond;
+            auto flow = eval(expr->cond, &cond);
+            if(flow != Next)
+                return flow;
+
+            if(cond.i)
+                return eval_into(expr->body, expr->type, out);
+            if(expr->else_if)
+                return eval_into(expr->else_if, expr->type, out);
+            return Next;
+        }
+
+        Walker::Flow Walker::eval_while(ast::While *expr) {
+            while(true) {
+                Register cond;
+                auto flow = eval(expr->cond, &cond);
+                if(flow != Next or !cond.i)
+                    return flow;
+
+                flow = eval_effect(expr->body);
+                if(flow != Next)
+                    return flow;
+                back_edge();
+            }
+        }
+
+        Walker::Flow Walker::eval_for(ast::For *expr) {
+            if(expr->expr->kind != ast::ast_range)
+                return trap(expr->pos(), "only a range can be iterated by the interpreter");
+
+            auto range = expr->expr->as<ast::Range>();
+            auto type = strip(range->type);
+
+            // the bounds are evaluated once, before the first iteration.
+            Register counter, end, step;
+            step.i = 1;
+            auto flow = eval(range->start, &counter);
+            if(flow == Next)
+                flow = eval(range->end, &end);
+            if(flow == Next and range->step)
+                flow = eval(range->step, &step);
+            if(flow != Next)
+                return flow;
+
+            Register* slot = nullptr;
+            if(expr->pattern->kind == ast::ast_ident_pattern)
+                slot = frame->slots + frame->layout->slots[expr->pattern->as<ast::IdentPattern>()->entity];
+
+            while(type->is_signed() ? counter.i < end.i : counter.u < end.u) {
+                if(slot)
+                    *slot = counter;
+
+                flow = eval_effect(expr->body);
+                if(flow != Next)
+                    return flow;
+                back_edge();
+
+                counter.u += step.u;
+                narrow(type, counter);
+            }
+            return Next;
+        }
+
+        Walker::Flow Walker::eval_match(ast::Match *expr, Register *out) {
+            if(size_of(expr->cond->type) != 1)
+                return trap(expr->cond->pos(), "only a primitive value can be matched by the interpreter");
+
+            Register value;
+            auto flow = eval(expr->cond, &value);
+            if(flow != Next)
+                return flow;
+
+            // the arms are tested in order, an arm with alternatives matches if any of them do.
+            auto type = strip(expr->cond->type);
+            for(auto member : expr->members) {
+                auto arm = member->as<ast::MatchArm>();
+
+                bool matched = false;
+                for(auto pattern : arm->patterns) {
+                    i64 literal = 0;
+                    if(pattern_value(pattern, literal))
+                        matched = constant(Val(literal), type).u == value.u;
+                    else if(pattern->kind == ast::ast_range_pattern) {
+                        // a range includes both of its bounds.
+                        auto range = pattern->as<ast::RangePattern>();
+                        i64 start = 0, end = 0;
+                        if(!pattern_value(range->start, start) or !pattern_value(range->end, end))
+                            return trap(pattern->pos(), "this pattern can not be interpreted");
+
+                        auto lower = constant(Val(start), type);
+                        auto upper = constant(Val(end), type);
+                        matched = type->is_signed() ? lower.i <= value.i and value.i <= upper.i :
+                                                      lower.u <= value.u and value.u <= upper.u;
+                    }
+                    else if(pattern->kind == ast::ast_ignore_pattern or pattern->kind == ast::ast_ident_pattern)
+                        matched = true;
+                    else
+                        return trap(pattern->pos(), "this pattern can not be interpreted");
+
+                    if(matched)
+                        break;
+                }
+
+                if(!matched)
+                    continue;
+
+                // a name is bound to the value being matched.
+                for(auto pattern : arm->patterns)
+                    if(pattern->kind == ast::ast_ident_pattern)
+                        frame->slots[frame->layout->slots[pattern->as<ast::IdentPattern>()->entity]] = value;
+
+                return eval_into(arm->body, expr->type, out);
+            }
+
+            // a match with a value has a default arm so nothing falls through.
+            if(size_of(expr->type) > 0)
+                return trap(expr->pos(), "no arm of the match matched");
+            return Next;
+        }
+
+        Walker::Flow Walker::eval_return(ast::Return *expr) {
+            if(expr->body) {
+                auto ret = frame->function->get_ret_type();
+                auto flow = ret and size_of(ret) > 0 ? eval_into(expr->body, ret, frame->result) : eval_effect(expr->body);
+                if(flow != Next)
+                    return flow;
+            }
+            return Return;
+        }
+
+        Walker::Flow Walker::eval_assign(ast::Assign *expr) {
+            auto lvalue = expr->lvalue;
+            auto count = size_of(lvalue->type);
+            if(count < 0)
+                return trap(lvalue->pos(), "a value of type '%s' can not be interpreted", lvalue->type->str().c_str());
+
+            Register* place = nullptr;
+            auto flow = eval_place(lvalue, place);
+            if(flow != Next)
+                return flow;
+            if(!place)
+                return trap(lvalue->pos(), "this expression can not be assigned by the interpreter");
+
+            // the value is computed before it is written, it can read the place.
+            auto save = top;
+            auto value = push(count);
+            if(!value)
+                return trap(expr->pos(), "stack overflow");
+
+            flow = eval(expr->rvalue, value);
+            if(flow == Next) {
+                if(expr->op == Tkn_Equal)
+                    std::memmove(place, value, count * sizeof(Register));
+                else {
+                    auto op = compound_operator(expr->op);
+                    auto result = strip(lvalue->type)->is_array() ?
+                            apply_elements(op, lvalue->type, expr->rvalue->type, place, value, place) :
+                            apply(op, lvalue->type, place[0], value[0], place[0]);
+                    switch(result) {
+                        case Operator_Ok:
+                            break;
+                        case Operator_DivisionByZero:
+                            flow = trap(expr->pos(), "division by zero");
+                            break;
+                        default:
+                            flow = trap(expr->pos(), "the operator '%s' can not be applied to '%s' by the interpreter",
+                                        Token::get_string(op).c_str(), lvalue->type->str().c_str());
+                            break;
+                    }
+                }
+            }
+
+            top = save;
+            return flow;
+        }
+
+        Walker::Flow Walker::eval_local(ast::DeclPtr decl) {
+            ast::PatternPtr pattern = nullptr;
+            ast::ExprPtr init = nullptr;
+            if(decl->kind == ast::ast_mutable) {
+                pattern = decl->as<ast::Mutable>()->names;
+                init = decl->as<ast::Mutable>()->init;
+            }
+            else {
+                pattern = decl->as<ast::Local>()->names;
+                init = decl->as<ast::Local>()->init;
+            }
+
+            if(!init) {
+                // a local declared without a value starts zeroed.
+                if(pattern->kind != ast::ast_ident_pattern)
+                    return trap(pattern->pos(), "this pattern needs a value to be interpreted");
+
+                auto local = pattern->as<ast::IdentPattern>()->entity;
+                auto count = std::max<i64>(size_of(local->get_type()), 0);
+                std::memset(frame->slots + frame->layout->slots[local], 0, count * sizeof(Register));
+                return Next;
+            }
+
+            // a single name is evaluated straight into its slots.
+            if(pattern->kind == ast::ast_ident_pattern) {
+                auto local = pattern->as<ast::IdentPattern>()->entity;
+                return eval(init, frame->slots + frame->layout->slots[local]);
+            }
+
+            auto count = size_of(init->type);
+            if(count < 0)
+                return trap(init->pos(), "a value of type '%s' can not be interpreted", init->type->str().c_str());
+
+            auto save = top;
+            auto value = push(count);
+            if(!value)
+                return trap(init->pos(), "stack overflow");
+
+            auto flow = eval(init, value);
+            if(flow == Next)
+                bind_pattern(pattern, init->type, value);
+            top = save;
+            return flow;
+        }
+
+        void Walker::bind_pattern(ast::Pattern *pattern, types::Type *type, const Register *value) {
+            switch(pattern->kind) {
+                case ast::ast_ident_pattern: {
+                    auto local = pattern->as<ast::IdentPattern>()->entity;
+                    auto count = std::max<i64>(size_of(type), 0);
+                    std::memmove(frame->slots + frame->layout->slots[local], value, count * sizeof(Register));
+                } break;
+                case ast::ast_tuple_desc: {
+                    auto tuple = strip(type)->as<types::Tuple>();
+                    auto& patterns = pattern->as<ast::TuplePattern>()->patterns;
+                    for(u64 i = 0; i < patterns.size(); ++i)
+                        bind_pattern(patterns[i], tuple->get_element_type(i), value + offset_of(tuple, i));
+                } break;
+                default:
+                    break;
+            }
+        }
+
+        Walker::Flow Walker::run_defers(u64 mark) {
+            // the deferred expressions can defer more, they are above the ones being run.
+            for(u64 i = defers.size(); i > mark; --i)
+                if(eval_effect(defers[i - 1]) == Trap)
+                    return Trap;
+            return Next;
+        }
+
+        void Walker::back_edge() {
+            frame->function->count_back_edge();
+            if(engine)
+                engine->back_edge(frame->function);
+        }
+    }
+}
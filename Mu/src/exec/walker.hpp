@@ -0,0 +1,151 @@
+#ifndef MU_WALKER_HPP
+#define MU_WALKER_HPP
+
+#include "common.hpp"
+#include "interpreter.hpp"
+#include "vm/bytecode.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace mu {
+    namespace exec {
+
+        using vm::Register;
+
+        class TieredEngine;
+
+        // Runs functions by walking their resolved ast.
+        //
+        // Values are flattened into registers the way the vm stores them, a tuple or a struct
+        // is a register for each primitive member. A pointer is the address of a register.
+        // The frames and temporaries of every call are on a single register stack so an
+        // address stays valid until the frame it points into returns.
+        class Walker {
+        public:
+            Walker(Interpreter* interp, u64 stack_size = 1 << 20);
+
+            // creates the storage of the globals of a module. Returns false if a global isn't
+            // initialized by a constant, it has been reported.
+            bool load(const std::vector<Entity*>& entities);
+
+            // calls function with its arguments in args, the results are written to results.
+            // returns false if the program trapped, it has been reported.
+            bool call(mu::Function* function, const Register* args, Register* results);
+
+            // the engine is asked how to run every function that is called.
+            inline void set_engine(TieredEngine* engine) { this->engine = engine; }
+
+        private:
+            enum Flow {
+                Next,
+                Return,
+                Trap,
+            };
+
+            // the registers of the locals of a function relative to its frame, the parameters
+            // come first. Every local has its own registers.
+            struct Layout {
+                std::unordered_map<Entity*, u32> slots;
+                u32 size{0};
+            };
+
+            struct Frame {
+                mu::Function* function;
+                Register* slots;
+                Register* result;
+                Layout* layout;
+            };
+
+            Layout& layout_of(mu::Function* function);
+
+            void collect(ast::Expr* expr, Layout& layout);
+
+            void collect_pattern(ast::Pattern* pattern, Layout& layout);
+
+            Register* push(u64 count);
+
+            /*-----------------------------Expressions------------------------------*/
+            Flow eval(ast::Expr* expr, Register* out);
+
+            // evaluates expr into out if it is a value of type, otherwise only for its effects.
+            Flow eval_into(ast::Expr* expr, types::Type* type, Register* out);
+
+            Flow eval_effect(ast::Expr* expr);
+
+            // the registers of an expression that has storage, nullptr if it doesn't have any.
+            Flow eval_place(ast::Expr* expr, Register*& place);
+
+            Flow eval_name(ast::Expr* expr, Register* out);
+
+            Flow eval_binary(ast::Binary* expr, Register* out);
+
+            // an operator applied to each element of an array.
+            Flow eval_elements(ast::Binary* expr, Register* out);
+
+            Flow eval_unary(ast::Unary* expr, Register* out);
+
+            Flow eval_cast(ast::Expr* expr, Register* out);
+
+            Flow eval_aggregate(ast::Expr* expr, Register* out);
+
+            Flow eval_accessor(ast::Expr* expr, Register* out);
+
+            // an element of an array, the index is checked against the length.
+            Flow eval_index(ast::Call* expr, Register* out);
+
+            Flow eval_call(ast::Expr* expr, mu::Function* callee, const ast::NodeList<ast::ExprPtr>& actuals,
+                           u64 first_actual, Register* out);
+
+            // calls a c function, only integers and pointers can be passed to it.
+            Flow call_foreign(ast::Expr* expr, mu::Function* callee, const Register* args, Register* out);
+
+            Flow eval_block(ast::Block* expr, Register* out);
+
+            Flow eval_if(ast::If* expr, Register* out);
+
+            Flow eval_while(ast::While* expr);
+
+            Flow eval_for(ast::For* expr);
+
+            Flow eval_match(ast::Match* expr, Register* out);
+
+            Flow eval_return(ast::Return* expr);
+
+            Flow eval_assign(ast::Assign* expr);
+
+            Flow eval_local(ast::DeclPtr decl);
+
+            void bind_pattern(ast::Pattern* pattern, types::Type* type, const Register* value);
+
+            Flow run_defers(u64 mark);
+
+            // counts an iteration of a loop of the current function.
+            void back_edge();
+
+            template <typename... Args>
+            Flow trap(const mu::Pos& pos, const std::string& fmt, Args... args) {
+                interp->report_error(pos, fmt, args...);
+                return Trap;
+            }
+
+            Interpreter* interp{nullptr};
+            TieredEngine* engine{nullptr};
+
+            std::unordered_map<mu::Function*, Layout> layouts;
+            std::unordered_map<Global*, u32> globals;
+            std::vector<Register> global_registers;
+
+            // the addresses of the c functions that have been called.
+            std::unordered_map<mu::Function*, void*> foreign;
+
+            std::vector<Register> stack;
+            u64 top{0};
+
+            Frame* frame{nullptr};
+            std::vector<ast::Expr*> defers;
+        };
+    }
+}
+
+#endif //MU_WALKER_HPP
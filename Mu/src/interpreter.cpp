@@ -6,6 +6,26 @@
 #include "parser/parser.hpp"
 #include <iostream>
 #include "parser/ast/renderer.hpp"
+#include "utils/thread_pool.hpp"
+#include "codegen/codegen.hpp"
+#include "codegen/jit.hpp"
+#include "exec/tiered.hpp"
+#include "exec/walker.hpp"
+#include "mir/lower.hpp"
+#include "mir/passes.hpp"
+#include "vm/compiler.hpp"
+#include "vm/vm.hpp"
+#include "serve/server.hpp"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#if defined(MU_APPLE) || defined(MU_LINUX)
+    #include <cerrno>
+    #include <unistd.h>
+    #include <sys/wait.h>
+#endif
 
 using namespace mu::types;
 
@@ -29,10 +49,19 @@ Type* type_string{nullptr};
 
 Interpreter* Interpreter::instance = nullptr;
 
-Interpreter::Context::Context(const std::vector<std::string> &args) : args(args) {
-    // get the current working directory(maybe this could be passed in through the args.
+thread_local std::ostream* Interpreter::thread_out = nullptr;
+
+Interpreter::StreamScope::StreamScope(std::ostream& out) : previous(thread_out) {
+    thread_out = &out;
+}
 
-    dir = new io::Directory(io::Path("."), true);
+Interpreter::StreamScope::~StreamScope() {
+    thread_out = previous;
+}
+
+Interpreter::Context::Context(const std::vector<std::string> &args) : args(args) {
+    // every source file under the working directory is found once, up front.
+    io::FileRegistry::get().walk(io::Path("."), true);
 
     process_args();
 }
@@ -40,13 +69,7 @@ Interpreter::Context::Context(const std::vector<std::string> &args) : args(args)
 io::File* Interpreter::Context::get_root() {
     auto path = io::Path(root_file);
 
-    auto [file, status] = dir->search(path);
-    switch(status) {
-        case io::FileOk:
-            return CAST_PTR(io::File, file);
-        default:
-            return nullptr;
-    }
+    return io::FileRegistry::get().find(path.string());
 }
 
 void Interpreter::Context::process_args() {
@@ -79,6 +102,19 @@ void Interpreter::Context::process_args() {
             root_file = args[1];
         }
     }
+    else if(first == "serve") {
+        // the server serves the working directory.
+        cmd = Serve;
+        return;
+    }
+    else if(first == "build-all") {
+        cmd = BuildAll;
+
+        // the directory is the root, an optional argument is the number of threads.
+        if(args.size() - 1 == 1)
+            num_jobs = std::strtoull(args[1].c_str(), nullptr, 10);
+        return;
+    }
     else if(first == "ast-render") {
         cmd = AstRender;
         if(args.size() - 1 == 0) {
@@ -90,6 +126,15 @@ void Interpreter::Context::process_args() {
             root_file = args[1];
         }
     }
+    else if(first == "fold-render") {
+        cmd = FoldRender;
+        if(args.size() - 1 == 0) {
+            cmd = Error;
+            return;
+        }
+
+        root_file = args[1];
+    }
     else if(first == "llvm-render") {
        cmd = LLVMRender;
         if(args.size() - 1 == 0) {
@@ -101,6 +146,56 @@ void Interpreter::Context::process_args() {
             root_file = args[1];
         }
     }
+    else if(first == "run") {
+        cmd = Run;
+        if(args.size() - 1 == 0) {
+            cmd = Error;
+            return;
+        }
+
+        root_file = args[1];
+    }
+    else if(first == "mir-render") {
+        cmd = MirRender;
+        if(args.size() - 1 == 0) {
+            cmd = Error;
+            return;
+        }
+
+        if(args.size() - 1 == 1) {
+            root_file = args[1];
+        }
+    }
+    else if(first == "vm-render") {
+        cmd = VmRender;
+        if(args.size() - 1 == 0) {
+            cmd = Error;
+            return;
+        }
+
+        root_file = args[1];
+    }
+    else if(first == "vm-run") {
+        cmd = VmRun;
+        if(args.size() - 1 == 0) {
+            cmd = Error;
+            return;
+        }
+
+        root_file = args[1];
+    }
+    else if(first == "tier-run") {
+        cmd = TierRun;
+        if(args.size() - 1 == 0) {
+            cmd = Error;
+            return;
+        }
+
+        // an optional argument is the number of calls and loop iterations before a function is compiled.
+        root_file = args[1];
+        if(args.size() - 1 == 2)
+            tier_threshold = std::strtoull(args[2].c_str(), nullptr, 10);
+    }
     else {
         cmd = BuildExe;
         root_file = first;
@@ -124,11 +219,11 @@ Interpreter::Interpreter(const std::vector<std::string> &args) : context(args) {
 }
 
 io::File *Interpreter::find_file_by_id(u64 id) {
-    auto [file, valid] = context.dir->find(id);
-    if(valid == io::FileOk and file->is_file())
-        return CAST_PTR(io::File, file);
-    else
-        return nullptr;
+    return io::FileRegistry::get().find(id);
+}
+
+io::File *Interpreter::find_file(const std::string &path) {
+    return io::FileRegistry::get().find(path);
 }
 
 void Interpreter::setup() {
@@ -140,8 +235,9 @@ void Interpreter::setup() {
 
     // until that is setup.
     // hand define the prelude scope.
+    mem::Arena::Scope scope(arena);
 
-    prelude = mu::make_scope<mu::ModuleScope>(new ast::Ident(find_name("_prelude"), mu::Pos()), nullptr, nullptr);
+    prelude = mu::make_scope<mu::ModuleScope>(ast::make_ident(find_name("_prelude"), mu::Pos()), nullptr, nullptr);
 
     // use the platform to determine the size of these types.
     type_u8  =  checked_new_type<PrimitiveInt>(Primitive_U8,  (u64) 1, (u64) 1);
@@ -162,19 +258,19 @@ void Interpreter::setup() {
 
     type_unit = checked_new_type<UnitType>();
 
-    auto type_u8_entity  =  new_entity<mu::Type>(new ast::Ident(find_name("u8"),   mu::Pos()), prelude, nullptr);
-    auto type_u16_entity =  new_entity<mu::Type>(new ast::Ident(find_name("u16"),  mu::Pos()), prelude, nullptr);
-    auto type_u32_entity =  new_entity<mu::Type>(new ast::Ident(find_name("u32"),  mu::Pos()), prelude, nullptr);
-    auto type_u64_entity =  new_entity<mu::Type>(new ast::Ident(find_name("u64"),  mu::Pos()), prelude, nullptr);
-    auto type_i8_entity  =  new_entity<mu::Type>(new ast::Ident(find_name("i8"),   mu::Pos()), prelude, nullptr);
-    auto type_i16_entity =  new_entity<mu::Type>(new ast::Ident(find_name("i16"),  mu::Pos()), prelude, nullptr);
-    auto type_i32_entity =  new_entity<mu::Type>(new ast::Ident(find_name("i32"),  mu::Pos()), prelude, nullptr);
-    auto type_i64_entity =  new_entity<mu::Type>(new ast::Ident(find_name("i64"),  mu::Pos()), prelude, nullptr);
-    auto type_f32_entity =  new_entity<mu::Type>(new ast::Ident(find_name("f32"),  mu::Pos()), prelude, nullptr);
-    auto type_f64_entity =  new_entity<mu::Type>(new ast::Ident(find_name("f64"),  mu::Pos()), prelude, nullptr);
-    auto type_char_entity = new_entity<mu::Type>(new ast::Ident(find_name("char"), mu::Pos()),  prelude, nullptr);
-    auto type_bool_entity = new_entity<mu::Type>(new ast::Ident(find_name("bool"), mu::Pos()),  prelude, nullptr);
-    auto type_unit_entity = new_entity<mu::Type>(new ast::Ident(find_name("Unit"), mu::Pos()),  prelude, nullptr);
+    auto type_u8_entity  =  new_entity<mu::Type>(ast::make_ident(find_name("u8"),   mu::Pos()), prelude, nullptr);
+    auto type_u16_entity =  new_entity<mu::Type>(ast::make_ident(find_name("u16"),  mu::Pos()), prelude, nullptr);
+    auto type_u32_entity =  new_entity<mu::Type>(ast::make_ident(find_name("u32"),  mu::Pos()), prelude, nullptr);
+    auto type_u64_entity =  new_entity<mu::Type>(ast::make_ident(find_name("u64"),  mu::Pos()), prelude, nullptr);
+    auto type_i8_entity  =  new_entity<mu::Type>(ast::make_ident(find_name("i8"),   mu::Pos()), prelude, nullptr);
+    auto type_i16_entity =  new_entity<mu::Type>(ast::make_ident(find_name("i16"),  mu::Pos()), prelude, nullptr);
+    auto type_i32_entity =  new_entity<mu::Type>(ast::make_ident(find_name("i32"),  mu::Pos()), prelude, nullptr);
+    auto type_i64_entity =  new_entity<mu::Type>(ast::make_ident(find_name("i64"),  mu::Pos()), prelude, nullptr);
+    auto type_f32_entity =  new_entity<mu::Type>(ast::make_ident(find_name("f32"),  mu::Pos()), prelude, nullptr);
+    auto type_f64_entity =  new_entity<mu::Type>(ast::make_ident(find_name("f64"),  mu::Pos()), prelude, nullptr);
+    auto type_char_entity = new_entity<mu::Type>(ast::make_ident(find_name("char"), mu::Pos()),  prelude, nullptr);
+    auto type_bool_entity = new_entity<mu::Type>(ast::make_ident(find_name("bool"), mu::Pos()),  prelude, nullptr);
+    auto type_unit_entity = new_entity<mu::Type>(ast::make_ident(find_name("Unit"), mu::Pos()),  prelude, nullptr);
 
     type_u8_entity->resolve_to(type_u8);
     type_u16_entity->resolve_to(type_u16);
@@ -215,15 +311,53 @@ void Interpreter::compile() {
         case BuildLib: {
             auto file = context.get_root();
             context.current_file = file;
-            process(file);
+            if(process(file) != InterpResult::Success and exit_code == 0)
+                exit_code = 1;
             break;
         }
+        case BuildAll:
+            if(build_all(context.num_jobs) != InterpResult::Success and exit_code == 0)
+                exit_code = 1;
+            break;
         case AstRender:
-        case LLVMRender: {
+        case FoldRender:
+        case LLVMRender:
+        case MirRender: {
             auto file = context.get_root();
             context.current_file = file;
             render(file);
         } break;
+        case Run: {
+            auto file = context.get_root();
+            context.current_file = file;
+            if(run(file) != InterpResult::Success and exit_code == 0)
+                exit_code = 1;
+        } break;
+        case VmRender: {
+            auto file = context.get_root();
+            context.current_file = file;
+
+            mu::vm::Program program;
+            if(compile_bytecode(file, program) == InterpResult::Success)
+                program.print(std::cout);
+        } break;
+        case VmRun: {
+            auto file = context.get_root();
+            context.current_file = file;
+            if(run_bytecode(file) != InterpResult::Success and exit_code == 0)
+                exit_code = 1;
+        } break;
+        case TierRun: {
+            auto file = context.get_root();
+            context.current_file = file;
+            if(run_tiered(file) != InterpResult::Success and exit_code == 0)
+                exit_code = 1;
+        } break;
+        case Serve: {
+            // the exit codes of the commands it served aren't its own.
+            mu::serve::Server server(this);
+            exit_code = server.run() ? 0 : 1;
+        } break;
         case PrintUsage:
             usage();
             break;
@@ -237,54 +371,181 @@ void Interpreter::compile() {
 }
 
 InterpResult Interpreter::process(io::File *file) {
-    mu::Parser parser(this);
-    mu::Typer typer(this);
-    context.current_file = file;
+    // the object file is written next to its source, 'a/main.mu' is built to 'a/main.o' so
+    // files with the same name in different directories don't share an object.
+    auto object_path = file->path().parent_path().string() + "/" + file->path().filename(false).string() + ".o";
+
+    refresh(file);
+    mu::ModuleSummary summary;
+    if(cache.lookup(file, summary) and cache.has_object(file, summary.hash, object_path)) {
+        print_summary(file, summary);
+        return InterpResult::Success;
+    }
 
-//    mu::Scanner scanner(this);
-//    scanner.init(file);
-//    scanner.advance();
-//
-//    while(true) {
-//        auto token = scanner.token();
-//        scanner.advance();
-//
-//        std::cout << token << std::endl;
-//
-//        if(token.kind() == mu::Tkn_Eof || token.kind() == mu::Tkn_Error) {
-//            break;
-//        }
-//    }
-//    return Success;
+    auto resident = this->resident(file);
+    if(!resident) {
+        mu::Parser parser(this);
+        context.current_file = file;
 
+        auto module = parser.process(file);
+        if(!module or parser.has_error())
+            return InterpResult::Error;
 
-    auto module = parser.process(file);
-//    auto expr = parser.parse_expr();
-//    auto res = typer.resolve_expr(expr.get(), nullptr);
-    if(!module or parser.has_error())
+        resident = resolve(file, module);
+#if defined(MU_TYPE_STATS)
+        types.print_stats(out_stream());
+#endif
+        if(!resident)
+            return InterpResult::Error;
+    }
+
+    mu::CodeGen codegen(this);
+    if(!codegen.generate(resident->module.get(), resident->entities) or !codegen.emit_object(object_path))
         return InterpResult::Error;
-    else {
-        auto modulefile = typer.resolve_main_module(module);
+
+    cache.store(file, summary.hash, resident->entities);
+    cache.store_object(file, summary.hash, object_path);
+    return InterpResult::Success;
+}
+
+InterpResult Interpreter::build_all(u64 num_jobs) {
+    struct Unit {
+        mu::ModuleSummary summary;
+        bool cached{false};
+        Resident* resident{nullptr};
+        // the parsed module until it is resolved, a module with errors is freed with the unit.
+        std::unique_ptr<ast::ModuleFile> module;
+        std::ostringstream diagnostics;
+        bool aborted{false};
+    };
+
+    // the whole tree is loaded before any thread looks up a file.
+    std::vector<io::File*> files;
+    io::FileRegistry::get().collect_sources(files);
+
+    std::vector<Unit> units(files.size());
+    for(u64 i = 0; i < files.size(); ++i) {
+        refresh(files[i]);
+        units[i].cached = cache.lookup(files[i], units[i].summary);
+        if(!units[i].cached)
+            units[i].resident = resident(files[i]);
+    }
+
+    {
+        ThreadPool pool(num_jobs);
+
+        // each worker reuses its own parser, and with it the scanner and token buffer.
+        std::vector<std::unique_ptr<mu::Parser>> parsers(pool.size());
+
+        for(u64 i = 0; i < files.size(); ++i) {
+            // unchanged files are not parsed again.
+            if(units[i].cached or units[i].resident)
+                continue;
+
+            pool.submit([this, &files, &units, &parsers, i](u64 worker) {
+                auto& unit = units[i];
+                StreamScope scope(unit.diagnostics);
+
+                auto& parser = parsers[worker];
+                if(!parser)
+                    parser = std::make_unique<mu::Parser>(this);
+
+                try {
+                    unit.module.reset(parser->process(files[i]));
+                    if(parser->has_error())
+                        unit.aborted = true;
+                }
+                catch(const Abort&) {
+                    // the parser was left in the middle of the file.
+                    parser.reset();
+                    unit.aborted = true;
+                }
+            });
+        }
+
+        // the parsers have to outlive the tasks.
+        pool.wait();
+    }
+
+    // diagnostics are printed in the order of the files, not the order they finished in.
+    bool has_error = false;
+    for(auto& unit : units) {
+        out_stream() << unit.diagnostics.str();
+        has_error = has_error or unit.aborted;
+    }
+
+    if(has_error)
+        return InterpResult::Error;
+
+    for(u64 i = 0; i < files.size(); ++i) {
+        auto& unit = units[i];
+        if(unit.cached) {
+            print_summary(files[i], unit.summary);
+            continue;
+        }
+
+        // the summary of a resident module was removed from the cache.
+        if(unit.resident) {
+            cache.store(files[i], unit.summary.hash, unit.resident->entities);
+            continue;
+        }
+
+        if(!unit.module)
+            continue;
+
+        auto resident = resolve(files[i], unit.module.release());
+        if(!resident)
+            has_error = true;
+        else
+            cache.store(files[i], unit.summary.hash, resident->entities);
     }
+    return has_error ? InterpResult::Error : InterpResult::Success;
 }
 
 InterpResult Interpreter::render(io::File *file) {
-    mu::Parser parser(this);
-    auto module = parser.process(file);
+    if(context.cmd == AstRender) {
+        // the module is rendered as it was written, a resident module has been folded.
+        refresh(file);
+        mu::Parser parser(this);
+        std::unique_ptr<ast::ModuleFile> module(parser.process(file));
 
-    if(parser.has_error())
+        if(parser.has_error())
+            return InterpResult::Error;
+
+        ast::AstRenderer renderer(true, std::cout);
+        renderer.render(module.get());
+        return InterpResult::Success;
+    }
+
+    auto resident = resolve(file);
+    if(!resident)
         return InterpResult::Error;
+    auto module = resident->module.get();
 
     switch(context.cmd) {
-        case AstRender: {
+        case FoldRender: {
+            // the typer folded the module when it was resolved.
             ast::AstRenderer renderer(true, std::cout);
             renderer.render(module);
             return InterpResult::Success;
         }
         case LLVMRender: {
-            mu::Typer typer(this);
-            typer.resolve_main_module(module);
-            return InterpResult::Error;
+            mu::CodeGen codegen(this);
+            if(!codegen.generate(module, resident->entities))
+                return InterpResult::Error;
+
+            codegen.print(std::cout);
+            return InterpResult::Success;
+        }
+        case MirRender: {
+            mu::mir::Module mir_module(module->get_name()->value());
+            mu::mir::Lowering lowering(this, &mir_module);
+            if(!lowering.lower(resident->entities))
+                return InterpResult::Error;
+
+            mu::mir::PassManager::default_pipeline().run(mir_module);
+            mir_module.print(std::cout);
+            return InterpResult::Success;
         }
         default:
             break;
@@ -292,33 +553,275 @@ InterpResult Interpreter::render(io::File *file) {
     return InterpResult::Error;
 }
 
+InterpResult Interpreter::run(io::File *file) {
+    auto resident = resolve(file);
+    if(!resident)
+        return InterpResult::Error;
+
+    mu::CodeGen codegen(this);
+    if(!codegen.generate(resident->module.get(), resident->entities))
+        return InterpResult::Error;
+
+    mu::Jit jit(this);
+    if(!jit.add(codegen.take_module()))
+        return InterpResult::Error;
+    return run_program([&]() {
+        return jit.run_main(exit_code) ? InterpResult::Success : InterpResult::Error;
+    });
+}
+
+InterpResult Interpreter::compile_bytecode(io::File *file, mu::vm::Program &program) {
+    auto resident = resolve(file);
+    if(!resident)
+        return InterpResult::Error;
+
+    mu::vm::Compiler compiler(this, &program);
+    if(!compiler.compile(resident->entities))
+        return InterpResult::Error;
+    return InterpResult::Success;
+}
+
+InterpResult Interpreter::run_bytecode(io::File *file) {
+    mu::vm::Program program;
+    if(compile_bytecode(file, program) != InterpResult::Success)
+        return InterpResult::Error;
+
+    mu::vm::Vm vm(this, program);
+    return run_program([&]() {
+        return vm.run_main(exit_code) ? InterpResult::Success : InterpResult::Error;
+    });
+}
+
+InterpResult Interpreter::run_tiered(io::File *file) {
+    auto resident = resolve(file);
+    if(!resident)
+        return InterpResult::Error;
+
+    auto module = resident->module.get();
+    auto& entities = resident->entities;
+    mu::Function* main = nullptr;
+    for(auto entity : entities)
+        if(entity and entity->is_function() and entity->is_resolved() and entity->get_name()->value() == "main")
+            main = entity->as<mu::Function>();
+
+    if(!main or main->num_params() != 0) {
+        message("The program doesn't have a main");
+        return InterpResult::Error;
+    }
+
+    // the engine compiles on threads of its own, they are started by the process that runs the program.
+    return run_program([&]() {
+        mu::exec::Walker walker(this);
+        mu::exec::TieredEngine engine(this, module, entities, context.tier_threshold);
+        if(!walker.load(entities))
+            return InterpResult::Error;
+        walker.set_engine(&engine);
+
+        // the program writes to the same stdout as the compiler.
+        out_stream().flush();
+
+        mu::vm::Register result;
+        result.i = 0;
+        if(!walker.call(main, nullptr, &result))
+            return InterpResult::Error;
+
+        std::fflush(stdout);
+        exit_code = main->get_ret_type() and !main->get_ret_type()->is_unit() ? CAST(i32, result.i) : 0;
+        engine.summary();
+        return InterpResult::Success;
+    });
+}
+
+InterpResult Interpreter::run_program(const std::function<InterpResult()>& body) {
+#if defined(MU_APPLE) || defined(MU_LINUX)
+    if(isolate_programs) {
+        // the child would write what is buffered a second time.
+        out_stream().flush();
+        std::fflush(stdout);
+
+        auto child = fork();
+        if(child < 0) {
+            message("Unable to start the program: %s", std::strerror(errno));
+            return InterpResult::Error;
+        }
+
+        if(child == 0) {
+            // the child never returns to the server, not even when the command is aborted.
+            auto result = InterpResult::Error;
+            try {
+                result = body();
+            }
+            catch(...) {
+            }
+            out_stream().flush();
+            std::fflush(stdout);
+            _exit(result == InterpResult::Success ? exit_code : 1);
+        }
+
+        i32 status = 0;
+        while(waitpid(child, &status, 0) < 0) {
+            if(errno != EINTR) {
+                message("Unable to wait for the program: %s", std::strerror(errno));
+                return InterpResult::Error;
+            }
+        }
+
+        if(WIFSIGNALED(status)) {
+            message("The program was killed by signal %d, %s", WTERMSIG(status), strsignal(WTERMSIG(status)));
+            exit_code = 128 + WTERMSIG(status);
+            return InterpResult::Error;
+        }
+        exit_code = WEXITSTATUS(status);
+        return InterpResult::Success;
+    }
+#endif
+    return body();
+}
+
+i32 Interpreter::request(const std::vector<std::string>& args) {
+    // the options of the previous command don't carry over.
+    context = Context(args);
+    if(context.cmd == PrimaryCommand::Error and !context.get_root()) {
+        // the file may have been made after the tree was walked.
+        io::FileRegistry::get().rescan();
+        context.process_args();
+    }
+    else if(context.cmd == BuildAll)
+        io::FileRegistry::get().rescan();
+
+    // a fatal error ends the command instead of the process.
+    StreamScope scope(std::cout);
+    exit_code = 0;
+    try {
+        if(args.empty())
+            fatal("missing input file");
+        else
+            compile();
+    }
+    catch(const Abort&) {
+        if(exit_code == 0)
+            exit_code = 1;
+    }
+    std::cout.flush();
+    return exit_code;
+}
+
+Interpreter::Resident* Interpreter::resident(io::File* file) {
+    auto iter = residents.find(file);
+    if(iter == residents.end() or !iter->second.resolved)
+        return nullptr;
+
+    // the folder unrolled the loops in place, another limit needs the module parsed again.
+    if(iter->second.unroll_limit != context.unroll_limit) {
+        drop(file);
+        return nullptr;
+    }
+    return &iter->second;
+}
+
+Interpreter::Resident* Interpreter::resolve(io::File* file) {
+    refresh(file);
+    context.current_file = file;
+    if(auto found = resident(file))
+        return found;
+
+    mu::Parser parser(this);
+    auto module = parser.process(file);
+    if(!module or parser.has_error())
+        return nullptr;
+    return resolve(file, module);
+}
+
+Interpreter::Resident* Interpreter::resolve(io::File* file, ast::ModuleFile* module) {
+    context.current_file = file;
+
+    // an earlier attempt that failed left its named types in the table.
+    auto [iter, fresh] = residents.try_emplace(file);
+    if(!fresh)
+        types.forget(module->get_name()->val);
+
+    auto& resident = iter->second;
+    resident = Resident();
+    resident.module.reset(module);
+
+    mu::Typer typer(this);
+    typer.resolve_main_module(module);
+    if(typer.has_error())
+        return nullptr;
+
+    resident.entities = typer.module_entities();
+    resident.resolved = true;
+    resident.unroll_limit = context.unroll_limit;
+    return &resident;
+}
+
+void Interpreter::refresh(io::File* file) {
+    if(!file->is_load() or !file->changed())
+        return;
+
+    // taken before the file is read, a change made while it is read is seen by the next command.
+    file->restamp();
+    std::ifstream in(file->absolute_path().string(), std::ios::binary);
+    if(in) {
+        std::string content{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        if(mu::ModuleCache::content_hash(content) == mu::ModuleCache::content_hash(file))
+            return;
+    }
+
+    drop(file);
+    file->unload();
+}
+
+void Interpreter::drop(io::File* file) {
+    auto iter = residents.find(file);
+    if(iter != residents.end()) {
+        types.forget(iter->second.module->get_name()->val);
+        residents.erase(iter);
+    }
+}
+
+void Interpreter::print_summary(io::File* file, const mu::ModuleSummary& summary) {
+    out_stream() << "'" << file->name() << "' is unchanged, using its cached summary" << std::endl;
+    for(auto& ex : summary.exports)
+        message("%s: %s", ex.name.c_str(), ex.type.c_str());
+}
+
 void Interpreter::usage() {
 
 }
 
 void Interpreter::print_file_pos(const mu::Pos &pos) {
-    auto file = find_file_by_id(pos.fid);
-    out_stream() << file->absolute_path() << ":" << pos << " ";
+    auto file = io::File::at(pos.offset);
+    if(!file)
+        return;
+
+    // the line and column are only needed here, they are found from the offset.
+    auto [line, column] = file->line_column(pos.offset);
+    out_stream() << file->absolute_path() << ":" << line << ":" << column << " ";
 }
 
 void Interpreter::print_file_section(const mu::Pos &pos) {
-    auto file = find_file_by_id(pos.fid);
+    auto file = io::File::at(pos.offset);
+    if(!file)
+        return;
 
-    auto line = pos.line;
-	const auto& line_str = file->get_line(line);
+    auto [line, column] = file->line_column(pos.offset);
+	auto line_str = file->get_line(line);
 
 	// removes the spaces and tabs from the line.
 	// this is so the carret lines up properly.
 	u32 offset = 0;
 	u32 toremove = 0;
-	while(line_str[offset] == ' ' or
-		  line_str[offset] == '\t') {
+	while(offset < line_str.size() and
+	      (line_str[offset] == ' ' or line_str[offset] == '\t')) {
 		toremove++;
 		offset++;
 	}
 
     out_stream() << "\t" <<  line_str.substr(offset) << std::endl;
-    out_stream() << "\t" << std::string(pos.column - toremove - 1, ' ') << '^' << std::endl;
+    // a position in the indentation is shown at the start of the text.
+    auto indent = column > toremove ? column - toremove - 1 : 0;
+    out_stream() << "\t" << std::string(indent, ' ') << '^' << std::endl;
 }
 
 void Interpreter::fatal(const std::string &msg) {
@@ -326,15 +829,17 @@ void Interpreter::fatal(const std::string &msg) {
     quit();
 }
 
-Atom* Interpreter::find_name(const std::string &name) {
-    auto iter = names.find(name);
-    if(iter == names.end())
-        return names.emplace(name, new Atom(name)).first->second;
-    else
-        return iter->second;
+Atom* Interpreter::find_name(std::string_view name) {
+    return names.find(name);
+}
+
+Atom* Interpreter::find_name(std::string_view name, u64 hash) {
+    return names.find(name, hash);
 }
 
 void Interpreter::quit() {
+    if(thread_out)
+        throw Abort();
     exit(1);
 }
 
@@ -385,6 +890,12 @@ bool Interpreter::equivalent_types(mu::types::Type *t1, mu::types::Type *t2) {
                     CAST_PTR(mu::types::TraitType, t2));
 		case mu::types::PtrType:
 			return equivalent_types(t1->base_type(), t2->base_type());
+		case mu::types::ArrayType: {
+			auto at1 = t1->as<mu::types::Array>();
+			auto at2 = t2->as<mu::types::Array>();
+			return at1->num_elements() == at2->num_elements() and
+				equivalent_types(at1->get_element_type(), at2->get_element_type());
+		}
 		case mu::types::TupleType: {
 			auto tt1 = t1->as<mu::types::Tuple>();
 			auto tt2 = t2->as<mu::types::Tuple>();
@@ -8,22 +8,34 @@
 
 #include "analysis/entity.hpp"
 #include "analysis/types/type.hpp"
+#include "analysis/types/type_table.hpp"
 #include "analysis/typer.hpp"
 #include "analysis/scope.hpp"
+#include "analysis/module_cache.hpp"
 
 #include "parser/ast/ast_common.hpp"
 #include "parser/ast/module.hpp"
 
 #include "utils/io.hpp"
 #include "utils/file.hpp"
-#include "utils/directory.hpp"
+#include "utils/file_registry.hpp"
+#include "utils/atom_table.hpp"
+#include "utils/arena.hpp"
 
 #include <cstdio>
+#include <functional>
+#include <memory>
 #include <ostream>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 
+namespace mu {
+    namespace vm {
+        struct Program;
+    }
+}
+
 enum InterpResult {
     Success,
     Error,
@@ -35,8 +47,16 @@ public:
     enum PrimaryCommand {
         BuildExe, // default, no command
         BuildLib,
+        BuildAll, // parses every module file of the directory
         AstRender,
+        FoldRender, // renders the ast after the constant expressions are folded
         LLVMRender,
+        MirRender,
+        Run, // compiles the module in memory and calls its main
+        VmRender,
+        VmRun, // compiles the module to bytecode and runs its main in the vm
+        TierRun, // interprets the module, hot functions are jit compiled in the background
+        Serve, // keeps the state of the interpreter and runs the commands sent by clients
         PrintUsage,
         Error,
     };
@@ -45,7 +65,6 @@ public:
         PrimaryCommand cmd;
 
         io::File* current_file{nullptr};
-        io::Directory* dir{nullptr};
         // io::Directory* standard; // Directory containing standard library
         // command line argument arguments are stored here.
         std::vector<std::string> args;
@@ -55,49 +74,118 @@ public:
         std::string render_file;
         std::string root_file;
 
+        // number of threads used by build-all, 0 is one per hardware thread.
+        u64 num_jobs{0};
+
+        // calls and loop iterations of a function before tier-run compiles it.
+        u64 tier_threshold{1000};
+
+        // the most iterations of a loop over a constant range the folder unrolls, 0 keeps every loop.
+        u64 unroll_limit{16};
+
         Context(const std::vector<std::string>& args);
         void process_args();
     };
 
+    // thrown by quit() on a thread with a redirected stream, see StreamScope.
+    // the thread gives up on its file instead of exiting the process.
+    struct Abort {};
+
+    // redirects the output of the calling thread to out for its lifetime.
+    // used by the parallel build so the diagnostics of each file can be printed in order.
+    class StreamScope {
+    public:
+        StreamScope(std::ostream& out);
+        ~StreamScope();
+
+    private:
+        std::ostream* previous;
+    };
+
     Interpreter(const std::vector<std::string>& args);
 
     void setup();
 
     void compile();
 
+    // parses and resolves file, unless the cache has an up to date summary of it.
     InterpResult process(io::File *file);
 
     InterpResult render(io::File* file);
 
+    // jit compiles file and calls its main, the result of main is the exit code.
+    InterpResult run(io::File* file);
+
+    // parses, resolves and compiles file to bytecode.
+    InterpResult compile_bytecode(io::File* file, mu::vm::Program& program);
+
+    // runs the main of file in the vm, the result of main is the exit code.
+    InterpResult run_bytecode(io::File* file);
+
+    // interprets the main of file, the functions that get hot are compiled to native code.
+    InterpResult run_tiered(io::File* file);
+
+    // runs a program with body. While serving, the program runs in a child process so one that
+    // traps or exits doesn't take the server with it, the status of the child is the exit code.
+    InterpResult run_program(const std::function<InterpResult()>& body);
+
+    // scans and parses every module file of the directory in parallel, then
+    // type checks them in path order.
+    InterpResult build_all(u64 num_jobs);
+
+    // runs the command of args with the state left by the earlier commands, the server calls it
+    // for every request. The result is the exit code of the command.
+    i32 request(const std::vector<std::string>& args);
+
     void usage();
 
-    Atom* find_name(const std::string& name);
+    Atom* find_name(std::string_view name);
+
+    // hash is from AtomTable::hash, used when the caller has already computed it.
+    Atom* find_name(std::string_view name, u64 hash);
 
     inline void set_stream(std::ostream* out) { this->out = out; }
-    inline std::ostream& out_stream() { return *out; }
+    inline std::ostream& out_stream() { return thread_out ? *thread_out : *out; }
 
     inline io::File* current_file() { return context.current_file; }
 
+    // the server runs every program in a child process of its own.
+    inline void set_isolate_programs(bool isolate) { isolate_programs = isolate; }
+
+    inline u64 unroll_limit() const { return context.unroll_limit; }
+    inline void set_unroll_limit(u64 limit) { context.unroll_limit = limit; }
+
     io::File* find_file_by_id(u64 id);
 
+    // a file of the working directory by its relative path, nullptr if it doesn't exist.
+    io::File* find_file(const std::string& path);
+
     template<typename... Args>
     void report_error(const mu::Pos& pos, const std::string& fmt, Args... args) {
         print_file_pos(pos);
 
-		printf("\033[0;31m");
-        out_stream() << "Error: ";
-        printf(fmt.c_str(), args...);
-		printf("\033[0m");
-
-        out_stream() << std::endl;
+        out_stream() << "\033[0;31m" << "Error: ";
+        out_stream() << format(fmt, args...);
+        out_stream() << "\033[0m" << std::endl;
         print_file_section(pos);
     }
 
     template <typename... Args>
     void message(const std::string& fmt, Args... args) {
-        out_stream() << "\t";
-        printf(fmt.c_str(), args...);
-        out_stream() << std::endl;
+        out_stream() << "\t" << format(fmt, args...) << std::endl;
+    }
+
+    // printf style formatting into a string.
+    template <typename... Args>
+    static std::string format(const std::string& fmt, Args... args) {
+        auto length = snprintf(nullptr, 0, fmt.c_str(), args...);
+        if(length <= 0)
+            return std::string();
+
+        std::string result(length + 1, '\0');
+        snprintf(result.data(), result.size(), fmt.c_str(), args...);
+        result.pop_back();
+        return result;
     }
 
     template <typename... Args>
@@ -111,6 +199,9 @@ public:
 
     void fatal(const std::string& msg);
 
+    // the exit code of the process, set by the program when it is run.
+    inline i32 get_exit_code() { return exit_code; }
+
     void quit();
 
     void print_file_pos(const mu::Pos& pos);
@@ -131,21 +222,13 @@ public:
     Ty* checked_new_type(Args... args) {
         static_assert(std::is_base_of<mu::types::Type, Ty>::value, "attempting to constructing non-scope object");
 
-        /// this type is not added to the set then it will be cleanup automatically.
-        auto type = new_type<Ty>(args...);
-
-        // I know this isn't the most efficent but it works for now.
-        for(auto& ty : types) {
-            if(equivalent_types(ty.get(), type.get())) {
-                return ty.get()->template as<Ty>();;
-            }
-        }
-
-        // an equivalent type is not found. Add it to the type set and return it casted.
-        auto iter = types.emplace(std::move(type));
-        return (*iter.first)->template as<Ty>();
+        /// if an equivalent type is already interned then this type is cleaned up automatically.
+        auto type = types.intern(new_type<Ty>(args...));
+        return type->template as<Ty>();
     }
 
+    inline mu::types::TypeTable& type_table() { return types; }
+
 
     template<typename Ty, typename... Args>
     Ty* new_entity(Args... args) {
@@ -176,15 +259,57 @@ public:
     void remove_entity(mu::Entity* entity);
 
 private:
+    // a module that has been parsed and resolved. It is kept until its file changes, so a
+    // server reuses it for every command on the file instead of parsing and resolving it again.
+    struct Resident {
+        std::unique_ptr<ast::ModuleFile> module;
+        std::vector<mu::Entity*> entities;
+        bool resolved{false};
+        // the loops of the module were unrolled up to this limit when it was folded.
+        u64 unroll_limit{0};
+    };
+
+    // the resident module of file, nullptr if it hasn't been resolved or was folded with
+    // another unroll limit.
+    Resident* resident(io::File* file);
+
+    // the resident module of file, it is parsed and resolved if there isn't one.
+    // nullptr when the module has errors.
+    Resident* resolve(io::File* file);
+
+    // resolves a module parsed from file and keeps it, nullptr when it has errors.
+    Resident* resolve(io::File* file, ast::ModuleFile* module);
+
+    // makes the loaded content of file the content on disk. The content is only hashed when the
+    // modification time changed, a file that was touched keeps its content and resident module.
+    void refresh(io::File* file);
+
+    // forgets the resident module of file and the types it named.
+    void drop(io::File* file);
+
+    // prints the exports of a file that was loaded from the cache.
+    void print_summary(io::File* file, const mu::ModuleSummary& summary);
+
     Context context;
-    std::unordered_map<std::string, Atom*> names;
+    AtomTable names;
     std::ostream* out;
 
-    std::unordered_set<mu::types::TypePtr> types;
+    mu::types::TypeTable types;
+    mu::ModuleCache cache;
+    std::unordered_map<io::File*, Resident> residents;
     std::unordered_set<mu::EntityPtr> entities;
+
+    // owns the nodes that don't belong to a module, such as the names of the prelude.
+    mem::Arena arena;
 //    mu::Module* prelude{nullptr};
     mu::ScopePtr prelude;
     static Interpreter* instance;
+
+    i32 exit_code{0};
+    bool isolate_programs{false};
+
+    // the stream of the current thread if it has been redirected.
+    static thread_local std::ostream* thread_out;
 };
 
 
@@ -1,8 +1,8 @@
 #include <iostream>
 #include "interpreter.hpp"
+#include "serve/server.hpp"
 #include "parser/scanner/scanner.hpp"
 #include "parser/scanner/token.hpp"
-#include "utils/directory.hpp"
 #include "utils/file.hpp"
 
 
@@ -14,6 +14,22 @@ int main(i32 argc, const char** argv) {
     for(i32 i = 1; i < argc; ++i)
         args.emplace_back(argv[i]);
 
+    // a client sends its command to the server of the working directory, the command is
+    // run by this process when there isn't one. A command only a server runs isn't.
+    if(!args.empty() and args.front() == "client") {
+        args.erase(args.begin());
+
+        i32 exit_code = 0;
+        if(mu::serve::client(args, exit_code))
+            return exit_code;
+
+        if(!args.empty() and args.front() == "shutdown") {
+            std::cerr << "Fatal Error: no server answered, there is nothing to shut down" << std::endl;
+            return 1;
+        }
+        std::cerr << "no server answered, the command runs in this process" << std::endl;
+    }
+
     Interpreter interp(args);
     interp.set_stream(&std::cout);
 
@@ -22,4 +38,5 @@ int main(i32 argc, const char** argv) {
     else {
         interp.compile();
     }
+    return interp.get_exit_code();
 }
\ No newline at end of file
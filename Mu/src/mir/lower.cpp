@@ -0,0 +1,1263 @@
+#include "lower.hpp"
+#include "analysis/types/type.hpp"
+#include "parser/ast/ast_common.hpp"
+
+extern mu::types::Type* type_bool;
+extern mu::types::Type* type_unit;
+
+// mutable only qualifies a type, it is lowered the same as the type it qualifies.
+static mu::types::Type* strip(mu::types::Type* type) {
+    while(type and type->kind() == mu::types::MutableType)
+        type = type->as<mu::types::Mutable>()->get_inner();
+    return type;
+}
+
+static mu::TokenKind compound_operator(mu::TokenKind op) {
+    switch(op) {
+        case mu::Tkn_PlusEqual: return mu::Tkn_Plus;
+        case mu::Tkn_MinusEqual: return mu::Tkn_Minus;
+        case mu::Tkn_AstrickEqual: return mu::Tkn_Astrick;
+        case mu::Tkn_SlashEqual: return mu::Tkn_Slash;
+        case mu::Tkn_PercentEqual: return mu::Tkn_Percent;
+        case mu::Tkn_AstrickAstrickEqual: return mu::Tkn_AstrickAstrick;
+        case mu::Tkn_LessLessEqual: return mu::Tkn_LessLess;
+        case mu::Tkn_GreaterGreaterEqual: return mu::Tkn_GreaterGreater;
+        case mu::Tkn_AmpersandEqual: return mu::Tkn_Ampersand;
+        case mu::Tkn_PipeEqual: return mu::Tkn_Pipe;
+        case mu::Tkn_CarrotEqual: return mu::Tkn_Carrot;
+        default: return op;
+    }
+}
+
+// the initializer of a struct member when it isn't given in the struct expression.
+static ast::ExprPtr default_member_init(mu::Local* member) {
+    auto decl = member->get_decl();
+    if(!decl or decl->kind != ast::ast_member_variable)
+        return nullptr;
+
+    auto variable = decl->as<ast::MemberVariable>();
+    if(variable->init.size() == 1)
+        return variable->init[0];
+
+    for(u64 i = 0; i < variable->names.size() and i < variable->init.size(); ++i)
+        if(variable->names[i]->val == member->get_name()->val)
+            return variable->init[i];
+    return nullptr;
+}
+
+static ast::ExprPtr accessor_operand(ast::Expr* expr) {
+    return expr->kind == ast::ast_accessor ? expr->as<ast::Accessor>()->operand :
+           expr->as<ast::TupleAcessor>()->operand;
+}
+
+// the index of the member or element an accessor refers to, -1 if it isn't known.
+static u64 accessor_index(ast::Expr* expr) {
+    if(expr->kind == ast::ast_tuple_accessor)
+        return expr->as<ast::TupleAcessor>()->value;
+
+    auto type = strip(accessor_operand(expr)->type);
+    if(type->is_ptr())
+        type = strip(type->base_type());
+
+    auto member = expr->operand.entity;
+    if(!member or type->kind() != mu::types::StructureType)
+        return (u64) -1;
+    return type->as<mu::types::StructType>()->get_index_of_member(member);
+}
+
+// the value a literal pattern matches.
+static bool pattern_value(ast::Pattern* pattern, i64& value) {
+    switch(pattern->kind) {
+        case ast::ast_int_pattern: value = pattern->as<ast::IntPattern>()->value; return true;
+        case ast::ast_char_pattern: value = pattern->as<ast::CharPattern>()->value; return true;
+        case ast::ast_bool_pattern: value = pattern->as<ast::BoolPattern>()->value; return true;
+        default: return false;
+    }
+}
+
+namespace mu {
+    namespace mir {
+
+        Lowering::Lowering(Interpreter *interp, Module *module) : interp(interp), module(module) {
+        }
+
+        bool Lowering::lower(const std::vector<Entity *> &entities) {
+            // everything is declared before any body is lowered so the order of the
+            // declarations doesn't matter.
+            std::vector<mu::Function*> bodies;
+            for(auto entity : entities) {
+                if(!entity or !entity->is_resolved())
+                    continue;
+
+                switch(entity->kind()) {
+                    case FunctionEntity: {
+                        auto function = entity->as<mu::Function>();
+                        declare_function(function, function->get_name()->value());
+                        bodies.push_back(function);
+                    } break;
+                    case TypeEntity: {
+                        auto type = entity->as<Type>();
+                        if(!type->is_struct())
+                            break;
+
+                        // methods are named by their type, 'Point.new'.
+                        auto scope = type->get_type()->as<types::StructType>()->get_scope();
+                        for(auto block : type->get_impls()) {
+                            for(auto decl : block->as<ast::Impl>()->methods) {
+                                if(decl->kind != ast::ast_procedure)
+                                    continue;
+
+                                auto [member, found] = scope->find(decl->as<ast::Procedure>()->name);
+                                if(!found or !member->is_function() or !member->is_resolved())
+                                    continue;
+
+                                auto method = member->as<mu::Function>();
+                                declare_function(method, type->get_name()->value() + "." + member->get_name()->value());
+                                bodies.push_back(method);
+                            }
+                        }
+                    } break;
+                    case GlobalEntity: {
+                        auto global = entity->as<Global>();
+                        globals.emplace(global, module->add_global(pointer_to(global->get_type()), global));
+                    } break;
+                    default:
+                        break;
+                }
+            }
+
+            for(auto function : bodies)
+                lower_function(function);
+
+            return !has_error();
+        }
+
+        void Lowering::declare_function(mu::Function *entity, const std::string &name) {
+            auto function = module->add_function(entity->get_type(), entity, name);
+
+            // the c variadic parameter isn't an argument, the rest of the actuals are passed in its place.
+            auto num_params = entity->num_params();
+            if(entity->is_variadic() and entity->get_param(num_params - 1)->is_cvariadic())
+                num_params--;
+
+            for(u32 i = 0; i < num_params; ++i) {
+                auto param = entity->get_param(i);
+                function->arguments().push_back(std::make_unique<Argument>(param->get_type(), i,
+                                                                           param->get_name()->value()));
+            }
+            functions.emplace(entity, function);
+        }
+
+        void Lowering::lower_function(mu::Function *entity) {
+            if(entity->no_body())
+                return;
+
+            this->entity = entity;
+            function = functions[entity];
+            definitions.clear();
+            incomplete_phis.clear();
+            sealed.clear();
+            removed_phis.clear();
+            address_taken.clear();
+            slots.clear();
+            defers.clear();
+
+            auto decl = entity->get_decl()->as<ast::Procedure>();
+            find_address_taken(decl->body);
+
+            current = function->create_block();
+            seal_block(current);
+
+            for(u32 i = 0; i < function->arguments().size(); ++i)
+                store_local(entity->get_param(i), function->arguments()[i].get());
+
+            auto value = lower_expr(decl->body);
+            if(value and run_defers(0)) {
+                auto ret = entity->get_ret_type();
+                if(!ret or ret->is_unit())
+                    emit(Op_Return, type_unit, {});
+                else
+                    emit(Op_Return, type_unit, {value});
+            }
+            else if(!current->terminator())
+                emit(Op_Unreachable, type_unit, {});
+
+            for(auto phi : removed_phis)
+                phi->get_parent()->erase(phi);
+
+            function->renumber();
+        }
+
+        /*--------------------------SSA Construction----------------------------*/
+
+        void Lowering::write_variable(Variable var, BasicBlock *block, Value *value) {
+            definitions[block][var] = value;
+        }
+
+        Value* Lowering::read_variable(Variable var, types::Type *type, BasicBlock *block) {
+            auto& defs = definitions[block];
+            auto iter = defs.find(var);
+            if(iter != defs.end())
+                return iter->second;
+            return read_variable_recursive(var, type, block);
+        }
+
+        Value* Lowering::read_variable_recursive(Variable var, types::Type *type, BasicBlock *block) {
+            Value* value = nullptr;
+            if(!sealed.count(block)) {
+                // not every predecessor is known, the phi is completed when the block is sealed.
+                auto phi = block->prepend(std::make_unique<Instruction>(Op_Phi, type, std::vector<Value*>()));
+                incomplete_phis[block].emplace_back(var, phi);
+                value = phi;
+            }
+            else if(block->predecessors().empty())
+                value = module->get_undef(type);
+            else if(block->predecessors().size() == 1)
+                value = read_variable(var, type, block->predecessors().front());
+            else {
+                // the phi is written first to break the cycles through loops.
+                auto phi = block->prepend(std::make_unique<Instruction>(Op_Phi, type, std::vector<Value*>()));
+                write_variable(var, block, phi);
+                value = add_phi_operands(var, phi);
+            }
+
+            write_variable(var, block, value);
+            return value;
+        }
+
+        Value* Lowering::add_phi_operands(Variable var, Instruction *phi) {
+            auto block = phi->get_parent();
+            for(auto pred : block->predecessors())
+                phi->add_incoming(read_variable(var, phi->get_type(), pred), pred);
+            return try_remove_trivial_phi(phi);
+        }
+
+        Value* Lowering::try_remove_trivial_phi(Instruction *phi) {
+            Value* same = nullptr;
+            for(auto operand : phi->get_operands()) {
+                if(operand == same or operand == phi)
+                    continue;
+                if(same)
+                    return phi;
+                same = operand;
+            }
+
+            // the phi is unreachable or in the entry block.
+            if(!same)
+                same = module->get_undef(phi->get_type());
+
+            std::vector<Instruction*> users;
+            for(auto& block : function->blocks())
+                for(auto& inst : block->instructions())
+                    if(inst.get() != phi and inst->opcode() == Op_Phi and !removed_phis.count(inst.get()))
+                        for(auto operand : inst->get_operands())
+                            if(operand == phi) {
+                                users.push_back(inst.get());
+                                break;
+                            }
+
+            function->replace_uses(phi, same);
+            for(auto& [block, defs] : definitions)
+                for(auto& [key, value] : defs)
+                    if(value == phi)
+                        value = same;
+            removed_phis.insert(phi);
+
+            // removing the phi can make the phis using it trivial.
+            for(auto user : users)
+                if(!removed_phis.count(user))
+                    try_remove_trivial_phi(user);
+
+            return same;
+        }
+
+        void Lowering::seal_block(BasicBlock *block) {
+            auto iter = incomplete_phis.find(block);
+            if(iter != incomplete_phis.end()) {
+                auto phis = std::move(iter->second);
+                incomplete_phis.erase(iter);
+                for(auto [var, phi] : phis)
+                    add_phi_operands(var, phi);
+            }
+            sealed.insert(block);
+        }
+
+        void Lowering::store_local(Entity *local, Value *value) {
+            if(address_taken.count(local))
+                emit(Op_Store, type_unit, {local_slot(local), value});
+            else
+                write_variable(local, current, value);
+        }
+
+        Value* Lowering::load_local(Entity *local) {
+            if(address_taken.count(local)) {
+                auto load = emit(Op_Load, local->get_type(), {local_slot(local)});
+                load->name = local->get_name()->value();
+                return load;
+            }
+            return read_variable(local, local->get_type(), current);
+        }
+
+        Value* Lowering::local_slot(Entity *local) {
+            auto iter = slots.find(local);
+            if(iter != slots.end())
+                return iter->second;
+
+            // the slots are in the entry block so they are only created once.
+            auto slot = function->entry()->prepend(std::make_unique<Instruction>(Op_Slot, pointer_to(local->get_type()),
+                                                                                 std::vector<Value*>()));
+            slot->name = local->get_name()->value();
+            slots.emplace(local, slot);
+            return slot;
+        }
+
+        void Lowering::find_address_taken(ast::Expr *expr) {
+            if(!expr)
+                return;
+
+            switch(expr->kind) {
+                case ast::ast_binary:
+                    find_address_taken(expr->as<ast::Binary>()->lhs);
+                    find_address_taken(expr->as<ast::Binary>()->rhs);
+                    break;
+                case ast::ast_unary: {
+                    auto unary = expr->as<ast::Unary>();
+                    if(unary->op == Tkn_Ampersand)
+                        mark_address_taken(unary->expr);
+                    find_address_taken(unary->expr);
+                } break;
+                case ast::ast_cast_expr:
+                    find_address_taken(expr->as<ast::Cast>()->operand);
+                    break;
+                case ast::ast_tuple_expr:
+                    for(auto element : expr->as<ast::TupleExpr>()->elements)
+                        find_address_taken(element);
+                    break;
+                case ast::ast_struct_expr:
+                    for(auto member : expr->as<ast::StructExpr>()->members)
+                        find_address_taken(member->kind == ast::ast_expr_binding ? member->as<ast::BindingExpr>()->expr : member);
+                    break;
+                case ast::ast_accessor:
+                case ast::ast_tuple_accessor:
+                    find_address_taken(accessor_operand(expr));
+                    break;
+                case ast::ast_call:
+                    find_address_taken(expr->as<ast::Call>()->name);
+                    for(auto actual : expr->as<ast::Call>()->actuals)
+                        find_address_taken(actual);
+                    break;
+                case ast::ast_method: {
+                    // the receiver is passed by address.
+                    auto& actuals = expr->as<ast::Method>()->actuals;
+                    if(!actuals.empty() and actuals[0]->type and !strip(actuals[0]->type)->is_ptr())
+                        mark_address_taken(actuals[0]);
+                    for(auto actual : actuals)
+                        find_address_taken(actual);
+                } break;
+                case ast::ast_block:
+                    for(auto stmt : expr->as<ast::Block>()->elements) {
+                        if(stmt->kind == ast::ast_expr)
+                            find_address_taken(stmt->as<ast::ExprStmt>()->expr);
+                        else if(stmt->kind == ast::ast_decl) {
+                            auto decl = stmt->as<ast::DeclStmt>()->decl;
+                            if(decl->kind == ast::ast_local)
+                                find_address_taken(decl->as<ast::Local>()->init);
+                            else if(decl->kind == ast::ast_mutable)
+                                find_address_taken(decl->as<ast::Mutable>()->init);
+                        }
+                    }
+                    break;
+                case ast::ast_if_expr:
+                    find_address_taken(expr->as<ast::If>()->cond);
+                    find_address_taken(expr->as<ast::If>()->body);
+                    find_address_taken(expr->as<ast::If>()->else_if);
+                    break;
+                case ast::ast_while_expr:
+                    find_address_taken(expr->as<ast::While>()->cond);
+                    find_address_taken(expr->as<ast::While>()->body);
+                    break;
+                case ast::ast_for_expr:
+                    find_address_taken(expr->as<ast::For>()->expr);
+                    find_address_taken(expr->as<ast::For>()->body);
+                    break;
+                case ast::ast_range:
+                    find_address_taken(expr->as<ast::Range>()->start);
+                    find_address_taken(expr->as<ast::Range>()->end);
+                    find_address_taken(expr->as<ast::Range>()->step);
+                    break;
+                case ast::ast_match_expr:
+                    find_address_taken(expr->as<ast::Match>()->cond);
+                    for(auto member : expr->as<ast::Match>()->members)
+                        find_address_taken(member->as<ast::MatchArm>()->body);
+                    break;
+                case ast::ast_defer_expr:
+                    find_address_taken(expr->as<ast::Defer>()->body);
+                    break;
+                case ast::ast_return:
+                    find_address_taken(expr->as<ast::Return>()->body);
+                    break;
+                case ast::ast_assign:
+                    find_address_taken(expr->as<ast::Assign>()->lvalue);
+                    find_address_taken(expr->as<ast::Assign>()->rvalue);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        void Lowering::mark_address_taken(ast::Expr *expr) {
+            // the address of a member is the address of the value it is a member of.
+            while((expr->kind == ast::ast_accessor or expr->kind == ast::ast_tuple_accessor) and
+                  accessor_operand(expr)->type and !strip(accessor_operand(expr)->type)->is_ptr())
+                expr = accessor_operand(expr);
+
+            if(expr->kind != ast::ast_name and expr->kind != ast::ast_self_expr)
+                return;
+
+            auto entity = expr->operand.entity;
+            if(entity and entity->is_local())
+                address_taken.insert(entity);
+        }
+
+        /*-----------------------------Expressions------------------------------*/
+
+        Value* Lowering::lower_expr(ast::Expr *expr) {
+            position = expr->pos();
+
+            auto type = strip(expr->type);
+            // a block, branch or call with a constant value still runs its statements.
+            if(mu::is_constant_expr(expr) and type and type->is_primative())
+                return lower_constant(expr->operand.val, type);
+
+            switch(expr->kind) {
+                case ast::ast_name:
+                case ast::ast_self_expr:
+                    return lower_name(expr);
+                case ast::ast_unit_expr:
+                    return unit_value();
+                case ast::ast_binary:
+                    return lower_binary(expr->as<ast::Binary>());
+                case ast::ast_unary:
+                    return lower_unary(expr->as<ast::Unary>());
+                case ast::ast_cast_expr: {
+                    auto value = lower_expr(expr->as<ast::Cast>()->operand);
+                    if(!value)
+                        return nullptr;
+                    return emit(Op_Cast, expr->type, {value});
+                }
+                case ast::ast_tuple_expr:
+                    return lower_tuple(expr->as<ast::TupleExpr>());
+                case ast::ast_struct_expr:
+                    return lower_struct(expr->as<ast::StructExpr>());
+                case ast::ast_accessor:
+                case ast::ast_tuple_accessor:
+                    return lower_accessor(expr);
+                case ast::ast_call:
+                    return lower_call(expr->as<ast::Call>());
+                case ast::ast_method:
+                    return lower_method(expr->as<ast::Method>());
+                case ast::ast_block:
+                    return lower_block(expr->as<ast::Block>());
+                case ast::ast_if_expr:
+                    return lower_if(expr->as<ast::If>());
+                case ast::ast_while_expr:
+                    return lower_while(expr->as<ast::While>());
+                case ast::ast_for_expr:
+                    return lower_for(expr->as<ast::For>());
+                case ast::ast_match_expr:
+                    return lower_match(expr->as<ast::Match>());
+                case ast::ast_defer_expr:
+                    defers.push_back(expr->as<ast::Defer>()->body);
+                    return unit_value();
+                case ast::ast_return:
+                    return lower_return(expr->as<ast::Return>());
+                case ast::ast_assign:
+                    return lower_assign(expr->as<ast::Assign>());
+                default:
+                    report(expr->pos(), "this expression can not be lowered at this time");
+                    return nullptr;
+            }
+        }
+
+        Value* Lowering::lower_address(ast::Expr *expr) {
+            switch(expr->kind) {
+                case ast::ast_name:
+                case ast::ast_self_expr: {
+                    auto entity = expr->operand.entity;
+                    if(entity and entity->is_local() and address_taken.count(entity))
+                        return local_slot(entity);
+                    if(entity and entity->is_global()) {
+                        auto iter = globals.find(entity->as<Global>());
+                        return iter == globals.end() ? nullptr : iter->second;
+                    }
+                    return nullptr;
+                }
+                case ast::ast_accessor:
+                case ast::ast_tuple_accessor: {
+                    auto operand = accessor_operand(expr);
+
+                    // a pointer is accessed through, otherwise the operand needs storage.
+                    Value* base = strip(operand->type)->is_ptr() ? lower_expr(operand) : lower_address(operand);
+                    if(!base)
+                        return nullptr;
+
+                    auto index = accessor_index(expr);
+                    if(index == (u64) -1)
+                        return nullptr;
+
+                    auto address = emit(Op_MemberAddr, pointer_to(expr->type), {base});
+                    address->index = index;
+                    return address;
+                }
+                case ast::ast_unary: {
+                    auto unary = expr->as<ast::Unary>();
+                    if(unary->op == Tkn_Astrick)
+                        return lower_expr(unary->expr);
+                    return nullptr;
+                }
+                default:
+                    return nullptr;
+            }
+        }
+
+        Value* Lowering::lower_spilled_address(ast::Expr *expr) {
+            if(auto address = lower_address(expr))
+                return address;
+
+            auto value = lower_expr(expr);
+            if(!value)
+                return nullptr;
+
+            auto slot = function->entry()->prepend(std::make_unique<Instruction>(Op_Slot, pointer_to(expr->type),
+                                                                                 std::vector<Value*>()));
+            slot->name = "tmp";
+            emit(Op_Store, type_unit, {slot, value});
+            return slot;
+        }
+
+        Value* Lowering::lower_constant(const Val &val, types::Type *type) {
+            type = strip(type);
+
+            // the value is read by the type it was evaluated as, which can differ from the
+            // type of the expression before it was cast.
+            auto kind = val.type ? strip(val.type)->kind() : type->kind();
+            bool is_float = false;
+            i64 integer = 0;
+            f64 floating = 0;
+            switch(kind) {
+                case types::Primitive_I8: integer = val._I8; break;
+                case types::Primitive_I16: integer = val._I16; break;
+                case types::Primitive_I32: integer = val._I32; break;
+                case types::Primitive_I64: integer = val._I64; break;
+                case types::Primitive_U8: integer = val._U8; break;
+                case types::Primitive_U16: integer = val._U16; break;
+                case types::Primitive_U32: integer = val._U32; break;
+                case types::Primitive_U64: integer = CAST(i64, val._U64); break;
+                case types::Primitive_Char: integer = val._Char; break;
+                case types::Primitive_Bool: integer = val._Bool; break;
+                case types::Primitive_Float32: floating = val._F32; is_float = true; break;
+                case types::Primitive_Float64: floating = val._F64; is_float = true; break;
+                default:
+                    report(position, "the constant of type '%s' can not be lowered at this time", type->str().c_str());
+                    return nullptr;
+            }
+
+            if(type->is_float())
+                return module->get_constant(type, 0, is_float ? floating : CAST(f64, integer));
+            return module->get_constant(type, is_float ? CAST(i64, floating) : integer);
+        }
+
+        Value* Lowering::lower_name(ast::Expr *expr) {
+            auto entity = expr->operand.entity;
+            if(!entity) {
+                report(expr->pos(), "this name can not be lowered at this time");
+                return nullptr;
+            }
+
+            switch(entity->kind()) {
+                case LocalEntity:
+                    return load_local(entity);
+                case GlobalEntity: {
+                    auto iter = globals.find(entity->as<Global>());
+                    if(iter == globals.end())
+                        break;
+                    auto load = emit(Op_Load, entity->get_type(), {iter->second});
+                    load->name = entity->get_name()->value();
+                    return load;
+                }
+                case ConstantEntity: {
+                    auto constant = entity->as<mu::Constant>();
+                    return lower_constant(constant->get_value(), constant->get_type());
+                }
+                case FunctionEntity: {
+                    auto iter = functions.find(entity->as<mu::Function>());
+                    if(iter == functions.end())
+                        break;
+                    return iter->second;
+                }
+                default:
+                    break;
+            }
+
+            report(expr->pos(), "'%s' can not be lowered at this time", entity->get_name()->value().c_str());
+            return nullptr;
+        }
+
+        Value* Lowering::lower_binary(ast::Binary *expr) {
+            if(expr->op == Tkn_And or expr->op == Tkn_Or)
+                return lower_logical(expr);
+
+            auto lhs = lower_expr(expr->lhs);
+            if(!lhs)
+                return nullptr;
+
+            auto rhs = lower_expr(expr->rhs);
+            if(!rhs)
+                return nullptr;
+
+            return emit_binary(expr->op, expr->type, lhs, rhs);
+        }
+
+        Value* Lowering::lower_logical(ast::Binary *expr) {
+            auto is_and = expr->op == Tkn_And;
+
+            auto lhs = lower_expr(expr->lhs);
+            if(!lhs)
+                return nullptr;
+
+            // the right side is only evaluated when the left side doesn't decide the result.
+            auto lhs_block = current;
+            auto rhs_block = function->create_block();
+            auto end_block = function->create_block();
+
+            if(is_and)
+                branch(lhs, rhs_block, end_block);
+            else
+                branch(lhs, end_block, rhs_block);
+
+            seal_block(rhs_block);
+            current = rhs_block;
+            auto rhs = lower_expr(expr->rhs);
+            if(!rhs)
+                return nullptr;
+            auto rhs_end = current;
+            jump(end_block);
+
+            seal_block(end_block);
+            current = end_block;
+            auto phi = current->prepend(std::make_unique<Instruction>(Op_Phi, type_bool, std::vector<Value*>()));
+            phi->add_incoming(module->get_constant(type_bool, !is_and), lhs_block);
+            phi->add_incoming(rhs, rhs_end);
+            return phi;
+        }
+
+        Value* Lowering::lower_unary(ast::Unary *expr) {
+            if(expr->op == Tkn_Ampersand)
+                return lower_spilled_address(expr->expr);
+
+            auto value = lower_expr(expr->expr);
+            if(!value)
+                return nullptr;
+
+            if(expr->op == Tkn_Astrick)
+                return emit(Op_Load, expr->type, {value});
+
+            auto inst = emit(Op_Unary, expr->type, {value});
+            inst->op = expr->op;
+            return inst;
+        }
+
+        Value* Lowering::lower_tuple(ast::TupleExpr *expr) {
+            std::vector<Value*> elements;
+            for(auto element : expr->elements) {
+                auto value = lower_expr(element);
+                if(!value)
+                    return nullptr;
+                elements.push_back(value);
+            }
+            return emit(Op_Aggregate, expr->type, elements);
+        }
+
+        Value* Lowering::lower_struct(ast::StructExpr *expr) {
+            auto struct_type = strip(expr->type)->as<types::StructType>();
+
+            // the members are given in order or by name.
+            std::vector<ast::ExprPtr> inits(struct_type->num_members(), nullptr);
+            for(u64 i = 0; i < expr->members.size() and i < inits.size(); ++i) {
+                auto member = expr->members[i];
+                if(member->kind == ast::ast_expr_binding) {
+                    auto binding = member->as<ast::BindingExpr>();
+                    auto [entity, found] = struct_type->get_scope()->find(binding->name);
+                    if(found)
+                        inits[struct_type->get_index_of_member(entity)] = binding->expr;
+                }
+                else
+                    inits[i] = member;
+            }
+
+            std::vector<Value*> members;
+            for(u64 i = 0; i < inits.size(); ++i) {
+                auto member = struct_type->get_member(i)->as<Local>();
+                auto init = inits[i] ? inits[i] : default_member_init(member);
+                if(!init) {
+                    report(expr->pos(), "member '%s' of '%s' isn't given a value",
+                           member->get_name()->value().c_str(), struct_type->get_name()->value().c_str());
+                    return nullptr;
+                }
+
+                auto value = lower_expr(init);
+                if(!value)
+                    return nullptr;
+                members.push_back(value);
+            }
+            return emit(Op_Aggregate, expr->type, members);
+        }
+
+        Value* Lowering::lower_accessor(ast::Expr *expr) {
+            if(auto address = lower_address(expr))
+                return emit(Op_Load, expr->type, {address});
+
+            // the operand is a value without storage, the member is taken out of it.
+            auto value = lower_expr(accessor_operand(expr));
+            if(!value)
+                return nullptr;
+
+            auto index = accessor_index(expr);
+            if(index == (u64) -1) {
+                report(expr->pos(), "this member can not be lowered at this time");
+                return nullptr;
+            }
+
+            auto extract = emit(Op_Extract, expr->type, {value});
+            extract->index = index;
+            return extract;
+        }
+
+        Value* Lowering::lower_call(ast::Call *expr) {
+            auto callee = expr->name->operand.entity;
+            if(callee and callee->is_function()) {
+                std::vector<Value*> args;
+                return lower_direct_call(callee->as<mu::Function>(), args, expr->actuals, 0);
+            }
+
+            // a call through a function pointer.
+            auto type = strip(expr->name->type);
+            if(!type or type->kind() != types::FunctType) {
+                report(expr->pos(), "this call can not be lowered at this time");
+                return nullptr;
+            }
+
+            auto pointer = lower_expr(expr->name);
+            if(!pointer)
+                return nullptr;
+
+            std::vector<Value*> operands = {pointer};
+            for(auto actual : expr->actuals) {
+                auto arg = lower_expr(actual);
+                if(!arg)
+                    return nullptr;
+                operands.push_back(arg);
+            }
+
+            auto ret = type->as<types::FunctionType>()->get_ret();
+            return emit(Op_Call, ret ? ret : type_unit, operands);
+        }
+
+        Value* Lowering::lower_method(ast::Method *expr) {
+            auto callee = expr->name->operand.entity;
+            if(!callee or !callee->is_function()) {
+                report(expr->pos(), "this method call can not be lowered at this time");
+                return nullptr;
+            }
+
+            // the receiver is passed by address, the first actual is the receiver or the type
+            // of a static method.
+            auto method = callee->as<mu::Function>();
+            std::vector<Value*> args;
+            if(!method->is_static()) {
+                auto receiver = expr->actuals[0];
+                auto self = strip(receiver->type)->is_ptr() ? lower_expr(receiver) : lower_spilled_address(receiver);
+                if(!self)
+                    return nullptr;
+                args.push_back(self);
+            }
+
+            return lower_direct_call(method, args, expr->actuals, 1);
+        }
+
+        Value* Lowering::lower_direct_call(mu::Function *callee, std::vector<Value *> &args,
+                                           const ast::NodeList<ast::ExprPtr> &actuals, u64 first_actual) {
+            auto iter = functions.find(callee);
+            if(iter == functions.end()) {
+                report(position, "'%s' can not be called, it wasn't lowered", callee->get_name()->value().c_str());
+                return nullptr;
+            }
+            auto target = iter->second;
+
+            auto actual = first_actual;
+            for(u64 i = args.size(); i < target->arguments().size(); ++i, ++actual) {
+                ast::ExprPtr init = actual < actuals.size() ? actuals[actual] : nullptr;
+                if(!init) {
+                    auto decl = callee->get_param(i)->get_decl();
+                    if(decl->kind == ast::ast_procedure_parameter)
+                        init = decl->as<ast::ProcedureParameter>()->init;
+                }
+
+                if(!init) {
+                    report(position, "parameter '%s' of '%s' isn't given a value",
+                           callee->get_param(i)->get_name()->value().c_str(), callee->get_name()->value().c_str());
+                    return nullptr;
+                }
+
+                auto arg = lower_expr(init);
+                if(!arg)
+                    return nullptr;
+                args.push_back(arg);
+            }
+
+            // the rest are c variadic arguments.
+            for(; actual < actuals.size(); ++actual) {
+                auto arg = lower_expr(actuals[actual]);
+                if(!arg)
+                    return nullptr;
+                args.push_back(arg);
+            }
+
+            args.insert(args.begin(), target);
+            auto ret = callee->get_ret_type();
+            return emit(Op_Call, ret ? ret : type_unit, args);
+        }
+
+        Value* Lowering::lower_block(ast::Block *expr) {
+            auto mark = defers.size();
+
+            Value* value = unit_value();
+            for(auto stmt : expr->elements) {
+                switch(stmt->kind) {
+                    case ast::ast_expr:
+                        value = lower_expr(stmt->as<ast::ExprStmt>()->expr);
+                        if(!value)
+                            return nullptr;
+                        break;
+                    case ast::ast_decl: {
+                        auto decl = stmt->as<ast::DeclStmt>()->decl;
+                        if(decl->kind != ast::ast_local and decl->kind != ast::ast_mutable) {
+                            report(decl->pos(), "this declaration can not be lowered at this time");
+                            return nullptr;
+                        }
+                        if(!lower_local(decl))
+                            return nullptr;
+                        value = unit_value();
+                    } break;
+                    default:
+                        break;
+                }
+            }
+
+            // the value of the block is computed before the deferred expressions run.
+            if(!run_defers(mark))
+                return nullptr;
+            defers.resize(mark);
+            return value;
+        }
+
+        Value* Lowering::lower_if(ast::If *expr) {
+            auto cond = lower_expr(expr->cond);
+            if(!cond)
+                return nullptr;
+
+            auto then_block = function->create_block();
+            auto else_block = expr->else_if ? function->create_block() : nullptr;
+            auto end_block = function->create_block();
+            branch(cond, then_block, else_block ? else_block : end_block);
+
+            seal_block(then_block);
+            current = then_block;
+            auto then_value = lower_expr(expr->body);
+            if(!then_value)
+                return nullptr;
+            auto then_end = current;
+            jump(end_block);
+
+            Value* else_value = nullptr;
+            BasicBlock* else_end = nullptr;
+            if(else_block) {
+                seal_block(else_block);
+                current = else_block;
+                else_value = lower_expr(expr->else_if);
+                if(!else_value)
+                    return nullptr;
+                else_end = current;
+                jump(end_block);
+            }
+
+            seal_block(end_block);
+            current = end_block;
+
+            auto type = strip(expr->type);
+            if(!else_block or !type or type->is_unit())
+                return unit_value();
+
+            auto phi = current->prepend(std::make_unique<Instruction>(Op_Phi, expr->type, std::vector<Value*>()));
+            phi->add_incoming(then_value, then_end);
+            phi->add_incoming(else_value, else_end);
+            return phi;
+        }
+
+        Value* Lowering::lower_while(ast::While *expr) {
+            // the condition block is sealed once the body has jumped back to it.
+            auto cond_block = function->create_block();
+            jump(cond_block);
+            current = cond_block;
+
+            auto cond = lower_expr(expr->cond);
+            if(!cond)
+                return nullptr;
+
+            auto body_block = function->create_block();
+            auto end_block = function->create_block();
+            branch(cond, body_block, end_block);
+
+            seal_block(body_block);
+            current = body_block;
+            if(!lower_expr(expr->body))
+                return nullptr;
+            jump(cond_block);
+
+            seal_block(cond_block);
+            seal_block(end_block);
+            current = end_block;
+            return unit_value();
+        }
+
+        Value* Lowering::lower_for(ast::For *expr) {
+            auto range = expr->expr->as<ast::Range>();
+            auto type = range->type;
+
+            auto start = lower_expr(range->start);
+            if(!start)
+                return nullptr;
+            auto end = lower_expr(range->end);
+            if(!end)
+                return nullptr;
+            auto step = range->step ? lower_expr(range->step) : module->get_constant(strip(type), 1);
+            if(!step)
+                return nullptr;
+
+            // the counter is hidden, the pattern is bound to it at the start of every iteration.
+            Variable counter = expr;
+            write_variable(counter, current, start);
+
+            auto cond_block = function->create_block();
+            jump(cond_block);
+            current = cond_block;
+
+            auto value = read_variable(counter, type, current);
+            auto cond = emit_binary(Tkn_Less, type_bool, value, end);
+
+            auto body_block = function->create_block();
+            auto end_block = function->create_block();
+            branch(cond, body_block, end_block);
+
+            seal_block(body_block);
+            current = body_block;
+            if(!bind_pattern(expr->pattern, value))
+                return nullptr;
+            if(!lower_expr(expr->body))
+                return nullptr;
+
+            auto next = emit_binary(Tkn_Plus, type, read_variable(counter, type, current), step);
+            write_variable(counter, current, next);
+            jump(cond_block);
+
+            seal_block(cond_block);
+            seal_block(end_block);
+            current = end_block;
+            return unit_value();
+        }
+
+        Value* Lowering::lower_match(ast::Match *expr) {
+            auto value = lower_expr(expr->cond);
+            if(!value)
+                return nullptr;
+
+            auto type = strip(expr->type);
+            auto has_value = type and !type->is_unit();
+
+            // the arms are tested in order, an arm with alternatives matches if any of them do.
+            auto end_block = function->create_block();
+            std::vector<std::pair<Value*, BasicBlock*>> values;
+            for(auto member : expr->members) {
+                auto arm = member->as<ast::MatchArm>();
+
+                Value* test = nullptr;
+                bool always = false;
+                for(auto pattern : arm->patterns) {
+                    auto pattern_test = lower_pattern_test(pattern, value);
+                    if(!pattern_test) {
+                        if(has_error())
+                            return nullptr;
+                        always = true;
+                        continue;
+                    }
+                    test = test ? emit_binary(Tkn_Pipe, type_bool, test, pattern_test) : pattern_test;
+                }
+
+                auto arm_block = function->create_block();
+                auto next_block = function->create_block();
+                branch(always ? module->get_constant(type_bool, 1) : test, arm_block, next_block);
+
+                seal_block(arm_block);
+                current = arm_block;
+                for(auto pattern : arm->patterns)
+                    if(pattern->kind == ast::ast_ident_pattern and !bind_pattern(pattern, value))
+                        return nullptr;
+
+                auto arm_value = lower_expr(arm->body);
+                if(!arm_value)
+                    return nullptr;
+                values.emplace_back(arm_value, current);
+                jump(end_block);
+
+                seal_block(next_block);
+                current = next_block;
+            }
+
+            // a match with a value has a default arm so nothing falls through.
+            if(has_value)
+                emit(Op_Unreachable, type_unit, {});
+            else
+                jump(end_block);
+
+            seal_block(end_block);
+            current = end_block;
+            if(!has_value)
+                return unit_value();
+
+            auto phi = current->prepend(std::make_unique<Instruction>(Op_Phi, expr->type, std::vector<Value*>()));
+            for(auto [arm_value, block] : values)
+                phi->add_incoming(arm_value, block);
+            return phi;
+        }
+
+        Value* Lowering::lower_pattern_test(ast::Pattern *pattern, Value *value) {
+            auto type = strip(value->get_type());
+            i64 literal = 0;
+            if(pattern_value(pattern, literal))
+                return emit_binary(Tkn_EqualEqual, type_bool, value, module->get_constant(type, literal));
+
+            switch(pattern->kind) {
+                case ast::ast_range_pattern: {
+                    // a range includes both of its bounds.
+                    auto range = pattern->as<ast::RangePattern>();
+                    i64 start = 0, end = 0;
+                    if(!pattern_value(range->start, start) or !pattern_value(range->end, end))
+                        break;
+
+                    auto lower = emit_binary(Tkn_GreaterEqual, type_bool, value, module->get_constant(type, start));
+                    auto upper = emit_binary(Tkn_LessEqual, type_bool, value, module->get_constant(type, end));
+                    return emit_binary(Tkn_Ampersand, type_bool, lower, upper);
+                }
+                case ast::ast_ignore_pattern:
+                case ast::ast_ident_pattern:
+                    return nullptr;
+                default:
+                    break;
+            }
+
+            report(pattern->pos(), "this pattern can not be lowered at this time");
+            return nullptr;
+        }
+
+        Value* Lowering::lower_return(ast::Return *expr) {
+            Value* value = nullptr;
+            if(expr->body) {
+                value = lower_expr(expr->body);
+                if(!value)
+                    return nullptr;
+            }
+
+            // every deferred expression of the function runs before it returns.
+            if(!run_defers(0))
+                return nullptr;
+
+            auto ret = entity->get_ret_type();
+            if(!ret or ret->is_unit() or !value)
+                emit(Op_Return, type_unit, {});
+            else
+                emit(Op_Return, type_unit, {value});
+
+            // anything after the return is dead, it is lowered into a block without predecessors.
+            current = function->create_block();
+            seal_block(current);
+            return unit_value();
+        }
+
+        Value* Lowering::lower_assign(ast::Assign *expr) {
+            auto value = lower_expr(expr->rvalue);
+            if(!value)
+                return nullptr;
+
+            if(expr->op != Tkn_Equal) {
+                auto current_value = lower_expr(expr->lvalue);
+                if(!current_value)
+                    return nullptr;
+                value = emit_binary(compound_operator(expr->op), expr->lvalue->type, current_value, value);
+            }
+
+            if(!assign_to(expr->lvalue, value))
+                return nullptr;
+            return unit_value();
+        }
+
+        bool Lowering::assign_to(ast::Expr *lvalue, Value *value) {
+            switch(lvalue->kind) {
+                case ast::ast_name:
+                case ast::ast_self_expr: {
+                    auto entity = lvalue->operand.entity;
+                    if(entity and entity->is_local()) {
+                        store_local(entity, value);
+                        return true;
+                    }
+                } break;
+                case ast::ast_accessor:
+                case ast::ast_tuple_accessor: {
+                    if(auto address = lower_address(lvalue)) {
+                        emit(Op_Store, type_unit, {address, value});
+                        return true;
+                    }
+
+                    // the operand is an SSA value, it is replaced by a copy with the member changed.
+                    auto operand = accessor_operand(lvalue);
+                    auto aggregate = lower_expr(operand);
+                    if(!aggregate)
+                        return false;
+
+                    auto index = accessor_index(lvalue);
+                    if(index == (u64) -1)
+                        break;
+
+                    auto insert = emit(Op_Insert, operand->type, {aggregate, value});
+                    insert->index = index;
+                    return assign_to(operand, insert);
+                }
+                default:
+                    break;
+            }
+
+            if(auto address = lower_address(lvalue)) {
+                emit(Op_Store, type_unit, {address, value});
+                return true;
+            }
+
+            report(lvalue->pos(), "this expression can not be assigned at this time");
+            return false;
+        }
+
+        bool Lowering::lower_local(ast::DeclPtr decl) {
+            ast::PatternPtr pattern = nullptr;
+            ast::ExprPtr init = nullptr;
+            if(decl->kind == ast::ast_mutable) {
+                pattern = decl->as<ast::Mutable>()->names;
+                init = decl->as<ast::Mutable>()->init;
+            }
+            else {
+                pattern = decl->as<ast::Local>()->names;
+                init = decl->as<ast::Local>()->init;
+            }
+
+            Value* value = nullptr;
+            if(init) {
+                value = lower_expr(init);
+                if(!value)
+                    return false;
+            }
+            return bind_pattern(pattern, value);
+        }
+
+        bool Lowering::bind_pattern(ast::Pattern *pattern, Value *value) {
+            switch(pattern->kind) {
+                case ast::ast_ident_pattern: {
+                    auto local = pattern->as<ast::IdentPattern>()->entity;
+                    if(!local) {
+                        report(pattern->pos(), "this pattern can not be lowered at this time");
+                        return false;
+                    }
+
+                    // a local declared without a value starts zeroed.
+                    auto type = strip(local->get_type());
+                    if(!value)
+                        value = type->is_primative() ? CAST_PTR(Value, module->get_constant(type, 0))
+                                                     : CAST_PTR(Value, module->get_undef(local->get_type()));
+
+                    // the copy gives the value the name of the local.
+                    auto copy = emit(Op_Copy, local->get_type(), {value});
+                    copy->name = local->get_name()->value();
+                    store_local(local, copy);
+                    return true;
+                }
+                case ast::ast_tuple_desc: {
+                    auto& patterns = pattern->as<ast::TuplePattern>()->patterns;
+                    for(u64 i = 0; i < patterns.size(); ++i) {
+                        Value* element = nullptr;
+                        if(value) {
+                            auto tuple = strip(value->get_type())->as<types::Tuple>();
+                            auto extract = emit(Op_Extract, tuple->get_element_type(i), {value});
+                            extract->index = i;
+                            element = extract;
+                        }
+                        if(!bind_pattern(patterns[i], element))
+                            return false;
+                    }
+                    return true;
+                }
+                case ast::ast_ignore_pattern:
+                    return true;
+                default:
+                    report(pattern->pos(), "this pattern can not be lowered at this time");
+                    return false;
+            }
+        }
+
+        bool Lowering::run_defers(u64 mark) {
+            // the deferred expressions can defer more, they are above the ones being run.
+            for(u64 i = defers.size(); i > mark; --i)
+                if(!lower_expr(defers[i - 1]))
+                    return false;
+            return true;
+        }
+
+        /*------------------------------Building--------------------------------*/
+
+        Instruction* Lowering::emit(Opcode opcode, types::Type *type, const std::vector<Value *> &operands) {
+            return current->append(std::make_unique<Instruction>(opcode, type, operands));
+        }
+
+        Instruction* Lowering::emit_binary(TokenKind op, types::Type *type, Value *lhs, Value *rhs) {
+            auto inst = emit(Op_Binary, type, {lhs, rhs});
+            inst->op = op;
+            return inst;
+        }
+
+        void Lowering::jump(BasicBlock *target) {
+            auto inst = std::make_unique<Instruction>(Op_Jump, type_unit, std::vector<Value*>());
+            inst->get_targets().push_back(target);
+            current->append(std::move(inst));
+        }
+
+        void Lowering::branch(Value *cond, BasicBlock *then_block, BasicBlock *else_block) {
+            auto inst = std::make_unique<Instruction>(Op_Branch, type_unit, std::vector<Value*>({cond}));
+            inst->get_targets().push_back(then_block);
+            inst->get_targets().push_back(else_block);
+            current->append(std::move(inst));
+        }
+
+        Value* Lowering::unit_value() {
+            return module->get_undef(type_unit);
+        }
+
+        types::Type* Lowering::pointer_to(types::Type *type) {
+            return interp->checked_new_type<types::Pointer>(type);
+        }
+    }
+}
@@ -0,0 +1,168 @@
+#ifndef MU_MIR_LOWER_HPP
+#define MU_MIR_LOWER_HPP
+
+#include "common.hpp"
+#include "interpreter.hpp"
+#include "mir.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mu {
+    namespace mir {
+
+        // Lowers the resolved ast of a module to the mid-level ir.
+        //
+        // The SSA form is built while lowering as described by Braun et al. in
+        // "Simple and Efficient Construction of Static Single Assignment Form". A block is
+        // sealed once all of its predecessors are known, reading a variable in a block that
+        // isn't sealed yet creates a phi that is completed when the block is sealed.
+        class Lowering {
+        public:
+            Lowering(Interpreter* interp, Module* module);
+
+            // lowers the top level entities of a resolved module. Returns false if something
+            // couldn't be lowered, the errors have been reported.
+            bool lower(const std::vector<Entity*>& entities);
+
+            inline bool has_error() { return errors_num > 0; }
+
+        private:
+            void declare_function(mu::Function* entity, const std::string& name);
+
+            void lower_function(mu::Function* entity);
+
+            /*--------------------------SSA Construction----------------------------*/
+            // a variable is a local or a hidden value such as the counter of a for loop.
+            typedef const void* Variable;
+
+            void write_variable(Variable var, BasicBlock* block, Value* value);
+
+            Value* read_variable(Variable var, types::Type* type, BasicBlock* block);
+
+            Value* read_variable_recursive(Variable var, types::Type* type, BasicBlock* block);
+
+            Value* add_phi_operands(Variable var, Instruction* phi);
+
+            Value* try_remove_trivial_phi(Instruction* phi);
+
+            void seal_block(BasicBlock* block);
+
+            // locals whose address is taken are kept in a slot instead.
+            void store_local(Entity* local, Value* value);
+
+            Value* load_local(Entity* local);
+
+            Value* local_slot(Entity* local);
+
+            void find_address_taken(ast::Expr* expr);
+
+            void mark_address_taken(ast::Expr* expr);
+
+            /*-----------------------------Expressions------------------------------*/
+            Value* lower_expr(ast::Expr* expr);
+
+            // the address of an expression that has storage, null if it doesn't have any.
+            Value* lower_address(ast::Expr* expr);
+
+            // the address of the expression, rvalues are stored to a temporary slot first.
+            Value* lower_spilled_address(ast::Expr* expr);
+
+            Value* lower_constant(const Val& val, types::Type* type);
+
+            Value* lower_name(ast::Expr* expr);
+
+            Value* lower_binary(ast::Binary* expr);
+
+            Value* lower_logical(ast::Binary* expr);
+
+            Value* lower_unary(ast::Unary* expr);
+
+            Value* lower_tuple(ast::TupleExpr* expr);
+
+            Value* lower_struct(ast::StructExpr* expr);
+
+            Value* lower_accessor(ast::Expr* expr);
+
+            Value* lower_call(ast::Call* expr);
+
+            Value* lower_method(ast::Method* expr);
+
+            Value* lower_direct_call(mu::Function* entity, std::vector<Value*>& args,
+                                     const ast::NodeList<ast::ExprPtr>& actuals, u64 first_actual);
+
+            Value* lower_block(ast::Block* expr);
+
+            Value* lower_if(ast::If* expr);
+
+            Value* lower_while(ast::While* expr);
+
+            Value* lower_for(ast::For* expr);
+
+            Value* lower_match(ast::Match* expr);
+
+            // the condition of a match arm pattern, null if the pattern matches everything.
+            Value* lower_pattern_test(ast::Pattern* pattern, Value* value);
+
+            Value* lower_return(ast::Return* expr);
+
+            Value* lower_assign(ast::Assign* expr);
+
+            bool assign_to(ast::Expr* lvalue, Value* value);
+
+            bool lower_local(ast::DeclPtr decl);
+
+            bool bind_pattern(ast::Pattern* pattern, Value* value);
+
+            // lowers the deferred expressions above mark, the most recent first.
+            bool run_defers(u64 mark);
+
+            /*------------------------------Building--------------------------------*/
+            Instruction* emit(Opcode opcode, types::Type* type, const std::vector<Value*>& operands);
+
+            Instruction* emit_binary(TokenKind op, types::Type* type, Value* lhs, Value* rhs);
+
+            void jump(BasicBlock* target);
+
+            void branch(Value* cond, BasicBlock* then_block, BasicBlock* else_block);
+
+            Value* unit_value();
+
+            types::Type* pointer_to(types::Type* type);
+
+            template <typename... Args>
+            void report(const mu::Pos& pos, const std::string& fmt, Args... args) {
+                interp->report_error(pos, fmt, args...);
+                errors_num++;
+            }
+
+            Interpreter* interp{nullptr};
+            Module* module{nullptr};
+
+            std::unordered_map<mu::Function*, Function*> functions;
+            std::unordered_map<mu::Global*, GlobalRef*> globals;
+
+            // the state of the function being lowered.
+            Function* function{nullptr};
+            mu::Function* entity{nullptr};
+            BasicBlock* current{nullptr};
+
+            std::unordered_map<BasicBlock*, std::unordered_map<Variable, Value*>> definitions;
+            std::unordered_map<BasicBlock*, std::vector<std::pair<Variable, Instruction*>>> incomplete_phis;
+            std::unordered_set<BasicBlock*> sealed;
+
+            // trivial phis are replaced while lowering and removed once the function is done.
+            std::unordered_set<Instruction*> removed_phis;
+
+            std::unordered_set<Entity*> address_taken;
+            std::unordered_map<Entity*, Value*> slots;
+
+            std::vector<ast::Expr*> defers;
+
+            mu::Pos position;
+            u32 errors_num{0};
+        };
+    }
+}
+
+#endif //MU_MIR_LOWER_HPP
@@ -0,0 +1,370 @@
+#include "mir.hpp"
+#include "analysis/entity.hpp"
+#include "analysis/types/type.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+static const char* opcode_names[] = {
+        "phi",
+        "copy",
+        "binary",
+        "unary",
+        "cast",
+        "aggregate",
+        "extract",
+        "insert",
+        "slot",
+        "load",
+        "store",
+        "member",
+        "call",
+        "jump",
+        "branch",
+        "ret",
+        "unreachable",
+};
+
+namespace mu {
+    namespace mir {
+
+        Value::Value(ValueKind k, types::Type *type) : k(k), type(type) {
+        }
+
+        Value::~Value() = default;
+
+        Constant::Constant(types::Type *type, i64 integer, f64 floating) : Value(ConstantValue, type),
+            integer(integer), floating(floating) {
+        }
+
+        void Constant::print(std::ostream &out) {
+            if(type->is_float())
+                out << floating;
+            else if(type->is_bool())
+                out << (integer ? "true" : "false");
+            else if(type->is_signed())
+                out << integer;
+            else
+                out << CAST(u64, integer);
+        }
+
+        Undef::Undef(types::Type *type) : Value(UndefValue, type) {
+        }
+
+        Argument::Argument(types::Type *type, u32 index, const std::string &name) : Value(ArgumentValue, type),
+            index(index), name(name) {
+        }
+
+        GlobalRef::GlobalRef(types::Type *type, mu::Global *global) : Value(GlobalValue, type), global(global) {
+        }
+
+        /*--------------------------Instructions---------------------------*/
+
+        Instruction::Instruction(Opcode opcode, types::Type *type, const std::vector<Value *> &operands) :
+            Value(InstructionValue, type), code(opcode), operands(operands) {
+        }
+
+        bool Instruction::is_terminator() {
+            return code >= Op_Jump;
+        }
+
+        bool Instruction::has_side_effects() {
+            switch(code) {
+                case Op_Store:
+                case Op_Call:
+                case Op_Jump:
+                case Op_Branch:
+                case Op_Return:
+                case Op_Unreachable:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        void Instruction::add_incoming(Value *value, BasicBlock *block) {
+            operands.push_back(value);
+            targets.push_back(block);
+        }
+
+        /*--------------------------Basic Blocks---------------------------*/
+
+        BasicBlock::BasicBlock(Function *parent, u32 id) : id(id), parent(parent) {
+        }
+
+        Instruction* BasicBlock::terminator() {
+            if(insts.empty() or !insts.back()->is_terminator())
+                return nullptr;
+            return insts.back().get();
+        }
+
+        std::vector<BasicBlock*> BasicBlock::successors() {
+            auto term = terminator();
+            return term ? term->get_targets() : std::vector<BasicBlock*>();
+        }
+
+        Instruction* BasicBlock::append(std::unique_ptr<Instruction> inst) {
+            inst->parent = this;
+            if(inst->is_terminator())
+                for(auto target : inst->get_targets())
+                    target->preds.push_back(this);
+
+            insts.push_back(std::move(inst));
+            return insts.back().get();
+        }
+
+        Instruction* BasicBlock::prepend(std::unique_ptr<Instruction> inst) {
+            inst->parent = this;
+            insts.push_front(std::move(inst));
+            return insts.front().get();
+        }
+
+        void BasicBlock::erase(Instruction *inst) {
+            if(inst->is_terminator()) {
+                for(auto target : inst->get_targets()) {
+                    auto iter = std::find(target->preds.begin(), target->preds.end(), this);
+                    if(iter != target->preds.end())
+                        target->preds.erase(iter);
+                }
+            }
+
+            insts.remove_if([inst](const std::unique_ptr<Instruction>& i) { return i.get() == inst; });
+        }
+
+        void BasicBlock::remove_incoming(BasicBlock *block) {
+            for(auto& inst : insts) {
+                if(inst->opcode() != Op_Phi)
+                    break;
+
+                auto& incoming = inst->get_incoming();
+                auto iter = std::find(incoming.begin(), incoming.end(), block);
+                if(iter == incoming.end())
+                    continue;
+
+                auto index = iter - incoming.begin();
+                incoming.erase(iter);
+                inst->get_operands().erase(inst->get_operands().begin() + index);
+            }
+        }
+
+        void BasicBlock::absorb(BasicBlock *block) {
+            for(auto succ : block->successors()) {
+                std::replace(succ->preds.begin(), succ->preds.end(), block, this);
+                for(auto& inst : succ->insts) {
+                    if(inst->opcode() != Op_Phi)
+                        break;
+                    auto& incoming = inst->get_incoming();
+                    std::replace(incoming.begin(), incoming.end(), block, this);
+                }
+            }
+
+            for(auto& inst : block->insts)
+                inst->parent = this;
+            insts.splice(insts.end(), block->insts);
+        }
+
+        /*---------------------------Functions-----------------------------*/
+
+        Function::Function(types::Type *type, mu::Function *entity, const std::string &name) :
+            Value(FunctionValue, type), entity(entity), name(name) {
+        }
+
+        Function::~Function() = default;
+
+        BasicBlock* Function::create_block() {
+            block_list.push_back(std::make_unique<BasicBlock>(this, next_block++));
+            return block_list.back().get();
+        }
+
+        void Function::erase(BasicBlock *block) {
+            if(auto term = block->terminator())
+                block->erase(term);
+
+            block_list.remove_if([block](const std::unique_ptr<BasicBlock>& b) { return b.get() == block; });
+        }
+
+        void Function::compute_predecessors() {
+            for(auto& block : block_list)
+                block->preds.clear();
+
+            for(auto& block : block_list)
+                for(auto succ : block->successors())
+                    succ->preds.push_back(block.get());
+        }
+
+        void Function::replace_uses(Value *from, Value *to) {
+            for(auto& block : block_list)
+                for(auto& inst : block->instructions())
+                    for(auto& operand : inst->get_operands())
+                        if(operand == from)
+                            operand = to;
+        }
+
+        std::unordered_map<Value*, u32> Function::count_uses() {
+            std::unordered_map<Value*, u32> uses;
+            for(auto& block : block_list)
+                for(auto& inst : block->instructions())
+                    for(auto operand : inst->get_operands())
+                        uses[operand]++;
+            return uses;
+        }
+
+        void Function::renumber() {
+            u32 id = 0;
+            for(auto& block : block_list)
+                block->id = id++;
+            next_block = id;
+        }
+
+        void Function::print(std::ostream &out) {
+            // values are numbered in the order they are printed.
+            std::unordered_map<Value*, u32> numbers;
+            for(auto& block : block_list)
+                for(auto& inst : block->instructions())
+                    if(!inst->get_type()->is_unit())
+                        numbers.emplace(inst.get(), numbers.size());
+
+            auto print_value = [&](Value* value) {
+                switch(value->kind()) {
+                    case ConstantValue:
+                        value->as<Constant>()->print(out);
+                        break;
+                    case UndefValue:
+                        out << (value->get_type()->is_unit() ? "()" : "undef");
+                        break;
+                    case ArgumentValue:
+                        out << "%" << value->as<Argument>()->get_name();
+                        break;
+                    case FunctionValue:
+                        out << "@" << value->as<Function>()->get_name();
+                        break;
+                    case GlobalValue:
+                        out << "@" << value->as<GlobalRef>()->get_global()->get_name()->value();
+                        break;
+                    case InstructionValue: {
+                        auto iter = numbers.find(value);
+                        if(iter == numbers.end())
+                            out << "%?";
+                        else
+                            out << "%" << iter->second;
+                    } break;
+                }
+            };
+
+            out << "fn " << name << "(";
+            for(auto& arg : args) {
+                out << (arg->get_index() ? ", " : "") << "%" << arg->get_name() << " " << arg->get_type()->str();
+            }
+            out << ") " << type->as<types::FunctionType>()->get_ret()->str();
+
+            if(is_declaration()) {
+                out << std::endl;
+                return;
+            }
+
+            out << " {" << std::endl;
+            for(auto& block : block_list) {
+                out << "bb" << block->get_id() << ":";
+                if(!block->predecessors().empty()) {
+                    out << "\t\t; preds";
+                    for(auto pred : block->predecessors())
+                        out << " bb" << pred->get_id();
+                }
+                out << std::endl;
+
+                for(auto& inst : block->instructions()) {
+                    out << "    ";
+                    auto iter = numbers.find(inst.get());
+                    if(iter != numbers.end())
+                        out << "%" << iter->second << " = ";
+
+                    out << opcode_names[inst->opcode()];
+                    if(inst->opcode() == Op_Binary or inst->opcode() == Op_Unary)
+                        out << " " << Token::get_string(inst->op);
+
+                    auto& operands = inst->get_operands();
+                    for(u64 i = 0; i < operands.size(); ++i) {
+                        out << (i ? ", " : " ");
+                        if(inst->opcode() == Op_Phi)
+                            out << "[bb" << inst->get_incoming()[i]->get_id() << ": ";
+                        print_value(operands[i]);
+                        if(inst->opcode() == Op_Phi)
+                            out << "]";
+                    }
+
+                    switch(inst->opcode()) {
+                        case Op_Extract:
+                        case Op_Insert:
+                        case Op_MemberAddr:
+                            out << ", " << inst->index;
+                            break;
+                        case Op_Jump:
+                        case Op_Branch:
+                            for(u64 i = 0; i < inst->get_targets().size(); ++i)
+                                out << (i or !operands.empty() ? ", " : " ") << "bb" << inst->get_targets()[i]->get_id();
+                            break;
+                        default:
+                            break;
+                    }
+
+                    if(iter != numbers.end())
+                        out << " : " << inst->get_type()->str();
+                    if(!inst->name.empty())
+                        out << "\t\t; " << inst->name;
+                    out << std::endl;
+                }
+            }
+            out << "}" << std::endl;
+        }
+
+        /*----------------------------Modules------------------------------*/
+
+        Module::Module(const std::string &name) : name(name) {
+        }
+
+        Module::~Module() = default;
+
+        Function* Module::add_function(types::Type *type, mu::Function *entity, const std::string &name) {
+            function_list.push_back(std::make_unique<Function>(type, entity, name));
+            return function_list.back().get();
+        }
+
+        GlobalRef* Module::add_global(types::Type *pointer_type, mu::Global *global) {
+            global_list.push_back(std::make_unique<GlobalRef>(pointer_type, global));
+            return global_list.back().get();
+        }
+
+        Constant* Module::get_constant(types::Type *type, i64 integer, f64 floating) {
+            // compared by the bits so -0.0 and 0.0 are different constants.
+            u64 bits = 0;
+            std::memcpy(&bits, &floating, sizeof(bits));
+
+            auto& constant = constants[std::make_tuple(type, integer, bits)];
+            if(!constant)
+                constant = std::make_unique<Constant>(type, integer, floating);
+            return constant.get();
+        }
+
+        Undef* Module::get_undef(types::Type *type) {
+            auto& undef = undefs[type];
+            if(!undef)
+                undef = std::make_unique<Undef>(type);
+            return undef.get();
+        }
+
+        void Module::print(std::ostream &out) {
+            for(auto& global : global_list) {
+                auto entity = global->get_global();
+                out << "global " << entity->get_name()->value() << " " << entity->get_type()->str() << std::endl;
+            }
+            if(!global_list.empty())
+                out << std::endl;
+
+            for(u64 i = 0; i < function_list.size(); ++i) {
+                if(i)
+                    out << std::endl;
+                function_list[i]->print(out);
+            }
+        }
+    }
+}
@@ -0,0 +1,290 @@
+#ifndef MU_MIR_HPP
+#define MU_MIR_HPP
+
+#include "common.hpp"
+#include "parser/scanner/token.hpp"
+
+#include <list>
+#include <map>
+#include <ostream>
+#include <unordered_map>
+
+namespace mu {
+    class Entity;
+    class Function;
+    class Global;
+
+    namespace types {
+        class Type;
+    }
+
+    // The mid-level ir.
+    //
+    // A function is a graph of basic blocks, every block ends with exactly one terminator.
+    // Values are in SSA form, a local is only stored to memory when its address is taken.
+    // Every value keeps the mu type it was resolved to, so nothing has to be resolved again
+    // after lowering.
+    namespace mir {
+        class BasicBlock;
+        class Function;
+        class Instruction;
+        class Module;
+
+        enum ValueKind {
+            ConstantValue,
+            UndefValue,
+            ArgumentValue,
+            FunctionValue,
+            GlobalValue,
+            InstructionValue,
+        };
+
+        class Value {
+        public:
+            Value(ValueKind k, types::Type* type);
+            virtual ~Value();
+
+            inline ValueKind kind() { return k; }
+            inline types::Type* get_type() { return type; }
+
+            inline bool is_constant() { return k == ConstantValue; }
+            inline bool is_instruction() { return k == InstructionValue; }
+
+            template <typename T>
+            T* as() {
+                return CAST_PTR(T, this);
+            }
+
+        protected:
+            ValueKind k;
+            types::Type* type{nullptr};
+        };
+
+        // a primitive constant, they are unique within a module so they can be compared by address.
+        class Constant : public Value {
+        public:
+            Constant(types::Type* type, i64 integer, f64 floating);
+
+            inline i64 get_integer() { return integer; }
+            inline f64 get_float() { return floating; }
+
+            void print(std::ostream& out);
+
+        private:
+            i64 integer{0};
+            f64 floating{0};
+        };
+
+        class Undef : public Value {
+        public:
+            Undef(types::Type* type);
+        };
+
+        class Argument : public Value {
+        public:
+            Argument(types::Type* type, u32 index, const std::string& name);
+
+            inline u32 get_index() { return index; }
+            inline const std::string& get_name() { return name; }
+
+        private:
+            u32 index;
+            std::string name;
+        };
+
+        // the address of a global variable.
+        class GlobalRef : public Value {
+        public:
+            GlobalRef(types::Type* type, mu::Global* global);
+
+            inline mu::Global* get_global() { return global; }
+
+        private:
+            mu::Global* global;
+        };
+
+        enum Opcode {
+            Op_Phi,
+            Op_Copy,
+            Op_Binary,
+            Op_Unary,
+            // the operand converted to the type of the instruction.
+            Op_Cast,
+
+            // aggregates, the index is the member of a struct or the element of a tuple.
+            Op_Aggregate,
+            Op_Extract,
+            Op_Insert,
+
+            // memory
+            Op_Slot,
+            Op_Load,
+            Op_Store,
+            Op_MemberAddr,
+
+            Op_Call,
+
+            // terminators
+            Op_Jump,
+            Op_Branch,
+            Op_Return,
+            Op_Unreachable,
+        };
+
+        class Instruction : public Value {
+        public:
+            Instruction(Opcode opcode, types::Type* type, const std::vector<Value*>& operands);
+
+            inline Opcode opcode() { return code; }
+            inline BasicBlock* get_parent() { return parent; }
+
+            inline u64 num_operands() { return operands.size(); }
+            inline Value* get_operand(u64 i) { return operands[i]; }
+            inline void set_operand(u64 i, Value* value) { operands[i] = value; }
+            inline std::vector<Value*>& get_operands() { return operands; }
+
+            bool is_terminator();
+
+            // false if the instruction can be removed when its result isn't used.
+            bool has_side_effects();
+
+            // the successors of a terminator.
+            std::vector<BasicBlock*>& get_targets() { return targets; }
+
+            // the blocks the values of a phi come from, in the same order as the operands.
+            std::vector<BasicBlock*>& get_incoming() { return targets; }
+
+            void add_incoming(Value* value, BasicBlock* block);
+
+            // the operator of a binary or unary instruction.
+            TokenKind op{Tkn_Error};
+
+            // the member or element of an aggregate instruction.
+            u64 index{0};
+
+            // the source name of the value, only used when printing.
+            std::string name;
+
+        private:
+            friend class BasicBlock;
+
+            Opcode code;
+            BasicBlock* parent{nullptr};
+            std::vector<Value*> operands;
+            std::vector<BasicBlock*> targets;
+        };
+
+        class BasicBlock {
+        public:
+            BasicBlock(Function* parent, u32 id);
+
+            inline Function* get_parent() { return parent; }
+            inline u32 get_id() { return id; }
+
+            inline std::list<std::unique_ptr<Instruction>>& instructions() { return insts; }
+            inline bool empty() { return insts.empty(); }
+
+            // the terminator of the block, null while it is still being built.
+            Instruction* terminator();
+
+            std::vector<BasicBlock*> successors();
+
+            inline std::vector<BasicBlock*>& predecessors() { return preds; }
+
+            Instruction* append(std::unique_ptr<Instruction> inst);
+
+            // phis are always at the start of a block.
+            Instruction* prepend(std::unique_ptr<Instruction> inst);
+
+            void erase(Instruction* inst);
+
+            // removes block from the incoming values of the phis of this block.
+            void remove_incoming(BasicBlock* block);
+
+            // moves the instructions of block to the end of this block, which doesn't have a
+            // terminator yet. The successors of block become the successors of this block.
+            void absorb(BasicBlock* block);
+
+            // the blocks of a function are numbered once it is finished.
+            u32 id;
+
+        private:
+            friend class Function;
+
+            Function* parent;
+            std::list<std::unique_ptr<Instruction>> insts;
+            std::vector<BasicBlock*> preds;
+        };
+
+        class Function : public Value {
+        public:
+            Function(types::Type* type, mu::Function* entity, const std::string& name);
+            ~Function() override;
+
+            inline mu::Function* get_entity() { return entity; }
+            inline const std::string& get_name() { return name; }
+
+            inline std::list<std::unique_ptr<BasicBlock>>& blocks() { return block_list; }
+            inline BasicBlock* entry() { return block_list.front().get(); }
+
+            inline std::vector<std::unique_ptr<Argument>>& arguments() { return args; }
+
+            inline bool is_declaration() { return block_list.empty(); }
+
+            BasicBlock* create_block();
+
+            void erase(BasicBlock* block);
+
+            // recomputes the predecessors of every block from the terminators.
+            void compute_predecessors();
+
+            // replaces every use of from with to.
+            void replace_uses(Value* from, Value* to);
+
+            // the number of uses of every value.
+            std::unordered_map<Value*, u32> count_uses();
+
+            // numbers the blocks in order.
+            void renumber();
+
+            void print(std::ostream& out);
+
+        private:
+            mu::Function* entity;
+            std::string name;
+            std::vector<std::unique_ptr<Argument>> args;
+            std::list<std::unique_ptr<BasicBlock>> block_list;
+            u32 next_block{0};
+        };
+
+        class Module {
+        public:
+            Module(const std::string& name);
+            ~Module();
+
+            inline const std::string& get_name() { return name; }
+            inline std::vector<std::unique_ptr<Function>>& functions() { return function_list; }
+            inline std::vector<std::unique_ptr<GlobalRef>>& globals() { return global_list; }
+
+            Function* add_function(types::Type* type, mu::Function* entity, const std::string& name);
+
+            GlobalRef* add_global(types::Type* pointer_type, mu::Global* global);
+
+            Constant* get_constant(types::Type* type, i64 integer, f64 floating = 0);
+
+            Undef* get_undef(types::Type* type);
+
+            void print(std::ostream& out);
+
+        private:
+            std::string name;
+            std::vector<std::unique_ptr<Function>> function_list;
+            std::vector<std::unique_ptr<GlobalRef>> global_list;
+
+            std::map<std::tuple<types::Type*, i64, u64>, std::unique_ptr<Constant>> constants;
+            std::unordered_map<types::Type*, std::unique_ptr<Undef>> undefs;
+        };
+    }
+}
+
+#endif //MU_MIR_HPP
@@ -0,0 +1,300 @@
+#include "passes.hpp"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <unordered_set>
+
+namespace mu {
+    namespace mir {
+
+        bool PassManager::run(Module &module) {
+            bool changed = false;
+            for(auto& function : module.functions())
+                if(!function->is_declaration())
+                    changed = run(*function) or changed;
+            return changed;
+        }
+
+        bool PassManager::run(Function &function) {
+            bool changed = false;
+            for(u32 round = 0; round < max_rounds; ++round) {
+                bool round_changed = false;
+                for(auto& pass : passes)
+                    round_changed = pass->run(function) or round_changed;
+
+                if(!round_changed)
+                    break;
+                changed = true;
+            }
+
+            function.renumber();
+            return changed;
+        }
+
+        PassManager PassManager::default_pipeline() {
+            PassManager manager;
+            manager.add<SimplifyCFG>();
+            manager.add<CopyPropagation>();
+            manager.add<LocalCSE>();
+            manager.add<DeadCodeElimination>();
+            return manager;
+        }
+
+        /*------------------------Dead Code Elimination-------------------------*/
+
+        bool DeadCodeElimination::run(Function &function) {
+            // everything reachable from an instruction with side effects is live.
+            std::unordered_set<Instruction*> live;
+            std::vector<Instruction*> work;
+            for(auto& block : function.blocks())
+                for(auto& inst : block->instructions())
+                    if(inst->has_side_effects()) {
+                        live.insert(inst.get());
+                        work.push_back(inst.get());
+                    }
+
+            while(!work.empty()) {
+                auto inst = work.back();
+                work.pop_back();
+                for(auto operand : inst->get_operands()) {
+                    if(!operand->is_instruction())
+                        continue;
+
+                    auto used = operand->as<Instruction>();
+                    if(live.insert(used).second)
+                        work.push_back(used);
+                }
+            }
+
+            bool changed = false;
+            for(auto& block : function.blocks()) {
+                auto& insts = block->instructions();
+                auto size = insts.size();
+                insts.remove_if([&live](const std::unique_ptr<Instruction>& inst) { return !live.count(inst.get()); });
+                changed = changed or insts.size() != size;
+            }
+            return changed;
+        }
+
+        /*---------------------------Copy Propagation---------------------------*/
+
+        bool CopyPropagation::run(Function &function) {
+            std::vector<std::pair<Instruction*, Value*>> replaced;
+            for(auto& block : function.blocks()) {
+                for(auto& inst : block->instructions()) {
+                    if(inst->opcode() == Op_Copy)
+                        replaced.emplace_back(inst.get(), inst->get_operand(0));
+                    else if(inst->opcode() == Op_Phi) {
+                        // a phi whose incoming values are all the same value, ignoring itself.
+                        Value* same = nullptr;
+                        bool trivial = true;
+                        for(auto operand : inst->get_operands()) {
+                            if(operand == same or operand == inst.get())
+                                continue;
+                            if(same) {
+                                trivial = false;
+                                break;
+                            }
+                            same = operand;
+                        }
+
+                        if(trivial and same)
+                            replaced.emplace_back(inst.get(), same);
+                    }
+                }
+            }
+
+            for(auto& [inst, value] : replaced) {
+                // a value replaced earlier can be the replacement of this one.
+                for(auto& [other, other_value] : replaced)
+                    if(other_value == inst)
+                        other_value = value;
+
+                // the name of the copy is kept if the value doesn't have one.
+                if(value->is_instruction() and value->as<Instruction>()->name.empty())
+                    value->as<Instruction>()->name = inst->name;
+
+                function.replace_uses(inst, value);
+                inst->get_parent()->erase(inst);
+            }
+            return !replaced.empty();
+        }
+
+        /*-------------------------------Simplify CFG-------------------------------*/
+
+        bool SimplifyCFG::run(Function &function) {
+            bool changed = remove_unreachable(function);
+            changed = fold_branches(function) or changed;
+            changed = merge_blocks(function) or changed;
+            changed = forward_jumps(function) or changed;
+            return changed;
+        }
+
+        bool SimplifyCFG::remove_unreachable(Function &function) {
+            std::unordered_set<BasicBlock*> reachable;
+            std::vector<BasicBlock*> work = {function.entry()};
+            while(!work.empty()) {
+                auto block = work.back();
+                work.pop_back();
+                if(!reachable.insert(block).second)
+                    continue;
+
+                for(auto succ : block->successors())
+                    work.push_back(succ);
+            }
+
+            std::vector<BasicBlock*> dead;
+            for(auto& block : function.blocks())
+                if(!reachable.count(block.get()))
+                    dead.push_back(block.get());
+
+            // the phis of the reachable blocks can't refer to a dead block.
+            for(auto block : dead) {
+                for(auto succ : block->successors())
+                    if(reachable.count(succ))
+                        succ->remove_incoming(block);
+
+                if(auto term = block->terminator())
+                    block->erase(term);
+            }
+
+            for(auto block : dead)
+                function.erase(block);
+            return !dead.empty();
+        }
+
+        bool SimplifyCFG::fold_branches(Function &function) {
+            bool changed = false;
+            for(auto& block : function.blocks()) {
+                auto term = block->terminator();
+                if(!term or term->opcode() != Op_Branch)
+                    continue;
+
+                auto cond = term->get_operand(0);
+                auto then_block = term->get_targets()[0];
+                auto else_block = term->get_targets()[1];
+
+                BasicBlock* target = nullptr;
+                if(then_block == else_block)
+                    target = then_block;
+                else if(cond->is_constant())
+                    target = cond->as<Constant>()->get_integer() ? then_block : else_block;
+                else
+                    continue;
+
+                // the phis of the block that isn't taken lose this block, if the targets are the
+                // same it is in the phis twice.
+                auto other = target == then_block ? else_block : then_block;
+                other->remove_incoming(block.get());
+
+                auto type = term->get_type();
+                block->erase(term);
+                auto jump = std::make_unique<Instruction>(Op_Jump, type, std::vector<Value*>());
+                jump->get_targets().push_back(target);
+                block->append(std::move(jump));
+                changed = true;
+            }
+            return changed;
+        }
+
+        bool SimplifyCFG::merge_blocks(Function &function) {
+            bool changed = false;
+            for(auto& block : function.blocks()) {
+                // a block that jumps to a block only it jumps to, they are one block.
+                while(true) {
+                    auto term = block->terminator();
+                    if(!term or term->opcode() != Op_Jump)
+                        break;
+
+                    auto succ = term->get_targets()[0];
+                    if(succ == block.get() or succ == function.entry() or succ->predecessors().size() != 1)
+                        break;
+
+                    // the phis have a single incoming value.
+                    auto& insts = succ->instructions();
+                    while(!insts.empty() and insts.front()->opcode() == Op_Phi) {
+                        auto phi = insts.front().get();
+                        function.replace_uses(phi, phi->get_operand(0));
+                        succ->erase(phi);
+                    }
+
+                    block->erase(term);
+                    block->absorb(succ);
+                    function.erase(succ);
+                    changed = true;
+                }
+            }
+            return changed;
+        }
+
+        bool SimplifyCFG::forward_jumps(Function &function) {
+            bool changed = false;
+            for(auto& block : function.blocks()) {
+                // a block that only jumps is skipped, unless the target has phis that need to
+                // know where they were entered from.
+                if(block.get() == function.entry() or block->instructions().size() != 1)
+                    continue;
+
+                auto term = block->terminator();
+                if(!term or term->opcode() != Op_Jump)
+                    continue;
+
+                auto target = term->get_targets()[0];
+                if(target == block.get() or block->predecessors().empty() or
+                   target->instructions().front()->opcode() == Op_Phi)
+                    continue;
+
+                for(auto pred : block->predecessors()) {
+                    auto& targets = pred->terminator()->get_targets();
+                    std::replace(targets.begin(), targets.end(), block.get(), target);
+                    target->predecessors().push_back(pred);
+                }
+                block->predecessors().clear();
+                changed = true;
+            }
+            return changed;
+        }
+
+        /*---------------------------------Local CSE--------------------------------*/
+
+        bool LocalCSE::run(Function &function) {
+            typedef std::tuple<Opcode, TokenKind, types::Type*, u64, std::vector<Value*>> Key;
+
+            bool changed = false;
+            for(auto& block : function.blocks()) {
+                std::map<Key, Instruction*> available;
+
+                auto& insts = block->instructions();
+                for(auto iter = insts.begin(); iter != insts.end();) {
+                    auto inst = iter->get();
+                    switch(inst->opcode()) {
+                        case Op_Binary:
+                        case Op_Unary:
+                        case Op_Cast:
+                        case Op_Aggregate:
+                        case Op_Extract:
+                        case Op_Insert:
+                        case Op_MemberAddr:
+                            break;
+                        default:
+                            ++iter;
+                            continue;
+                    }
+
+                    Key key(inst->opcode(), inst->op, inst->get_type(), inst->index, inst->get_operands());
+                    auto [existing, inserted] = available.emplace(key, inst);
+                    if(inserted) {
+                        ++iter;
+                        continue;
+                    }
+
+                    function.replace_uses(inst, existing->second);
+                    iter = insts.erase(iter);
+                    changed = true;
+                }
+            }
+            return changed;
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef MU_MIR_PASSES_HPP
+#define MU_MIR_PASSES_HPP
+
+#include "mir.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace mu {
+    namespace mir {
+
+        // a transformation of a single function.
+        class Pass {
+        public:
+            virtual ~Pass() = default;
+
+            virtual const char* name() = 0;
+
+            // returns true if the function was changed.
+            virtual bool run(Function& function) = 0;
+        };
+
+        // runs its passes over every function of a module until none of them change anything.
+        class PassManager {
+        public:
+            // the passes are run in the order they are added.
+            template <typename T, typename... Args>
+            void add(Args&&... args) {
+                passes.push_back(std::make_unique<T>(std::forward<Args>(args)...));
+            }
+
+            // returns true if any function was changed.
+            bool run(Module& module);
+
+            bool run(Function& function);
+
+            // the cleanup passes, run after lowering.
+            static PassManager default_pipeline();
+
+        private:
+            std::vector<std::unique_ptr<Pass>> passes;
+
+            // a bound on the rounds, each pass only ever makes a function smaller so this
+            // is never reached in practice.
+            static const u32 max_rounds = 16;
+        };
+
+        // removes the instructions whose values aren't used and don't have side effects.
+        class DeadCodeElimination : public Pass {
+        public:
+            const char* name() override { return "dce"; }
+            bool run(Function& function) override;
+        };
+
+        // replaces the uses of copies and of phis with a single incoming value.
+        class CopyPropagation : public Pass {
+        public:
+            const char* name() override { return "copy-prop"; }
+            bool run(Function& function) override;
+        };
+
+        // removes unreachable blocks, folds constant branches, merges straight line blocks
+        // and skips blocks that only jump.
+        class SimplifyCFG : public Pass {
+        public:
+            const char* name() override { return "simplify-cfg"; }
+            bool run(Function& function) override;
+
+        private:
+            bool remove_unreachable(Function& function);
+            bool fold_branches(Function& function);
+            bool merge_blocks(Function& function);
+            bool forward_jumps(Function& function);
+        };
+
+        // reuses the value of an equivalent pure instruction earlier in the same block.
+        class LocalCSE : public Pass {
+        public:
+            const char* name() override { return "local-cse"; }
+            bool run(Function& function) override;
+        };
+    }
+}
+
+#endif //MU_MIR_PASSES_HPP
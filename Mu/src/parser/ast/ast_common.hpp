@@ -3,9 +3,12 @@
 
 #include <fstream>
 #include <type_traits>
+#include <cassert>
 
 #include "analysis/operand.hpp"
 #include "common.hpp"
+#include "utils/arena.hpp"
+#include "utils/small_vector.hpp"
 struct Atom;
 
 namespace mu {
@@ -14,16 +17,16 @@ namespace mu {
         class Type;
     }
 
+    // A position is an offset into the range of its file and the number of characters it spans.
+    // Every loaded file is given its own range of one offset space, see io::File::base, the line
+    // and column are only computed when a position is printed.
     struct Pos {
-        u64 line;
-        u64 column;
-        u64 span;
-        u64 fid;
+        u32 offset;
+        u32 span;
 
+        inline Pos() : offset(0), span(0) {}
 
-        inline Pos() = default;
-
-        inline Pos(u64 line, u64 column, u64 span, u64 fid) : line(line), column(column), span(span), fid(fid) {
+        inline Pos(u32 offset, u32 span) : offset(offset), span(span) {
         }
 
         inline Pos extend(const Pos& pos) {
@@ -32,15 +35,11 @@ namespace mu {
         }
 
         bool operator== (const mu::Pos& pos) {
-            return line == pos.line && column == pos.column &&
-                   span == pos.span && fid == pos.fid;
-        }
-
-        friend inline std::ostream& operator<< (std::ostream& out, const mu::Pos& pos) {
-            out << pos.line << ":" << pos.column;
-            return out;
+            return offset == pos.offset && span == pos.span;
         }
     };
+
+    static_assert(sizeof(Pos) == 8, "a position should be 8 bytes");
 }
 
 namespace ast {
@@ -243,40 +242,57 @@ namespace ast {
         Pattern(AstKind kind, const mu::Pos& pos) : AstNode(kind, pos) {}
     };
 
-    typedef std::shared_ptr<Expr> ExprPtr;
-    typedef std::shared_ptr<Decl> DeclPtr;
-    typedef std::shared_ptr<Stmt> StmtPtr;
-    typedef std::shared_ptr<Pattern> PatternPtr;
-    typedef std::shared_ptr<Spec> SpecPtr;
+    // nodes are owned by the arena of the module they were parsed in,
+    // see ModuleFile. They are made in the current arena of the thread.
+    typedef Expr* ExprPtr;
+    typedef Decl* DeclPtr;
+    typedef Stmt* StmtPtr;
+    typedef Pattern* PatternPtr;
+    typedef Spec* SpecPtr;
+
+    // child lists of nodes.
+    template <typename T>
+    using NodeList = mem::SmallVector<T, 2>;
+
+    template <typename Type, typename... Args>
+    Type* make_node(Args... args) {
+        auto arena = mem::Arena::current();
+        assert(arena and "ast nodes must be made with an active arena");
+        return arena->make<Type>(args...);
+    }
 
     template <typename Type, typename... Args>
     ExprPtr make_expr(Args... args) {
-//        static_assert(std::is_base_of<Type, Expr>::value, "Type must be a base type of Expr");
-        return std::make_shared<Type>(args...);
+        static_assert(std::is_base_of<Expr, Type>::value, "Type must be derived from Expr");
+        return make_node<Type>(args...);
     }
 
     template <typename Type, typename... Args>
     StmtPtr make_stmt(Args... args) {
-//        static_assert(std::is_base_of<Type, Stmt>::value, "Type must be a base type of Stmt");
-        return std::make_shared<Type>(args...);
+        static_assert(std::is_base_of<Stmt, Type>::value, "Type must be derived from Stmt");
+        return make_node<Type>(args...);
     }
 
     template <typename Type, typename... Args>
     SpecPtr make_spec(Args... args) {
-//        static_assert(std::is_base_of<Type, Spec>::value, "Type must be a base type of Spec");
-        return std::make_shared<Type>(args...);
+        static_assert(std::is_base_of<Spec, Type>::value, "Type must be derived from Spec");
+        return make_node<Type>(args...);
     }
 
     template <typename Type, typename... Args>
     DeclPtr make_decl(Args... args) {
-//        static_assert(std::is_base_of<Type, Decl>::value, "Type must be a base type of Decl");
-        return std::make_shared<Type>(args...);
+        static_assert(std::is_base_of<Decl, Type>::value, "Type must be derived from Decl");
+        return make_node<Type>(args...);
     }
 
     template <typename Type, typename... Args>
     PatternPtr make_pattern(Args... args) {
-//        static_assert(std::is_base_of<Type, Decl>::value, "Type must be a base type of Decl");
-        return std::make_shared<Type>(args...);
+        static_assert(std::is_base_of<Pattern, Type>::value, "Type must be derived from Pattern");
+        return make_node<Type>(args...);
+    }
+
+    inline Ident* make_ident(Atom* val, const mu::Pos& pos) {
+        return make_node<Ident>(val, pos);
     }
 
     typedef std::vector<Ident*> SPath;
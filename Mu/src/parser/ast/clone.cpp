@@ -0,0 +1,472 @@
+#include "clone.hpp"
+
+#include <tuple>
+#include <vector>
+
+namespace ast {
+
+    // set while a resolved tree is copied, see copy().
+    static bool keep_annotations = false;
+
+    template <typename T>
+    NodeList<T> clone_list(NodeList<T>& list) {
+        NodeList<T> result;
+        for(auto node : list)
+            result.push_back(clone(node));
+        return result;
+    }
+
+    static ExprPtr clone_expr(ExprPtr expr) {
+        switch(expr->kind) {
+            case ast_integer:
+                return make_expr<Integer>(expr->as<Integer>()->value, expr->pos());
+            case ast_fl:
+                return make_expr<Float>(expr->as<Float>()->value, expr->pos());
+            case ast_ch:
+                return make_expr<Char>(expr->as<Char>()->value, expr->pos());
+            case ast_str:
+                return make_expr<Str>(expr->as<Str>()->value, expr->pos());
+            case ast_bool:
+                return make_expr<Bool>(expr->as<Bool>()->value, expr->pos());
+            case ast_nil:
+                return make_expr<Nil>(expr->pos());
+            case ast_unit_expr:
+                return make_expr<Unit>(expr->pos());
+            case ast_self_expr:
+                return make_expr<Self>(expr->pos());
+            case ast_name:
+                return make_expr<Name>(expr->as<Name>()->name, expr->pos());
+            case ast_name_generic: {
+                auto node = expr->as<NameGeneric>();
+                auto params = clone_list(node->type_params);
+                return make_expr<NameGeneric>(node->name, params, expr->pos());
+            }
+            case ast_list: {
+                auto elements = clone_list(expr->as<List>()->elements);
+                return make_expr<List>(elements, expr->pos());
+            }
+            case ast_map: {
+                std::vector<std::tuple<ExprPtr, ExprPtr>> elements;
+                for(auto& [key, value] : expr->as<Map>()->elements)
+                    elements.emplace_back(clone(key), clone(value));
+                return make_expr<Map>(elements, expr->pos());
+            }
+            case ast_tuple_expr: {
+                auto elements = clone_list(expr->as<TupleExpr>()->elements);
+                return make_expr<TupleExpr>(elements, expr->pos());
+            }
+            case ast_lambda: {
+                auto node = expr->as<Lambda>();
+                auto params = clone_list(node->parameters);
+                auto ret = clone(node->ret);
+                auto body = clone(node->body);
+                return make_expr<Lambda>(params, ret, body, expr->pos());
+            }
+            case ast_unary: {
+                auto node = expr->as<Unary>();
+                auto operand = clone(node->expr);
+                return make_expr<Unary>(node->op, operand, expr->pos());
+            }
+            case ast_binary: {
+                auto node = expr->as<Binary>();
+                auto lhs = clone(node->lhs);
+                auto rhs = clone(node->rhs);
+                return make_expr<Binary>(node->op, lhs, rhs, expr->pos());
+            }
+            case ast_accessor: {
+                auto node = expr->as<Accessor>();
+                auto operand = clone(node->operand);
+                return make_expr<Accessor>(operand, node->name, expr->pos());
+            }
+            case ast_tuple_accessor: {
+                auto node = expr->as<TupleAcessor>();
+                auto operand = clone(node->operand);
+                return make_expr<TupleAcessor>(operand, node->value, expr->pos());
+            }
+            case ast_method: {
+                auto node = expr->as<Method>();
+                auto actuals = clone_list(node->actuals);
+                return make_expr<Method>(clone(node->name), actuals, expr->pos());
+            }
+            case ast_call: {
+                auto node = expr->as<Call>();
+                auto name = clone(node->name);
+                auto actuals = clone_list(node->actuals);
+                return make_expr<Call>(name, actuals, expr->pos());
+            }
+            case ast_cast_expr: {
+                auto node = expr->as<Cast>();
+                auto operand = clone(node->operand);
+                auto type = clone(node->type);
+                return make_expr<Cast>(operand, type, expr->pos());
+            }
+            case ast_block: {
+                auto elements = clone_list(expr->as<Block>()->elements);
+                return make_expr<Block>(elements, expr->pos());
+            }
+            case ast_if_expr: {
+                auto node = expr->as<If>();
+                auto cond = clone(node->cond);
+                auto body = clone(node->body);
+                auto else_if = clone(node->else_if);
+                return make_expr<If>(cond, body, else_if, expr->pos());
+            }
+            case ast_while_expr: {
+                auto node = expr->as<While>();
+                auto cond = clone(node->cond);
+                auto body = clone(node->body);
+                return make_expr<While>(cond, body, expr->pos());
+            }
+            case ast_match_arm: {
+                auto node = expr->as<MatchArm>();
+                auto patterns = clone_list(node->patterns);
+                auto body = clone(node->body);
+                return make_expr<MatchArm>(patterns, body, expr->pos());
+            }
+            case ast_match_expr: {
+                auto node = expr->as<Match>();
+                auto cond = clone(node->cond);
+                auto members = clone_list(node->members);
+                return make_expr<Match>(cond, members, expr->pos());
+            }
+            case ast_for_expr: {
+                auto node = expr->as<For>();
+                auto pattern = clone(node->pattern);
+                auto iter = clone(node->expr);
+                auto body = clone(node->body);
+                return make_expr<For>(pattern, iter, body, expr->pos());
+            }
+            case ast_defer_expr: {
+                auto body = clone(expr->as<Defer>()->body);
+                return make_expr<Defer>(body, expr->pos());
+            }
+            case ast_return: {
+                auto body = clone(expr->as<Return>()->body);
+                return make_expr<Return>(body, expr->pos());
+            }
+            case ast_expr_binding: {
+                auto node = expr->as<BindingExpr>();
+                auto value = clone(node->expr);
+                return make_expr<BindingExpr>(node->name, value, expr->pos());
+            }
+            case ast_struct_expr: {
+                auto node = expr->as<StructExpr>();
+                auto spec = clone(node->spec);
+                auto members = clone_list(node->members);
+                return make_expr<StructExpr>(spec, members, expr->pos());
+            }
+            case ast_range: {
+                auto node = expr->as<Range>();
+                auto start = clone(node->start);
+                auto end = clone(node->end);
+                auto step = clone(node->step);
+                return make_expr<Range>(start, end, step, expr->pos());
+            }
+            case ast_assign: {
+                auto node = expr->as<Assign>();
+                auto lvalue = clone(node->lvalue);
+                auto rvalue = clone(node->rvalue);
+                return make_expr<Assign>(node->op, lvalue, rvalue, expr->pos());
+            }
+            default:
+                assert(false and "unknown expression kind in clone");
+                return nullptr;
+        }
+    }
+
+    ExprPtr clone(ExprPtr expr) {
+        if(!expr)
+            return nullptr;
+
+        auto node = clone_expr(expr);
+        if(node and keep_annotations) {
+            node->type = expr->type;
+            node->operand = expr->operand;
+            node->operand.expr = node;
+        }
+        return node;
+    }
+
+    ExprPtr copy(ExprPtr expr) {
+        auto save = keep_annotations;
+        keep_annotations = true;
+        auto node = clone(expr);
+        keep_annotations = save;
+        return node;
+    }
+
+    ProcedureSigniture* clone(ProcedureSigniture* sig) {
+        if(!sig)
+            return nullptr;
+        auto params = clone_list(sig->parameters);
+        auto ret = clone(sig->ret);
+        auto generics = clone(sig->generics);
+        return make_node<ProcedureSigniture>(params, ret, generics);
+    }
+
+    DeclPtr clone(DeclPtr decl) {
+        if(!decl)
+            return nullptr;
+
+        switch(decl->kind) {
+            case ast_local: {
+                auto node = decl->as<Local>();
+                auto names = clone(node->names);
+                auto type = clone(node->type);
+                auto init = clone(node->init);
+                return make_decl<Local>(names, type, init, decl->pos());
+            }
+            case ast_mutable: {
+                auto node = decl->as<Mutable>();
+                auto names = clone(node->names);
+                auto type = clone(node->type);
+                auto init = clone(node->init);
+                auto pos = decl->pos();
+                return make_decl<Mutable>(names, type, init, pos);
+            }
+            case ast_global: {
+                auto node = decl->as<Global>();
+                auto type = clone(node->type);
+                auto init = clone(node->init);
+                return make_decl<Global>(node->name, type, init, node->vis, decl->pos());
+            }
+            case ast_global_mut: {
+                auto node = decl->as<GlobalMut>();
+                auto type = clone(node->type);
+                auto init = clone(node->init);
+                return make_decl<GlobalMut>(node->name, type, init, node->vis, decl->pos());
+            }
+            case ast_procedure: {
+                auto node = decl->as<Procedure>();
+                auto sig = clone(node->signiture);
+                auto body = clone(node->body);
+                return make_decl<Procedure>(node->name, sig, body, node->attributeList, node->modifiers,
+                        node->vis, decl->pos());
+            }
+            case ast_procedure_parameter: {
+                auto node = decl->as<ProcedureParameter>();
+                auto pattern = clone(node->pattern);
+                auto type = clone(node->type);
+                auto init = clone(node->init);
+                return make_decl<ProcedureParameter>(pattern, type, init, decl->pos());
+            }
+            case ast_self_parameter:
+                return make_decl<SelfParameter>(decl->as<SelfParameter>()->mut, decl->pos());
+            case ast_c_variadic:
+                return make_decl<CVariadicParameter>(clone(decl->as<CVariadicParameter>()->pattern), decl->pos());
+            case ast_variadic: {
+                auto node = decl->as<VariadicParameter>();
+                return make_decl<VariadicParameter>(clone(node->pattern), clone(node->type), decl->pos());
+            }
+            case ast_structure: {
+                auto node = decl->as<Structure>();
+                auto bounds = clone_list(node->bounds);
+                auto members = clone_list(node->members);
+                auto generics = clone(node->generics);
+                return make_decl<Structure>(node->name, bounds, members, generics, node->vis, decl->pos());
+            }
+            case ast_type: {
+                auto node = decl->as<Type>();
+                auto bounds = clone_list(node->bounds);
+                auto members = clone_list(node->members);
+                auto generics = clone(node->generics);
+                return make_decl<Type>(node->name, bounds, members, generics, node->vis, decl->pos());
+            }
+            case ast_type_class: {
+                auto node = decl->as<TypeClass>();
+                auto members = clone_list(node->members);
+                auto generics = clone(node->generics);
+                return make_decl<TypeClass>(node->name, members, generics, node->vis, decl->pos());
+            }
+            case ast_alias: {
+                auto node = decl->as<Alias>();
+                auto type = clone(node->type);
+                return make_decl<Alias>(node->name, type, node->vis, decl->pos());
+            }
+            case ast_generic:
+                return make_decl<Generic>(decl->as<Generic>()->name, decl->pos());
+            case ast_bounded_generic: {
+                auto node = decl->as<BoundedGeneric>();
+                auto type_bounds = clone_list(node->bounds.type_bounds);
+                auto result = make_node<BoundedGeneric>(node->name, node->bounds, decl->pos());
+                // the bounds refer back to the generic they belong to.
+                result->bounds = GenericBounds(type_bounds, result);
+                return result;
+            }
+            case ast_generics_group: {
+                auto generics = clone_list(decl->as<GenericGroup>()->generics);
+                return make_decl<GenericGroup>(generics, decl->pos());
+            }
+            case ast_member_variable: {
+                auto node = decl->as<MemberVariable>();
+                auto type = clone(node->type);
+                auto init = clone_list(node->init);
+                return make_decl<MemberVariable>(node->names, type, init, node->vis, decl->pos());
+            }
+            case ast_impl: {
+                auto node = decl->as<Impl>();
+                auto methods = clone_list(node->methods);
+                auto generics = clone(node->generics);
+                return make_decl<Impl>(node->name, methods, generics, decl->pos());
+            }
+            case ast_type_member: {
+                auto node = decl->as<TypeMember>();
+                auto types = clone_list(node->types);
+                return make_decl<TypeMember>(node->name, types, decl->pos());
+            }
+            case ast_trait_element_type: {
+                auto node = decl->as<TraitElementType>();
+                auto init = clone(node->init);
+                return make_decl<TraitElementType>(node->name, init, decl->pos());
+            }
+            // use declarations are never resolved twice, they are shared.
+            case ast_use:
+            case ast_use_path:
+            case ast_use_path_list:
+            case ast_use_path_alias:
+                return decl;
+            default:
+                assert(false and "unknown declaration kind in clone");
+                return nullptr;
+        }
+    }
+
+    StmtPtr clone(StmtPtr stmt) {
+        if(!stmt)
+            return nullptr;
+
+        switch(stmt->kind) {
+            case ast_expr: {
+                auto expr = clone(stmt->as<ExprStmt>()->expr);
+                return make_stmt<ExprStmt>(expr, stmt->pos());
+            }
+            case ast_decl: {
+                auto decl = clone(stmt->as<DeclStmt>()->decl);
+                return make_stmt<DeclStmt>(decl, stmt->pos());
+            }
+            case ast_empty:
+                return make_stmt<EmptyStmt>(stmt->pos());
+            default:
+                assert(false and "unknown statement kind in clone");
+                return nullptr;
+        }
+    }
+
+    SpecPtr clone(SpecPtr spec) {
+        if(!spec)
+            return nullptr;
+
+        switch(spec->kind) {
+            case ast_expr_type: {
+                auto type = clone(spec->as<ExprSpec>()->type);
+                return make_spec<ExprSpec>(type, spec->pos());
+            }
+            case ast_tuple: {
+                auto elements = clone_list(spec->as<TupleSpec>()->elements);
+                return make_spec<TupleSpec>(elements, spec->pos());
+            }
+            case ast_list_spec: {
+                auto node = spec->as<ListSpec>();
+                auto type = clone(node->type);
+                return make_spec<ListSpec>(type, clone(node->size), spec->pos());
+            }
+            case ast_list_spec_dyn: {
+                auto type = clone(spec->as<DynListSpec>()->type);
+                return make_spec<DynListSpec>(type, spec->pos());
+            }
+            case ast_procedure_spec: {
+                auto node = spec->as<ProcedureSpec>();
+                auto params = clone_list(node->params);
+                auto ret = clone(node->ret);
+                return make_spec<ProcedureSpec>(params, ret, spec->pos());
+            }
+            case ast_ptr: {
+                auto type = clone(spec->as<PtrSpec>()->type);
+                return make_spec<PtrSpec>(type, spec->pos());
+            }
+            case ast_ref: {
+                auto type = clone(spec->as<RefSpec>()->type);
+                return make_spec<RefSpec>(type, spec->pos());
+            }
+            case ast_mut: {
+                auto type = clone(spec->as<MutSpec>()->type);
+                return make_spec<MutSpec>(type, spec->pos());
+            }
+            case ast_self_type:
+                return make_spec<SelfSpec>(spec->pos());
+            case ast_infer_type:
+                return make_spec<InferSpec>(spec->pos());
+            case ast_type_lit:
+                return make_spec<TypeLitSpec>(spec->pos());
+            case ast_unit_type:
+                return make_spec<UnitSpec>(spec->pos());
+            default:
+                assert(false and "unknown type spec kind in clone");
+                return nullptr;
+        }
+    }
+
+    PatternPtr clone(PatternPtr pattern) {
+        if(!pattern)
+            return nullptr;
+
+        switch(pattern->kind) {
+            case ast_ident_pattern: {
+                auto node = make_pattern<IdentPattern>(pattern->as<IdentPattern>()->name, pattern->pos());
+                if(keep_annotations)
+                    node->as<IdentPattern>()->entity = pattern->as<IdentPattern>()->entity;
+                return node;
+            }
+            case ast_multi: {
+                auto patterns = clone_list(pattern->as<MultiPattern>()->patterns);
+                return make_pattern<MultiPattern>(patterns, pattern->pos());
+            }
+            case ast_tuple_desc: {
+                auto patterns = clone_list(pattern->as<TuplePattern>()->patterns);
+                return make_pattern<TuplePattern>(patterns, pattern->pos());
+            }
+            case ast_struct_desc: {
+                auto node = pattern->as<StructPattern>();
+                auto type = clone(node->type);
+                auto elements = clone_list(node->elements);
+                return make_pattern<StructPattern>(type, elements, pattern->pos());
+            }
+            case ast_list_desc: {
+                auto elements = clone_list(pattern->as<ListPattern>()->elements);
+                return make_pattern<ListPattern>(elements, pattern->pos());
+            }
+            case ast_type_desc: {
+                auto node = pattern->as<TypePattern>();
+                auto type = clone(node->type);
+                auto elements = clone_list(node->elements);
+                return make_pattern<TypePattern>(type, elements, pattern->pos());
+            }
+            case ast_ignore_pattern:
+                return make_pattern<IgnorePattern>(pattern->pos());
+            case ast_bind_pattern: {
+                auto node = pattern->as<BindPattern>();
+                auto patterns = clone(node->patterns);
+                return make_pattern<BindPattern>(node->name, patterns, pattern->pos());
+            }
+            case ast_int_pattern:
+                return make_pattern<IntPattern>(pattern->as<IntPattern>()->value, pattern->pos());
+            case ast_float_pattern:
+                return make_pattern<FloatPattern>(pattern->as<FloatPattern>()->value, pattern->pos());
+            case ast_char_pattern:
+                return make_pattern<CharPattern>(pattern->as<CharPattern>()->value, pattern->pos());
+            case ast_string_pattern:
+                return make_pattern<StringPattern>(pattern->as<StringPattern>()->value, pattern->pos());
+            case ast_bool_pattern:
+                return make_pattern<BoolPattern>(pattern->as<BoolPattern>()->value, pattern->pos());
+            case ast_range_pattern: {
+                auto node = pattern->as<RangePattern>();
+                auto start = clone(node->start);
+                auto end = clone(node->end);
+                return make_pattern<RangePattern>(start, end, pattern->pos());
+            }
+            default:
+                assert(false and "unknown pattern kind in clone");
+                return nullptr;
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef MU_CLONE_HPP
+#define MU_CLONE_HPP
+
+#include "ast_common.hpp"
+#include "expr.hpp"
+#include "decl.hpp"
+#include "stmt.hpp"
+#include "specs.hpp"
+#include "pattern.hpp"
+
+namespace ast {
+    // Deep copies of a tree that has not been resolved.
+    //
+    // The typer annotates the nodes it resolves, so a declaration that is resolved
+    // more than once, an instance of a generic structure or procedure, is resolved
+    // over its own copy. The copies are made in the current arena and share the
+    // identifiers of the original, nothing the typer attached to the original is
+    // copied.
+    ExprPtr clone(ExprPtr expr);
+
+    DeclPtr clone(DeclPtr decl);
+
+    StmtPtr clone(StmtPtr stmt);
+
+    SpecPtr clone(SpecPtr spec);
+
+    PatternPtr clone(PatternPtr pattern);
+
+    // a copy of a resolved expression that keeps the types, operands and entities the
+    // typer attached to it, the folder unrolls a loop over copies of its body.
+    ExprPtr copy(ExprPtr expr);
+}
+
+#endif //MU_CLONE_HPP
@@ -6,7 +6,7 @@ namespace ast {
             : Decl(ast_local, pos), names(std::move(names)), type(std::move(type)), init(std::move(init)) {}
 
     Mutable::Mutable(PatternPtr &names, SpecPtr &type, ExprPtr &init, mu::Pos &pos)
-            : Decl(ast_local, pos), names(std::move(names)), type(std::move(type)), init(std::move(init)) {}
+            : Decl(ast_mutable, pos), names(std::move(names)), type(std::move(type)), init(std::move(init)) {}
 
     Global::Global(Ident *name, SpecPtr &type, ExprPtr &init, ast::Visibility vis, const mu::Pos &pos) : Decl(
             ast_global, pos),
@@ -30,11 +30,11 @@ namespace ast {
 
     AttributeList::AttributeList(const std::vector<Attribute> &attributes) : attributes(attributes) {}
 
-    ProcedureSigniture::ProcedureSigniture(std::vector<DeclPtr> &parameters, SpecPtr &ret, DeclPtr &generics) :
+    ProcedureSigniture::ProcedureSigniture(NodeList<DeclPtr> &parameters, SpecPtr &ret, DeclPtr &generics) :
             parameters(std::move(parameters)), ret(std::move(ret)), generics(std::move(generics)) {
     }
 
-    Procedure::Procedure(Ident *name, std::shared_ptr<ProcedureSigniture> &signiture, ExprPtr &body,
+    Procedure::Procedure(Ident *name, ProcedureSigniture* signiture, ExprPtr &body,
                          AttributeList &attributeList, const std::vector<Modifier> &modifiers,
                          Visibility vis, const mu::Pos &pos) : Decl(ast_procedure, pos), name(name),
                                                                signiture(std::move(signiture)),
@@ -58,19 +58,19 @@ namespace ast {
         pattern(std::move(pattern)), type(std::move(type)) {
     }
 
-    Structure::Structure(Ident *name, std::vector<SpecPtr> &bounds, std::vector<DeclPtr> &members, DeclPtr &generics,
+    Structure::Structure(Ident *name, NodeList<SpecPtr> &bounds, NodeList<DeclPtr> &members, DeclPtr &generics,
                          Visibility vis, const mu::Pos &pos) : Decl(ast_structure, pos),
                                                                name(name), bounds(std::move(bounds)),
                                                                members(std::move(members)),
                                                                generics(std::move(generics)),
                                                                vis(vis) {}
 
-    Type::Type(Ident *name, std::vector<SpecPtr> &bounds, std::vector<DeclPtr> &members, DeclPtr &generics,
+    Type::Type(Ident *name, NodeList<SpecPtr> &bounds, NodeList<DeclPtr> &members, DeclPtr &generics,
                Visibility vis, const mu::Pos &pos) : Decl(ast_type, pos),
                                                      name(name), bounds(std::move(bounds)), members(std::move(members)),
                                                      generics(std::move(generics)), vis(vis) {}
 
-    TypeClass::TypeClass(Ident *name, std::vector<DeclPtr> &members, DeclPtr &generics, Visibility vis,
+    TypeClass::TypeClass(Ident *name, NodeList<DeclPtr> &members, DeclPtr &generics, Visibility vis,
                          const mu::Pos &pos) :
             Decl(ast_type_class, pos), name(name), members(std::move(members)), generics(std::move(generics)),
             vis(vis) {}
@@ -78,7 +78,7 @@ namespace ast {
     UsePath::UsePath(const SPath &path, bool all_names, const mu::Pos &pos) : Decl(ast_use_path, pos),
                                                                               path(path), all_names(all_names) {}
 
-    UsePathList::UsePathList(const SPath &path, std::vector<DeclPtr> &subpaths, const mu::Pos &pos) : Decl(
+    UsePathList::UsePathList(const SPath &path, NodeList<DeclPtr> &subpaths, const mu::Pos &pos) : Decl(
             ast_use_path_list, pos),
                                                                                                       base(path),
                                                                                                       subpaths(
@@ -96,7 +96,7 @@ namespace ast {
 
     Generic::Generic(Ident *name, const mu::Pos &pos) : Decl(ast_generic, pos), name(name) {}
 
-    GenericBounds::GenericBounds(std::vector<ast::SpecPtr> &type_bounds, BoundedGeneric *parent) :
+    GenericBounds::GenericBounds(ast::NodeList<ast::SpecPtr> &type_bounds, BoundedGeneric *parent) :
             type_bounds(std::move(type_bounds)), parent(parent) {}
 
     BoundedGeneric::BoundedGeneric(Ident *name, GenericBounds &bounds, const mu::Pos &pos) : Decl(ast_bounded_generic,
@@ -105,18 +105,18 @@ namespace ast {
                                                                                              bounds(std::move(
                                                                                                      bounds)) {}
 
-    GenericGroup::GenericGroup(std::vector<DeclPtr> &generics, const mu::Pos &pos) : Decl(ast_generics_group, pos),
+    GenericGroup::GenericGroup(NodeList<DeclPtr> &generics, const mu::Pos &pos) : Decl(ast_generics_group, pos),
                                                                                      generics(std::move(generics)) {}
 
-    MemberVariable::MemberVariable(std::vector<Ident *> &names, SpecPtr &type,
-                                   std::vector<ExprPtr> &init, Visibility vis, const mu::Pos &pos) :
+    MemberVariable::MemberVariable(NodeList<Ident*> &names, SpecPtr &type,
+                                   NodeList<ExprPtr> &init, Visibility vis, const mu::Pos &pos) :
             Decl(ast_member_variable, pos), names(std::move(names)), type(std::move(type)),
             init(std::move(init)), vis(vis) {}
 
-    Impl::Impl(Ident *name, std::vector<DeclPtr> &methods, DeclPtr &generics, const mu::Pos &pos) :
+    Impl::Impl(Ident *name, NodeList<DeclPtr> &methods, DeclPtr &generics, const mu::Pos &pos) :
         Decl(ast_impl, pos), name(name), generics(std::move(generics)), methods(std::move(methods))  {}
 
-    TypeMember::TypeMember(Ident *name, std::vector<SpecPtr> &types, const mu::Pos &pos) :
+    TypeMember::TypeMember(Ident *name, NodeList<SpecPtr> &types, const mu::Pos &pos) :
             Decl(ast_type_member, pos), name(name), types(std::move(types)) {}
 
     TraitElementType::TraitElementType(Ident *name, SpecPtr &init, const mu::Pos &pos) : Decl(ast_trait_element_type,
@@ -15,9 +15,9 @@ namespace ast {
     };
 
     struct Local : public Decl {
-        PatternPtr names;
-        SpecPtr type;
-        ExprPtr init;
+        PatternPtr names{nullptr};
+        SpecPtr type{nullptr};
+        ExprPtr init{nullptr};
 
         Local(PatternPtr &names, SpecPtr &type, ExprPtr &init, const mu::Pos& pos);
         virtual ~Local() = default;
@@ -25,9 +25,9 @@ namespace ast {
     };
 
     struct Mutable : public Decl {
-        PatternPtr names;
-        SpecPtr type;
-        ExprPtr init;
+        PatternPtr names{nullptr};
+        SpecPtr type{nullptr};
+        ExprPtr init{nullptr};
 
         Mutable(PatternPtr &names, SpecPtr &type, ExprPtr &init, mu::Pos& pos);
         virtual ~Mutable() = default;
@@ -70,27 +70,28 @@ namespace ast {
 
     enum Modifier {
         Mod_Inline,
+        Mod_Const, // can be run while the module is compiled
 //        Mod_Public,
 //        Mod_Private
     };
 
     struct ProcedureSigniture {
-        std::vector<DeclPtr> parameters;
-        SpecPtr ret;
-        DeclPtr generics;
+        NodeList<DeclPtr> parameters;
+        SpecPtr ret{nullptr};
+        DeclPtr generics{nullptr};
 
-        ProcedureSigniture(std::vector<DeclPtr>& parameters, SpecPtr& ret, DeclPtr& generics);
+        ProcedureSigniture(NodeList<DeclPtr>& parameters, SpecPtr& ret, DeclPtr& generics);
     };
 
     struct Procedure : public Decl {
         Ident* name;
-        std::shared_ptr<ProcedureSigniture> signiture;
-        ExprPtr body;
+        ProcedureSigniture* signiture{nullptr};
+        ExprPtr body{nullptr};
         AttributeList attributeList;
         Visibility vis;
         std::vector<Modifier> modifiers;
 
-        Procedure(Ident* name, std::shared_ptr<ProcedureSigniture>& signiture, ExprPtr& body, AttributeList& attributeList, const std::vector<Modifier>& modifiers,
+        Procedure(Ident* name, ProcedureSigniture* signiture, ExprPtr& body, AttributeList& attributeList, const std::vector<Modifier>& modifiers,
                 Visibility vis, const mu::Pos& pos);
         
         virtual ~Procedure() = default;
@@ -98,9 +99,9 @@ namespace ast {
     };
 
     struct ProcedureParameter : public Decl {
-        PatternPtr pattern;
-        SpecPtr type;
-        ExprPtr init;
+        PatternPtr pattern{nullptr};
+        SpecPtr type{nullptr};
+        ExprPtr init{nullptr};
 
         ProcedureParameter(PatternPtr& pattern, SpecPtr& type, ExprPtr& init, const mu::Pos& pos);
 
@@ -118,7 +119,7 @@ namespace ast {
     };
 
     struct CVariadicParameter : public Decl {
-        PatternPtr pattern;
+        PatternPtr pattern{nullptr};
         CVariadicParameter(PatternPtr pattern, const mu::Pos& pos);
 
         virtual ~CVariadicParameter() = default;
@@ -126,8 +127,8 @@ namespace ast {
     };
 
     struct VariadicParameter : public Decl {
-        PatternPtr pattern;
-        SpecPtr type;
+        PatternPtr pattern{nullptr};
+        SpecPtr type{nullptr};
 
         VariadicParameter(PatternPtr pattern, SpecPtr type, const mu::Pos& pos);
 
@@ -137,12 +138,12 @@ namespace ast {
 
     struct Structure : public Decl {
         Ident* name{nullptr};
-        std::vector<SpecPtr> bounds;
-        std::vector<DeclPtr> members;
-        DeclPtr generics;
+        NodeList<SpecPtr> bounds;
+        NodeList<DeclPtr> members;
+        DeclPtr generics{nullptr};
         Visibility vis;
 
-        Structure(Ident *name, std::vector<SpecPtr> &bounds, std::vector<DeclPtr> &members, DeclPtr &generics,
+        Structure(Ident *name, NodeList<SpecPtr> &bounds, NodeList<DeclPtr> &members, DeclPtr &generics,
                   Visibility vis, const mu::Pos &pos);
             
         virtual ~Structure() = default;
@@ -151,12 +152,12 @@ namespace ast {
 
     struct Type : public Decl {
         Ident* name;
-        std::vector<SpecPtr> bounds;
-        std::vector<DeclPtr> members;
-        DeclPtr generics;
+        NodeList<SpecPtr> bounds;
+        NodeList<DeclPtr> members;
+        DeclPtr generics{nullptr};
         Visibility vis;
 
-        Type(Ident *name, std::vector<SpecPtr> &bounds, std::vector<DeclPtr> &members, DeclPtr &generics,
+        Type(Ident *name, NodeList<SpecPtr> &bounds, NodeList<DeclPtr> &members, DeclPtr &generics,
             Visibility vis, const mu::Pos &pos);
         
         virtual ~Type() = default;
@@ -165,11 +166,11 @@ namespace ast {
 
     struct TypeClass : public Decl {
         Ident* name;
-        std::vector<DeclPtr> members;
-        DeclPtr generics;
+        NodeList<DeclPtr> members;
+        DeclPtr generics{nullptr};
         Visibility vis;
 
-        TypeClass(Ident* name, std::vector<DeclPtr>& members, DeclPtr& generics, Visibility vis, const mu::Pos& pos);
+        TypeClass(Ident* name, NodeList<DeclPtr>& members, DeclPtr& generics, Visibility vis, const mu::Pos& pos);
 
         virtual ~TypeClass() = default;
         void renderer(AstRenderer* renderer) override;
@@ -187,9 +188,9 @@ namespace ast {
 
     struct UsePathList : public Decl {
         SPath base;
-        std::vector<DeclPtr> subpaths;
+        NodeList<DeclPtr> subpaths;
 
-        UsePathList(const SPath& path, std::vector<DeclPtr>& subpaths, const mu::Pos& pos);
+        UsePathList(const SPath& path, NodeList<DeclPtr>& subpaths, const mu::Pos& pos);
 
         virtual ~UsePathList() = default;
         void renderer(AstRenderer* renderer) override;
@@ -206,7 +207,7 @@ namespace ast {
     };
 
     struct Use : public Decl {
-        DeclPtr use_path;
+        DeclPtr use_path{nullptr};
         Visibility vis;
 
         Use(DeclPtr& use_path, Visibility vis, const mu::Pos& pos);
@@ -217,7 +218,7 @@ namespace ast {
 
     struct Alias : public Decl {
         Ident* name;
-        SpecPtr type;
+        SpecPtr type{nullptr};
         Visibility vis;
 
         Alias(Ident* name, SpecPtr& type, Visibility vis, const mu::Pos& pos);
@@ -239,10 +240,10 @@ namespace ast {
     struct BoundedGeneric;
 
     struct GenericBounds {
-        std::vector<ast::SpecPtr> type_bounds;
+        NodeList<ast::SpecPtr> type_bounds;
         BoundedGeneric* parent;
 
-        GenericBounds(std::vector<ast::SpecPtr>& type_bounds, BoundedGeneric* parent);
+        GenericBounds(ast::NodeList<ast::SpecPtr>& type_bounds, BoundedGeneric* parent);
     };
     struct BoundedGeneric : public Decl {
         Ident* name;
@@ -255,22 +256,22 @@ namespace ast {
     };
 
     struct GenericGroup : public Decl {
-        std::vector<DeclPtr> generics;
+        NodeList<DeclPtr> generics;
 
-        GenericGroup(std::vector<DeclPtr>& generics, const mu::Pos& pos);
+        GenericGroup(NodeList<DeclPtr>& generics, const mu::Pos& pos);
 
         virtual ~GenericGroup() = default;
         void renderer(AstRenderer* renderer) override;
     };
 
     struct MemberVariable : public Decl {
-        std::vector<ast::Ident*> names;
-        SpecPtr type;
-        std::vector<ast::ExprPtr> init;
+        NodeList<ast::Ident*> names;
+        SpecPtr type{nullptr};
+        NodeList<ast::ExprPtr> init;
         Visibility vis{Visibility::Private};
 
-        MemberVariable(std::vector<Ident *> &names, SpecPtr &type,
-                       std::vector<ExprPtr> &init, Visibility vis, const mu::Pos& pos);
+        MemberVariable(NodeList<Ident*> &names, SpecPtr &type,
+                       NodeList<ExprPtr> &init, Visibility vis, const mu::Pos& pos);
         
         virtual ~MemberVariable() = default;
         void renderer(AstRenderer* renderer) override;
@@ -278,9 +279,9 @@ namespace ast {
 
     struct Impl : public Decl {
         Ident* name;
-        DeclPtr generics;
-        std::vector<DeclPtr> methods;
-        Impl(Ident* name, std::vector<DeclPtr>& methods, DeclPtr& generics, const mu::Pos& pos);
+        DeclPtr generics{nullptr};
+        NodeList<DeclPtr> methods;
+        Impl(Ident* name, NodeList<DeclPtr>& methods, DeclPtr& generics, const mu::Pos& pos);
 
         virtual ~Impl() = default;
         void renderer(AstRenderer* renderer) override;
@@ -288,9 +289,9 @@ namespace ast {
 
     struct TypeMember : public Decl {
         Ident* name;
-        std::vector<SpecPtr> types;
+        NodeList<SpecPtr> types;
 
-        TypeMember(Ident* name, std::vector<SpecPtr>& types, const mu::Pos& pos);
+        TypeMember(Ident* name, NodeList<SpecPtr>& types, const mu::Pos& pos);
 
         virtual ~TypeMember() = default;
         void renderer(AstRenderer* renderer) override;
@@ -298,7 +299,7 @@ namespace ast {
 
     struct TraitElementType : public Decl {
         Ident* name;
-        SpecPtr init; // default type if one is not provided
+        SpecPtr init{nullptr}; // default type if one is not provided
 
         TraitElementType(Ident* name, SpecPtr& init, const mu::Pos& pos);
 
@@ -17,7 +17,7 @@ namespace ast {
 //           return out;
 //        }
 
-    NameGeneric::NameGeneric(Ident* name, std::vector<ast::SpecPtr>& type_params, const mu::Pos& pos) : Expr(ast_name_generic, pos), name(name), type_params(std::move(type_params)) {}
+    NameGeneric::NameGeneric(Ident* name, ast::NodeList<ast::SpecPtr>& type_params, const mu::Pos& pos) : Expr(ast_name_generic, pos), name(name), type_params(std::move(type_params)) {}
 
     Integer::Integer(u64 value, const mu::Pos& pos) : Expr(ast_integer, pos), value(value) {}
     Integer::~Integer()  = default;
@@ -64,18 +64,18 @@ namespace ast {
     Self::Self(const mu::Pos& pos): Expr(ast_self_expr, pos) {}
 
 
-    Lambda::Lambda(std::vector<DeclPtr>& parameters, SpecPtr& ret, ExprPtr& body, const mu::Pos& pos) :
+    Lambda::Lambda(NodeList<DeclPtr>& parameters, SpecPtr& ret, ExprPtr& body, const mu::Pos& pos) :
                 Expr(ast_lambda, pos), parameters(std::move(parameters)), ret(std::move(ret)),
                 body(std::move(body)) {}
 
     Lambda::~Lambda() = default;
 
-    TupleExpr::TupleExpr(std::vector<ExprPtr>& elements, const mu::Pos& pos) : Expr(ast_tuple_expr, pos),
+    TupleExpr::TupleExpr(NodeList<ExprPtr>& elements, const mu::Pos& pos) : Expr(ast_tuple_expr, pos),
                                                                         elements(std::move(elements)){}
 
     TupleExpr::~TupleExpr() = default;
 
-    List::List(std::vector<ExprPtr>& elements, const mu::Pos& pos) : Expr(ast_list, pos),
+    List::List(NodeList<ExprPtr>& elements, const mu::Pos& pos) : Expr(ast_list, pos),
                                                                    elements(std::move(elements)) {}
 
 //     List::~List()  = default;
@@ -148,7 +148,7 @@ namespace ast {
         TupleAcessor::~TupleAcessor() = default;
 
 
-        Method::Method(ExprPtr name, const std::vector<ExprPtr>& actuals, const mu::Pos& pos):
+        Method::Method(ExprPtr name, const NodeList<ExprPtr>& actuals, const mu::Pos& pos):
 			Expr(ast_method, pos), name(std::move(name)), actuals(actuals) {}
 
         Method::~Method() = default;
@@ -158,7 +158,7 @@ namespace ast {
         Cast::~Cast() = default;
 
 
-        Block::Block(std::vector<StmtPtr>& elements, const mu::Pos& pos) : Expr(ast_block, pos),
+        Block::Block(NodeList<StmtPtr>& elements, const mu::Pos& pos) : Expr(ast_block, pos),
                                                                     elements(std::move(elements)) {}
         Block::~Block() = default;
 //        std::ostream&operator<< (std::ostream& out)  {
@@ -175,7 +175,7 @@ namespace ast {
 //        }
 
 
-        Call::Call(ExprPtr &operand, const std::vector<ExprPtr> &actuals,
+        Call::Call(ExprPtr &operand, const NodeList<ExprPtr> &actuals,
              const mu::Pos &pos) : Expr(ast_call, pos), name(std::move(operand)), actuals(std::move(actuals)) {}
         Call::~Call() = default;
 
@@ -189,15 +189,15 @@ namespace ast {
         While::~While() = default;
 
 
-        MatchArm::MatchArm(std::vector<PatternPtr>& patterns, ExprPtr& body, const mu::Pos& pos) : Expr(ast_match_arm, pos),
+        MatchArm::MatchArm(NodeList<PatternPtr>& patterns, ExprPtr& body, const mu::Pos& pos) : Expr(ast_match_arm, pos),
                                                                                          patterns(std::move(patterns)), body(std::move(body)) {}
 
 
-        Match::Match(ExprPtr& cond, std::vector<ExprPtr>& members, const mu::Pos& pos) : Expr(ast_match_expr, pos),
+        Match::Match(ExprPtr& cond, NodeList<ExprPtr>& members, const mu::Pos& pos) : Expr(ast_match_expr, pos),
                                                                                   cond(std::move(cond)), members(std::move(members)) {}
 
         For::For(ast::PatternPtr& pattern, ast::ExprPtr& expr, ast::ExprPtr& body, const mu::Pos& pos) :
-                Expr(ast_expr, pos), pattern(std::move(pattern)), expr(std::move(expr)),
+                Expr(ast_for_expr, pos), pattern(std::move(pattern)), expr(std::move(expr)),
                 body(std::move(body)) {}
 
         Defer::Defer(ExprPtr& body, const mu::Pos& pos) : Expr(ast_defer_expr, pos),
@@ -210,7 +210,7 @@ namespace ast {
                                                                       name(name), expr(std::move(expr)) {}
 
 
-        StructExpr::StructExpr(SpecPtr& spec, std::vector<ExprPtr>& members, const mu::Pos& pos) : Expr(ast_struct_expr, pos),
+        StructExpr::StructExpr(SpecPtr& spec, NodeList<ExprPtr>& members, const mu::Pos& pos) : Expr(ast_struct_expr, pos),
                                                                                        spec(std::move(spec)), members(std::move(members)) {}
 
 
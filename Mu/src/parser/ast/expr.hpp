@@ -31,9 +31,9 @@ namespace ast {
     
     struct NameGeneric : Expr {
         Ident* name;
-        std::vector<SpecPtr> type_params;
+        NodeList<SpecPtr> type_params;
 
-        NameGeneric(Ident* name, std::vector<SpecPtr>& type_params, const mu::Pos& pos);
+        NameGeneric(Ident* name, NodeList<SpecPtr>& type_params, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
@@ -117,29 +117,29 @@ namespace ast {
     };
 
     struct Lambda : public Expr {
-        std::vector<DeclPtr> parameters;
-        SpecPtr ret;
-        ExprPtr body;
+        NodeList<DeclPtr> parameters;
+        SpecPtr ret{nullptr};
+        ExprPtr body{nullptr};
 
-        Lambda(std::vector<DeclPtr>& parameters, SpecPtr& ret, ExprPtr& body, const mu::Pos& pos);
+        Lambda(NodeList<DeclPtr>& parameters, SpecPtr& ret, ExprPtr& body, const mu::Pos& pos);
 
         ~Lambda() override;
         void renderer(AstRenderer* renderer) override;
     };
 
     struct TupleExpr : public Expr {
-        std::vector<ExprPtr> elements;
+        NodeList<ExprPtr> elements;
 
-        TupleExpr(std::vector<ExprPtr>& elements, const mu::Pos& pos);
+        TupleExpr(NodeList<ExprPtr>& elements, const mu::Pos& pos);
 
         ~TupleExpr() override;
         void renderer(AstRenderer* renderer) override;
     };
 
     struct List : public Expr {
-        std::vector<ExprPtr> elements;
+        NodeList<ExprPtr> elements;
 
-        List(std::vector<ExprPtr>& elements, const mu::Pos& pos);
+        List(NodeList<ExprPtr>& elements, const mu::Pos& pos);
 
         ~List() override = default;
         void renderer(AstRenderer* renderer) override;
@@ -183,7 +183,7 @@ namespace ast {
 
     struct Unary : public Expr {
         mu::TokenKind op;
-        ExprPtr expr;
+        ExprPtr expr{nullptr};
 
         Unary(mu::TokenKind op, ExprPtr& expr, const mu::Pos& pos);
         ~Unary() override;
@@ -199,7 +199,7 @@ namespace ast {
 
     struct Binary : public Expr {
         mu::TokenKind op;
-        ExprPtr lhs, rhs;
+        ExprPtr lhs{nullptr}, rhs{nullptr};
 
         Binary(mu::TokenKind op, ExprPtr& lhs, ExprPtr& rhs, const mu::Pos& pos);
 
@@ -216,7 +216,7 @@ namespace ast {
     };
 
     struct Accessor : public Expr {
-        ExprPtr operand;
+        ExprPtr operand{nullptr};
         Ident* name;
 
         Accessor(ExprPtr& operand, Ident* name, const mu::Pos& pos);
@@ -226,7 +226,7 @@ namespace ast {
     };
 
     struct TupleAcessor : public Expr {
-        ExprPtr operand;
+        ExprPtr operand{nullptr};
         u64 value;
 
         TupleAcessor(ExprPtr& operand, u64 value, const mu::Pos& pos);
@@ -236,19 +236,19 @@ namespace ast {
     };
 
     struct Method : public Expr {
-        ExprPtr name;
+        ExprPtr name{nullptr};
 		// [self, args ...]
-        std::vector<ExprPtr> actuals;
+        NodeList<ExprPtr> actuals;
 
-        Method(ExprPtr name, const std::vector<ExprPtr>& actuals, const mu::Pos& pos);
+        Method(ExprPtr name, const NodeList<ExprPtr>& actuals, const mu::Pos& pos);
         ~Method() override;
 
         void renderer(AstRenderer* renderer) override;
     };
 
     struct Cast : public Expr {
-        ExprPtr operand;
-        SpecPtr type;
+        ExprPtr operand{nullptr};
+        SpecPtr type{nullptr};
 
         Cast(ExprPtr& operand, SpecPtr& type, const mu::Pos& pos);
 
@@ -257,9 +257,9 @@ namespace ast {
     };
 
     struct Block : public Expr {
-        std::vector<StmtPtr> elements;
+        NodeList<StmtPtr> elements;
 
-        Block(std::vector<StmtPtr>& elements, const mu::Pos& pos);
+        Block(NodeList<StmtPtr>& elements, const mu::Pos& pos);
 
         ~Block() override;
         void renderer(AstRenderer* renderer) override;
@@ -279,11 +279,11 @@ namespace ast {
     };
 
     struct Call : public Expr {
-        ExprPtr name;
-        // std::vector<ast::SpecPtr> type_parameters;
-        std::vector<ExprPtr> actuals;
+        ExprPtr name{nullptr};
+        // ast::NodeList<ast::SpecPtr> type_parameters;
+        NodeList<ExprPtr> actuals;
 
-        Call(ExprPtr &operand, const std::vector<ExprPtr> &actuals,
+        Call(ExprPtr &operand, const NodeList<ExprPtr> &actuals,
              const mu::Pos &pos);
 
         ~Call() override;
@@ -291,9 +291,9 @@ namespace ast {
     };
 
     struct If : public Expr {
-        ExprPtr cond;
-        ExprPtr body;
-        ExprPtr else_if;
+        ExprPtr cond{nullptr};
+        ExprPtr body{nullptr};
+        ExprPtr else_if{nullptr};
 
         If(ExprPtr& cond, ExprPtr& body, ExprPtr& else_if, const mu::Pos& pos);
 
@@ -302,8 +302,8 @@ namespace ast {
     };
 
     struct While : public Expr {
-        ExprPtr cond;
-        ExprPtr body;
+        ExprPtr cond{nullptr};
+        ExprPtr body{nullptr};
 
         While(ExprPtr& cond, ExprPtr& body, const mu::Pos& pos);
 
@@ -312,39 +312,39 @@ namespace ast {
     };
 
     struct MatchArm : public Expr {
-       std::vector<PatternPtr> patterns;
-       ExprPtr body;
+       NodeList<PatternPtr> patterns;
+       ExprPtr body{nullptr};
 
-       MatchArm(std::vector<PatternPtr>& patterns, ExprPtr& body, const mu::Pos& pos);
+       MatchArm(NodeList<PatternPtr>& patterns, ExprPtr& body, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct Match : public Expr {
-        ExprPtr cond;
-        std::vector<ExprPtr> members;
+        ExprPtr cond{nullptr};
+        NodeList<ExprPtr> members;
 
-        Match(ExprPtr& cond, std::vector<ExprPtr>& members, const mu::Pos& pos);
+        Match(ExprPtr& cond, NodeList<ExprPtr>& members, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct For : public Expr {
-        ast::PatternPtr pattern;
-        ast::ExprPtr expr;
-        ast::ExprPtr body;
+        ast::PatternPtr pattern{nullptr};
+        ast::ExprPtr expr{nullptr};
+        ast::ExprPtr body{nullptr};
 
         For(ast::PatternPtr& pattern, ast::ExprPtr& expr, ast::ExprPtr& body, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct Defer : public Expr {
-        ExprPtr body;
+        ExprPtr body{nullptr};
 
         Defer(ExprPtr& body, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct Return : public Expr {
-        ExprPtr body;
+        ExprPtr body{nullptr};
 
         Return(ExprPtr& body, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
@@ -352,24 +352,24 @@ namespace ast {
 
     struct BindingExpr : public Expr {
         Ident* name;
-        ExprPtr expr;
+        ExprPtr expr{nullptr};
 
         BindingExpr(Ident* name, ExprPtr& expr, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct StructExpr : public Expr {
-        SpecPtr spec;
-        std::vector<ExprPtr> members;
+        SpecPtr spec{nullptr};
+        NodeList<ExprPtr> members;
 
-        StructExpr(SpecPtr& spec, std::vector<ExprPtr>& members, const mu::Pos& pos);
+        StructExpr(SpecPtr& spec, NodeList<ExprPtr>& members, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct Range : public Expr {
-        ExprPtr start;
-        ExprPtr end;
-        ExprPtr step;
+        ExprPtr start{nullptr};
+        ExprPtr end{nullptr};
+        ExprPtr step{nullptr};
 
         Range(ExprPtr& start, ExprPtr& end, ExprPtr& step, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
@@ -377,8 +377,8 @@ namespace ast {
 
     struct Assign : public Expr {
         mu::TokenKind op;
-        ExprPtr lvalue;
-        ExprPtr rvalue;
+        ExprPtr lvalue{nullptr};
+        ExprPtr rvalue{nullptr};
 
         Assign(mu::TokenKind op, ExprPtr& lvalue, ExprPtr& rvalue, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
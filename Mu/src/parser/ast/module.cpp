@@ -5,8 +5,9 @@
 #include "module.hpp"
 #include "renderer.hpp"
 
-ast::ModuleFile::ModuleFile(ast::Ident *name, std::vector<ast::DeclPtr> &items, const mu::Pos &pos)
-        : AstNode(ast_module_file, pos), name(name), items(std::move(items)) {
+ast::ModuleFile::ModuleFile(ast::Ident *name, ast::NodeList<ast::DeclPtr> &items, std::unique_ptr<mem::Arena> arena,
+                            const mu::Pos &pos)
+        : AstNode(ast_module_file, pos), name(name), items(std::move(items)), arena(std::move(arena)) {
 }
 
 void ast::ModuleFile::renderer(AstRenderer* renderer) {
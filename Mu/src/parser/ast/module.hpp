@@ -6,22 +6,28 @@
 #define MU_MODULE_HPP
 
 #include "ast_common.hpp"
+#include <memory>
 #include <vector>
 
 namespace ast {
+    // the root of a parsed file. It owns the arena of every node in the file,
+    // they are all released when the module is destroyed.
     class ModuleFile : public AstNode {
     public:
-        ModuleFile(ast::Ident *name, std::vector<ast::DeclPtr> &items, const mu::Pos &pos);
+        ModuleFile(ast::Ident *name, ast::NodeList<ast::DeclPtr> &items, std::unique_ptr<mem::Arena> arena, const mu::Pos &pos);
 
         inline ast::Ident* get_name() { return name; }
 
-        inline std::vector<ast::DeclPtr>::iterator begin() { return items.begin(); }
-        inline std::vector<ast::DeclPtr>::iterator end() { return items.end(); }
+        inline mem::Arena& get_arena() { return *arena; }
+
+        inline ast::NodeList<ast::DeclPtr>::iterator begin() { return items.begin(); }
+        inline ast::NodeList<ast::DeclPtr>::iterator end() { return items.end(); }
         void renderer(AstRenderer* renderer) override;
 
     private:
         ast::Ident* name;
-        std::vector<ast::DeclPtr> items;
+        ast::NodeList<ast::DeclPtr> items;
+        std::unique_ptr<mem::Arena> arena;
     };
 
     class ModuleDirectory : public AstNode {
@@ -4,19 +4,19 @@
 namespace ast {
     IdentPattern::IdentPattern(Ident* name, const mu::Pos& pos) : Pattern(ast_ident_pattern, pos), name(name) {}
 
-    MultiPattern::MultiPattern(std::vector<PatternPtr>& patterns, const mu::Pos& pos) : Pattern(ast_multi, pos),
+    MultiPattern::MultiPattern(NodeList<PatternPtr>& patterns, const mu::Pos& pos) : Pattern(ast_multi, pos),
         patterns(std::move(patterns)) {}
 
-    TuplePattern::TuplePattern(std::vector<PatternPtr>& patterns, const mu::Pos& pos) : Pattern(ast_tuple_desc, pos),
+    TuplePattern::TuplePattern(NodeList<PatternPtr>& patterns, const mu::Pos& pos) : Pattern(ast_tuple_desc, pos),
         patterns(std::move(patterns)) {}
 
-    StructPattern::StructPattern(SpecPtr& type, std::vector<PatternPtr>& elements, const mu::Pos& pos) :
+    StructPattern::StructPattern(SpecPtr& type, NodeList<PatternPtr>& elements, const mu::Pos& pos) :
         Pattern(ast_struct_desc, pos), type(std::move(type)), elements(std::move(elements)) {}
 
-    ListPattern::ListPattern(std::vector<PatternPtr>& elements, const mu::Pos& pos) : Pattern(ast_list_desc, pos),
+    ListPattern::ListPattern(NodeList<PatternPtr>& elements, const mu::Pos& pos) : Pattern(ast_list_desc, pos),
         elements(std::move(elements)) {}
 
-    TypePattern::TypePattern(SpecPtr& type, std::vector<PatternPtr>& elements, const mu::Pos& pos) : Pattern(ast_type_desc, pos),
+    TypePattern::TypePattern(SpecPtr& type, NodeList<PatternPtr>& elements, const mu::Pos& pos) : Pattern(ast_type_desc, pos),
         type(std::move(type)), elements(std::move(elements)) {}
 
     IgnorePattern::IgnorePattern(const mu::Pos& pos) : Pattern(ast_ignore_pattern, pos) {}
@@ -11,45 +11,47 @@ namespace ast {
 
     struct IdentPattern : public Pattern {
         Ident* name;
+        // the local the typer declared for this name.
+        mu::Entity* entity{nullptr};
 
         IdentPattern(Ident* name, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct MultiPattern : public Pattern {
-        std::vector<PatternPtr> patterns;
+        NodeList<PatternPtr> patterns;
 
-        MultiPattern(std::vector<PatternPtr>& patterns, const mu::Pos& pos);
+        MultiPattern(NodeList<PatternPtr>& patterns, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct TuplePattern : public Pattern {
-        std::vector<PatternPtr> patterns;
+        NodeList<PatternPtr> patterns;
 
-        TuplePattern(std::vector<PatternPtr>& patterns, const mu::Pos& pos);
+        TuplePattern(NodeList<PatternPtr>& patterns, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct StructPattern : public Pattern {
-        SpecPtr type;
-        std::vector<PatternPtr> elements;
+        SpecPtr type{nullptr};
+        NodeList<PatternPtr> elements;
 
-        StructPattern(SpecPtr& type, std::vector<PatternPtr>& elements, const mu::Pos& pos);
+        StructPattern(SpecPtr& type, NodeList<PatternPtr>& elements, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct ListPattern : public Pattern {
-        std::vector<PatternPtr> elements;
+        NodeList<PatternPtr> elements;
 
-        ListPattern(std::vector<PatternPtr>& elements, const mu::Pos& pos);
+        ListPattern(NodeList<PatternPtr>& elements, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct TypePattern : public Pattern {
-        SpecPtr type;
-        std::vector<PatternPtr> elements;
+        SpecPtr type{nullptr};
+        NodeList<PatternPtr> elements;
 
-        TypePattern(SpecPtr& type, std::vector<PatternPtr>& elements, const mu::Pos& pos);
+        TypePattern(SpecPtr& type, NodeList<PatternPtr>& elements, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
@@ -60,7 +62,7 @@ namespace ast {
 
     struct BindPattern : public Pattern {
         Ident* name;
-        PatternPtr patterns;
+        PatternPtr patterns{nullptr};
 
         BindPattern(Ident* name, PatternPtr& patterns, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
@@ -102,8 +104,8 @@ namespace ast {
     };
 
     struct RangePattern : public Pattern {
-        PatternPtr start;
-        PatternPtr end;
+        PatternPtr start{nullptr};
+        PatternPtr end{nullptr};
 
         RangePattern(PatternPtr& start, PatternPtr& end, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
@@ -368,7 +368,8 @@ void ast::AstRenderer::render(Range *node) {
     indent();
     node->start->renderer(this);
     node->end->renderer(this);
-    node->step->renderer(this);
+    if(node->step)
+        node->step->renderer(this);
     unindent();
 }
 
@@ -593,7 +594,7 @@ void ast::AstRenderer::render(Procedure *node) {
         render(&node->attributeList);
         render(node->name);
     }
-    render(node->signiture.get());
+    render(node->signiture);
     node->body->renderer(this);
     unindent();
 
@@ -5,7 +5,7 @@ namespace ast {
     ExprSpec::ExprSpec(ExprPtr& type, const mu::Pos& pos) : Spec(ast_expr_type, pos), type(std::move(type)) {
     }
 
-    TupleSpec::TupleSpec(std::vector<SpecPtr> &elements, const mu::Pos& pos) : Spec(ast_tuple, pos),
+    TupleSpec::TupleSpec(NodeList<SpecPtr> &elements, const mu::Pos& pos) : Spec(ast_tuple, pos),
     elements(std::move(elements)) {}
 
     ListSpec::ListSpec(SpecPtr &type, const ExprPtr &size, const mu::Pos& pos) : Spec(ast_list_spec, pos),
@@ -14,7 +14,7 @@ namespace ast {
     DynListSpec::DynListSpec(SpecPtr& type, const mu::Pos& pos) : Spec(ast_list_spec_dyn, pos),
     type(std::move(type)) {}
 
-    ProcedureSpec::ProcedureSpec(std::vector<SpecPtr>& params, SpecPtr& ret, const mu::Pos& pos) : Spec(ast_procedure_spec, pos),
+    ProcedureSpec::ProcedureSpec(NodeList<SpecPtr>& params, SpecPtr& ret, const mu::Pos& pos) : Spec(ast_procedure_spec, pos),
     params(std::move(params)), ret(std::move(ret)) {}
 
     PtrSpec::PtrSpec(SpecPtr &type, const mu::Pos& pos) : Spec(ast_ptr, pos), type(std::move(type)) {}
@@ -16,14 +16,14 @@ namespace ast {
 
     // struct NamedGeneric : public Spec {
     //     Ident* name;
-    //     std::vector<SpecPtr> params;
+    //     NodeList<SpecPtr> params;
 
-    //     NamedGeneric(Ident* name, std::vector<SpecPtr>& params, const mu::Pos& pos) : Spec(ast_named_generic, pos),
+    //     NamedGeneric(Ident* name, NodeList<SpecPtr>& params, const mu::Pos& pos) : Spec(ast_named_generic, pos),
     //         name(name), params(std::move(params)) {}
     // };
 
     struct ExprSpec : public Spec {
-        ExprPtr type;
+        ExprPtr type{nullptr};
 
         // type must be named expressions such as x, x.y x.y[f32] 
         ExprSpec(ExprPtr& type, const mu::Pos& pos);
@@ -31,51 +31,51 @@ namespace ast {
     };
 
     struct TupleSpec : public Spec {
-        std::vector<SpecPtr> elements;
+        NodeList<SpecPtr> elements;
 
-        TupleSpec(std::vector<SpecPtr> &elements, const mu::Pos& pos);
+        TupleSpec(NodeList<SpecPtr> &elements, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct ListSpec : public Spec {
-        SpecPtr type;
-        ExprPtr size;
+        SpecPtr type{nullptr};
+        ExprPtr size{nullptr};
 
         ListSpec(SpecPtr &type, const ExprPtr &size, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct DynListSpec : public Spec {
-        SpecPtr type;
+        SpecPtr type{nullptr};
 
         DynListSpec(SpecPtr& type, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct ProcedureSpec : public Spec {
-        std::vector<SpecPtr> params;
-        SpecPtr ret;
+        NodeList<SpecPtr> params;
+        SpecPtr ret{nullptr};
 
-        ProcedureSpec(std::vector<SpecPtr>& params, SpecPtr& ret, const mu::Pos& pos);
+        ProcedureSpec(NodeList<SpecPtr>& params, SpecPtr& ret, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct PtrSpec : public Spec {
-        SpecPtr type;
+        SpecPtr type{nullptr};
 
         PtrSpec(SpecPtr &type, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct RefSpec : public Spec {
-        SpecPtr type;
+        SpecPtr type{nullptr};
 
         RefSpec(SpecPtr &type, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
     };
 
     struct MutSpec : public Spec {
-        SpecPtr type;
+        SpecPtr type{nullptr};
 
         MutSpec(SpecPtr &type, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
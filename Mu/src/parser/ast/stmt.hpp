@@ -11,7 +11,7 @@
 namespace ast {
 
     struct ExprStmt : public Stmt {
-        ExprPtr expr;
+        ExprPtr expr{nullptr};
         ExprStmt(ExprPtr& expr, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
 
@@ -24,7 +24,7 @@ namespace ast {
     };
 
     struct DeclStmt : public Stmt {
-        DeclPtr decl;
+        DeclPtr decl{nullptr};
         DeclStmt(DeclPtr& decl, const mu::Pos& pos);
         void renderer(AstRenderer* renderer) override;
 
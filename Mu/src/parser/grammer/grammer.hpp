@@ -6,27 +6,82 @@
 #define MU_GRAMMER_HPP
 
 #include "parser/grammer/parsers/infix_parser.hpp"
-#include "parser/grammer/parsers/prefix_parser.hpp"
-
-#include <unordered_map>
-#include <memory>
+#include "parser/grammer/parsers/range_parser.hpp"
+#include "parser/grammer/parsers/cast_parser.hpp"
+#include "parser/grammer/parsers/period_parser.hpp"
 
 namespace parse {
-    class Grammar {
-    public:
-        Grammar();
+    // continues the expression left of an operator, the operator is the current token.
+    typedef ast::ExprPtr (*InfixFn)(mu::Parser& parser, ast::ExprPtr left, mu::Token op);
 
-        void register_parser(mu::TokenKind tok, parse::InfixParser *parser);
+    // how a token continues an expression. A token with a precedence of zero ends it, a
+    // token with a precedence and no function is an operator that can't be parsed yet.
+    struct Rule {
+        i32 prec;
+        mu::Associative acc;
+        InfixFn infix;
+    };
 
-        void register_parser(mu::TokenKind tok, parse::PrefixParser *parser);
+    constexpr InfixFn infix_function(mu::TokenKind kind) {
+        switch(kind) {
+            case mu::Tkn_Plus:
+            case mu::Tkn_Minus:
+            case mu::Tkn_Slash:
+            case mu::Tkn_Astrick:
+            case mu::Tkn_EqualEqual:
+            case mu::Tkn_BangEqual:
+            case mu::Tkn_Less:
+            case mu::Tkn_Greater:
+            case mu::Tkn_LessEqual:
+            case mu::Tkn_GreaterEqual:
+            case mu::Tkn_LessLess:
+            case mu::Tkn_GreaterGreater:
+            case mu::Tkn_LessLessEqual:
+            case mu::Tkn_GreaterGreaterEqual:
+            case mu::Tkn_Percent:
+            case mu::Tkn_AstrickAstrick:
+            case mu::Tkn_And:
+            case mu::Tkn_Or:
+            case mu::Tkn_Ampersand:
+            case mu::Tkn_Pipe:
+            // assignments are only parsed at the start of a statement, see Parser::parse_stmt.
+            case mu::Tkn_Equal:
+            case mu::Tkn_PlusEqual:
+            case mu::Tkn_MinusEqual:
+            case mu::Tkn_AstrickEqual:
+            case mu::Tkn_SlashEqual:
+            case mu::Tkn_PercentEqual:
+            case mu::Tkn_AmpersandEqual:
+            case mu::Tkn_PipeEqual:
+                return &InfixParser::lud;
+            case mu::Tkn_PeriodPeriod:
+                return &RangeParser::lud;
+            case mu::Tkn_As:
+                return &CastParser::lud;
+            // the period has no precedence, it is only followed by Parser::parse_expr_spec.
+            case mu::Tkn_Period:
+                return &PeriodParser::lud;
+            default:
+                return nullptr;
+        }
+    }
 
-        parse::InfixParser *get_infix(const mu::Token &token);
+    // The rules are a dense table indexed by the token kind, it is built from TOKEN_KINDS when
+    // Mu is compiled so the loop of Parser::parse_expr is a load per operator.
+    class Grammar {
+    public:
+        static constexpr const Rule& rule(mu::TokenKind kind) { return rules[kind]; }
 
-        parse::PrefixParser *get_prefix(const mu::Token &token);
+        static inline InfixFn get_infix(const mu::Token& token) { return rules[token.kind()].infix; }
 
     private:
-        std::unordered_map<mu::TokenKind, std::unique_ptr<parse::InfixParser>> infix_parser;
-        std::unordered_map<mu::TokenKind, std::unique_ptr<parse::PrefixParser>> prefix_parser;
+        static constexpr Rule rules[] = {
+#define TOKEN_KIND(n, ...) {mu::precedence(mu::Tkn_##n), mu::associativity(mu::Tkn_##n), infix_function(mu::Tkn_##n)},
+            TOKEN_KINDS
+#undef TOKEN_KIND
+        };
+
+        static_assert(sizeof(rules) / sizeof(Rule) == mu::Tkn_As + 1, "every token kind has a rule");
     };
 }
 
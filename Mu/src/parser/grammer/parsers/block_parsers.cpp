@@ -14,22 +14,22 @@
 #include <iostream>
 
 ast::ExprPtr parse::BlockParsers::lud(mu::Parser &parser, mu::Token token) {
-    std::cout << parser.current() << std::endl;
+    parser.out_stream() << parser.current() << std::endl;
     parser.advance(true);
 //    std::cout << parser.current() << std::endl;
 //    parser.allow(mu::Tkn_NewLine);
 
 
     auto pos = token.pos();
-    std::vector<ast::StmtPtr> elements;
+    ast::NodeList<ast::StmtPtr> elements;
     if(!parser.check(mu::Tkn_CloseBracket)) {
         parser.many<ast::StmtPtr>([&parser]() {
-            std::cout << parser.current() << std::endl;
+            parser.out_stream() << parser.current() << std::endl;
             auto stmt = parser.parse_stmt();
             return stmt;
         }, [&parser]() {
             return !parser.check(mu::Tkn_CloseBracket);
-        }, [&pos, &elements](std::vector<ast::StmtPtr> &, ast::StmtPtr stmt) {
+        }, [&pos, &elements](ast::NodeList<ast::StmtPtr> &, ast::StmtPtr stmt) {
             mu::Parser::append(elements, stmt);
             pos.extend(stmt->pos());
         });
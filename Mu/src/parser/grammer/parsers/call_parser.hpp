@@ -11,9 +11,9 @@
 
 
 namespace parse {
-    class CallParser : public InfixParser {
+    class CallParser {
     public:
-        ast::ExprPtr lud(mu::Parser &parser, ast::ExprPtr left, mu::Token op) override;
+        static ast::ExprPtr lud(mu::Parser &parser, ast::ExprPtr left, mu::Token op);
     };
 }
 
@@ -10,9 +10,9 @@
 #include "parser/scanner/token.hpp"
 
 namespace parse {
-    class CastParser : public InfixParser {
+    class CastParser {
     public:
-        ast::ExprPtr lud(mu::Parser &parser, ast::ExprPtr left, mu::Token op) override;
+        static ast::ExprPtr lud(mu::Parser &parser, ast::ExprPtr left, mu::Token op);
     };
 }
 
@@ -42,13 +42,13 @@ ast::ExprPtr parse::CompoundedLiteralParser::lud(mu::Parser &parser, mu::Token t
         return ast::make_expr<ast::Map>(elements, pos);
     }
     else {
-        std::vector<ast::ExprPtr> elements = {first};
+        ast::NodeList<ast::ExprPtr> elements = {first};
         parser.many<ast::ExprPtr>(
                 [&parser]() {
                     return parser.parse_expr();
                 },
                 condition,
-                [&pos, &elements](std::vector<ast::ExprPtr>&,
+                [&pos, &elements](ast::NodeList<ast::ExprPtr>&,
                                   ast::ExprPtr element) {
                     elements.push_back(element);
                     pos.extend(element->pos());
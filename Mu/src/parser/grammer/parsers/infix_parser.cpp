@@ -4,6 +4,7 @@
 
 #include "parser/ast/expr.hpp"
 #include "infix_parser.hpp"
+#include "parser/grammer/grammer.hpp"
 #include "parser/parser.hpp"
 
 ast::ExprPtr parse::InfixParser::lud(mu::Parser &parser, ast::ExprPtr left, mu::Token op) {
@@ -22,7 +23,10 @@ ast::ExprPtr parse::InfixParser::lud(mu::Parser &parser, ast::ExprPtr left, mu::
         return ast::make_expr<ast::Assign>(op.kind(), left, rhs, pos);
     }
     else {
-        auto rhs = parser.parse_expr(op.prec());
+        // the right operand of a right associative operator takes the operators of the same
+        // precedence, '2 ** 3 ** 2' is '2 ** (3 ** 2)'.
+        auto& rule = parse::Grammar::rule(op.kind());
+        auto rhs = parser.parse_expr(rule.acc == mu::Associative::Right ? rule.prec - 1 : rule.prec);
         auto pos = left->pos();
 
         if(rhs->kind == ast::ast_assign) {
@@ -14,10 +14,11 @@ namespace mu {
 }
 
 namespace parse {
+    // the parsers of the infix operators are stateless, the grammar calls them through a
+    // table of function pointers indexed by the kind of the operator.
     class InfixParser {
     public:
-        virtual ~InfixParser() = default;
-        virtual ast::ExprPtr lud(mu::Parser& parser, ast::ExprPtr left, mu::Token op);
+        static ast::ExprPtr lud(mu::Parser& parser, ast::ExprPtr left, mu::Token op);
     };
 }
 
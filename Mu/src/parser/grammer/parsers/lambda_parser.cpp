@@ -27,7 +27,7 @@ ast::ExprPtr parse::LambdaParser::lud(mu::Parser &parser, mu::Token token) {
     for(auto& p : params)
         pos.extend(p->pos());
 
-    ast::SpecPtr ret;
+    ast::SpecPtr ret = nullptr;
     if(parser.allow(mu::Tkn_Colon))
         ret = parser.parse_spec(false);
     else
@@ -44,7 +44,7 @@ ast::ExprPtr parse::LambdaParser::lud(mu::Parser &parser, mu::Token token) {
         return ast::make_expr<ast::Lambda>(params, ret, body, pos);
     }
     else {
-        ast::ExprPtr expr;
+        ast::ExprPtr expr = nullptr;
         return expr;
     }
 }
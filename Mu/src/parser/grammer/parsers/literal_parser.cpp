@@ -16,7 +16,7 @@ ast::ExprPtr parse::LiteralParser::lud(mu::Parser &parser, mu::Token token) {
         case mu::Tkn_CharLiteral:
             return ast::make_expr<ast::Char>(token.character, token.pos());
         case mu::Tkn_StringLiteral:
-            return ast::make_expr<ast::Str>(token.str, token.pos());
+            return ast::make_expr<ast::Str>(std::string(token.str), token.pos());
         case mu::Tkn_Nil:
             return ast::make_expr<ast::Nil>(token.pos());
         case mu::Tkn_True:
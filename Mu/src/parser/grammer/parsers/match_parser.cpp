@@ -78,7 +78,7 @@ ast::ExprPtr parse::MatchParser::parse_arm(mu::Parser &parser) {
         return ast::make_expr<ast::MatchArm>(patterns, body, pos);
     }
     else {
-        ast::ExprPtr expr;
+        ast::ExprPtr expr = nullptr;
         return expr;
     }
 }
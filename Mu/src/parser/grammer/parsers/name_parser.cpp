@@ -9,7 +9,7 @@
 #include "parser/ast/specs.hpp"
 
 ast::ExprPtr parse::NameParser::lud(mu::Parser &parser, mu::Token token) {
-    ast::ExprPtr expr;
+    ast::ExprPtr expr = nullptr;
     bool is_self = false;
     if(token.kind() != mu::Tkn_SelfType) {
         expr = parser.parse_expr_spec(false);
@@ -36,7 +36,7 @@ ast::ExprPtr parse::NameParser::lud(mu::Parser &parser, mu::Token token) {
         auto pos = spec->pos();
         pos.span++;
 
-        std::vector<ast::ExprPtr> members;
+        ast::NodeList<ast::ExprPtr> members;
         if(!parser.check(mu::Tkn_CloseBracket)) {
             members = parser.many<ast::ExprPtr>(
                     [&parser]() {
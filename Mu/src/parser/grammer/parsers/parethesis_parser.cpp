@@ -11,7 +11,7 @@ ast::ExprPtr parse::ParethesisParser::lud(mu::Parser &parser, mu::Token token) {
     auto pos = token.pos();
 
     auto expr = parser.parse_expr();
-    std::vector<ast::ExprPtr> elements = {expr};
+    ast::NodeList<ast::ExprPtr> elements = {expr};
     pos.extend(expr->pos());
 
     if(parser.allow(mu::Tkn_Comma)) {
@@ -29,7 +29,7 @@ ast::ExprPtr parse::ParethesisParser::lud(mu::Parser &parser, mu::Token token) {
                         }
                         return val;
                     },
-                    [&parser, &pos, &elements](std::vector<ast::ExprPtr>&, ast::ExprPtr expr) {
+                    [&parser, &pos, &elements](ast::NodeList<ast::ExprPtr>&, ast::ExprPtr expr) {
                         if(expr) {
                             elements.push_back(expr);
                             pos.extend(expr->pos());
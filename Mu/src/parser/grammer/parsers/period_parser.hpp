@@ -11,9 +11,9 @@
 #include "parser/scanner/token.hpp"
 
 namespace parse {
-    class PeriodParser : public InfixParser {
+    class PeriodParser {
     public:
-        ast::ExprPtr lud(mu::Parser &parser, ast::ExprPtr left, mu::Token op) override;
+        static ast::ExprPtr lud(mu::Parser &parser, ast::ExprPtr left, mu::Token op);
     };
 }
 
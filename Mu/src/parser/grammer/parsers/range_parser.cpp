@@ -15,17 +15,19 @@ ast::ExprPtr parse::RangeParser::lud(mu::Parser &parser, ast::ExprPtr left, mu::
         return ast::ExprPtr();
     }
 
-    auto expr = parser.parse_expr();
+    parser.advance();
+    auto expr = parser.parse_expr(op.prec());
 
     if(!expr)
         return expr;
+    pos.extend(expr->pos());
 
     if(expr->kind == ast::ast_range) {
         parser.report(parser.current().pos(), "the end of a range must not be a range");
         return ast::ExprPtr();
     }
 
-    ast::ExprPtr step;
+    ast::ExprPtr step = nullptr;
     if(parser.allow(mu::Tkn_Comma)) {
         step = parser.parse_expr();
         if (step)
@@ -11,9 +11,9 @@
 #include "parser/scanner/token.hpp"
 
 namespace parse {
-    class RangeParser : public InfixParser {
+    class RangeParser {
     public:
-        ast::ExprPtr lud(mu::Parser &parser, ast::ExprPtr left, mu::Token op) override;
+        static ast::ExprPtr lud(mu::Parser &parser, ast::ExprPtr left, mu::Token op);
     };
 }
 #endif //MU_RANGE_PARSER_HPP
@@ -94,11 +94,22 @@ void mu::Parser::pop_restriction() {
 }
 
 ast::ModuleFile *mu::Parser::process(io::File *file) {
-    if(!scanner.init(file))
+    // every node of the file is made in this arena, it is given to the module.
+    arena = std::make_unique<mem::Arena>();
+    mem::Arena::Scope scope(*arena);
+    this->file = file;
+
+    // a parser is reused for the files of a worker, nothing of the previous file carries over.
+    error_count = 0;
+    restriction = Default;
+    prev_res = std::stack<Restriction>();
+    prev_res.push(Default);
+
+    // the whole file is scanned up front.
+    if(!scanner.init(file) or !scanner.tokenize(tokens))
         return nullptr;
-    scanner.advance();
-    t = scanner.token();
-    scanner.advance();
+    index = 0;
+    t = scanner.unpack(tokens, index);
     return parse_module();
 }
 
@@ -127,21 +138,21 @@ ast::ModuleFile * mu::Parser::parse_module() {
     for(auto& d : decls)
         pos.extend(d->pos());
 
-    auto file = interp->current_file();
     auto name = file->name();
     auto mname = interp->find_name(name);
 
-    std::cout << "Num Decls: " << decls.size() << std::endl;
-    return new ast::ModuleFile(new ast::Ident(mname, mu::Pos(0, 0, 0, file->id())), decls, pos);
+    interp->out_stream() << "Num Decls: " << decls.size() << std::endl;
+    auto name_ident = ast::make_ident(mname, mu::Pos(file->base(), 0));
+    return new ast::ModuleFile(name_ident, decls, std::move(arena), pos);
 }
 
 bool mu::Parser::advance(bool ignore_newline) {
+    // comments are never added to the token buffer.
     do {
-        t = scanner.token();
-        scanner.advance();
-    } while(t.kind() == mu::Tkn_Comment ||
-            (ignore_newline and t.kind() == Tkn_NewLine)
-    );
+        index = next_index();
+    } while(ignore_newline and tokens.kind(index) == Tkn_NewLine);
+
+    t = scanner.unpack(tokens, index);
     return t.kind() == mu::Tkn_Error;
 }
 
@@ -180,13 +191,15 @@ ast::ExprPtr mu::Parser::parse_expr(i32 prec_min) {
     if(!expr)
         return expr;
 
-    while(prec_min < current().prec()) {
-        auto parser = grammar.get_infix(current());
-        if(!parser) {
+    while(true) {
+        auto& rule = parse::Grammar::rule(t.kind());
+        if(prec_min >= rule.prec)
+            break;
+        if(!rule.infix) {
             report(current().pos(), "expecting binary operator found: '%s'", current().get_string().c_str());
             break;
         }
-        expr = parser->lud(*this, expr, current());
+        expr = rule.infix(*this, expr, current());
 
         if(!expr)
             return expr;
@@ -234,7 +247,7 @@ ast::ExprPtr mu::Parser::try_struct_expr(ast::ExprPtr operand) {
         auto pos = spec->pos();
         pos.span++;
 
-        std::vector<ast::ExprPtr> members;
+        ast::NodeList<ast::ExprPtr> members;
         if(!check(mu::Tkn_CloseBracket)) {
             members = many<ast::ExprPtr>(
                     [this]() {
@@ -299,7 +312,7 @@ ast::ExprPtr mu::Parser::parse_bottom_expr() {
             return ast::make_expr<ast::Char>(token.character, token.pos());
         case mu::Tkn_StringLiteral:
             advance();;
-            return ast::make_expr<ast::Str>(token.str, token.pos());
+            return ast::make_expr<ast::Str>(std::string(token.str), token.pos());
         case mu::Tkn_Nil:
             advance();;
             return ast::make_expr<ast::Nil>(token.pos());
@@ -315,7 +328,7 @@ ast::ExprPtr mu::Parser::parse_bottom_expr() {
 			return ast::make_expr<ast::Self>(token.pos());
 		case mu::Tkn_OpenBracket: {
 			auto pos = token.pos();
-			std::vector<ast::StmtPtr> elements;
+			ast::NodeList<ast::StmtPtr> elements;
             advance();;
 			if(!check(mu::Tkn_CloseBracket)) {
 				many<ast::StmtPtr>([this]() {
@@ -324,7 +337,7 @@ ast::ExprPtr mu::Parser::parse_bottom_expr() {
 					return stmt;
 				}, [this]() {
 					return !check(mu::Tkn_CloseBracket);
-				}, [&pos, &elements](std::vector<ast::StmtPtr> &, ast::StmtPtr stmt) {
+				}, [&pos, &elements](ast::NodeList<ast::StmtPtr> &, ast::StmtPtr stmt) {
 					mu::Parser::append(elements, stmt);
 					pos.extend(stmt->pos());
 				});
@@ -342,7 +355,8 @@ ast::ExprPtr mu::Parser::parse_bottom_expr() {
 		case mu::Tkn_Defer: {
 			auto [_, valid] = expect(mu::Tkn_Defer);
 			if(valid) {
-				auto expr = parse_expr();
+				// the deferred expression is usually an assignment, 'defer x = 0'.
+				auto expr = parse_expr(0);
 				if(expr)
 					return ast::make_expr<ast::Defer>(expr, token.position.extend(expr->pos()));
 				else
@@ -352,6 +366,8 @@ ast::ExprPtr mu::Parser::parse_bottom_expr() {
 		}
 		case mu::Tkn_For:
 			return parse_for();
+		case mu::Tkn_Match:
+			return parse_match();
 		case mu::Tkn_If:
 			return parse_if();
 		case mu::Tkn_BackSlash:
@@ -360,7 +376,7 @@ ast::ExprPtr mu::Parser::parse_bottom_expr() {
 			advance();
 			auto pos = token.pos();
 
-			if(check(mu::Tkn_NewLine)) {
+			if(!check(mu::Tkn_NewLine) and !check(mu::Tkn_CloseBracket)) {
 				auto expr = parse_expr();
 				return ast::make_expr<ast::Return>(expr, pos.extend(expr->pos()));
 			}
@@ -399,7 +415,7 @@ ast::ExprPtr mu::Parser::try_tuple_or_expr() {
     advance();
 
     auto expr = parse_expr();
-    std::vector<ast::ExprPtr> elements = {expr};
+    ast::NodeList<ast::ExprPtr> elements = {expr};
     pos.extend(expr->pos());
 
     if(allow(mu::Tkn_Comma)) {
@@ -417,7 +433,7 @@ ast::ExprPtr mu::Parser::try_tuple_or_expr() {
                         }
                         return val;
                     },
-                    [this, &pos, &elements](std::vector<ast::ExprPtr>&, ast::ExprPtr expr) {
+                    [this, &pos, &elements](ast::NodeList<ast::ExprPtr>&, ast::ExprPtr expr) {
                         if(expr) {
                             elements.push_back(expr);
                             pos.extend(expr->pos());
@@ -505,7 +521,7 @@ ast::ExprPtr mu::Parser::parse_arm() {
         return ast::make_expr<ast::MatchArm>(patterns, body, pos);
     }
     else {
-        ast::ExprPtr expr;
+        ast::ExprPtr expr = nullptr;
         return expr;
     }
 }
@@ -527,7 +543,7 @@ ast::ExprPtr mu::Parser::parse_lambda() {
     for(auto& p : params)
         pos.extend(p->pos());
 
-    ast::SpecPtr ret;
+    ast::SpecPtr ret = nullptr;
     if(allow(mu::Tkn_Colon))
         ret = parse_spec(false);
     else
@@ -564,37 +580,42 @@ ast::ExprPtr mu::Parser::parse_compound_literal() {
 		std::vector<std::tuple<ast::ExprPtr, ast::ExprPtr>> elements;
 		elements.emplace_back(first, second);
 	
-		many<std::tuple<ast::ExprPtr, ast::ExprPtr>>(
-				[this]() {
-					auto key = parse_expr();
-					expect(mu::Tkn_Colon);
-					auto value = parse_expr();
-					return std::make_tuple(key, value);
-				},
-				condition,
-				[&pos, &elements](std::vector<std::tuple<ast::ExprPtr, ast::ExprPtr>>&,
-						std::tuple<ast::ExprPtr, ast::ExprPtr> element) {
-					elements.push_back(element);
-					pos.extend(std::get<0>(element)->pos());
-					pos.extend(std::get<1>(element)->pos());
-				}
-		);
+		// the first element has been parsed, the rest follow a comma.
+		if(condition()) {
+			many<std::tuple<ast::ExprPtr, ast::ExprPtr>>(
+					[this]() {
+						auto key = parse_expr();
+						expect(mu::Tkn_Colon);
+						auto value = parse_expr();
+						return std::make_tuple(key, value);
+					},
+					condition,
+					[&pos, &elements](std::vector<std::tuple<ast::ExprPtr, ast::ExprPtr>>&,
+							std::tuple<ast::ExprPtr, ast::ExprPtr> element) {
+						elements.push_back(element);
+						pos.extend(std::get<0>(element)->pos());
+						pos.extend(std::get<1>(element)->pos());
+					}
+			);
+		}
 		expect(mu::Tkn_CloseBrace);
 		return ast::make_expr<ast::Map>(elements, pos);
 	}
 	else {
-		std::vector<ast::ExprPtr> elements = {first};
-		many<ast::ExprPtr>(
-				[this]() {
-					return parse_expr();
-				},
-				condition,
-				[&pos, &elements](std::vector<ast::ExprPtr>&,
-								  ast::ExprPtr element) {
-					elements.push_back(element);
-					pos.extend(element->pos());
-				}
-		);
+		ast::NodeList<ast::ExprPtr> elements = {first};
+		if(condition()) {
+			many<ast::ExprPtr>(
+					[this]() {
+						return parse_expr();
+					},
+					condition,
+					[&pos, &elements](ast::NodeList<ast::ExprPtr>&,
+									  ast::ExprPtr element) {
+						elements.push_back(element);
+						pos.extend(element->pos());
+					}
+			);
+		}
 		pos.extend(expect(mu::Tkn_CloseBrace).first.pos());
 	
 		return ast::make_expr<ast::List>(elements, pos);
@@ -608,9 +629,12 @@ ast::ExprPtr mu::Parser::parse_for() {
     advance();
 
     auto pattern = parse_pattern(false);
+    if(!pattern)
+        return ast::ExprPtr();
     pos.extend(pattern->pos());
 
-    if(pattern)
+    auto [_, valid] = expect(mu::Tkn_In);
+    if(!valid)
         return ast::ExprPtr();
 
     push_restriction(mu::NoStructExpr);
@@ -636,16 +660,19 @@ ast::ExprPtr mu::Parser::parse_if() {
         case mu::Tkn_Elif: {
             advance();
 
+            push_restriction(mu::NoStructExpr);
             auto cond = parse_expr();
+            pop_restriction();
 
             if(check(mu::Tkn_OpenBracket)) {
-                push_restriction(mu::NoStructExpr);
                 auto body = parse_expr();
-                pop_restriction();
 
+                // the newlines are only skipped when another branch follows,
+                // otherwise they end the statement containing the if.
+                auto state = save_state();
                 remove_newlines();
-//                if(check(mu::Tkn_NewLine))
-//                    advance(true);
+                if(!check(mu::Tkn_Elif) and !check(mu::Tkn_Else))
+                    reset(state);
 
                 auto tok = current();
                 auto else_if = parse_if();
@@ -678,8 +705,8 @@ ast::ExprPtr mu::Parser::parse_if() {
 }
 
 ast::ExprPtr mu::Parser::parse_call(ast::ExprPtr& name, mu::Token token) {
-    std::vector<ast::SpecPtr> type_parameters;
-    std::vector<ast::ExprPtr> actuals;
+    ast::NodeList<ast::SpecPtr> type_parameters;
+    ast::NodeList<ast::ExprPtr> actuals;
 	auto pos = name->pos();
 
     if(allow(mu::Tkn_OpenParen)) {
@@ -728,7 +755,7 @@ ast::ExprPtr mu::Parser::parse_call(ast::ExprPtr& name, mu::Token token) {
 
 ast::ExprPtr mu::Parser::parse_expr_spec(bool is_spec) {
     auto token = current();
-    ast::ExprPtr expr;
+    ast::ExprPtr expr = nullptr;
     if(check(mu::Tkn_Identifier))
         expr = parse_name();
     else {
@@ -740,8 +767,8 @@ ast::ExprPtr mu::Parser::parse_expr_spec(bool is_spec) {
         expr = parse_call(expr, current());
 
     if(check(mu::Tkn_Period)) {
-        auto parser = grammar.get_infix(current());
-        expr = parser->lud(*this, expr, current());
+        auto infix = parse::Grammar::get_infix(current());
+        expr = infix(*this, expr, current());
     }
     return expr;
 }
@@ -753,12 +780,17 @@ ast::ExprPtr mu::Parser::parse_name() {
 
     if(valid) {
         auto pos = name.pos();
-        std::vector<ast::SpecPtr> type_params;
+        ast::NodeList<ast::SpecPtr> type_params;
         if(check(mu::Tkn_OpenBrace)) {
             pos.extend(current().pos());
             expect(mu::Tkn_OpenBrace);
             type_params = many<ast::SpecPtr>(
                     [this]() {
+                        // the value of a generic bounded by an integer type, 'Vec[f32, 3]'.
+                        if(check(mu::Tkn_IntLiteral) or check(mu::Tkn_CharLiteral)) {
+                            auto value = parse_expr();
+                            return ast::make_spec<ast::ExprSpec>(value, value->pos());
+                        }
                         return parse_spec(false);
                     },
                     [this]() {
@@ -791,7 +823,7 @@ ast::ExprPtr mu::Parser::parse_suffix(ast::ExprPtr& expr, bool is_spec) {
         auto name = current().ident;
         auto element = parse_name();
 	
-		std::cout << "Parse Suffix: " << current() << std::endl;
+		interp->out_stream() << "Parse Suffix: " << current() << std::endl;
         if(current().kind() == mu::Tkn_OpenParen) {
             return parse_method(expr, element, current());
         }
@@ -829,7 +861,7 @@ ast::ExprPtr mu::Parser::parse_method(ast::ExprPtr operand, ast::ExprPtr name,
 	bool error = false;
 
     if(allow(mu::Tkn_OpenParen)) {
-		std::vector<ast::ExprPtr> actuals = {operand};
+		ast::NodeList<ast::ExprPtr> actuals = {operand};
 
 		if(!check(mu::Tkn_CloseParen)) {
 			many<ast::ExprPtr>([this]() {
@@ -913,7 +945,11 @@ ast::StmtPtr mu::Parser::parse_stmt() {
         if(allow(mu::Tkn_NewLine))
             return ast::make_stmt<ast::EmptyStmt>(token.pos());
 
-        auto expr = parse_expr();
+        // the lowest precedence, an expression statement can be an assignment.
+        auto expr = parse_expr(0);
+        if(!expr)
+            return ast::make_stmt<ast::EmptyStmt>(token.pos());
+
         auto [tok, valid] = expect(Tkn_NewLine);
         if(valid)
             return ast::make_stmt<ast::ExprStmt>(expr, expr->pos());
@@ -995,10 +1031,10 @@ ast::DeclPtr mu::Parser::parse_variable(mu::TokenKind kind) {
     auto type = parse_spec(false);
     pos.extend(type->pos());
 
-    ast::ExprPtr init;
+    ast::ExprPtr init = nullptr;
     if(allow(mu::Tkn_Equal)) {
         init = parse_expr();
-        passert(init.get());
+        passert(init);
         pos.extend(init->pos());
     }
     if(kind == mu::Tkn_Let) {
@@ -1018,8 +1054,8 @@ ast::DeclPtr mu::Parser::parse_global(mu::TokenKind kind, ast::Visibility vis) {
     auto [name, valid] = expect(mu::Tkn_Identifier);
     pos.extend(name.pos());
 
-    ast::ExprPtr init;
-    ast::SpecPtr spec;
+    ast::ExprPtr init = nullptr;
+    ast::SpecPtr spec = nullptr;
 
     if(valid) {
         if(check(mu::Tkn_NewLine)) {
@@ -1079,7 +1115,7 @@ ast::DeclPtr mu::Parser::parse_trait(ast::Ident *name, ast::Visibility vis) {
     pos.extend(current().pos());
     advance();
 
-    ast::DeclPtr generics;
+    ast::DeclPtr generics = nullptr;
     if(check(mu::Tkn_OpenBrace)) {
         generics = parse_generic_group();
         pos.extend(generics->pos());
@@ -1089,7 +1125,7 @@ ast::DeclPtr mu::Parser::parse_trait(ast::Ident *name, ast::Visibility vis) {
     expect(mu::Tkn_OpenBracket);
     remove_newlines();
 
-    std::vector<ast::DeclPtr> members;
+    ast::NodeList<ast::DeclPtr> members;
     if(!check(mu::Tkn_CloseBracket)) {
         members = many<ast::DeclPtr>(
                 [this]() {
@@ -1101,7 +1137,7 @@ ast::DeclPtr mu::Parser::parse_trait(ast::Ident *name, ast::Visibility vis) {
                         if (valid) {
                             expect(mu::Tkn_Colon);
                             if(allow(mu::Tkn_TypeLit)) {
-                                ast::SpecPtr def;
+                                ast::SpecPtr def = nullptr;
                                 auto pos = token.pos();
                                 pos.span += 1;
                                 if(check(mu::Tkn_Equal)) {
@@ -1143,7 +1179,7 @@ ast::AttributeList mu::Parser::parse_attributes() {
                             auto [value, exp] = expect(mu::Tkn_StringLiteral);
                             expect(mu::Tkn_CloseParen);
                             if(exp) {
-                                return ast::Attribute(token.ident, value.str);
+                                return ast::Attribute(token.ident, std::string(value.str));
                             }
                             else {
                                 report(current().pos(), "expecting a string as an attribute parameter, found: '%s'",
@@ -1219,7 +1255,7 @@ ast::DeclPtr mu::Parser::parse_procedure_parameter() {
         }
         else {
             pos.extend(type->pos());
-            ast::ExprPtr init;
+            ast::ExprPtr init = nullptr;
 
             if (allow(mu::Tkn_Equal)) {
                 init = parse_expr();
@@ -1232,12 +1268,12 @@ ast::DeclPtr mu::Parser::parse_procedure_parameter() {
     }
 }
 
-std::shared_ptr<ast::ProcedureSigniture> mu::Parser::parse_procedure_signiture() {
-    ast::DeclPtr generics;
+ast::ProcedureSigniture* mu::Parser::parse_procedure_signiture() {
+    ast::DeclPtr generics = nullptr;
     if(check(mu::Tkn_OpenBrace))
         generics = parse_generic_group();
     if(allow(mu::Tkn_OpenParen)) {
-        std::vector<ast::DeclPtr> parameters;
+        ast::NodeList<ast::DeclPtr> parameters;
         bool error = false;
         if(!check(mu::Tkn_CloseParen)) {
             parameters = many<ast::DeclPtr>(
@@ -1247,7 +1283,7 @@ std::shared_ptr<ast::ProcedureSigniture> mu::Parser::parse_procedure_signiture()
                     [this]() {
                         return allow(mu::Tkn_Comma);
                     },
-                    [&error, this](std::vector<ast::DeclPtr>& result, ast::DeclPtr res) {
+                    [&error, this](ast::NodeList<ast::DeclPtr>& result, ast::DeclPtr res) {
                         if(res) {
 
                             if(!result.empty()) {
@@ -1275,7 +1311,7 @@ std::shared_ptr<ast::ProcedureSigniture> mu::Parser::parse_procedure_signiture()
 
         auto ret = parse_spec(false);
         if(error) return nullptr;
-        else return std::make_shared<ast::ProcedureSigniture>(parameters, ret, generics);
+        else return ast::make_node<ast::ProcedureSigniture>(parameters, ret, generics);
     }
     else {
         report(current().pos(), "expecting '(' or '[' in procedure declaration");
@@ -1295,6 +1331,11 @@ ast::DeclPtr mu::Parser::parse_procedure(ast::Ident *name, const ast::AttributeL
                 pos.extend(current().pos());
                 advance();
                 break;
+            case mu::Tkn_Const:
+                modifiers.push_back(ast::Mod_Const);
+                pos.extend(current().pos());
+                advance();
+                break;
             default:
                 stop = true;
         }
@@ -1324,7 +1365,7 @@ ast::DeclPtr mu::Parser::parse_procedure(ast::Ident *name, const ast::AttributeL
         return ast::make_decl<ast::Procedure>(name, sig, body, attributes, modifiers, vis, pos);
     }
     else {
-        ast::ExprPtr body;
+        ast::ExprPtr body = nullptr;
         return ast::make_decl<ast::Procedure>(name, sig, body, attributes, modifiers, vis, pos);
     }
 }
@@ -1334,9 +1375,9 @@ ast::DeclPtr mu::Parser::parse_struct(ast::Ident *name, ast::Visibility vis) {
     advance();
 
     auto pos = name->pos;
-    std::vector<ast::SpecPtr> bounds;
+    ast::NodeList<ast::SpecPtr> bounds;
 
-    ast::DeclPtr generics;
+    ast::DeclPtr generics = nullptr;
 
     if(check(mu::Tkn_OpenBrace)) {
         generics = parse_generic_group();
@@ -1355,7 +1396,7 @@ ast::DeclPtr mu::Parser::parse_struct(ast::Ident *name, ast::Visibility vis) {
                 [this, &error]() {
                     return allow(mu::Tkn_Plus) and !error;
                 },
-                [&bounds, &pos, &error](std::vector<ast::SpecPtr>&, ast::SpecPtr res) {
+                [&bounds, &pos, &error](ast::NodeList<ast::SpecPtr>&, ast::SpecPtr res) {
                     if(res)
                         bounds.push_back(res);
                     else
@@ -1373,7 +1414,7 @@ ast::DeclPtr mu::Parser::parse_struct(ast::Ident *name, ast::Visibility vis) {
     remove_newlines();
 
     // explicitly check for an empty block.
-    std::vector<ast::DeclPtr> members;
+    ast::NodeList<ast::DeclPtr> members;
     if(!check(mu::Tkn_CloseBracket)) {
         members = many<ast::DeclPtr>(
                 [this]() {
@@ -1384,7 +1425,7 @@ ast::DeclPtr mu::Parser::parse_struct(ast::Ident *name, ast::Visibility vis) {
                     remove_newlines();
                     return val and !check(mu::Tkn_CloseBracket);
                 },
-                [&pos](std::vector<ast::DeclPtr> &results, ast::DeclPtr res) {
+                [&pos](ast::NodeList<ast::DeclPtr> &results, ast::DeclPtr res) {
                     Parser::append<ast::DeclPtr>(results, res);
                     pos.extend(res->pos());
                 }
@@ -1407,8 +1448,8 @@ ast::DeclPtr mu::Parser::parse_type(ast::Ident *name, ast::Visibility vis) {
     advance();
 
     auto pos = name->pos;
-    std::vector<ast::SpecPtr> bounds;
-    ast::DeclPtr generics;
+    ast::NodeList<ast::SpecPtr> bounds;
+    ast::DeclPtr generics = nullptr;
     if(check(mu::Tkn_OpenBrace)) {
         generics = parse_generic_group();
         pos.extend(generics->pos());
@@ -1423,7 +1464,7 @@ ast::DeclPtr mu::Parser::parse_type(ast::Ident *name, ast::Visibility vis) {
                 [this, &error]() {
                     return allow(mu::Tkn_Plus) and !error;
                 },
-                [&bounds, &pos, &error](std::vector<ast::SpecPtr>&, ast::SpecPtr res) {
+                [&bounds, &pos, &error](ast::NodeList<ast::SpecPtr>&, ast::SpecPtr res) {
                     if(res)
                         bounds.push_back(res);
                     else
@@ -1441,7 +1482,7 @@ ast::DeclPtr mu::Parser::parse_type(ast::Ident *name, ast::Visibility vis) {
     remove_newlines();
 
     // explicitly check for an empty block.
-    std::vector<ast::DeclPtr> members;
+    ast::NodeList<ast::DeclPtr> members;
     if(!check(mu::Tkn_CloseBracket)) {
         members = many<ast::DeclPtr>(
                 [this]() {
@@ -1452,7 +1493,7 @@ ast::DeclPtr mu::Parser::parse_type(ast::Ident *name, ast::Visibility vis) {
                     remove_newlines();
                     return val and !check(mu::Tkn_CloseBracket);
                 },
-                [&pos](std::vector<ast::DeclPtr> &results, ast::DeclPtr res) {
+                [&pos](ast::NodeList<ast::DeclPtr> &results, ast::DeclPtr res) {
                     Parser::append<ast::DeclPtr>(results, res);
                     pos.extend(res->pos());
                 }
@@ -1466,8 +1507,8 @@ ast::DeclPtr mu::Parser::parse_type(ast::Ident *name, ast::Visibility vis) {
 
 ast::DeclPtr mu::Parser::parse_member_variable() {
 
-    ast::SpecPtr type;
-    std::vector<ast::ExprPtr> init;
+    ast::SpecPtr type = nullptr;
+    ast::NodeList<ast::ExprPtr> init;
     ast::Visibility vis = ast::Visibility::Private;
 
     auto pos = current().pos();
@@ -1476,7 +1517,7 @@ ast::DeclPtr mu::Parser::parse_member_variable() {
     if(allow(mu::Tkn_Pub))
         vis = ast::Visibility::Public;
 
-    std::vector<ast::Ident*> names = many<ast::Ident*>(
+    ast::NodeList<ast::Ident*> names = many<ast::Ident*>(
             [this]() {
                 auto [token, valid] = expect(mu::Tkn_Identifier);
                 if(valid)
@@ -1487,7 +1528,7 @@ ast::DeclPtr mu::Parser::parse_member_variable() {
             [this]() {
                 return allow(mu::Tkn_Comma);
             },
-            [&pos](std::vector<ast::Ident*>& results, ast::Ident* res) {
+            [&pos](ast::NodeList<ast::Ident*>& results, ast::Ident* res) {
                 Parser::append(results, res);
                 pos.extend(res->pos);
             }
@@ -1510,7 +1551,7 @@ ast::DeclPtr mu::Parser::parse_member_variable() {
         //         [this]() {
         //             return check(mu::Tkn_Comma);
         //         },
-        //         [&pos](std::vector<ast::ExprPtr>& results, ast::ExprPtr res) {
+        //         [&pos](ast::NodeList<ast::ExprPtr>& results, ast::ExprPtr res) {
         //             Parser::append(results, res);
         //             if(res)
         //                 pos.extend(res->pos());
@@ -1561,7 +1602,7 @@ ast::DeclPtr mu::Parser::parse_generic_and_bounds() {
     if(!generic) {
         return nullptr;
     }
-    std::vector<ast::SpecPtr> bounds;
+    ast::NodeList<ast::SpecPtr> bounds;
     auto pos = generic->pos();
     bool error = false;
 
@@ -1574,7 +1615,7 @@ ast::DeclPtr mu::Parser::parse_generic_and_bounds() {
                 [this]() {
                     return allow(mu::Tkn_Plus);
                 },
-                [&bounds, &pos, &error](std::vector<ast::SpecPtr>&, ast::SpecPtr res) {
+                [&bounds, &pos, &error](ast::NodeList<ast::SpecPtr>&, ast::SpecPtr res) {
                     if(res)
                         bounds.push_back(res);
                     else
@@ -1586,10 +1627,10 @@ ast::DeclPtr mu::Parser::parse_generic_and_bounds() {
             return nullptr;
 
         // @TODO: Refactor this objects construction.
-        auto name = std::static_pointer_cast<ast::Generic>(generic)->name;
+        auto name = generic->as<ast::Generic>()->name;
         auto bounded_generic = ast::make_decl<ast::BoundedGeneric>(name, ast::GenericBounds(bounds, nullptr), pos);
         // we just constructed this object so we know this is safe to do.
-        auto bounded_generic_ptr = static_cast<ast::BoundedGeneric*>(bounded_generic.get());
+        auto bounded_generic_ptr = bounded_generic->as<ast::BoundedGeneric>();
         bounded_generic_ptr->bounds.parent = bounded_generic_ptr;
         return bounded_generic;
     }
@@ -1655,7 +1696,7 @@ ast::PatternPtr mu::Parser::parse_pattern(bool bind_pattern) {
                 return ast::make_pattern<ast::CharPattern>(token.character, token.pos());
             case mu::Tkn_StringLiteral:
                 advance();
-                return ast::make_pattern<ast::StringPattern>(token.str, token.pos());
+                return ast::make_pattern<ast::StringPattern>(std::string(token.str), token.pos());
             case mu::Tkn_True:
             case mu::Tkn_False:
                 advance();
@@ -1674,9 +1715,14 @@ ast::PatternPtr mu::Parser::parse_pattern(bool bind_pattern) {
             }
             case mu::Tkn_Identifier: {
                 auto name = token.ident;
-                ast::SpecPtr type;
+                ast::SpecPtr type = nullptr;
 
-                switch (peek().kind()) {
+                // in 'a [f32; 3]' the brace starts the type of the name.
+                auto next = peek().kind();
+                if(next == mu::Tkn_OpenBrace and !is_generic_type_pattern())
+                    next = mu::Tkn_Identifier;
+
+                switch (next) {
                     case mu::Tkn_Period:
                     case mu::Tkn_OpenBrace:
                     case mu::Tkn_OpenParen:
@@ -1751,6 +1797,27 @@ ast::PatternPtr mu::Parser::parse_pattern(bool bind_pattern) {
         return pattern;
 }
 
+bool mu::Parser::is_generic_type_pattern() {
+    auto state = save_state();
+    advance();
+
+    // the arguments are skipped, the pattern of the type follows them.
+    u64 depth = 0;
+    do {
+        if(check(mu::Tkn_OpenBrace))
+            ++depth;
+        else if(check(mu::Tkn_CloseBrace))
+            --depth;
+        else if(check(mu::Tkn_Eof))
+            break;
+        advance();
+    } while(depth > 0);
+
+    auto result = check(mu::Tkn_OpenParen) or check(mu::Tkn_OpenBracket);
+    reset(state);
+    return result;
+}
+
 ast::SpecPtr mu::Parser::parse_spec(bool allow_infer) {
     auto token = current();
     switch(token.kind()) {
@@ -1854,7 +1921,7 @@ ast::DeclPtr mu::Parser::parse_impl(ast::Ident *name, ast::Visibility vis) {
     pos.extend(current().pos());
     advance();
 
-    ast::DeclPtr generics;
+    ast::DeclPtr generics = nullptr;
     if(check(mu::Tkn_OpenBrace)) {
         generics = parse_generic_group();
         pos.extend(generics->pos());
@@ -1865,7 +1932,7 @@ ast::DeclPtr mu::Parser::parse_impl(ast::Ident *name, ast::Visibility vis) {
     auto [_, valid] = expect(mu::Tkn_OpenBracket);
     remove_newlines();
 
-    std::vector<ast::DeclPtr> members;
+    ast::NodeList<ast::DeclPtr> members;
     if(!check(mu::Tkn_CloseBracket)) {
       members = many<ast::DeclPtr>(
             [this]() {
@@ -1882,7 +1949,7 @@ ast::DeclPtr mu::Parser::parse_impl(ast::Ident *name, ast::Visibility vis) {
                     return parse_procedure(token.ident, attributes, vis);
                 }
                 else {
-                    ast::DeclPtr ret;
+                    ast::DeclPtr ret = nullptr;
                     report(current().pos(), "expecting identifier, found: '%s'", current().get_string().c_str());
                     return ret;
                 }
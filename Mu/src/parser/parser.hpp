@@ -41,7 +41,7 @@ namespace mu {
 
         bool check(TokenKind tok);
 
-        inline Token peek() { return scanner.token(); }
+        inline Token peek() { return scanner.unpack(tokens, next_index()); }
 
         void passert(bool term);
 
@@ -63,20 +63,28 @@ namespace mu {
             return t;
         }
 
+        // debug output of the grammar, it follows the stream of the interpreter.
+        inline std::ostream& out_stream() { return interp->out_stream(); }
+
+        // lists of nodes are built in the arena of the module, anything else is a std::vector.
+        template<typename Ret>
+        using List = typename std::conditional<std::is_trivially_copyable<Ret>::value,
+                ast::NodeList<Ret>, std::vector<Ret>>::type;
+
         template<typename Ret>
-        static void append(std::vector<Ret>& result, Ret val) {
+        static void append(List<Ret>& result, Ret val) {
             if(val)
                 result.push_back(val);
         }
 
         template<typename Ret>
-        static void append_value(std::vector<Ret>& result, Ret val) {
+        static void append_value(List<Ret>& result, Ret val) {
             result.push_back(val);
         }
 
         template<typename Ret, typename Fn, typename Cond, typename Process>
-        std::vector<Ret> many(Fn fn, Cond cond, Process process = Parser::append<Ret>) {
-            std::vector<Ret> result;
+        List<Ret> many(Fn fn, Cond cond, Process process = Parser::append<Ret>) {
+            List<Ret> result;
             do {
                 auto res = fn();
                 process(result, res);
@@ -86,8 +94,9 @@ namespace mu {
 
         ast::ModuleFile * parse_module();
 
-        inline mu::Scanner::State save_state() { return scanner.save(); }
-        inline void reset(const mu::Scanner::State& state) { scanner.restore(state); }
+        // backtracking only has to remember the index of the current token.
+        inline u64 save_state() { return index; }
+        inline void reset(u64 state) { index = state; t = scanner.unpack(tokens, index); }
 
         // expression parsing
         ast::ExprPtr parse_expr();
@@ -145,7 +154,7 @@ namespace mu {
 
         ast::DeclPtr parse_procedure_parameter();
 
-        std::shared_ptr<ast::ProcedureSigniture> parse_procedure_signiture();
+        ast::ProcedureSigniture* parse_procedure_signiture();
 
         ast::DeclPtr parse_procedure(ast::Ident *name, const ast::AttributeList &attributes, ast::Visibility vis);
 
@@ -173,6 +182,9 @@ namespace mu {
 
         ast::PatternPtr parse_pattern(bool bind_pattern = false);
 
+        // whether the name at the current token starts the pattern of a generic type, 'Pair[i32](a, b)'.
+        bool is_generic_type_pattern();
+
         ast::SpecPtr parse_spec(bool allow_infer);
 
         ast::Visibility parse_visability();
@@ -186,10 +198,16 @@ namespace mu {
         void pop_restriction();
 
     private:
+        // the index following the current token, the parser stays on the final Tkn_Eof.
+        inline u64 next_index() { return index + (index + 1 < tokens.size()); }
+
         Interpreter* interp;
         Scanner scanner;
+        io::File* file{nullptr};
+        std::unique_ptr<mem::Arena> arena;
+        TokenBuffer tokens;
+        u64 index{0};
         Token t;
-        parse::Grammar grammar;
         Restriction restriction{Default};
         std::stack<Restriction> prev_res;
 
@@ -0,0 +1,223 @@
+#include "scan_kernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define MU_SCAN_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define MU_TARGET_AVX2
+    #else
+        #define MU_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace mu {
+
+    // scalar kernels, these are used when no vector instructions are available.
+
+    static const char* scalar_skip_space(const char* ch) {
+        while(is_class(*ch, Space))
+            ++ch;
+        return ch;
+    }
+
+    static const char* scalar_skip_ident(const char* ch) {
+        while(is_class(*ch, IdentChar))
+            ++ch;
+        return ch;
+    }
+
+    static const char* scalar_find_line_end(const char* ch) {
+        while(*ch != '\n' and *ch != '\0')
+            ++ch;
+        return ch;
+    }
+
+    static const ScanKernels scalar_kernels = {
+        scalar_skip_space,
+        scalar_skip_ident,
+        scalar_find_line_end,
+        "scalar"
+    };
+
+    const ScanKernels& scalar_scan_kernels() {
+        return scalar_kernels;
+    }
+
+#if defined(MU_SCAN_X86)
+
+    inline u32 first_set(u32 mask) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    // Each class function loads an aligned block and returns a mask with a bit
+    // set for every character that ends the run. The '\0' sentinel always ends
+    // a run, which is what keeps the loads inside of the buffer.
+    //
+    // The comparisons are signed so characters above 127 are never part of a class,
+    // this matches the scalar table.
+
+    inline u32 sse2_space_stop(const char* block) {
+        auto v = _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+        auto space = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+        auto range = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('\t' - 1)),
+                                   _mm_cmplt_epi8(v, _mm_set1_epi8('\r' + 1)));
+        auto newline = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+        auto ws = _mm_or_si128(space, _mm_andnot_si128(newline, range));
+        return ~_mm_movemask_epi8(ws) & 0xFFFF;
+    }
+
+    inline u32 sse2_ident_stop(const char* block) {
+        auto v = _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+        auto lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        auto alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                   _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+        auto digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                   _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+        auto underscore = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+        auto ident = _mm_or_si128(_mm_or_si128(alpha, digit), underscore);
+        return ~_mm_movemask_epi8(ident) & 0xFFFF;
+    }
+
+    inline u32 sse2_line_end_stop(const char* block) {
+        auto v = _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+        auto stop = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                                 _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+        return _mm_movemask_epi8(stop);
+    }
+
+    // finds the first stop character at or after ch, starting from the aligned
+    // block that contains it.
+    template <u32 (*Stop)(const char*)>
+    const char* sse2_run(const char* ch) {
+        auto offset = CAST(u64, reinterpret_cast<uintptr_t>(ch) & 15);
+        auto block = ch - offset;
+
+        u32 mask = Stop(block) >> offset;
+        if(mask)
+            return ch + first_set(mask);
+
+        for(block += 16;; block += 16) {
+            mask = Stop(block);
+            if(mask)
+                return block + first_set(mask);
+        }
+    }
+
+    static const ScanKernels sse2_kernels = {
+        sse2_run<sse2_space_stop>,
+        sse2_run<sse2_ident_stop>,
+        sse2_run<sse2_line_end_stop>,
+        "sse2"
+    };
+
+    const ScanKernels* sse2_scan_kernels() {
+        return &sse2_kernels;
+    }
+
+    MU_TARGET_AVX2 inline u32 avx2_space_stop(const char* block) {
+        auto v = _mm256_load_si256(reinterpret_cast<const __m256i*>(block));
+        auto space = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+        auto range = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('\t' - 1)),
+                                      _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), v));
+        auto newline = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+        auto ws = _mm256_or_si256(space, _mm256_andnot_si256(newline, range));
+        return ~CAST(u32, _mm256_movemask_epi8(ws));
+    }
+
+    MU_TARGET_AVX2 inline u32 avx2_ident_stop(const char* block) {
+        auto v = _mm256_load_si256(reinterpret_cast<const __m256i*>(block));
+        auto lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        auto alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                      _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+        auto digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                                      _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+        auto underscore = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+        auto ident = _mm256_or_si256(_mm256_or_si256(alpha, digit), underscore);
+        return ~CAST(u32, _mm256_movemask_epi8(ident));
+    }
+
+    MU_TARGET_AVX2 inline u32 avx2_line_end_stop(const char* block) {
+        auto v = _mm256_load_si256(reinterpret_cast<const __m256i*>(block));
+        auto stop = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                                    _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+        return CAST(u32, _mm256_movemask_epi8(stop));
+    }
+
+    template <u32 (*Stop)(const char*)>
+    MU_TARGET_AVX2 const char* avx2_run(const char* ch) {
+        auto offset = CAST(u64, reinterpret_cast<uintptr_t>(ch) & 31);
+        auto block = ch - offset;
+
+        u32 mask = Stop(block) >> offset;
+        if(mask)
+            return ch + first_set(mask);
+
+        for(block += 32;; block += 32) {
+            mask = Stop(block);
+            if(mask)
+                return block + first_set(mask);
+        }
+    }
+
+    static const ScanKernels avx2_kernels = {
+        avx2_run<avx2_space_stop>,
+        avx2_run<avx2_ident_stop>,
+        avx2_run<avx2_line_end_stop>,
+        "avx2"
+    };
+
+    static bool cpu_has_avx2() {
+#if defined(_MSC_VER)
+        i32 info[4];
+        __cpuid(info, 0);
+        if(info[0] < 7)
+            return false;
+
+        // the os must also save the ymm registers.
+        __cpuid(info, 1);
+        bool osxsave = info[2] & (1 << 27);
+        if(!osxsave or (_xgetbv(0) & 0x6) != 0x6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return info[1] & (1 << 5);
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    const ScanKernels* avx2_scan_kernels() {
+        return cpu_has_avx2() ? &avx2_kernels : nullptr;
+    }
+
+#else
+
+    const ScanKernels* sse2_scan_kernels() {
+        return nullptr;
+    }
+
+    const ScanKernels* avx2_scan_kernels() {
+        return nullptr;
+    }
+
+#endif
+
+    const ScanKernels& scan_kernels() {
+        static const ScanKernels* kernels = [] () {
+            if(auto k = avx2_scan_kernels())
+                return k;
+            if(auto k = sse2_scan_kernels())
+                return k;
+            return &scalar_scan_kernels();
+        }();
+        return *kernels;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef SCAN_KERNELS_HPP_
+#define SCAN_KERNELS_HPP_
+
+#include "common.hpp"
+#include <array>
+
+namespace mu {
+
+    // character classes used by the scanner, this replaces the calls to
+    // isspace/isalpha/isalnum in the inner loops with a single table lookup.
+    // The '\0' sentinel is in no class so every loop stops at the end of the source.
+    enum CharClass : u8 {
+        Space      = 1 << 0, // whitespace, excluding new lines
+        IdentStart = 1 << 1,
+        IdentChar  = 1 << 2,
+        Digit      = 1 << 3,
+    };
+
+    constexpr std::array<u8, 256> build_char_classes() {
+        std::array<u8, 256> classes{};
+        for(u32 ch = 0; ch < 256; ++ch) {
+            u8 c = 0;
+            if(ch == ' ' or ch == '\t' or ch == '\v' or ch == '\f' or ch == '\r')
+                c |= Space;
+            if((ch >= 'a' and ch <= 'z') or (ch >= 'A' and ch <= 'Z') or ch == '_')
+                c |= IdentStart | IdentChar;
+            if(ch >= '0' and ch <= '9')
+                c |= Digit | IdentChar;
+            classes[ch] = c;
+        }
+        return classes;
+    }
+
+    inline constexpr auto char_classes = build_char_classes();
+
+    inline bool is_class(char ch, u8 c) { return char_classes[(u8) ch] & c; }
+
+    // Kernels for finding the end of long runs of characters. Each one takes a
+    // pointer into a '\0' terminated buffer and never reads past the 16 or 32 byte
+    // aligned block containing the terminator, so they can't fault.
+    //
+    // The implementation is picked once at startup based on what the CPU supports.
+    struct ScanKernels {
+        // first character that isn't whitespace (new lines are not whitespace).
+        const char* (*skip_space)(const char* ch);
+
+        // first character that can't be part of an identifier.
+        const char* (*skip_ident)(const char* ch);
+
+        // first new line or '\0'.
+        const char* (*find_line_end)(const char* ch);
+
+        const char* name;
+    };
+
+    const ScanKernels& scan_kernels();
+
+    // the individual implementations, exposed for the benchmarks.
+    const ScanKernels& scalar_scan_kernels();
+    const ScanKernels* sse2_scan_kernels();
+    const ScanKernels* avx2_scan_kernels();
+}
+
+#endif
@@ -1,11 +1,13 @@
 #include "scanner.hpp"
+#include "scan_kernels.hpp"
 
-#include <thread>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include "interpreter.hpp"
 
 namespace mu {
-    Scanner::Scanner(Interpreter* interp) : interp(interp) {}
+    Scanner::Scanner(Interpreter* interp) : interp(interp), kernels(&scan_kernels()) {}
 
     Scanner::~Scanner() = default;
 
@@ -22,104 +24,123 @@ namespace mu {
 		return current;
     }
 
-    bool Scanner::init() {
+    bool Scanner::tokenize(TokenBuffer& buffer) {
+        buffer.clear();
+
+        if(source.size() >= UINT32_MAX) {
+            interp->report_error(mu::Pos(file->base(), 0), "file is too large to be scanned: '%s'", file->path().string().c_str());
+            return false;
+        }
+
+        do {
+            advance();
+            if(current.kind() != Tkn_Comment)
+                buffer.push(current, tokenStart - begin, clamped(cursor) - tokenStart);
+        } while(current.kind() != Tkn_Eof);
+
+        return true;
+    }
+
+    Token Scanner::unpack(const TokenBuffer& buffer, u64 index) {
+        auto& packed = buffer[index];
+        auto kind = CAST(TokenKind, packed.kind);
+
+        Token token(kind, pos_of(begin + packed.offset, packed.span));
+        if(TokenBuffer::has_literal(kind)) {
+            auto& literal = buffer.literal(packed);
+            switch(kind) {
+                case Tkn_IntLiteral:
+                    token.integer = literal.integer;
+                    break;
+                case Tkn_FloatLiteral:
+                    token.floating = literal.floating;
+                    break;
+                case Tkn_CharLiteral:
+                    token.character = literal.character;
+                    break;
+                case Tkn_Identifier:
+                    token.ident = literal.ident;
+                    break;
+                default:
+                    break;
+            }
+            token.str = literal.str;
+        }
+        return token;
+    }
 
-		// this is unecessary complexity, but I want to try it.
-		//std::thread loadThread([](io::File* file) {
-		//}, this->file);
+    std::string_view Scanner::save_literal(std::string&& value) {
+        return literals.emplace_back(std::move(value));
+    }
 
-        index = 0;
-        position = mu::Pos(1, 1, 0, file->id());
+    bool Scanner::init() {
+        begin = end = cursor = tokenStart = nullptr;
+        literals.clear();
 
 		if (!file->load()) {
-			interp->report_error(this->position, "Failed to load file: '%s'", file->path().string().c_str());
+			interp->report_error(mu::Pos(), "Failed to load file: '%s'", file->path().string().c_str());
 			return false;
 		}
-	
-            
-        // std::cout << "Waiting for the file to load" << std::endl;
-		// this will join the calling thread to wait until loadThread is complete.
-		//loadThread.join();
-
-        // std::cout << "The file has been loaded" << std::endl;
 
-        source = &file->value();
+        source = file->value();
 
-		if(source->empty())
+		if(source.empty())
 		    return false;
 
-        currentCh = &source->at(index);
-        if(index + 1 >= source->size())
-            nextCh = nullptr;
-        else
-            nextCh = &source->at(index + 1);
+        begin = source.data();
+        end = begin + source.size();
+        cursor = tokenStart = begin;
 		return true;
     }
 
-    void Scanner::bump() {
-        if(index + 1 < source->size()) {
-            // check if the current character is a new line
-            if(check('\n')) {
-                // if so, then update the line and column count
-                position.line++;
-                position.column = 0;
-            }
-    
-            // move the current forward in the source
-            ++index;
-            ++position.span;
-            ++savePos.span;
-            ++position.column;
-    
-            // update the character pointers.
-            currentCh = &source->at(index);
-            if(index + 1 >= source->size())
-                nextCh = nullptr;
-            else
-                nextCh = &source->at(index + 1);
-        }
-        else
-            currentCh = nullptr;
+    Pos Scanner::token_pos() {
+        return pos_of(tokenStart, clamped(cursor) - tokenStart);
+    }
+
+    Pos Scanner::current_pos() {
+        return pos_of(clamped(cursor), clamped(cursor) - tokenStart);
     }
 
     Token Scanner::next_token() {
-        // consumes all of the whitespace
-        while(currentCh and isspace(*currentCh) and *currentCh != '\n')
-            bump();
-       
+        // consumes all of the whitespace, most tokens are separated by a single
+        // space so the vector loop is only used for longer runs.
+        if(is_class(*cursor, Space)) {
+            ++cursor;
+            if(is_class(*cursor, Space))
+                cursor = kernels->skip_space(cursor);
+        }
+
         // initializes a new token from the currnet point in the text
         new_token();
 
-		if (!currentCh)
-			return Token(Tkn_Eof, savePos);
+		if (at_end())
+			return Token(Tkn_Eof, token_pos());
 
-		if (isalpha(*this->currentCh) or check('_'))
+		if (is_class(*cursor, IdentStart))
 			return scan_identifier();
-		else if (isdigit(*this->currentCh))
+		else if (is_class(*cursor, Digit))
 			return scan_number_literal();
 		else
 			return scan_op();
     }
 
 	Token Scanner::scan_identifier() {
-        std::string temp;
-        while(currentCh && (isalnum(*currentCh) or check('_'))) {
-            temp.push_back(*currentCh);
-            bump();
-        }
+        // the identifier is a slice of the source, it is only copied
+        // the first time the name is seen.
+        auto start = cursor;
+        cursor = kernels->skip_ident(cursor);
 
-        // clean up the string if it isnt used by the table
-
-        
-        TokenKind kind = Token::keyword(temp);
+        std::string_view name(start, cursor - start);
+        TokenKind kind = Token::keyword(name);
+        auto pos = token_pos();
 
         if(kind == Tkn_None) {
-			auto s = interp->find_name(temp);
+			auto s = interp->find_name(name);
 			// this is fine, Visual Studio is not detecting the constructors generated from a Macro.
-			return Token(new ast::Ident(s, savePos), savePos);
+			return Token(ast::make_ident(s, pos), pos);
         }
         else {
-            return Token(kind, savePos);
+            return Token(kind, pos);
         }
     }
 
@@ -131,25 +152,25 @@ namespace mu {
 			if (check('x') or
 				check('X')) {
                 bump();
-				while (currentCh && isxdigit(*currentCh)){
-                    temp.push_back(*currentCh);
+				while (isxdigit(*cursor)){
+                    temp.push_back(*cursor);
                     bump();
                 }
 
 				u64 val = strtoll(temp.c_str(), NULL, 16);
-				return Token(val, savePos);
+				return Token(val, token_pos());
 			}
 			else if (check('b') or
                      check('B')) {
                 bump();
 				while (check('1') or
 					   check('0')) {
-                    temp.push_back(*currentCh);
+                    temp.push_back(*cursor);
                     bump();
                 }
 
 				u64 val = strtoll(temp.c_str(), NULL, 2);
-				return Token(val, savePos);
+				return Token(val, token_pos());
 			}
             else
                 temp.push_back('0');
@@ -157,38 +178,38 @@ namespace mu {
 		bool floating_point = false;
 		bool scientific_notation = false;
         // scan digits before the decimal point
-		while (currentCh && isdigit(*currentCh)) {
-            temp.push_back(*currentCh);
+		while (is_class(*cursor, Digit)) {
+            temp.push_back(*cursor);
             bump();
         }
 
 		// we only want it to be a float if it is a complete float e.i 1.0
-		if (check('.') and (nextCh and *nextCh != '.' and isdigit(*nextCh))) {
-            temp.push_back(*currentCh);
+		if (check('.') and (cursor[1] != '.' and is_class(cursor[1], Digit))) {
+            temp.push_back(*cursor);
             bump();
-			while (currentCh && isdigit(*currentCh)) {
-                temp.push_back(*currentCh);
+			while (is_class(*cursor, Digit)) {
+                temp.push_back(*cursor);
                 bump();
             }
 			floating_point = true;
 		}
 		if (check('e') or
 			check('E')) {
-            temp.push_back(*currentCh);
+            temp.push_back(*cursor);
             bump();
 			if (check('-') or
 				check('+')) {
                 if(check('-'))
                     floating_point = true;
-                temp.push_back(*currentCh);
+                temp.push_back(*cursor);
                 bump();
             }
 
 
 
-			if (currentCh && isdigit(*currentCh))
-				while(currentCh && isdigit(*currentCh)) {
-                    temp.push_back(*currentCh);
+			if (is_class(*cursor, Digit))
+				while(is_class(*cursor, Digit)) {
+                    temp.push_back(*cursor);
                     bump();
                 }
 			else {
@@ -201,26 +222,26 @@ namespace mu {
 		Token token;
 		if (floating_point) {
 			f64 val = strtod(temp.c_str(), NULL);
-            token = Token(val, savePos);
+            token = Token(val, token_pos());
 		}
 		else {
 			u64 val = strtoll(temp.c_str(), NULL, 10);
-            token = Token(val, savePos);
+            token = Token(val, token_pos());
 		}
-		token.str = temp;
+		token.str = save_literal(std::move(temp));
 		return token;
     }
 
-#define SingleToken(ch, kind) case ch: return Token(kind, savePos);
+#define SingleToken(ch, kind) case ch: return Token(kind, token_pos());
 
 #define DoubleToken(ch, kind1, kind2) \
 	case ch: \
 		if(check('=')) { \
             bump(); \
-			return Token(kind2, savePos); \
+			return Token(kind2, token_pos()); \
 		} \
 		else { \
-			return Token(kind1, savePos); \
+			return Token(kind1, token_pos()); \
 		} \
 		break;
 
@@ -228,14 +249,14 @@ namespace mu {
 	case ch: \
 		if(check('=')) { \
             bump(); \
-			return Token(kind2, savePos); \
+			return Token(kind2, token_pos()); \
 		} \
 		else if(check((ch))) { \
             bump(); \
-			return Token(kind3, savePos); \
+			return Token(kind3, token_pos()); \
 		} \
 		else { \
-			return Token(kind1, savePos); \
+			return Token(kind1, token_pos()); \
 		} \
 		break;
 
@@ -243,25 +264,25 @@ namespace mu {
 	case ch: {\
 		if(check('=')) { \
             bump(); \
-			return Token(kind2, savePos); \
+			return Token(kind2, token_pos()); \
 		} \
 		else if(check((ch))) { \
             bump(); \
 			if(check('=')) { \
                 bump(); \
-                return Token(kind4, savePos); \
+                return Token(kind4, token_pos()); \
 			} \
 			else { \
-                return Token(kind3, savePos); \
+                return Token(kind3, token_pos()); \
 			} \
 		} \
 		else { \
-          return Token(kind1, savePos); \
+          return Token(kind1, token_pos()); \
 		} \
 	} break;
 
     Token Scanner::scan_op() {
-        auto ch = *currentCh;
+        auto ch = *cursor;
         bump();
         switch(ch) {
             SingleToken('\n', Tkn_NewLine);
@@ -293,31 +314,31 @@ namespace mu {
             case '=': {
                 if(check('=')) {
                     bump();
-                    return Token(Tkn_EqualEqual, savePos);
+                    return Token(Tkn_EqualEqual, token_pos());
                 }
                 else if(check('>')) {
                     bump();
-                    return Token(Tkn_Arrow, savePos);
+                    return Token(Tkn_Arrow, token_pos());
                 }
                 else
-                    return Token(Tkn_Equal, savePos);
+                    return Token(Tkn_Equal, token_pos());
             }
             case ':': {
                     if(check(':')) {
                         bump();
-                        return Token(Tkn_ColonColon, savePos);
+                        return Token(Tkn_ColonColon, token_pos());
                     }
                     else
-                        return Token(Tkn_Colon, savePos);
+                        return Token(Tkn_Colon, token_pos());
             }
 
             case '-': {
                     if(check('>')) {
                         bump();
-                        return Token(Tkn_MinusGreater, savePos);
+                        return Token(Tkn_MinusGreater, token_pos());
                     }
                     else
-                        return Token(Tkn_Minus, savePos);
+                        return Token(Tkn_Minus, token_pos());
                 }
 
             case '.': {
@@ -325,20 +346,20 @@ namespace mu {
                         bump();
                         if(check('.')) {
                             bump();
-                            return Token(Tkn_PeriodPeriodPeriod, savePos);
+                            return Token(Tkn_PeriodPeriodPeriod, token_pos());
                         }
                         else
-                            return Token(Tkn_PeriodPeriod, savePos);
+                            return Token(Tkn_PeriodPeriod, token_pos());
                     }
-                    return Token(Tkn_Period, savePos);
+                    return Token(Tkn_Period, token_pos());
                 }
             case '/': {
                     if(check('/') or check('*'))
                         return scan_comment();
                     else if(check('='))
-                        return Token(Tkn_SlashEqual, savePos);
+                        return Token(Tkn_SlashEqual, token_pos());
                     else
-                        return Token(Tkn_Slash, savePos);
+                        return Token(Tkn_Slash, token_pos());
                     }
                   case '\'': {
                             return scan_character();
@@ -350,104 +371,106 @@ namespace mu {
             case '<': {
                 if(check('=')) {
                     bump();
-                    return Token(Tkn_LessEqual, savePos);
+                    return Token(Tkn_LessEqual, token_pos());
                 }
                 else if(check('<')) {
                     bump();
                     if(check('=')) {
                         bump();
-                        return Token(Tkn_LessLessEqual, savePos);
+                        return Token(Tkn_LessLessEqual, token_pos());
                     }
                     else {
-                        return Token(Tkn_LessLess, savePos);
+                        return Token(Tkn_LessLess, token_pos());
                     }
                 }
                 else if(check('>')) {
                     bump();
-                    return Token(Tkn_Unit, savePos);
+                    return Token(Tkn_Unit, token_pos());
                 }
                 else {
-                  return Token(Tkn_Less, savePos);
+                  return Token(Tkn_Less, token_pos());
                 }
             } break;
             default:
-              std::cout << "Found unknown character: '" << ch << "'" << std::endl;
+              interp->out_stream() << "Found unknown character: '" << ch << "'" << std::endl;
               break;  
         }
 
-        return Token(Tkn_Error, savePos);
+        return Token(Tkn_Error, token_pos());
     }
 
     Token Scanner::scan_character() {
         char temp;
-        if(!currentCh)  {
-            interp->report_error(position, "found end of file while expecting to find character");
+        if(at_end())  {
+            interp->report_error(current_pos(), "found end of file while expecting to find character");
         }
-        switch(*currentCh) {
+        switch(*cursor) {
             case '\\':
                 temp = validate_escape();
                 break;
             default:
-                temp = *currentCh;
+                temp = *cursor;
                 bump();
         }
 		if(check('\''))
 			bump();
 		else {
 			// report the error
-			std::cout << "This is an error" << std::endl;
+			interp->out_stream() << "This is an error" << std::endl;
 		}
 		// this is fine, Visual Studio is not detecting the constructors generated from a Macro.
 
-        auto token = Token(temp, savePos);
-		token.str = temp;
+        auto token = Token(temp, token_pos());
+		token.str = save_literal(std::string(1, temp));
 		return token;
     }
 
     Token Scanner::scan_string() {
 		char ch;
         std::string temp;
-        while(currentCh and !check('"')) {
+        while(!at_end() and !check('"')) {
             if(check('\\'))
                 ch = validate_escape();
             else {
-                ch = *currentCh;
+                ch = *cursor;
                 bump();
             }
     
             temp.push_back(ch);
 
-			if (!currentCh)
-				std::cout << "String current character is null" << std::endl;
+			if (at_end())
+				interp->out_stream() << "String current character is null" << std::endl;
         }
         bump();
 		// this is fine, Visual Studio is not detecting the constructors generated from a Macro.
-        return Token(temp, savePos);
+        return Token(save_literal(std::move(temp)), token_pos());
     }
     
     /// @TODO: implement scanning for block comments and embedded block comments.
     Token Scanner::scan_comment() {
         // consume the next forward slash
 		bump();
-        std::string temp;
-		while (currentCh && !check('\n')) {
-			temp.push_back(*currentCh);
-			bump();
-		}
+        auto start = cursor;
+        cursor = kernels->find_line_end(cursor);
+
+        // a '\0' inside of the file doesn't end the comment.
+        while(!at_end() and !check('\n'))
+            cursor = kernels->find_line_end(cursor + 1);
+        auto length = cursor - start;
 
         // takes the new line
         bump();
-        Token token = Token(temp, savePos);
-        token.tokenKind = Tkn_Comment;
+        Token token(Tkn_Comment, token_pos());
+        token.str = std::string_view(start, length);
         return token;
     }
 
     char Scanner::validate_escape() {
-        if(!currentCh) {
-            interp->report_error(position, "invalid escape character at end of file");
+        if(at_end()) {
+            interp->report_error(current_pos(), "invalid escape character at end of file");
         }
         bump();               // consumes the the the forward slash
-        auto ch = *currentCh; // gets the character following the forward slash.
+        auto ch = *cursor;    // gets the character following the forward slash.
 		bump();               // consumes it.
         switch(ch) {
             case 'a':
@@ -500,22 +523,4 @@ namespace mu {
         }
         return 0x0;
     }
-
-    Scanner::State Scanner::save() {
-        return State {
-            index,
-            currentCh,
-            nextCh,
-            position,
-            savePos
-        };
-    }
-
-    void Scanner::restore(const State& state) {
-        index = state.index;
-        currentCh = state.currentCh;
-        nextCh = state.nextCh;
-        position = state.position;
-        savePos = state.savePos;
-    }
 }
@@ -2,28 +2,21 @@
 #define SCANNER_HPP_
 
 #include "token.hpp"
+#include "token_buffer.hpp"
 #include "utils/file.hpp"
+#include <deque>
 
 class Interpreter;
 
 namespace mu {
+    struct ScanKernels;
+
     class Scanner {
         public:
-            struct State {
-                u64 index;               /// the index within the source
-                const char* currentCh;         /// the current character
-                const char* nextCh;            /// the next character
-                Pos position;            /// the current position within the file
-                Pos savePos;             /// the start of current token
-            };
-
             Scanner(Interpreter* interp);
 
             ~Scanner();
     
-            /// tokenizes the give file.
-            // std::vector<Token> tokenize(io::File* file);
-            
             // initializes the scanner with the new file
             bool init(io::File *file);
     
@@ -33,10 +26,12 @@ namespace mu {
             // returns the most resent token
             Token& token();
 
-            State save();
-
-            void restore(const State& state);
+            // scans the rest of the file into buffer, the last token is always Tkn_Eof.
+            // returns false if the file is too large to be packed.
+            bool tokenize(TokenBuffer& buffer);
 
+            // rebuilds the full token at index of a buffer filled by this scanner.
+            Token unpack(const TokenBuffer& buffer, u64 index);
 
 
         private:
@@ -45,13 +40,27 @@ namespace mu {
             bool init();
         
             /// move the cursor to the next character.
-            void bump();
-    
+            /// the cursor never moves past the sentinel at the end of the source.
+            inline void bump() { cursor += (cursor < end); }
+
+            inline bool at_end() { return cursor == end; }
+
             // this is to allow the span to be updated as we move along.
-            inline void new_token() { position.span = 0; savePos = position; }
+            inline void new_token() { tokenStart = clamped(cursor); }
 
-			inline bool check(char ch) { return currentCh && *currentCh == ch; }
+			inline bool check(char ch) { return *cursor == ch; }
 
+            // the last character of the source is the furthest a position can refer to.
+            inline const char* clamped(const char* ch) { return ch < end ? ch : end - 1; }
+
+            // the position of the current token, from its start to the cursor.
+            Pos token_pos();
+
+            // the current position within the file
+            Pos current_pos();
+
+            // the position of a character, its offset in the range of the file.
+            inline Pos pos_of(const char* ch, u64 span) { return Pos(file->base() + CAST(u32, ch - begin), span); }
 
 		private:
 
@@ -64,22 +73,25 @@ namespace mu {
             Token scan_string();
             Token scan_comment();
 
-            static TokenKind keyword(const std::string& str);
-
             char validate_escape();
 
+            // keeps the text of a literal alive for as long as the scanner.
+            std::string_view save_literal(std::string&& value);
+
             Interpreter* interp{nullptr}; /// the active interpreter
+            const ScanKernels* kernels{nullptr}; /// the vectorized loops for this cpu
             io::File* file{nullptr}; /// the current file being scanned
             Token current;
 
             // state data
-            u64 index;               /// the index within the source
-            const char* currentCh;         /// the current character
-            const char* nextCh;            /// the next character
-            const std::string* source;     /// the source
-            Pos position;            /// the current position within the file
-            Pos savePos;             /// the start of current token
-
+            std::string_view source;       /// the source, followed by a '\0' sentinel
+            const char* begin{nullptr};    /// the first character of the source
+            const char* end{nullptr};      /// the sentinel following the source
+            const char* cursor{nullptr};   /// the current character
+            const char* tokenStart{nullptr}; /// the start of current token
+
+            // the text of literals that can't refer to the source.
+            std::deque<std::string> literals;
 
     };
 }
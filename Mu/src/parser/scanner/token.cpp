@@ -1,6 +1,7 @@
 #include "token.hpp"
+#include "utils/file.hpp"
 #include <vector>
-#include <algorithm>
+#include <array>
 
 static std::string nl = "Newline";
 static std::string eof = "EOF";
@@ -11,25 +12,51 @@ static const std::vector<std::string> token_strings = {
 #undef TOKEN_KIND
 };
 
-namespace mu {
+static constexpr std::string_view token_views[] = {
+#define TOKEN_KIND(n, str) std::string_view(str),
+    TOKEN_KINDS
+#undef TOKEN_KIND
+};
 
-#define TOKEN_CONSTRUCTOR_IMP(Type, Elem, TokenType) \
-    Token::TOKEN_CONSTRUCTOR_DEF(Type) : Token(TokenType, pos) { \
-        this->Elem = elem;  \
-    }
+// Keywords are every token kind from Tkn_Underscore to Tkn_As. They are recognized
+// with a perfect hash built at compile time from TOKEN_KINDS, so identifiers only
+// need a single string comparison.
+// If a new keyword collides with an existing one, the static_assert below fails and
+// the shifts of keyword_hash need to be changed.
+static constexpr u64 KEYWORD_TABLE_SIZE = 128;
+static constexpr u64 KEYWORD_MAX_LENGTH = 8;
+
+static constexpr u64 keyword_hash(std::string_view str) {
+    auto n = str.size();
+    return ((u8) str[0] + ((u8) str[n > 1 ? n - 2 : 0] << 3) + ((u8) str[n - 1] << 2) + n) & (KEYWORD_TABLE_SIZE - 1);
+}
 
-	Token::Token() {}
+static constexpr std::array<mu::TokenKind, KEYWORD_TABLE_SIZE> build_keyword_table() {
+    std::array<mu::TokenKind, KEYWORD_TABLE_SIZE> table{};
+    for(auto& kind : table)
+        kind = mu::Tkn_None;
 
-	Token::Token(TokenKind kind, const Pos& pos) : tokenKind(kind), position(pos) {}
+    for(u64 i = mu::Tkn_Underscore; i <= mu::Tkn_As; ++i)
+        table[keyword_hash(token_views[i])] = (mu::TokenKind) i;
 
-    TOKEN_CONSTRUCTOR_IMP(u64, integer, Tkn_IntLiteral)
-    TOKEN_CONSTRUCTOR_IMP(f64, floating, Tkn_FloatLiteral)
-    TOKEN_CONSTRUCTOR_IMP(char, character, Tkn_CharLiteral)
-    TOKEN_CONSTRUCTOR_IMP(const std::string&, str, Tkn_StringLiteral)
-    TOKEN_CONSTRUCTOR_IMP(ast::Ident*, ident, Tkn_Identifier)
+    return table;
+}
 
+static constexpr auto keyword_table = build_keyword_table();
 
-    Token::~Token() {}
+static constexpr bool keyword_table_is_perfect() {
+    for(u64 i = mu::Tkn_Underscore; i <= mu::Tkn_As; ++i) {
+        if(keyword_table[keyword_hash(token_views[i])] != (mu::TokenKind) i)
+            return false;
+        if(token_views[i].size() > KEYWORD_MAX_LENGTH)
+            return false;
+    }
+    return true;
+}
+
+static_assert(keyword_table_is_perfect(), "keyword hash has a collision or a keyword is too long");
+
+namespace mu {
 
     const std::string& Token::get_string(TokenKind kind) {
         switch (kind) {
@@ -43,7 +70,7 @@ namespace mu {
         return token_strings[kind];
     }
 
-    const std::string &Token::get_string() {
+    std::string Token::get_string() {
         switch(kind()) {
             case Tkn_Identifier:
                 return ident->value();
@@ -57,20 +84,21 @@ namespace mu {
             case Tkn_FloatLiteral:
             case Tkn_StringLiteral:
             case Tkn_CharLiteral:
-                return str;
+                return std::string(str);
             default:
                 return Token::get_string(kind());
         }
     }
 
-    TokenKind Token::keyword(const std::string& str) {
-        auto iter = std::find(token_strings.begin(), token_strings.end(), str);
-        if(iter == token_strings.end())
+    TokenKind Token::keyword(std::string_view str) {
+        if(str.empty() or str.size() > KEYWORD_MAX_LENGTH)
+            return Tkn_None;
+
+        auto kind = keyword_table[keyword_hash(str)];
+        if(kind != Tkn_None and token_views[kind] == str)
+            return kind;
+        else
             return Tkn_None;
-        else {
-            u64 index = std::distance(token_strings.begin(), iter);
-            return (TokenKind) index;
-        }
     }
 
 	std::ostream& operator<< (std::ostream& out, const Token& t) {
@@ -95,115 +123,18 @@ namespace mu {
             default:
                 break;
 		}
+		// the line and column are found from the offset, the token is only printed to debug.
+		auto file = io::File::at(t.position.offset);
+		auto [line, column] = file ? file->line_column(t.position.offset) : io::LineColumn {0, 0};
 		out << ", "
-            << t.position.line <<  ", "
-            << t.position.column << ", "
+            << line <<  ", "
+            << column << ", "
             << t.position.span << ", "
-            << t.position.fid << ")";
+            << (file ? file->id() : 0) << ")";
 
 		return out;
 	}
 
-    i32 Token::prec() {
-        switch(kind()) {
-            case Tkn_AstrickAstrick:
-                return 14;
-            case Tkn_Slash:
-            case Tkn_Astrick:
-            case Tkn_Percent:
-                return 13;
-            case Tkn_Plus:
-            case Tkn_Minus:
-                return 12;
-            case Tkn_LessLess:
-            case Tkn_GreaterGreater:
-                return 11;
-            case Tkn_EqualEqual:
-            case Tkn_BangEqual:
-                return 10;
-            case Tkn_LessEqual:
-            case Tkn_GreaterEqual:
-            case Tkn_Less:
-            case Tkn_Greater:
-                return 9;
-            case Tkn_Ampersand:
-                return 8;
-            case Tkn_Carrot:
-                return 7;
-            case Tkn_Pipe:
-                return 6;
-            case Tkn_And:
-                return 5;
-            case Tkn_Or:
-                return 4;
-            case Tkn_PeriodPeriod:
-                return 3;
-            case Tkn_As:
-                return 2;
-        // case Tkn_Question:
-        // case Tkn_PeriodPeriod:
-        // case Tkn_PeriodPeriodPeriod:
-        // case Tkn_InfixOp:
-        //   return 2;
-            case Tkn_Equal:
-            case Tkn_LessLessEqual:
-            case Tkn_GreaterGreaterEqual:
-            case Tkn_PlusEqual:
-            case Tkn_MinusEqual:
-            case Tkn_SlashEqual:
-            case Tkn_AstrickEqual:
-            case Tkn_AmpersandEqual:
-            case Tkn_PipeEqual:
-            case Tkn_CarrotEqual:
-            case Tkn_AstrickAstrickEqual:
-            case Tkn_Dollar:
-                return 1;
-            default:
-                return 0;
-        }
-    }
-
-    Associative Token::acc() {
-        switch(kind()) {
-            case Tkn_AstrickAstrick:
-            case Tkn_Dollar:
-                return Associative::Right;
-            case Tkn_Slash:
-            case Tkn_Astrick:
-            case Tkn_Percent:
-            case Tkn_Plus:
-            case Tkn_Minus:
-            case Tkn_LessLess:
-            case Tkn_GreaterGreater:
-            case Tkn_EqualEqual:
-            case Tkn_BangEqual:
-            case Tkn_LessEqual:
-            case Tkn_GreaterEqual:
-            case Tkn_Less:
-            case Tkn_Greater:
-            case Tkn_Ampersand:
-            case Tkn_Carrot:
-            case Tkn_Pipe:
-            case Tkn_And:
-            case Tkn_Or:
-            case Tkn_Equal:
-            case Tkn_LessLessEqual:
-            case Tkn_GreaterGreaterEqual:
-            case Tkn_PlusEqual:
-            case Tkn_MinusEqual:
-            case Tkn_SlashEqual:
-            case Tkn_AstrickEqual:
-            case Tkn_AmpersandEqual:
-            case Tkn_PipeEqual:
-            case Tkn_CarrotEqual:
-            case Tkn_AstrickAstrickEqual:
-            case Tkn_PeriodPeriod:
-                return Associative::Left;
-            default:
-                return Associative::None;
-        }
-    }
-
     bool Token::is_operator() {
         auto k = kind();
         return Tkn_Plus <= k && k <= Tkn_PipeEqual;
@@ -3,6 +3,7 @@
 
 #include "common.hpp"
 #include <string>
+#include <string_view>
 #include <fstream>
 #include "parser/ast/ast_common.hpp"
 
@@ -85,6 +86,7 @@
     TOKEN_KIND(Derive, "derive") \
     TOKEN_KIND(Where, "where") \
     TOKEN_KIND(Inline, "inline") \
+    TOKEN_KIND(Const, "const") \
 	TOKEN_KIND(Defer, "defer") \
     TOKEN_KIND(For, "for") \
     TOKEN_KIND(Match, "match") \
@@ -128,23 +130,129 @@ namespace mu {
         None
     };
 
-    struct Token {
-        Token();
+    // the binding power of a token that continues an expression, a higher precedence binds
+    // tighter. Any token that can't follow an operand is zero, it ends the expression.
+    constexpr i32 precedence(TokenKind kind) {
+        switch(kind) {
+            case Tkn_AstrickAstrick:
+                return 14;
+            case Tkn_Slash:
+            case Tkn_Astrick:
+            case Tkn_Percent:
+                return 13;
+            case Tkn_Plus:
+            case Tkn_Minus:
+                return 12;
+            case Tkn_LessLess:
+            case Tkn_GreaterGreater:
+                return 11;
+            case Tkn_EqualEqual:
+            case Tkn_BangEqual:
+                return 10;
+            case Tkn_LessEqual:
+            case Tkn_GreaterEqual:
+            case Tkn_Less:
+            case Tkn_Greater:
+                return 9;
+            case Tkn_Ampersand:
+                return 8;
+            case Tkn_Carrot:
+                return 7;
+            case Tkn_Pipe:
+                return 6;
+            case Tkn_And:
+                return 5;
+            case Tkn_Or:
+                return 4;
+            case Tkn_PeriodPeriod:
+                return 3;
+            case Tkn_As:
+                return 2;
+        // case Tkn_Question:
+        // case Tkn_PeriodPeriod:
+        // case Tkn_PeriodPeriodPeriod:
+        // case Tkn_InfixOp:
+        //   return 2;
+            case Tkn_Equal:
+            case Tkn_LessLessEqual:
+            case Tkn_GreaterGreaterEqual:
+            case Tkn_PlusEqual:
+            case Tkn_MinusEqual:
+            case Tkn_SlashEqual:
+            case Tkn_AstrickEqual:
+            case Tkn_AmpersandEqual:
+            case Tkn_PipeEqual:
+            case Tkn_CarrotEqual:
+            case Tkn_AstrickAstrickEqual:
+            case Tkn_Dollar:
+                return 1;
+            default:
+                return 0;
+        }
+    }
+
+    constexpr Associative associativity(TokenKind kind) {
+        switch(kind) {
+            case Tkn_AstrickAstrick:
+            case Tkn_Dollar:
+                return Associative::Right;
+            case Tkn_Slash:
+            case Tkn_Astrick:
+            case Tkn_Percent:
+            case Tkn_Plus:
+            case Tkn_Minus:
+            case Tkn_LessLess:
+            case Tkn_GreaterGreater:
+            case Tkn_EqualEqual:
+            case Tkn_BangEqual:
+            case Tkn_LessEqual:
+            case Tkn_GreaterEqual:
+            case Tkn_Less:
+            case Tkn_Greater:
+            case Tkn_Ampersand:
+            case Tkn_Carrot:
+            case Tkn_Pipe:
+            case Tkn_And:
+            case Tkn_Or:
+            case Tkn_Equal:
+            case Tkn_LessLessEqual:
+            case Tkn_GreaterGreaterEqual:
+            case Tkn_PlusEqual:
+            case Tkn_MinusEqual:
+            case Tkn_SlashEqual:
+            case Tkn_AstrickEqual:
+            case Tkn_AmpersandEqual:
+            case Tkn_PipeEqual:
+            case Tkn_CarrotEqual:
+            case Tkn_AstrickAstrickEqual:
+            case Tkn_PeriodPeriod:
+                return Associative::Left;
+            default:
+                return Associative::None;
+        }
+    }
 
-		Token(TokenKind kind, const Pos& pos);
+// the constructors are defined inline since one is called for every token scanned.
+#define TOKEN_CONSTRUCTOR_IMP(Type, Elem, TokenType) \
+    inline TOKEN_CONSTRUCTOR_DEF(Type) : Token(TokenType, pos) { \
+        this->Elem = elem;  \
+    }
+
+    struct Token {
+        inline Token() {}
 
-		TOKEN_CONSTRUCTOR_DEF(u64);
-		TOKEN_CONSTRUCTOR_DEF(f64);
-		TOKEN_CONSTRUCTOR_DEF(char);
-		TOKEN_CONSTRUCTOR_DEF(const std::string&);
-		TOKEN_CONSTRUCTOR_DEF(ast::Ident*);
+		inline Token(TokenKind kind, const Pos& pos) : tokenKind(kind), position(pos) {}
 
-        ~Token();
+        TOKEN_CONSTRUCTOR_IMP(u64, integer, Tkn_IntLiteral)
+        TOKEN_CONSTRUCTOR_IMP(f64, floating, Tkn_FloatLiteral)
+        TOKEN_CONSTRUCTOR_IMP(char, character, Tkn_CharLiteral)
+        TOKEN_CONSTRUCTOR_IMP(std::string_view, str, Tkn_StringLiteral)
+        TOKEN_CONSTRUCTOR_IMP(ast::Ident*, ident, Tkn_Identifier)
 
-        const std::string& get_string();
+        std::string get_string();
 
         static const std::string& get_string(TokenKind kind);
-        static TokenKind keyword(const std::string& str);
+        static TokenKind keyword(std::string_view str);
 
         inline TokenKind kind() const { return tokenKind; }
 		inline TokenKind kind() { return tokenKind; }
@@ -154,15 +262,16 @@ namespace mu {
 
         bool is_assignment();
 
-        i32 prec();
-        Associative acc();
+        inline i32 prec() const { return precedence(tokenKind); }
+        inline Associative acc() const { return associativity(tokenKind); }
 
         TokenKind tokenKind;
 		Pos position;
 
 		friend std::ostream& operator<< (std::ostream& out, const Token& t);
     
-        std::string str;
+        // the text of a literal, it is owned by the scanner or refers to the source.
+        std::string_view str;
 //		enum {
 			u64 integer;
             f64 floating;
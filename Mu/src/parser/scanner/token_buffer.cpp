@@ -0,0 +1,53 @@
+#include "token_buffer.hpp"
+
+namespace mu {
+
+    void TokenBuffer::clear() {
+        tokens.clear();
+        literals.clear();
+    }
+
+    bool TokenBuffer::has_literal(TokenKind kind) {
+        switch(kind) {
+            case Tkn_IntLiteral:
+            case Tkn_FloatLiteral:
+            case Tkn_StringLiteral:
+            case Tkn_CharLiteral:
+            case Tkn_Identifier:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void TokenBuffer::push(const Token& token, u64 offset, u64 span) {
+        PackedToken packed{CAST(u32, offset), CAST(u32, span), CAST(u32, token.kind()), 0};
+
+        if(has_literal(token.kind())) {
+            TokenLiteral literal;
+            switch(token.kind()) {
+                case Tkn_IntLiteral:
+                    literal.integer = token.integer;
+                    break;
+                case Tkn_FloatLiteral:
+                    literal.floating = token.floating;
+                    break;
+                case Tkn_CharLiteral:
+                    literal.character = token.character;
+                    break;
+                case Tkn_Identifier:
+                    literal.ident = token.ident;
+                    break;
+                default:
+                    literal.integer = 0;
+                    break;
+            }
+            literal.str = token.str;
+
+            packed.literal = CAST(u32, literals.size());
+            literals.push_back(literal);
+        }
+
+        tokens.push_back(packed);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef TOKEN_BUFFER_HPP_
+#define TOKEN_BUFFER_HPP_
+
+#include "token.hpp"
+#include <vector>
+
+namespace mu {
+
+    // the compact form of a token stored in a TokenBuffer. The position is
+    // kept as an offset into the source and the value of literals and identifiers
+    // is kept in a side table, so every token is the same 16 bytes.
+    struct PackedToken {
+        u32 offset;     /// the offset of the first character of the token
+        u32 span;       /// the number of characters in the token
+        u32 kind;       /// the TokenKind
+        u32 literal;    /// index into the literal table, only valid when has_literal(kind)
+    };
+
+    static_assert(sizeof(PackedToken) == 16, "PackedToken should be 16 bytes");
+
+    struct TokenLiteral {
+        union {
+            u64 integer;
+            f64 floating;
+            char character;
+            ast::Ident* ident;
+        };
+        std::string_view str;
+    };
+
+    // All of the tokens of a file, filled by Scanner::tokenize. Comments are
+    // not stored, the parser never looks at them.
+    class TokenBuffer {
+    public:
+        void clear();
+
+        void push(const Token& token, u64 offset, u64 span);
+
+        inline u64 size() const { return tokens.size(); }
+
+        inline TokenKind kind(u64 index) const { return CAST(TokenKind, tokens[index].kind); }
+
+        inline const PackedToken& operator[] (u64 index) const { return tokens[index]; }
+
+        inline const TokenLiteral& literal(const PackedToken& token) const { return literals[token.literal]; }
+
+        static bool has_literal(TokenKind kind);
+
+    private:
+        std::vector<PackedToken> tokens;
+        std::vector<TokenLiteral> literals;
+    };
+}
+
+#endif
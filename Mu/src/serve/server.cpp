@@ -0,0 +1,334 @@
+#include "server.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#if defined(MU_APPLE) || defined(MU_LINUX)
+    #include <cerrno>
+    #include <climits>
+    #include <csignal>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/socket.h>
+    #include <sys/time.h>
+    #include <sys/un.h>
+#endif
+
+// the largest request a server reads, the working directory and the arguments.
+const u32 MAX_REQUEST = 64 * 1024;
+
+// the seconds a server waits for each part of a request before it drops the client.
+const i32 REQUEST_TIMEOUT = 5;
+
+namespace mu {
+    namespace serve {
+#if defined(MU_APPLE) || defined(MU_LINUX)
+        // the standard input, output and error, sent with the length of a request.
+        const u64 NUM_DESCRIPTORS = 3;
+
+        static bool socket_address(sockaddr_un& address) {
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if(SOCKET_PATH.size() >= sizeof(address.sun_path))
+                return false;
+            std::memcpy(address.sun_path, SOCKET_PATH.c_str(), SOCKET_PATH.size() + 1);
+            return true;
+        }
+
+        static i32 make_socket() {
+            auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if(fd >= 0)
+                fcntl(fd, F_SETFD, FD_CLOEXEC);
+            return fd;
+        }
+
+        // a connection to the server of the working directory, -1 if there isn't one.
+        static i32 connect_server() {
+            sockaddr_un address;
+            if(!socket_address(address))
+                return -1;
+
+            auto fd = make_socket();
+            if(fd < 0)
+                return -1;
+
+            if(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                close(fd);
+                return -1;
+            }
+            return fd;
+        }
+
+        static bool read_all(i32 fd, void* data, u64 size) {
+            auto bytes = CAST_PTR(char, data);
+            while(size > 0) {
+                auto count = read(fd, bytes, size);
+                if(count < 0 and errno == EINTR)
+                    continue;
+                if(count <= 0)
+                    return false;
+                bytes += count;
+                size -= count;
+            }
+            return true;
+        }
+
+        static bool write_all(i32 fd, const void* data, u64 size) {
+            auto bytes = CAST_PTR(const char, data);
+            while(size > 0) {
+                auto count = write(fd, bytes, size);
+                if(count < 0 and errno == EINTR)
+                    continue;
+                if(count <= 0)
+                    return false;
+                bytes += count;
+                size -= count;
+            }
+            return true;
+        }
+
+        // the length of the request is sent with the descriptors of the client.
+        static bool send_request(i32 connection, u32 length) {
+            i32 fds[NUM_DESCRIPTORS] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))];
+            std::memset(control, 0, sizeof(control));
+
+            iovec data{&length, sizeof(length)};
+            msghdr message;
+            std::memset(&message, 0, sizeof(message));
+            message.msg_iov = &data;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+
+            auto header = CMSG_FIRSTHDR(&message);
+            header->cmsg_level = SOL_SOCKET;
+            header->cmsg_type = SCM_RIGHTS;
+            header->cmsg_len = CMSG_LEN(sizeof(fds));
+            std::memcpy(CMSG_DATA(header), fds, sizeof(fds));
+
+            return sendmsg(connection, &message, 0) == sizeof(length);
+        }
+
+        static bool receive_request(i32 connection, u32& length, i32 (&fds)[NUM_DESCRIPTORS]) {
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))];
+            std::memset(control, 0, sizeof(control));
+
+            iovec data{&length, sizeof(length)};
+            msghdr message;
+            std::memset(&message, 0, sizeof(message));
+            message.msg_iov = &data;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+
+            if(recvmsg(connection, &message, MSG_WAITALL) != sizeof(length))
+                return false;
+
+            for(auto header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+                if(header->cmsg_level != SOL_SOCKET or header->cmsg_type != SCM_RIGHTS)
+                    continue;
+
+                auto count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(i32);
+                std::memcpy(fds, CMSG_DATA(header), std::min<u64>(count, NUM_DESCRIPTORS) * sizeof(i32));
+                if(count == NUM_DESCRIPTORS)
+                    return true;
+
+                // a client that sent the wrong number of descriptors isn't served.
+                for(u64 i = 0; i < std::min<u64>(count, NUM_DESCRIPTORS); ++i)
+                    close(fds[i]);
+                return false;
+            }
+            return false;
+        }
+#endif
+
+        Server::Server(Interpreter* interp) : interp(interp) {
+        }
+
+        bool Server::run() {
+#if defined(MU_APPLE) || defined(MU_LINUX)
+            // a client that goes away before its answer doesn't stop the server.
+            signal(SIGPIPE, SIG_IGN);
+
+            char cwd[PATH_MAX];
+            if(!getcwd(cwd, sizeof(cwd)))
+                return false;
+            directory = cwd;
+
+            sockaddr_un address;
+            if(!io::Path(SOCKET_PATH).parent_path().create_directory() or !socket_address(address)) {
+                interp->out_stream() << "Fatal Error: unable to make '" << SOCKET_PATH << "'" << std::endl;
+                return false;
+            }
+
+            auto listener = make_socket();
+            if(listener < 0)
+                return false;
+
+            if(bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                auto running = connect_server();
+                if(running >= 0) {
+                    close(running);
+                    close(listener);
+                    interp->out_stream() << "Fatal Error: a server is already running in '" << directory << "'" << std::endl;
+                    return false;
+                }
+
+                // the socket of a server that didn't stop is left behind.
+                unlink(SOCKET_PATH.c_str());
+                if(bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                    close(listener);
+                    interp->out_stream() << "Fatal Error: unable to bind '" << SOCKET_PATH << "'" << std::endl;
+                    return false;
+                }
+            }
+
+            if(listen(listener, 16) != 0) {
+                close(listener);
+                unlink(SOCKET_PATH.c_str());
+                return false;
+            }
+
+            // a program that traps or exits ends its own process instead of the server.
+            interp->set_isolate_programs(true);
+
+            interp->out_stream() << "serving '" << directory << "' on " << SOCKET_PATH << std::endl;
+            while(true) {
+                auto connection = accept(listener, nullptr, nullptr);
+                if(connection < 0) {
+                    if(errno == EINTR or errno == ECONNABORTED)
+                        continue;
+                    break;
+                }
+                fcntl(connection, F_SETFD, FD_CLOEXEC);
+
+                // one client is served at a time, one that stops sending is dropped.
+                timeval timeout{REQUEST_TIMEOUT, 0};
+                setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+                auto serving = serve(connection);
+                close(connection);
+                if(!serving)
+                    break;
+            }
+
+            close(listener);
+            unlink(SOCKET_PATH.c_str());
+            return true;
+#else
+            interp->out_stream() << "Fatal Error: the server needs unix domain sockets" << std::endl;
+            return false;
+#endif
+        }
+
+        bool Server::serve(i32 connection) {
+#if defined(MU_APPLE) || defined(MU_LINUX)
+            u32 length = 0;
+            i32 fds[NUM_DESCRIPTORS] = {-1, -1, -1};
+            if(!receive_request(connection, length, fds))
+                return true;
+
+            // the request is the working directory then the arguments, each ends with a '\0'.
+            std::string request(std::min(length, MAX_REQUEST), '\0');
+            if(length > MAX_REQUEST or !read_all(connection, request.data(), length)) {
+                for(auto fd : fds)
+                    close(fd);
+                return true;
+            }
+
+            std::vector<std::string> parts;
+            for(u64 start = 0; start < request.size();) {
+                auto end = request.find('\0', start);
+                if(end == std::string::npos)
+                    end = request.size();
+                parts.emplace_back(request, start, end - start);
+                start = end + 1;
+            }
+
+            auto cwd = parts.empty() ? std::string() : parts.front();
+            std::vector<std::string> args(parts.begin() + !parts.empty(), parts.end());
+
+            // the command writes to the descriptors of the client.
+            std::cout.flush();
+            std::fflush(stdout);
+            i32 saved[NUM_DESCRIPTORS];
+            for(u64 i = 0; i < NUM_DESCRIPTORS; ++i) {
+                saved[i] = dup(i);
+                dup2(fds[i], i);
+                close(fds[i]);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            i32 exit_code = 0;
+            bool serving = true;
+            if(cwd != directory) {
+                interp->out_stream() << "Fatal Error: the server serves '" << directory << "', not '" << cwd << "'" << std::endl;
+                exit_code = 1;
+            }
+            else if(!args.empty() and args.front() == "shutdown")
+                serving = false;
+            else if(!args.empty() and args.front() == "serve") {
+                interp->out_stream() << "Fatal Error: a server is already running in '" << directory << "'" << std::endl;
+                exit_code = 1;
+            }
+            else
+                exit_code = interp->request(args);
+            std::chrono::duration<f64> elapsed = std::chrono::steady_clock::now() - start;
+
+            std::cout.flush();
+            std::fflush(stdout);
+            for(u64 i = 0; i < NUM_DESCRIPTORS; ++i) {
+                dup2(saved[i], i);
+                close(saved[i]);
+            }
+
+            std::string command;
+            for(auto& arg : args)
+                command += (command.empty() ? "" : " ") + arg;
+            interp->out_stream() << Interpreter::format("'%s' exited with %d in %.3fs", command.c_str(), exit_code,
+                                                        elapsed.count()) << std::endl;
+
+            write_all(connection, &exit_code, sizeof(exit_code));
+            return serving;
+#else
+            return false;
+#endif
+        }
+
+        bool client(const std::vector<std::string>& args, i32& exit_code) {
+#if defined(MU_APPLE) || defined(MU_LINUX)
+            auto connection = connect_server();
+            if(connection < 0)
+                return false;
+
+            char cwd[PATH_MAX];
+            if(!getcwd(cwd, sizeof(cwd))) {
+                close(connection);
+                return false;
+            }
+
+            std::string request(cwd);
+            request.push_back('\0');
+            for(auto& arg : args) {
+                request += arg;
+                request.push_back('\0');
+            }
+
+            exit_code = 1;
+            if(!send_request(connection, CAST(u32, request.size())) or
+               !write_all(connection, request.data(), request.size()) or
+               !read_all(connection, &exit_code, sizeof(exit_code))) {
+                std::cerr << "Fatal Error: the server closed the connection" << std::endl;
+                exit_code = 1;
+            }
+            close(connection);
+            return true;
+#else
+            return false;
+#endif
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef MU_SERVER_HPP
+#define MU_SERVER_HPP
+
+#include "common.hpp"
+#include "interpreter.hpp"
+
+#include <string>
+#include <vector>
+
+namespace mu {
+    namespace serve {
+
+        // the socket of the server of a directory, relative to it.
+        const std::string SOCKET_PATH = ".mu-cache/serve.sock";
+
+        // Runs the commands of clients with the state of one interpreter, 'Mu serve'.
+        //
+        // A command starts from the names, prelude, file registry and resolved modules left by the
+        // ones before it, only the files that changed since are parsed and resolved again. The
+        // server listens on a unix domain socket in the directory it serves and runs one command
+        // at a time. The program of a run command runs in a child process, a trap ends the child.
+        //
+        // A client sends its working directory and arguments with its standard input, output and
+        // error. The command writes to the descriptors of the client, the server answers with
+        // the exit code once it is done. A client that doesn't send its request in time is dropped.
+        class Server {
+        public:
+            Server(Interpreter* interp);
+
+            // serves until a client sends 'shutdown', false if the socket can't be made.
+            bool run();
+
+        private:
+            // runs the request of a client, false when the server should stop.
+            bool serve(i32 connection);
+
+            Interpreter* interp;
+
+            // the directory being served, the working directory of every client.
+            std::string directory;
+        };
+
+        // sends the command of args to the server of the working directory and waits for it.
+        // Returns false when there isn't a server, the command hasn't been run.
+        bool client(const std::vector<std::string>& args, i32& exit_code);
+    }
+}
+
+#endif //MU_SERVER_HPP
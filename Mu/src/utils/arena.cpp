@@ -0,0 +1,71 @@
+#include "arena.hpp"
+#include <cstdlib>
+#include <cassert>
+
+namespace mem {
+    static thread_local Arena* current_arena = nullptr;
+
+    Arena::Arena(u64 block_size) : block_size(block_size) {
+    }
+
+    Arena::~Arena() {
+        clear();
+    }
+
+    inline char* align_up(char* ptr, u64 align) {
+        auto address = reinterpret_cast<uintptr_t>(ptr);
+        return ptr + ((align - (address & (align - 1))) & (align - 1));
+    }
+
+    void* Arena::allocate(u64 size, u64 align) {
+        assert((align & (align - 1)) == 0 and "alignment must be a power of two");
+
+        char* ptr = cursor ? align_up(cursor, align) : nullptr;
+        if(!ptr or ptr > limit or size > CAST(u64, limit - ptr)) {
+            new_block(size + align);
+            ptr = align_up(cursor, align);
+        }
+
+        cursor = ptr + size;
+        used += size;
+        allocations++;
+        return ptr;
+    }
+
+    void Arena::new_block(u64 min_size) {
+        // large allocations get a block of their own.
+        u64 size = min_size > block_size ? min_size : block_size;
+        auto data = CAST_PTR(char, std::malloc(size));
+        if(!data)
+            throw std::bad_alloc();
+
+        blocks.push_back({data, size});
+        cursor = data;
+        limit = data + size;
+    }
+
+    void Arena::clear() {
+        for(auto iter = finalizers.rbegin(); iter != finalizers.rend(); ++iter)
+            iter->destroy(iter->object);
+        finalizers.clear();
+
+        for(auto& block : blocks)
+            std::free(block.data);
+        blocks.clear();
+
+        cursor = limit = nullptr;
+        used = allocations = 0;
+    }
+
+    Arena* Arena::current() {
+        return current_arena;
+    }
+
+    Arena::Scope::Scope(Arena& arena) : previous(current_arena) {
+        current_arena = &arena;
+    }
+
+    Arena::Scope::~Scope() {
+        current_arena = previous;
+    }
+}
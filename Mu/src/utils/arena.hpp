@@ -0,0 +1,83 @@
+#pragma once
+
+#include "common.hpp"
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mem {
+
+    // Bump allocator. Memory is taken from large blocks and is only given back
+    // when the arena is destroyed, everything it owns is released in one step.
+    // Objects that need their destructors run are recorded and destroyed in
+    // the reverse order they were made.
+    class Arena {
+    public:
+        static const u64 DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        Arena(u64 block_size = DEFAULT_BLOCK_SIZE);
+
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator= (const Arena&) = delete;
+
+        void* allocate(u64 size, u64 align);
+
+        template <typename T>
+        T* allocate_array(u64 count) {
+            return CAST_PTR(T, allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        template <typename T, typename... Args>
+        T* make(Args&&... args) {
+            auto object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            if constexpr (!std::is_trivially_destructible<T>::value)
+                finalizers.push_back({object, [](void* ptr) { CAST_PTR(T, ptr)->~T(); }});
+            return object;
+        }
+
+        // destroys every object and frees all of the blocks.
+        void clear();
+
+        inline u64 bytes_used() { return used; }
+        inline u64 num_allocations() { return allocations; }
+        inline u64 num_blocks() { return blocks.size(); }
+
+        // the arena that nodes are made in on this thread, nullptr if there isn't one.
+        static Arena* current();
+
+        // makes an arena current until the scope is left.
+        class Scope {
+        public:
+            Scope(Arena& arena);
+            ~Scope();
+
+        private:
+            Arena* previous;
+        };
+
+    private:
+        struct Block {
+            char* data;
+            u64 size;
+        };
+
+        struct Finalizer {
+            void* object;
+            void (*destroy)(void*);
+        };
+
+        void new_block(u64 min_size);
+
+        std::vector<Block> blocks;
+        std::vector<Finalizer> finalizers;
+        char* cursor{nullptr};
+        char* limit{nullptr};
+        u64 block_size;
+
+        u64 used{0};
+        u64 allocations{0};
+    };
+}
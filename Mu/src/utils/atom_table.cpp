@@ -0,0 +1,90 @@
+#include "atom_table.hpp"
+#include <cstring>
+
+const u64 INITIAL_SLOTS = 128;
+
+AtomTable::AtomTable() = default;
+
+AtomTable::Shard::Shard() : slots(INITIAL_SLOTS, Slot{0, nullptr}) {
+}
+
+const u64 HASH_MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+
+inline u64 hash_mix(u64 h, u64 word) {
+    h = (h ^ word) * HASH_MULTIPLIER;
+    return h ^ (h >> 32);
+}
+
+u64 AtomTable::hash(std::string_view name) {
+    auto ch = name.data();
+    auto length = name.size();
+    u64 h = length * HASH_MULTIPLIER;
+
+    for(; length >= 8; ch += 8, length -= 8) {
+        u64 word;
+        std::memcpy(&word, ch, 8);
+        h = hash_mix(h, word);
+    }
+
+    if(length) {
+        u64 word = 0;
+        std::memcpy(&word, ch, length);
+        h = hash_mix(h, word);
+    }
+
+    // the low bits index the table so they need to depend on every character.
+    h ^= h >> 29;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    return h ^ (h >> 32);
+}
+
+Atom* AtomTable::find(std::string_view name, u64 hash) {
+    // the low bits of the hash index the slots, the high bits pick the shard.
+    auto& shard = shards[hash >> (64 - SHARD_BITS)];
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    auto& slots = shard.slots;
+    u64 mask = slots.size() - 1;
+    u64 index = hash & mask;
+
+    // linear probing, the table is never more than 3/4 full so an empty slot will be found.
+    while(slots[index].atom) {
+        auto& slot = slots[index];
+        if(slot.hash == hash and slot.atom->value == name)
+            return slot.atom;
+        index = (index + 1) & mask;
+    }
+
+    auto atom = &shard.atoms.emplace_back(std::string(name));
+    slots[index] = Slot{hash, atom};
+
+    if(++shard.count * 4 > slots.size() * 3)
+        shard.grow();
+
+    return atom;
+}
+
+u64 AtomTable::size() {
+    u64 count = 0;
+    for(auto& shard : shards) {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        count += shard.count;
+    }
+    return count;
+}
+
+void AtomTable::Shard::grow() {
+    std::vector<Slot> old(slots.size() * 2, Slot{0, nullptr});
+    old.swap(slots);
+
+    u64 mask = slots.size() - 1;
+    for(auto& slot : old) {
+        if(!slot.atom)
+            continue;
+
+        u64 index = slot.hash & mask;
+        while(slots[index].atom)
+            index = (index + 1) & mask;
+        slots[index] = slot;
+    }
+}
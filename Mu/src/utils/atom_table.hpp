@@ -0,0 +1,56 @@
+#pragma once
+
+#include "common.hpp"
+#include <deque>
+#include <mutex>
+#include <string_view>
+
+// Interning table for identifiers.
+//
+// Lookups are done with a string_view into the source, so a name that
+// has already been seen doesn't allocate or copy.
+//
+// The table is safe to use from several threads. It is split into shards,
+// selected by the high bits of the hash, that are each guarded by their own
+// lock so scanners running in parallel rarely wait on each other.
+class AtomTable {
+public:
+    AtomTable();
+
+    // hashes eight characters at a time, identifiers are short so this
+    // is usually one or two multiplies.
+    static u64 hash(std::string_view name);
+
+    // finds the atom of name, creating it if it doesn't exist.
+    // hash must be the result of AtomTable::hash(name).
+    Atom* find(std::string_view name, u64 hash);
+
+    inline Atom* find(std::string_view name) { return find(name, hash(name)); }
+
+    u64 size();
+
+private:
+    struct Slot {
+        u64 hash;
+        Atom* atom;
+    };
+
+    struct Shard {
+        Shard();
+
+        void grow();
+
+        std::mutex lock;
+
+        // slots.size() is always a power of two.
+        std::vector<Slot> slots;
+        u64 count{0};
+
+        // atoms are never moved once created.
+        std::deque<Atom> atoms;
+    };
+
+    static const u64 SHARD_BITS = 4;
+
+    Shard shards[1 << SHARD_BITS];
+};
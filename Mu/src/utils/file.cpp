@@ -1,4 +1,5 @@
 #include "file.hpp"
+#include "parser/scanner/scan_kernels.hpp"
 #include <cstdio>
 #include <iostream>
 
@@ -6,13 +7,42 @@
 #include <fstream>
 
 
+#include <algorithm>
 #include <functional>
+#include <mutex>
+
+#if defined(MU_APPLE) || defined(MU_LINUX)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
 
 namespace io {
-    File::File(const Path &p) : IO(io::IOFile, p) {
+    // the part of the offset space given to one load of a file.
+    struct Range {
+        u32 base;
+        u32 size;
+        File* file;
+    };
+
+    // the list is kept sorted by base. Files are loaded by the workers of build-all, the lock
+    // guards the list, the next base and the space used.
+    static std::mutex range_lock;
+    static std::vector<Range> ranges;
+
+    // no file is placed at zero, it is the offset of a position that isn't in a file.
+    static u64 next_base = 1;
+
+    // the size of the ranges in the list. The rest of the space below next_base was given to
+    // files that have been unloaded since, a server reloads files for as long as it runs.
+    static u64 used = 0;
+
+    File::File(const Path &p, LoadMode mode) : IO(io::IOFile, p), mode(mode) {
     }
 
     File::~File() {
+        unload();
     }
 
     std::string File::extention() {
@@ -25,59 +55,224 @@ namespace io {
         if(kind() != io::IOFile)
             return false;
 
+        if(loaded)
+            return true;
+
+        // taken before the content is read, a change made while it is read is seen by changed().
+        restamp();
+
+        if(mode == LoadMapped and load_mapped())
+            loaded = true;
+        else
+            loaded = load_copy();
+
+        if(loaded and !place())
+            unload();
+
+        return loaded;
+    }
+
+    bool File::load_mapped() {
+#if defined(MU_APPLE) || defined(MU_LINUX)
+        auto abs = absolute_path().string();
+        auto fd = open(abs.c_str(), O_RDONLY);
+        if(fd < 0)
+            return false;
+
+        struct stat info;
+        if(fstat(fd, &info) != 0) {
+            close(fd);
+            return false;
+        }
+
+        // the bytes following the end of the file in the last page are zero, this
+        // is used as the sentinel. If the file fills the last page (or is empty)
+        // there isn't one so the file is copied instead.
+        u64 size = info.st_size;
+        u64 page_size = sysconf(_SC_PAGESIZE);
+        if(size == 0 or size % page_size == 0) {
+            close(fd);
+            return false;
+        }
+
+        auto addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if(addr == MAP_FAILED)
+            return false;
+
+        mapped = CAST_PTR(const char, addr);
+        mapped_size = size;
+        text = std::string_view(mapped, mapped_size);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool File::load_copy() {
         auto abs = absolute_path().string();
-        std::ifstream iis(abs);
+        std::ifstream iis(abs, std::ios::binary);
         if(iis) {
-            std::stringstream ss;
-            ss << iis.rdbuf();
-            content = ss.str();
+            iis.seekg(0, std::ios::end);
+            auto size = iis.tellg();
+            if(size < 0)
+                return false;
+            iis.seekg(0, std::ios::beg);
+
+            // read directly into the content, std::string provides the sentinel.
+            content.resize(size);
+            iis.read(&content[0], size);
+            content.resize(iis.gcount());
+
+            text = std::string_view(content);
             return true;
         }
         return false;
     }
 
-    const std::string &File::value() {
-        return content;
+    void File::unload() {
+#if defined(MU_APPLE) || defined(MU_LINUX)
+        if(mapped)
+            munmap(const_cast<char*>(mapped), mapped_size);
+#endif
+        mapped = nullptr;
+        mapped_size = 0;
+
+        content.clear();
+        content.shrink_to_fit();
+
+        text = std::string_view();
+        line_starts.clear();
+        loaded = false;
+        displace();
     }
 
-    bool File::has_line(u64 line) {
-        return false;
+    bool File::changed() {
+        u64 time = 0, size = 0;
+        if(!loaded or !stat_file(time, size))
+            return true;
+        return time != stamp_time or size != stamp_size;
     }
 
-    bool File::cache_has_line(u64 line) {
-        return line <= line_cache.size();
+    void File::restamp() {
+        if(!stat_file(stamp_time, stamp_size))
+            stamp_time = stamp_size = 0;
     }
 
-    void File::build_cache_to(u64 line) {
-        if(line_cache.empty()) {
-            u64 index = 0;
-            u64 start = index;
+    bool File::stat_file(u64& time, u64& size) {
+#if defined(MU_APPLE) || defined(MU_LINUX)
+        struct stat info;
+        if(stat(absolute_path().string().c_str(), &info) != 0)
+            return false;
+
+    #if defined(MU_APPLE)
+        time = info.st_mtimespec.tv_sec * 1000000000ull + info.st_mtimespec.tv_nsec;
+    #else
+        time = info.st_mtim.tv_sec * 1000000000ull + info.st_mtim.tv_nsec;
+    #endif
+        size = info.st_size;
+        return true;
+#else
+        // without the time every check of the file hashes its content.
+        return false;
+#endif
+    }
 
-            while(index < content.size() and content[index] != '\n')
-                index++;
+    bool File::place() {
+        std::lock_guard<std::mutex> lock(range_lock);
+        u64 size = text.size() + 1;
+        u64 base = next_base;
+        auto position = ranges.end();
 
-            line_cache.push_back(LineInfo {content.substr(start, index - start), start, index});
+        // the first gap left by unloaded files that is large enough is reused, the list is
+        // only searched when the gaps add up to the size.
+        if(next_base - 1 - used >= size) {
+            u64 end = 1;
+            for(auto iter = ranges.begin(); iter != ranges.end(); ++iter) {
+                if(end + size <= iter->base) {
+                    base = end;
+                    position = iter;
+                    break;
+                }
+                end = u64(iter->base) + iter->size;
+            }
         }
 
-        const LineInfo& lineInfo = line_cache.back();
-        u64 startIndex = lineInfo.end + 1;
+        if(base + size > UINT32_MAX)
+            return false;
+
+        if(position == ranges.end())
+            next_base = base + size;
+        start = CAST(u32, base);
+        ranges.insert(position, Range {start, CAST(u32, size), this});
+        used += size;
+        return true;
+    }
 
-        u64 start = startIndex;
+    void File::displace() {
+        std::lock_guard<std::mutex> lock(range_lock);
+        for(auto& range : ranges)
+            if(range.file == this)
+                used -= range.size;
+        ranges.erase(std::remove_if(ranges.begin(), ranges.end(), [this](const Range& range) {
+            return range.file == this;
+        }), ranges.end());
 
-        while(line_cache.size() < line) {
-            while(startIndex < content.size() and content[startIndex] != '\n')
-                startIndex++;
-            line_cache.push_back(LineInfo {content.substr(start, startIndex - start), start, startIndex});
-            start = ++startIndex;
-        }
+        // the space after the last range is free again.
+        next_base = ranges.empty() ? 1 : u64(ranges.back().base) + ranges.back().size;
+    }
+
+    File* File::at(u32 offset) {
+        std::lock_guard<std::mutex> lock(range_lock);
+        auto range = std::upper_bound(ranges.begin(), ranges.end(), offset, [](u32 offset, const Range& range) {
+            return offset < range.base;
+        });
+        if(range == ranges.begin())
+            return nullptr;
+        --range;
+        return offset - range->base < range->size ? range->file : nullptr;
     }
 
-    const std::string &File::get_line(u64 line) {
-        if(cache_has_line(line))
-            return line_cache[line - 1].line;
+    std::string_view File::value() {
+        return text;
+    }
+
+    void File::build_lines() {
+        if(!line_starts.empty())
+            return;
+
+        // the text is followed by a '\0' sentinel, the kernel stops at it or a new line. The
+        // search continues past a '\0' in the text.
+        auto kernels = &mu::scan_kernels();
+        auto begin = text.data();
+        auto end = begin + text.size();
+        line_starts.push_back(0);
+        if(text.empty())
+            return;
+        for(auto ch = kernels->find_line_end(begin); ch < end; ch = kernels->find_line_end(ch + 1))
+            if(*ch == '\n')
+                line_starts.push_back(CAST(u32, ch - begin + 1));
+    }
+
+    bool File::has_line(u64 line) {
+        build_lines();
+        return line >= 1 and line <= line_starts.size();
+    }
+
+    LineColumn File::line_column(u32 offset) {
+        build_lines();
+        u64 local = offset - start;
+        auto line = std::upper_bound(line_starts.begin(), line_starts.end(), local) - 1;
+        return LineColumn {CAST(u64, line - line_starts.begin()) + 1, local - *line + 1};
+    }
 
-        build_cache_to(line);
+    std::string_view File::get_line(u64 line) {
+        if(!has_line(line))
+            return std::string_view();
 
-        return line_cache[line - 1].line;
+        u64 first = line_starts[line - 1];
+        u64 last = line < line_starts.size() ? line_starts[line] - 1 : text.size();
+        return text.substr(first, last - first);
     }
 }
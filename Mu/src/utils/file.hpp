@@ -2,13 +2,24 @@
 
 #include "common.hpp"
 #include "io.hpp"
+#include <string_view>
 
 // it is assumed this class is given the absolute path of the file.
 
 namespace io {
+    enum LoadMode {
+        LoadMapped, // map the file read only, falls back to LoadCopy when it isn't possible.
+        LoadCopy,   // read the file into memory.
+    };
+
+    struct LineColumn {
+        u64 line;
+        u64 column;
+    };
+
 	class File : public IO {
     public:
-        File(const Path& p);
+        File(const Path& p, LoadMode mode = LoadMapped);
 
         virtual ~File();
 
@@ -16,24 +27,72 @@ namespace io {
 
         virtual bool load();
 
-        const std::string& value();
+        // releases the content of the file.
+        void unload();
+
+        // the content of the file. The view is always followed by a '\0' sentinel,
+        // so value().data()[value().size()] can be read.
+        std::string_view value();
+
+        inline bool is_mapped() { return mapped != nullptr; }
 
-        const std::string& get_line(u64 line);
+        // every load of a file is given the next range of an offset space shared by all of the files,
+        // a position is an offset into it. The range covers the content and the sentinel.
+        inline u32 base() { return start; }
+
+        // the file whose range has the offset, nullptr when the offset isn't in a loaded file.
+        static File* at(u32 offset);
+
+        // the line and column, from 1, of an offset in the range of this file. The line is found
+        // with a binary search of the line table.
+        LineColumn line_column(u32 offset);
+
+        // the text of a line, from 1, without its new line. It refers to the content of the file.
+        std::string_view get_line(u64 line);
 
         bool has_line(u64 line);
 
+        // whether the modification time or size of the file on disk differ from when it was
+        // loaded, the content isn't read. A file that isn't loaded has changed.
+        bool changed();
+
+        // takes the modification time and size on disk as those of the loaded content,
+        // for a file that was touched without changing its content.
+        void restamp();
+
     private:
+        bool load_mapped();
+
+        bool load_copy();
+
+        // gives the loaded content a range of the offset space, fails when there is no space left.
+        // The space of files that were unloaded is given out again.
+        bool place();
+
+        // removes the ranges given to this file, their space can be placed again.
+        void displace();
 
-		struct LineInfo {
-			std::string line;
-			u64 start, end;
-		};
+        LoadMode mode;
+
+        // only one of these are used depending on how the file was loaded.
         std::string content;
+        const char* mapped{nullptr};
+        u64 mapped_size{0};
+
+        std::string_view text;
+        u32 start{0};
+
+        // the modification time, in nanoseconds, and the size of the file on disk.
+        bool stat_file(u64& time, u64& size);
 
-		bool cache_has_line(u64 line);
+        // the time and size of the file when its content was loaded.
+        u64 stamp_time{0};
+        u64 stamp_size{0};
 
-		void build_cache_to(u64 line);
+        // finds the start of every line the first time a line is needed.
+        void build_lines();
 
-        std::vector<LineInfo> line_cache;
+        // the offset of the first character of each line, built once per load.
+        std::vector<u32> line_starts;
 	};
 }
@@ -0,0 +1,195 @@
+#include "file_registry.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+
+#if defined(MU_APPLE) || defined(MU_LINUX)
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/stat.h>
+#endif
+
+#if defined(MU_LINUX)
+    #include <sys/syscall.h>
+#endif
+
+namespace io {
+    enum EntryKind {
+        EntryFile,
+        EntryDirectory,
+        EntryOther,
+    };
+
+    static EntryKind entry_kind(int dir, const char* name, u8 type) {
+        switch(type) {
+            case DT_REG: return EntryFile;
+            case DT_DIR: return EntryDirectory;
+            case DT_UNKNOWN: {
+                // some file systems don't fill in the type, the entry is looked at instead.
+                struct stat info;
+                if(fstatat(dir, name, &info, AT_SYMLINK_NOFOLLOW) != 0)
+                    return EntryOther;
+                if(S_ISREG(info.st_mode))
+                    return EntryFile;
+                return S_ISDIR(info.st_mode) ? EntryDirectory : EntryOther;
+            }
+            default:
+                return EntryOther;
+        }
+    }
+
+#if defined(MU_LINUX)
+    // calls visit for every entry of an open directory. The entries are read a buffer at
+    // a time straight from the kernel, there is no allocation per entry. Each record has the
+    // layout of dirent64, d_name ends at d_reclen rather than at the size of the struct.
+    static void read_entries(int dir, const std::function<void(const char*, EntryKind)>& visit) {
+        alignas(8) char buffer[32 * 1024];
+        while(true) {
+            auto count = syscall(SYS_getdents64, dir, buffer, sizeof(buffer));
+            if(count <= 0)
+                return;
+
+            for(long offset = 0; offset < count;) {
+                auto entry = reinterpret_cast<dirent64*>(buffer + offset);
+                offset += entry->d_reclen;
+                visit(entry->d_name, entry_kind(dir, entry->d_name, entry->d_type));
+            }
+        }
+    }
+#elif defined(MU_APPLE)
+    static void read_entries(int dir, const std::function<void(const char*, EntryKind)>& visit) {
+        auto handle = fdopendir(dup(dir));
+        if(!handle)
+            return;
+        while(auto entry = readdir(handle))
+            visit(entry->d_name, entry_kind(dir, entry->d_name, entry->d_type));
+        closedir(handle);
+    }
+#endif
+
+    FileRegistry& FileRegistry::get() {
+        static auto registry = new FileRegistry();
+        return *registry;
+    }
+
+    bool FileRegistry::walk(const Path& root, bool only_source, u64 num_jobs) {
+        if(walked)
+            return true;
+        walked = true;
+
+        top = root.string();
+        this->only_source = only_source;
+        this->num_jobs = num_jobs;
+        if(!root.is_directory()) {
+            std::cout << "Path doesn't exist: " << root.get_absolute().string() << std::endl;
+            return false;
+        }
+
+        auto relative = scan();
+        files.reserve(relative.size());
+        paths.reserve(relative.size());
+        for(auto& path : relative)
+            sources.push_back(add(path));
+        return true;
+    }
+
+    void FileRegistry::rescan() {
+        if(!walked)
+            return;
+
+        // a file that is found again keeps its id, the new files are given the next ones.
+        auto relative = scan();
+        std::unordered_map<std::string, File*> previous;
+        previous.swap(paths);
+        sources.clear();
+        for(auto& path : relative) {
+            auto iter = previous.find(path);
+            if(iter != previous.end()) {
+                paths.emplace(path, iter->second);
+                sources.push_back(iter->second);
+            }
+            else
+                sources.push_back(add(path));
+        }
+    }
+
+    std::vector<std::string> FileRegistry::scan() {
+        // each worker keeps the paths it finds, relative to the root, they are merged after.
+        std::vector<std::vector<std::string>> found;
+        {
+            ThreadPool pool(num_jobs);
+            found.resize(pool.size());
+
+            std::function<void(u64, std::string)> read_directory;
+            read_directory = [&](u64 worker, std::string relative) {
+                auto path = relative.empty() ? top : top + "/" + relative;
+                auto dir = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+                if(dir < 0)
+                    return;
+
+                read_entries(dir, [&](const char* name, EntryKind kind) {
+                    if(name[0] == '.')
+                        return;
+
+                    auto entry = relative.empty() ? std::string(name) : relative + "/" + name;
+                    if(kind == EntryDirectory)
+                        pool.submit([&read_directory, entry](u64 worker) { read_directory(worker, entry); });
+                    else if(kind == EntryFile) {
+                        auto ext = std::string_view(name).find_last_of('.');
+                        if(only_source and (ext == std::string_view::npos or
+                                            std::string_view(name).substr(ext + 1) != EXTENSION_NAME.string()))
+                            return;
+                        found[worker].push_back(std::move(entry));
+                    }
+                });
+                close(dir);
+            };
+
+            pool.submit([&read_directory](u64 worker) { read_directory(worker, std::string()); });
+            pool.wait();
+        }
+
+        std::vector<std::string> relative;
+        for(auto& paths : found)
+            relative.insert(relative.end(), std::make_move_iterator(paths.begin()), std::make_move_iterator(paths.end()));
+        std::sort(relative.begin(), relative.end());
+        return relative;
+    }
+
+    File* FileRegistry::add(const std::string& path) {
+        // the path of a file keeps the root, as it is shown in diagnostics.
+        auto file = std::make_unique<File>(Path(top + "/" + path));
+        file->uid = files.size();
+        paths.emplace(path, file.get());
+        files.push_back(std::move(file));
+        return files.back().get();
+    }
+
+    File* FileRegistry::find(std::string_view path) {
+        auto iter = paths.find(normalize(path));
+        return iter == paths.end() ? nullptr : iter->second;
+    }
+
+    void FileRegistry::collect_sources(std::vector<File*>& sources) {
+        for(auto file : this->sources) {
+            if(file->path().extension().string() == EXTENSION_NAME.string())
+                sources.push_back(file);
+        }
+    }
+
+    std::string FileRegistry::normalize(std::string_view path) {
+        std::string key;
+        key.reserve(path.size());
+        while(path.substr(0, 2) == "./")
+            path.remove_prefix(2);
+        for(auto ch : path) {
+            if(ch == DIR_SEP and !key.empty() and key.back() == DIR_SEP)
+                continue;
+            key.push_back(ch);
+        }
+        return key;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "common.hpp"
+#include "file.hpp"
+#include "io.hpp"
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace io {
+    // Every source file under the root directory, found by a single walk of the tree when the
+    // interpreter starts. The id of a file is its index in the registry and its path relative
+    // to the root is hashed, so a file is found by either in constant time.
+    //
+    // The ids of the first walk follow the order of the paths, they don't depend on the order
+    // the walk found them in.
+    class FileRegistry {
+    public:
+        // the registry of the process. It is never destroyed, positions printed while the
+        // process exits still find their files.
+        static FileRegistry& get();
+
+        // walks the tree under root with a thread pool, a directory is read by one task.
+        // Directories and files whose name starts with '.' and symbolic links are skipped.
+        // Only the first call walks the tree.
+        bool walk(const Path& root, bool only_source = true, u64 num_jobs = 0);
+
+        // walks the root of the first walk again, for a process that outlives changes to the tree.
+        // A file that is still there keeps its id and object, a new file is given the next id.
+        // A file that was removed can't be found by its path, its id stays valid.
+        void rescan();
+
+        inline File* find(u64 id) { return id < files.size() ? files[id].get() : nullptr; }
+
+        // the file with a path relative to the root, nullptr when it wasn't found by the walk.
+        File* find(std::string_view path);
+
+        inline u64 size() { return files.size(); }
+
+        // the source files found by the last walk in the order of their paths.
+        void collect_sources(std::vector<File*>& sources);
+
+    private:
+        // the paths under the root relative to it, sorted.
+        std::vector<std::string> scan();
+
+        // gives the file at a path relative to the root the next id.
+        File* add(const std::string& path);
+
+        // the key of a path, "./a//b.mu" and "a/b.mu" are the same file.
+        static std::string normalize(std::string_view path);
+
+        std::vector<std::unique_ptr<File>> files;
+        std::unordered_map<std::string, File*> paths;
+        // the files of the last walk, ordered by path.
+        std::vector<File*> sources;
+
+        std::string top;
+        bool only_source{true};
+        u64 num_jobs{0};
+        bool walked{false};
+    };
+}
@@ -124,6 +124,17 @@ bool io::Path::is_directory() {
     return const_cast<const Path&>(*this).is_directory();
 }
 
+bool io::Path::create_directory() const {
+    if(is_directory())
+        return true;
+
+    #if defined(MU_APPLE) || defined(MU_LINUX)
+    return mkdir(path.c_str(), 0755) == 0 or errno == EEXIST;
+    #else
+    return CreateDirectoryA(path.c_str(), nullptr) or GetLastError() == ERROR_ALREADY_EXISTS;
+    #endif
+}
+
 bool io::Path::is_file() const {
     #if defined(MU_APPLE) || defined(MU_LINUX)
     auto dir = opendir(path.c_str());
@@ -50,6 +50,9 @@ namespace io {
 
         void remove_filename();
 
+        // creates the directory of this path if it doesn't exist, the parent must exist.
+        bool create_directory() const;
+
         Path parent_path() const;
         Path parent_path();
 
@@ -92,6 +95,9 @@ namespace io {
 
         static u64 hash_name(const std::string& filename);
     private:
+        // a file found by the registry is given its index as its id.
+        friend class FileRegistry;
+
         FileKind k;         /// the type of io this is.
         Path n;         /// the name of the entity
         Path p;         /// the path of the entity
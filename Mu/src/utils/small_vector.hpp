@@ -0,0 +1,148 @@
+#pragma once
+
+#include "common.hpp"
+#include "arena.hpp"
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+namespace mem {
+
+    // Vector with room for N elements inside of itself. When it grows past that
+    // the elements are moved into the arena it was made with, the old storage
+    // is never freed, it goes away with the arena.
+    //
+    // This is meant for the child lists of AST nodes, where most lists are short
+    // and the nodes themselves live in the arena. Only types that can be copied
+    // with memcpy are allowed so the vector never has to destroy anything.
+    template <typename T, u32 N = 2>
+    class SmallVector {
+        static_assert(std::is_trivially_copyable<T>::value and std::is_trivially_destructible<T>::value,
+                      "SmallVector elements must be trivially copyable");
+    public:
+        typedef T value_type;
+        typedef T* iterator;
+        typedef const T* const_iterator;
+
+        SmallVector(Arena* arena = Arena::current()) : arena(arena) {
+        }
+
+        SmallVector(const std::vector<T>& values, Arena* arena = Arena::current()) : arena(arena) {
+            assign(values.data(), values.size());
+        }
+
+        SmallVector(std::initializer_list<T> values, Arena* arena = Arena::current()) : arena(arena) {
+            assign(values.begin(), values.size());
+        }
+
+        SmallVector(const SmallVector& other) : arena(other.arena) {
+            assign(other.data(), other.size());
+        }
+
+        // elements that have spilled into the arena are taken instead of copied.
+        SmallVector(SmallVector&& other) noexcept : arena(other.arena) {
+            if(other.elements) {
+                elements = other.elements;
+                count = other.count;
+                cap = other.cap;
+                other.elements = nullptr;
+                other.count = 0;
+                other.cap = N;
+            }
+            else
+                assign(other.data(), other.size());
+        }
+
+        SmallVector& operator= (const SmallVector& other) {
+            if(this != &other) {
+                count = 0;
+                assign(other.data(), other.size());
+            }
+            return *this;
+        }
+
+        SmallVector& operator= (SmallVector&& other) noexcept {
+            if(this != &other) {
+                if(other.elements and other.arena == arena) {
+                    elements = other.elements;
+                    count = other.count;
+                    cap = other.cap;
+                    other.elements = nullptr;
+                    other.count = 0;
+                    other.cap = N;
+                }
+                else {
+                    count = 0;
+                    assign(other.data(), other.size());
+                }
+            }
+            return *this;
+        }
+
+        SmallVector& operator= (const std::vector<T>& values) {
+            count = 0;
+            assign(values.data(), values.size());
+            return *this;
+        }
+
+        inline u64 size() const { return count; }
+        inline bool empty() const { return count == 0; }
+        inline u64 capacity() const { return cap; }
+
+        inline T* data() { return elements ? elements : local; }
+        inline const T* data() const { return elements ? elements : local; }
+
+        inline iterator begin() { return data(); }
+        inline iterator end() { return data() + count; }
+        inline const_iterator begin() const { return data(); }
+        inline const_iterator end() const { return data() + count; }
+
+        inline T& operator[] (u64 index) { return data()[index]; }
+        inline const T& operator[] (u64 index) const { return data()[index]; }
+
+        inline T& front() { return data()[0]; }
+        inline T& back() { return data()[count - 1]; }
+        inline const T& front() const { return data()[0]; }
+        inline const T& back() const { return data()[count - 1]; }
+
+        void push_back(const T& value) {
+            if(count == cap)
+                reserve(cap * 2);
+            data()[count++] = value;
+        }
+
+        void pop_back() {
+            --count;
+        }
+
+        void clear() {
+            count = 0;
+        }
+
+        void reserve(u64 n) {
+            if(n <= cap)
+                return;
+
+            assert(arena and "SmallVector grew without an arena");
+            auto storage = arena->allocate_array<T>(n);
+            std::memcpy(storage, data(), sizeof(T) * count);
+            elements = storage;
+            cap = n;
+        }
+
+    private:
+        void assign(const T* values, u64 n) {
+            reserve(n);
+            if(n)
+                std::memcpy(data(), values, sizeof(T) * n);
+            count = n;
+        }
+
+        T* elements{nullptr}; /// arena storage, nullptr while the elements fit in local
+        u64 count{0};
+        u64 cap{N};
+        Arena* arena;
+        T local[N];
+    };
+}
@@ -0,0 +1,91 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(u64 num_workers) {
+    if(num_workers == 0)
+        num_workers = std::max(1u, std::thread::hardware_concurrency());
+
+    for(u64 i = 0; i < num_workers; ++i)
+        queues.push_back(std::make_unique<Queue>());
+
+    for(u64 i = 0; i < num_workers; ++i)
+        threads.emplace_back([this, i]() { run(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    work_ready.notify_all();
+
+    for(auto& thread : threads)
+        thread.join();
+}
+
+void ThreadPool::submit(Task task) {
+    {
+        // the counts are changed under the lock so a worker going to sleep can not miss them.
+        std::lock_guard<std::mutex> guard(lock);
+        auto& queue = *queues[next_queue];
+        next_queue = (next_queue + 1) % queues.size();
+
+        std::lock_guard<std::mutex> queue_guard(queue.lock);
+        queue.tasks.push_back(std::move(task));
+        ++pending;
+        ++queued;
+    }
+    work_ready.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> guard(lock);
+    work_done.wait(guard, [this]() { return pending == 0; });
+}
+
+void ThreadPool::run(u64 worker) {
+    Task task;
+    while(true) {
+        if(take(worker, task)) {
+            task(worker);
+            task = nullptr;
+
+            std::lock_guard<std::mutex> guard(lock);
+            if(--pending == 0)
+                work_done.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(lock);
+        work_ready.wait(guard, [this]() { return stopping or queued > 0; });
+        if(stopping and queued == 0)
+            return;
+    }
+}
+
+bool ThreadPool::take(u64 worker, Task& task) {
+    auto n = queues.size();
+
+    // the worker's own queue is used like a stack, the most recent task is the most likely
+    // to still be in cache. Other queues are stolen from the opposite end.
+    for(u64 i = 0; i < n; ++i) {
+        auto& queue = *queues[(worker + i) % n];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if(queue.tasks.empty())
+            continue;
+
+        if(i == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        --queued;
+        return true;
+    }
+    return false;
+}
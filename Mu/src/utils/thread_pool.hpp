@@ -0,0 +1,61 @@
+#pragma once
+
+#include "common.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// A fixed set of worker threads with a work-stealing scheduler.
+//
+// Every worker owns a queue. Tasks are dealt out to the queues round robin,
+// a worker runs the tasks of its own queue newest first and when it runs dry
+// it steals the oldest task of another worker. This keeps every core busy
+// when the tasks are uneven, such as files of very different sizes.
+class ThreadPool {
+public:
+    // the index of the worker running the task, in [0, size()).
+    // this is used to give each worker its own state.
+    typedef std::function<void(u64)> Task;
+
+    // a num_workers of 0 uses one worker per hardware thread.
+    ThreadPool(u64 num_workers = 0);
+
+    // waits for the submitted tasks then joins the workers.
+    ~ThreadPool();
+
+    inline u64 size() { return threads.size(); }
+
+    void submit(Task task);
+
+    // blocks until every submitted task has finished.
+    void wait();
+
+private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    void run(u64 worker);
+
+    // takes a task from the worker's own queue, otherwise steals one.
+    bool take(u64 worker, Task& task);
+
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<Queue>> queues;
+
+    std::mutex lock;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+
+    // tasks in a queue and tasks not yet finished.
+    std::atomic<u64> queued{0};
+    u64 pending{0};
+
+    u64 next_queue{0};
+    bool stopping{false};
+};
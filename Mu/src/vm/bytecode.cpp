@@ -0,0 +1,167 @@
+#include "bytecode.hpp"
+#include "analysis/entity.hpp"
+#include "analysis/types/type.hpp"
+
+#include <iomanip>
+
+static const char* opcode_names[] = {
+#define OPCODE(n, s, ...) s,
+    OPCODES
+#undef OPCODE
+};
+
+static const mu::vm::Format opcode_formats[] = {
+#define OPCODE(n, s, f) mu::vm::f,
+    OPCODES
+#undef OPCODE
+};
+
+// mutable only qualifies a type, it is stored the same as the type it qualifies.
+static mu::types::Type* strip(mu::types::Type* type) {
+    while(type and type->kind() == mu::types::MutableType)
+        type = type->as<mu::types::Mutable>()->get_inner();
+    return type;
+}
+
+namespace mu {
+    namespace vm {
+
+        const char* opcode_name(Opcode op) {
+            return opcode_names[op];
+        }
+
+        Format opcode_format(Opcode op) {
+            return opcode_formats[op];
+        }
+
+        i64 num_registers(types::Type *type, bool pointers) {
+            type = strip(type);
+            if(!type)
+                return -1;
+
+            if(type->is_primative() or (pointers and type->is_ptr()))
+                return 1;
+
+            i64 count = 0;
+            switch(type->kind()) {
+                case types::Unit_Type:
+                    return 0;
+                case types::TupleType: {
+                    auto tuple = type->as<types::Tuple>();
+                    for(u64 i = 0; i < tuple->num_elements(); ++i) {
+                        auto element = num_registers(tuple->get_element_type(i), pointers);
+                        if(element < 0)
+                            return -1;
+                        count += element;
+                    }
+                    return count;
+                }
+                case types::StructureType: {
+                    auto structure = type->as<types::StructType>();
+                    for(u64 i = 0; i < structure->num_members(); ++i) {
+                        auto member = num_registers(structure->get_member(i)->get_type(), pointers);
+                        if(member < 0)
+                            return -1;
+                        count += member;
+                    }
+                    return count;
+                }
+                case types::ArrayType: {
+                    auto array = type->as<types::Array>();
+                    auto element = num_registers(array->get_element_type(), pointers);
+                    if(element < 0)
+                        return -1;
+                    return element * CAST(i64, array->num_elements());
+                }
+                default:
+                    return -1;
+            }
+        }
+
+        u32 member_offset(types::Type *type, u64 index, bool pointers) {
+            type = strip(type);
+
+            u32 offset = 0;
+            if(type->kind() == types::TupleType) {
+                auto tuple = type->as<types::Tuple>();
+                for(u64 i = 0; i < index; ++i)
+                    offset += num_registers(tuple->get_element_type(i), pointers);
+            }
+            else if(type->kind() == types::StructureType) {
+                auto structure = type->as<types::StructType>();
+                for(u64 i = 0; i < index; ++i)
+                    offset += num_registers(structure->get_member(i)->get_type(), pointers);
+            }
+            else if(type->kind() == types::ArrayType)
+                offset = CAST(u32, index * num_registers(type->as<types::Array>()->get_element_type(), pointers));
+            return offset;
+        }
+
+        Register constant_register(const Val& val) {
+            Register reg;
+            reg.i = 0;
+            if(!val.type)
+                return reg;
+
+            switch(val.type->kind()) {
+                case types::Primitive_I8: reg.i = val._I8; break;
+                case types::Primitive_I16: reg.i = val._I16; break;
+                case types::Primitive_I32: reg.i = val._I32; break;
+                case types::Primitive_I64: reg.i = val._I64; break;
+                case types::Primitive_U8: reg.u = val._U8; break;
+                case types::Primitive_U16: reg.u = val._U16; break;
+                case types::Primitive_U32: reg.u = val._U32; break;
+                case types::Primitive_U64: reg.u = val._U64; break;
+                case types::Primitive_Char: reg.i = val._Char; break;
+                case types::Primitive_Bool: reg.i = val._Bool; break;
+                case types::Primitive_Float32: reg.f = val._F32; break;
+                case types::Primitive_Float64: reg.f = val._F64; break;
+                default: break;
+            }
+            return reg;
+        }
+
+        void Chunk::print(std::ostream &out, const std::vector<Val> &constants) {
+            out << "fn " << name << " params: " << num_params << " registers: " << num_registers
+                << " results: " << num_results << std::endl;
+
+            for(u64 pc = 0; pc < code.size(); ++pc) {
+                auto inst = code[pc];
+                auto op = get_op(inst);
+                out << "    " << std::setw(4) << pc << "  " << std::left << std::setw(12) << opcode_name(op)
+                    << std::right;
+
+                switch(opcode_format(op)) {
+                    case ABC:
+                        out << "r" << CAST(u32, get_a(inst)) << ", " << CAST(u32, get_b(inst)) << ", "
+                            << CAST(u32, get_c(inst));
+                        break;
+                    case ABx:
+                        out << "r" << CAST(u32, get_a(inst)) << ", " << get_bx(inst);
+                        if(op == Op_LoadK)
+                            out << "\t\t; " << constants[get_bx(inst)];
+                        break;
+                    case AsBx:
+                        out << "r" << CAST(u32, get_a(inst)) << ", " << get_sbx(inst);
+                        if(op == Op_Jump or op == Op_JumpIf or op == Op_JumpIfNot)
+                            out << "\t\t; to " << CAST(i64, pc) + 1 + get_sbx(inst);
+                        break;
+                }
+                out << std::endl;
+            }
+        }
+
+        void Program::print(std::ostream &out) {
+            // a function that isn't reached from main isn't compiled.
+            bool first = true;
+            for(auto& chunk : chunks) {
+                if(chunk.code.empty())
+                    continue;
+                if(!first)
+                    out << std::endl;
+                chunk.print(out, constants);
+                first = false;
+            }
+        }
+    }
+}
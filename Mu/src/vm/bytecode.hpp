@@ -0,0 +1,175 @@
+#ifndef MU_VM_BYTECODE_HPP
+#define MU_VM_BYTECODE_HPP
+
+#include "common.hpp"
+#include "analysis/value.hpp"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+// The instructions of the vm.
+//
+// An instruction is 32 bits, an opcode and up to three 8 bit register operands (ABC),
+// or a register and an unsigned or signed 16 bit operand (ABx, AsBx). Registers are
+// relative to the frame of the function. Integers are kept sign or zero extended to
+// 64 bits, f32 is kept as an f64 that has been rounded to f32.
+#define OPCODES \
+    OPCODE(Move, "move", ABC)          /* a = b */ \
+    OPCODE(LoadK, "loadk", ABx)        /* a = constants[bx] */ \
+    OPCODE(LoadI, "loadi", AsBx)       /* a = sbx */ \
+    OPCODE(LoadG, "loadg", ABx)        /* a = globals[bx] */ \
+    OPCODE(StoreG, "storeg", ABx)      /* globals[bx] = a */ \
+    OPCODE(GetX, "getx", ABC)          /* a = r[b + c], c is the register of an index */ \
+    OPCODE(SetX, "setx", ABC)          /* r[a + b] = c, b is the register of an index */ \
+    OPCODE(Bound, "bound", ABx)        /* traps unless a < bx as unsigned integers */ \
+    OPCODE(Add, "add", ABC)            /* a = b + c */ \
+    OPCODE(Sub, "sub", ABC) \
+    OPCODE(Mul, "mul", ABC) \
+    OPCODE(DivS, "divs", ABC) \
+    OPCODE(DivU, "divu", ABC) \
+    OPCODE(RemS, "rems", ABC) \
+    OPCODE(RemU, "remu", ABC) \
+    OPCODE(Shl, "shl", ABC) \
+    OPCODE(ShrS, "shrs", ABC) \
+    OPCODE(ShrU, "shru", ABC) \
+    OPCODE(BitAnd, "and", ABC) \
+    OPCODE(BitOr, "or", ABC) \
+    OPCODE(BitXor, "xor", ABC) \
+    OPCODE(AddF, "addf", ABC) \
+    OPCODE(SubF, "subf", ABC) \
+    OPCODE(MulF, "mulf", ABC) \
+    OPCODE(DivF, "divf", ABC) \
+    OPCODE(RemF, "remf", ABC) \
+    OPCODE(PowF, "powf", ABC) \
+    OPCODE(AddI, "addi", ABC)          /* a = b + c, c is a signed 8 bit immediate */ \
+    OPCODE(Neg, "neg", ABC)            /* a = -b */ \
+    OPCODE(NegF, "negf", ABC) \
+    OPCODE(BitNot, "not", ABC)         /* a = ~b */ \
+    OPCODE(LogicNot, "lnot", ABC)      /* a = !b */ \
+    OPCODE(Eq, "eq", ABC)              /* a = b == c */ \
+    OPCODE(Ne, "ne", ABC) \
+    OPCODE(LtS, "lts", ABC) \
+    OPCODE(LeS, "les", ABC) \
+    OPCODE(LtU, "ltu", ABC) \
+    OPCODE(LeU, "leu", ABC) \
+    OPCODE(EqF, "eqf", ABC) \
+    OPCODE(NeF, "nef", ABC) \
+    OPCODE(LtF, "ltf", ABC) \
+    OPCODE(LeF, "lef", ABC) \
+    OPCODE(Narrow, "narrow", ABC)      /* a = b narrowed to the kind in c, see NarrowKind */ \
+    OPCODE(IToF, "itof", ABC)          /* a = b converted from a signed integer to a float */ \
+    OPCODE(UToF, "utof", ABC) \
+    OPCODE(FToI, "ftoi", ABC)          /* a = b converted from a float to a signed integer */ \
+    OPCODE(FToU, "ftou", ABC) \
+    OPCODE(Jump, "jump", AsBx)         /* pc += sbx */ \
+    OPCODE(JumpIf, "jumpif", AsBx)     /* if a then pc += sbx */ \
+    OPCODE(JumpIfNot, "jumpifnot", AsBx) \
+    OPCODE(Call, "call", ABx)          /* the arguments are at a.., the result is written to a.. */ \
+    OPCODE(Return, "ret", ABC)         /* returns b registers starting at a */ \
+    OPCODE(Unreachable, "unreachable", ABC)
+
+namespace mu {
+    namespace vm {
+
+        enum Opcode : u8 {
+#define OPCODE(n, ...) Op_##n,
+            OPCODES
+#undef OPCODE
+            Op_Count,
+        };
+
+        enum Format : u8 {
+            ABC,
+            ABx,
+            AsBx,
+        };
+
+        // the narrowing applied after an operation on a type smaller than 64 bits.
+        enum NarrowKind : u8 {
+            Narrow_I8,
+            Narrow_I16,
+            Narrow_I32,
+            Narrow_U8,
+            Narrow_U16,
+            Narrow_U32,
+            Narrow_F32,
+        };
+
+        typedef u32 Instruction;
+
+        const i32 MaxSBx = 0x7fff;
+
+        inline Instruction encode_abc(Opcode op, u8 a, u8 b, u8 c) {
+            return CAST(u32, op) | (CAST(u32, a) << 8) | (CAST(u32, b) << 16) | (CAST(u32, c) << 24);
+        }
+
+        inline Instruction encode_abx(Opcode op, u8 a, u16 bx) {
+            return CAST(u32, op) | (CAST(u32, a) << 8) | (CAST(u32, bx) << 16);
+        }
+
+        inline Instruction encode_asbx(Opcode op, u8 a, i32 sbx) {
+            return encode_abx(op, a, CAST(u16, sbx + MaxSBx));
+        }
+
+        inline Opcode get_op(Instruction inst) { return CAST(Opcode, inst & 0xff); }
+        inline u8 get_a(Instruction inst) { return CAST(u8, inst >> 8); }
+        inline u8 get_b(Instruction inst) { return CAST(u8, inst >> 16); }
+        inline u8 get_c(Instruction inst) { return CAST(u8, inst >> 24); }
+        inline u16 get_bx(Instruction inst) { return CAST(u16, inst >> 16); }
+        inline i32 get_sbx(Instruction inst) { return CAST(i32, get_bx(inst)) - MaxSBx; }
+
+        const char* opcode_name(Opcode op);
+
+        Format opcode_format(Opcode op);
+
+        // a register, every value is stored in one or more registers. A tuple, a struct or
+        // an array is stored in consecutive registers, one for each of its primitive members.
+        union Register {
+            i64 i;
+            u64 u;
+            f64 f;
+        };
+
+        // the code of a single function.
+        struct Chunk {
+            std::string name;
+            std::vector<Instruction> code;
+
+            // the registers of the parameters come first.
+            u32 num_params{0};
+            u32 num_registers{0};
+            u32 num_results{0};
+
+            void print(std::ostream& out, const std::vector<Val>& constants);
+        };
+
+        struct Program {
+            std::vector<Chunk> chunks;
+
+            // the constants are the values the typer computed.
+            std::vector<Val> constants;
+
+            // the initial value of every global register.
+            std::vector<Val> globals;
+
+            // the chunk of main, -1 if there isn't one.
+            i64 main{-1};
+
+            void print(std::ostream& out);
+        };
+
+        // the number of registers a value of type is stored in, -1 if it can't be stored.
+        // A pointer is an address in a single register when pointers is set.
+        i64 num_registers(types::Type* type, bool pointers = false);
+
+        // the first register of a member of a tuple or struct, or an element of an array,
+        // relative to the first register of the value.
+        u32 member_offset(types::Type* type, u64 index, bool pointers = false);
+
+        // the register value of a constant, it is converted from the type it was evaluated as.
+        Register constant_register(const Val& val);
+    }
+}
+
+#endif //MU_VM_BYTECODE_HPP
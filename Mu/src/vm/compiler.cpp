@@ -0,0 +1,1355 @@
+#include "compiler.hpp"
+#include "analysis/types/type.hpp"
+#include "parser/ast/ast_common.hpp"
+
+#include <algorithm>
+
+extern mu::types::Type* type_u64;
+
+// mutable only qualifies a type, it is stored the same as the type it qualifies.
+static mu::types::Type* strip(mu::types::Type* type) {
+    while(type and type->kind() == mu::types::MutableType)
+        type = type->as<mu::types::Mutable>()->get_inner();
+    return type;
+}
+
+// an immutable self is passed by value, the type of a member access through it is
+// the type it points to.
+static mu::types::Type* value_type(mu::types::Type* type) {
+    type = strip(type);
+    if(type and type->is_ptr())
+        type = strip(type->base_type());
+    return type;
+}
+
+// the type a parameter is stored as in the registers of the callee.
+static mu::types::Type* stored_type(mu::Local* param) {
+    auto type = param->get_type();
+    if(param->is_self() and strip(type)->is_ptr() and strip(type)->base_type()->kind() != mu::types::MutableType)
+        return strip(type)->base_type();
+    return type;
+}
+
+static mu::TokenKind compound_operator(mu::TokenKind op) {
+    switch(op) {
+        case mu::Tkn_PlusEqual: return mu::Tkn_Plus;
+        case mu::Tkn_MinusEqual: return mu::Tkn_Minus;
+        case mu::Tkn_AstrickEqual: return mu::Tkn_Astrick;
+        case mu::Tkn_SlashEqual: return mu::Tkn_Slash;
+        case mu::Tkn_PercentEqual: return mu::Tkn_Percent;
+        case mu::Tkn_AstrickAstrickEqual: return mu::Tkn_AstrickAstrick;
+        case mu::Tkn_LessLessEqual: return mu::Tkn_LessLess;
+        case mu::Tkn_GreaterGreaterEqual: return mu::Tkn_GreaterGreater;
+        case mu::Tkn_AmpersandEqual: return mu::Tkn_Ampersand;
+        case mu::Tkn_PipeEqual: return mu::Tkn_Pipe;
+        case mu::Tkn_CarrotEqual: return mu::Tkn_Carrot;
+        default: return op;
+    }
+}
+
+// the initializer of a struct member when it isn't given in the struct expression.
+static ast::ExprPtr default_member_init(mu::Local* member) {
+    auto decl = member->get_decl();
+    if(!decl or decl->kind != ast::ast_member_variable)
+        return nullptr;
+
+    auto variable = decl->as<ast::MemberVariable>();
+    if(variable->init.size() == 1)
+        return variable->init[0];
+
+    for(u64 i = 0; i < variable->names.size() and i < variable->init.size(); ++i)
+        if(variable->names[i]->val == member->get_name()->val)
+            return variable->init[i];
+    return nullptr;
+}
+
+static ast::ExprPtr accessor_operand(ast::Expr* expr) {
+    return expr->kind == ast::ast_accessor ? expr->as<ast::Accessor>()->operand :
+           expr->as<ast::TupleAcessor>()->operand;
+}
+
+// the index of the member or element an accessor refers to, -1 if it isn't known.
+static u64 accessor_index(ast::Expr* expr) {
+    if(expr->kind == ast::ast_tuple_accessor)
+        return expr->as<ast::TupleAcessor>()->value;
+
+    auto type = value_type(accessor_operand(expr)->type);
+    auto member = expr->operand.entity;
+    if(!member or type->kind() != mu::types::StructureType)
+        return (u64) -1;
+    return type->as<mu::types::StructType>()->get_index_of_member(member);
+}
+
+// whether a call takes an element of an array, 'v(i)'.
+static bool is_index(ast::Expr* expr) {
+    if(expr->kind != ast::ast_call)
+        return false;
+    auto type = strip(expr->as<ast::Call>()->name->type);
+    return type and type->is_array();
+}
+
+// the value of a constant index.
+static u64 constant_index(ast::Expr* index) {
+    mu::Val value = index->operand.val;
+    if(!value.type)
+        value.type = strip(index->type);
+    value.cast_to(type_u64);
+    return value._U64;
+}
+
+// the value a literal pattern matches.
+static bool pattern_value(ast::Pattern* pattern, i64& value) {
+    switch(pattern->kind) {
+        case ast::ast_int_pattern: value = pattern->as<ast::IntPattern>()->value; return true;
+        case ast::ast_char_pattern: value = pattern->as<ast::CharPattern>()->value; return true;
+        case ast::ast_bool_pattern: value = pattern->as<ast::BoolPattern>()->value; return true;
+        default: return false;
+    }
+}
+
+namespace mu {
+    namespace vm {
+
+        Compiler::Compiler(Interpreter *interp, Program *program) : interp(interp), program(program) {
+        }
+
+        bool Compiler::compile(const std::vector<Entity *> &entities) {
+            // everything is declared before any body is compiled so the order of the
+            // declarations doesn't matter.
+            std::vector<mu::Function*> bodies;
+            for(auto entity : entities) {
+                if(!entity or !entity->is_resolved())
+                    continue;
+
+                switch(entity->kind()) {
+                    case FunctionEntity: {
+                        auto function = entity->as<mu::Function>();
+                        declare_function(function, function->get_name()->value());
+                        bodies.push_back(function);
+                    } break;
+                    case TypeEntity: {
+                        auto type = entity->as<Type>();
+                        if(!type->is_struct())
+                            break;
+
+                        // methods are named by their type, 'Point.new'.
+                        auto scope = type->get_type()->as<types::StructType>()->get_scope();
+                        for(auto block : type->get_impls()) {
+                            for(auto decl : block->as<ast::Impl>()->methods) {
+                                if(decl->kind != ast::ast_procedure)
+                                    continue;
+
+                                auto [member, found] = scope->find(decl->as<ast::Procedure>()->name);
+                                if(!found or !member->is_function() or !member->is_resolved())
+                                    continue;
+
+                                auto method = member->as<mu::Function>();
+                                declare_function(method, type->get_name()->value() + "." + member->get_name()->value());
+                                bodies.push_back(method);
+                            }
+                        }
+                    } break;
+                    case GlobalEntity: {
+                        auto global = entity->as<Global>();
+                        auto type = strip(global->get_type());
+                        auto count = num_registers(type);
+                        if(count < 0)
+                            break;
+
+                        // only a primitive global has an initial value, an aggregate starts zeroed.
+                        auto decl = global->get_decl();
+                        auto init = global->is_mutable() ? decl->as<ast::GlobalMut>()->init : decl->as<ast::Global>()->init;
+
+                        if(init and type->is_primative() and !mu::is_constant_expr(init))
+                            report(init->pos(), "global '%s' must be initialized by a constant",
+                                   global->get_name()->value().c_str());
+
+                        globals.emplace(global, program->globals.size());
+                        for(i64 i = 0; i < count; ++i) {
+                            Val value(CAST(i64, 0));
+                            if(init and mu::is_constant_expr(init) and type->is_primative())
+                                value = init->operand.val;
+                            value.cast_to(type);
+                            program->globals.push_back(value);
+                        }
+                    } break;
+                    default:
+                        break;
+                }
+            }
+
+            // only the functions main can reach are compiled, a function the vm can't run
+            // doesn't matter unless it is called. A module without a main is compiled whole.
+            for(auto function : bodies)
+                if(chunks.count(function) and (program->main < 0 or chunks[function] == program->main))
+                    reach(function);
+
+            while(!pending.empty()) {
+                auto function = pending.back();
+                pending.pop_back();
+                compile_function(function);
+            }
+
+            return !has_error();
+        }
+
+        void Compiler::declare_function(mu::Function *entity, const std::string &name) {
+            // a function that takes or returns something that can't be stored in registers
+            // isn't declared, calling it is reported.
+            if(entity->is_foreign() or entity->no_body())
+                return;
+
+            u32 num_params = 0;
+            for(u64 i = 0; i < entity->num_params(); ++i) {
+                auto count = num_registers(stored_type(entity->get_param(i)));
+                if(count < 0)
+                    return;
+                num_params += count;
+            }
+
+            auto ret = entity->get_ret_type();
+            auto num_results = ret ? num_registers(ret) : 0;
+            if(num_results < 0)
+                return;
+
+            Chunk chunk;
+            chunk.name = name;
+            chunk.num_params = num_params;
+            chunk.num_results = num_results;
+
+            chunks.emplace(entity, program->chunks.size());
+            if(name == "main")
+                program->main = program->chunks.size();
+            program->chunks.push_back(std::move(chunk));
+        }
+
+        void Compiler::reach(mu::Function *entity) {
+            if(reached.insert(entity).second)
+                pending.push_back(entity);
+        }
+
+        void Compiler::compile_function(mu::Function *entity) {
+            this->entity = entity;
+            chunk = &program->chunks[chunks[entity]];
+            locals.clear();
+            defers.clear();
+            top = 0;
+
+            // the arguments are in the first registers of the frame.
+            for(u64 i = 0; i < entity->num_params(); ++i) {
+                auto param = entity->get_param(i);
+                locals[param] = allocate(num_registers(stored_type(param)));
+            }
+
+            auto ret = entity->get_ret_type();
+            auto result = allocate(chunk->num_results);
+
+            auto body = entity->get_decl()->as<ast::Procedure>()->body;
+            if(ret and chunk->num_results)
+                compile_into(body, ret, result);
+            else
+                compile_effect(body);
+            run_defers(0);
+
+            emit(encode_abc(Op_Return, result, chunk->num_results, 0));
+        }
+
+        /*------------------------------Registers-------------------------------*/
+
+        u32 Compiler::allocate(u32 count) {
+            auto reg = top;
+            top += count;
+
+            // a register is 8 bits in an instruction.
+            if(top > 256 and chunk->num_registers <= 256)
+                report(position, "'%s' needs more than 256 registers", chunk->name.c_str());
+
+            chunk->num_registers = std::max(chunk->num_registers, top);
+            return reg;
+        }
+
+        void Compiler::release(u32 top) {
+            this->top = top;
+        }
+
+        bool Compiler::registers_of(ast::Expr *expr, u32 &count) {
+            auto registers = num_registers(expr->type);
+            if(registers < 0) {
+                report(expr->pos(), "a value of type '%s' can not be run by the vm",
+                       expr->type ? expr->type->str().c_str() : "unknown");
+                return false;
+            }
+
+            count = registers;
+            return true;
+        }
+
+        /*-----------------------------Expressions------------------------------*/
+
+        bool Compiler::compile_expr(ast::Expr *expr, u32 target) {
+            position = expr->pos();
+
+            auto type = strip(expr->type);
+            // a block, branch or call with a constant value still runs its statements.
+            if(mu::is_constant_expr(expr) and type and type->is_primative()) {
+                compile_constant(expr->operand.val, type, target);
+                return true;
+            }
+
+            switch(expr->kind) {
+                case ast::ast_name:
+                case ast::ast_self_expr:
+                    return compile_name(expr, target);
+                case ast::ast_unit_expr:
+                    return true;
+                case ast::ast_binary:
+                    return compile_binary(expr->as<ast::Binary>(), target);
+                case ast::ast_unary:
+                    return compile_unary(expr->as<ast::Unary>(), target);
+                case ast::ast_cast_expr:
+                    return compile_cast(expr, target);
+                case ast::ast_tuple_expr:
+                case ast::ast_struct_expr:
+                case ast::ast_list:
+                    return compile_aggregate(expr, target);
+                case ast::ast_accessor:
+                case ast::ast_tuple_accessor:
+                    return compile_accessor(expr, target);
+                case ast::ast_call: {
+                    auto call = expr->as<ast::Call>();
+                    if(is_index(expr))
+                        return compile_index(call, target);
+
+                    auto callee = call->name->operand.entity;
+                    if(!callee or !callee->is_function()) {
+                        report(expr->pos(), "only a function can be called by the vm");
+                        return false;
+                    }
+                    return compile_call(expr, callee->as<mu::Function>(), call->actuals, 0, target);
+                }
+                case ast::ast_method: {
+                    // the first actual is the receiver, or the type of a static method.
+                    auto method = expr->as<ast::Method>();
+                    auto callee = method->name->operand.entity;
+                    if(!callee or !callee->is_function()) {
+                        report(expr->pos(), "only a function can be called by the vm");
+                        return false;
+                    }
+
+                    auto function = callee->as<mu::Function>();
+                    if(!function->is_static() and strip(method->actuals[0]->type)->is_ptr()) {
+                        report(expr->pos(), "a method can not be called through a pointer by the vm");
+                        return false;
+                    }
+                    return compile_call(expr, function, method->actuals, function->is_static() ? 1 : 0, target);
+                }
+                case ast::ast_block:
+                    return compile_block(expr->as<ast::Block>(), target);
+                case ast::ast_if_expr:
+                    return compile_if(expr->as<ast::If>(), target);
+                case ast::ast_while_expr:
+                    return compile_while(expr->as<ast::While>());
+                case ast::ast_for_expr:
+                    return compile_for(expr->as<ast::For>());
+                case ast::ast_match_expr:
+                    return compile_match(expr->as<ast::Match>(), target);
+                case ast::ast_defer_expr:
+                    defers.push_back(expr->as<ast::Defer>()->body);
+                    return true;
+                case ast::ast_return:
+                    return compile_return(expr->as<ast::Return>());
+                case ast::ast_assign:
+                    return compile_assign(expr->as<ast::Assign>());
+                default:
+                    report(expr->pos(), "this expression can not be run by the vm");
+                    return false;
+            }
+        }
+
+        bool Compiler::compile_into(ast::Expr *expr, types::Type *type, u32 target) {
+            auto count = num_registers(type);
+            if(count > 0 and num_registers(expr->type) == count)
+                return compile_expr(expr, target);
+            return compile_effect(expr);
+        }
+
+        bool Compiler::compile_effect(ast::Expr *expr) {
+            auto save = top;
+
+            u32 count = 0;
+            if(!registers_of(expr, count))
+                return false;
+
+            auto result = compile_expr(expr, allocate(count));
+            release(save);
+            return result;
+        }
+
+        bool Compiler::compile_operand(ast::Expr *expr, u32 &reg) {
+            u32 count = 0;
+            if(!registers_of(expr, count))
+                return false;
+
+            if(count != 1) {
+                report(expr->pos(), "expected a primitive value, found '%s'", expr->type->str().c_str());
+                return false;
+            }
+
+            if(!expr->operand.val.is_constant and compile_place(expr, reg))
+                return true;
+
+            reg = allocate(1);
+            return compile_expr(expr, reg);
+        }
+
+        bool Compiler::compile_value(ast::Expr *expr, u32 &reg) {
+            u32 count = 0;
+            if(!registers_of(expr, count))
+                return false;
+
+            if(!expr->operand.val.is_constant and compile_place(expr, reg))
+                return true;
+
+            reg = allocate(count);
+            return compile_expr(expr, reg);
+        }
+
+        bool Compiler::compile_place(ast::Expr *expr, u32 &reg) {
+            switch(expr->kind) {
+                case ast::ast_name:
+                case ast::ast_self_expr: {
+                    auto iter = locals.find(expr->operand.entity);
+                    if(iter == locals.end())
+                        return false;
+                    reg = iter->second;
+                    return true;
+                }
+                case ast::ast_accessor:
+                case ast::ast_tuple_accessor: {
+                    auto operand = accessor_operand(expr);
+                    auto index = accessor_index(expr);
+                    if(index == (u64) -1 or !compile_place(operand, reg))
+                        return false;
+                    reg += member_offset(value_type(operand->type), index);
+                    return true;
+                }
+                case ast::ast_call: {
+                    if(!is_index(expr))
+                        return false;
+
+                    auto call = expr->as<ast::Call>();
+                    auto index = call->actuals.front();
+                    if(!mu::is_constant_expr(index) or !compile_place(call->name, reg))
+                        return false;
+                    reg += member_offset(call->name->type, constant_index(index));
+                    return true;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        void Compiler::compile_constant(const Val &val, types::Type *type, u32 target) {
+            type = strip(type);
+
+            // the value is converted to the type of the expression it is the value of.
+            Val value = val;
+            if(!value.type)
+                value.type = type;
+            else if(value.type != type)
+                value.cast_to(type);
+
+            // the bits of a float zero are the same as an integer zero.
+            auto reg = constant_register(value);
+            if((type->is_float() and reg.u == 0) or (!type->is_float() and reg.i >= -MaxSBx and reg.i <= MaxSBx)) {
+                emit(encode_asbx(Op_LoadI, target, CAST(i32, reg.i)));
+                return;
+            }
+
+            auto [iter, inserted] = constants.emplace(std::make_pair(type, reg.u), program->constants.size());
+            if(inserted) {
+                if(program->constants.size() > 0xffff)
+                    report(position, "the module has more constants than the vm supports");
+                program->constants.push_back(value);
+            }
+            emit(encode_abx(Op_LoadK, target, iter->second));
+        }
+
+        bool Compiler::compile_name(ast::Expr *expr, u32 target) {
+            auto entity = expr->operand.entity;
+            if(!entity) {
+                report(expr->pos(), "this name can not be run by the vm");
+                return false;
+            }
+
+            u32 count = 0;
+            switch(entity->kind()) {
+                case LocalEntity: {
+                    auto iter = locals.find(entity);
+                    if(iter == locals.end() or !registers_of(expr, count))
+                        break;
+                    emit_move(target, iter->second, count);
+                    return true;
+                }
+                case GlobalEntity: {
+                    auto iter = globals.find(entity->as<Global>());
+                    if(iter == globals.end() or !registers_of(expr, count))
+                        break;
+                    for(u32 i = 0; i < count; ++i)
+                        emit(encode_abx(Op_LoadG, target + i, iter->second + i));
+                    return true;
+                }
+                case ConstantEntity: {
+                    auto constant = entity->as<mu::Constant>();
+                    if(!strip(constant->get_type())->is_primative())
+                        break;
+                    compile_constant(constant->get_value(), constant->get_type(), target);
+                    return true;
+                }
+                default:
+                    break;
+            }
+
+            report(expr->pos(), "'%s' can not be run by the vm", entity->get_name()->value().c_str());
+            return false;
+        }
+
+        bool Compiler::compile_binary(ast::Binary *expr, u32 target) {
+            if(expr->op == Tkn_And or expr->op == Tkn_Or)
+                return compile_logical(expr, target);
+
+            auto save = top;
+            u32 lhs = 0, rhs = 0;
+            if(strip(expr->type)->is_array()) {
+                if(!compile_value(expr->lhs, lhs) or !compile_value(expr->rhs, rhs))
+                    return false;
+
+                position = expr->pos();
+                auto result = emit_elements(expr->op, expr->lhs->type, expr->rhs->type, target, lhs, rhs);
+                release(save);
+                return result;
+            }
+
+            if(!compile_operand(expr->lhs, lhs) or !compile_operand(expr->rhs, rhs))
+                return false;
+
+            position = expr->pos();
+            auto result = emit_operator(expr->op, expr->lhs->type, target, lhs, rhs);
+            release(save);
+            return result;
+        }
+
+        bool Compiler::compile_logical(ast::Binary *expr, u32 target) {
+            // the right side is only evaluated when the left side doesn't decide the result.
+            if(!compile_expr(expr->lhs, target))
+                return false;
+
+            auto skip = emit_jump(expr->op == Tkn_And ? Op_JumpIfNot : Op_JumpIf, target);
+            if(!compile_expr(expr->rhs, target))
+                return false;
+
+            patch_jump(skip);
+            return true;
+        }
+
+        bool Compiler::compile_unary(ast::Unary *expr, u32 target) {
+            if(expr->op == Tkn_Ampersand or expr->op == Tkn_Astrick) {
+                report(expr->pos(), "pointers can not be run by the vm");
+                return false;
+            }
+
+            auto save = top;
+            u32 value = 0;
+            if(!compile_operand(expr->expr, value))
+                return false;
+
+            auto type = strip(expr->expr->type);
+            switch(expr->op) {
+                case Tkn_Minus:
+                    emit(encode_abc(type->is_float() ? Op_NegF : Op_Neg, target, value, 0));
+                    emit_narrow(type, target);
+                    break;
+                case Tkn_Tilde:
+                    emit(encode_abc(Op_BitNot, target, value, 0));
+                    emit_narrow(type, target);
+                    break;
+                case Tkn_Bang:
+                    emit(encode_abc(Op_LogicNot, target, value, 0));
+                    break;
+                default:
+                    report(expr->pos(), "the operator '%s' can not be run by the vm", Token::get_string(expr->op).c_str());
+                    return false;
+            }
+
+            release(save);
+            return true;
+        }
+
+        bool Compiler::compile_cast(ast::Expr *expr, u32 target) {
+            auto save = top;
+            u32 value = 0;
+            auto operand = expr->as<ast::Cast>()->operand;
+            if(!compile_operand(operand, value))
+                return false;
+
+            auto from = strip(operand->type);
+            auto to = strip(expr->type);
+            if(to->is_bool()) {
+                // any value other than zero is true, the bits of a float zero are an integer zero.
+                auto zero = allocate(1);
+                emit(encode_asbx(Op_LoadI, zero, 0));
+                emit(encode_abc(from->is_float() ? Op_NeF : Op_Ne, target, value, zero));
+            }
+            else if(to->is_float()) {
+                if(from->is_float())
+                    emit_move(target, value, 1);
+                else
+                    emit(encode_abc(from->is_signed() ? Op_IToF : Op_UToF, target, value, 0));
+                emit_narrow(to, target);
+            }
+            else {
+                // the registers are extended to 64 bits by the type of the operand, narrowing is enough.
+                if(from->is_float())
+                    emit(encode_abc(to->is_signed() ? Op_FToI : Op_FToU, target, value, 0));
+                else
+                    emit_move(target, value, 1);
+                emit_narrow(to, target);
+            }
+
+            release(save);
+            return true;
+        }
+
+        bool Compiler::compile_aggregate(ast::Expr *expr, u32 target) {
+            auto type = strip(expr->type);
+            if(expr->kind == ast::ast_list) {
+                auto& elements = expr->as<ast::List>()->elements;
+                for(u64 i = 0; i < elements.size(); ++i)
+                    if(!compile_expr(elements[i], target + member_offset(type, i)))
+                        return false;
+                return true;
+            }
+
+            if(expr->kind == ast::ast_tuple_expr) {
+                auto& elements = expr->as<ast::TupleExpr>()->elements;
+                for(u64 i = 0; i < elements.size(); ++i)
+                    if(!compile_expr(elements[i], target + member_offset(type, i)))
+                        return false;
+                return true;
+            }
+
+            auto struct_expr = expr->as<ast::StructExpr>();
+            auto struct_type = type->as<types::StructType>();
+
+            // the members are given in order or by name.
+            std::vector<ast::ExprPtr> inits(struct_type->num_members(), nullptr);
+            for(u64 i = 0; i < struct_expr->members.size() and i < inits.size(); ++i) {
+                auto member = struct_expr->members[i];
+                if(member->kind == ast::ast_expr_binding) {
+                    auto binding = member->as<ast::BindingExpr>();
+                    auto [entity, found] = struct_type->get_scope()->find(binding->name);
+                    if(found)
+                        inits[struct_type->get_index_of_member(entity)] = binding->expr;
+                }
+                else
+                    inits[i] = member;
+            }
+
+            for(u64 i = 0; i < inits.size(); ++i) {
+                auto member = struct_type->get_member(i)->as<Local>();
+                auto init = inits[i] ? inits[i] : default_member_init(member);
+                if(!init) {
+                    report(expr->pos(), "member '%s' of '%s' isn't given a value",
+                           member->get_name()->value().c_str(), struct_type->get_name()->value().c_str());
+                    return false;
+                }
+
+                if(!compile_expr(init, target + member_offset(struct_type, i)))
+                    return false;
+            }
+            return true;
+        }
+
+        bool Compiler::compile_accessor(ast::Expr *expr, u32 target) {
+            u32 count = 0;
+            if(!registers_of(expr, count))
+                return false;
+
+            u32 place = 0;
+            if(compile_place(expr, place)) {
+                emit_move(target, place, count);
+                return true;
+            }
+
+            // the operand is a temporary, the member is moved out of it.
+            auto operand = accessor_operand(expr);
+            auto index = accessor_index(expr);
+            u32 operand_count = 0;
+            if(index == (u64) -1 or !registers_of(operand, operand_count)) {
+                report(expr->pos(), "this member can not be run by the vm");
+                return false;
+            }
+
+            auto save = top;
+            auto base = allocate(operand_count);
+            if(!compile_expr(operand, base))
+                return false;
+
+            emit_move(target, base + member_offset(operand->type, index), count);
+            release(save);
+            return true;
+        }
+
+        bool Compiler::compile_index(ast::Call *expr, u32 target) {
+            u32 count = 0;
+            if(!registers_of(expr, count))
+                return false;
+
+            u32 place = 0;
+            if(compile_place(expr, place)) {
+                emit_move(target, place, count);
+                return true;
+            }
+
+            // an array without storage is computed first.
+            auto save = top;
+            auto array = expr->name;
+            u32 base = 0;
+            if(!compile_place(array, base)) {
+                u32 array_count = 0;
+                if(!registers_of(array, array_count))
+                    return false;
+                base = allocate(array_count);
+                if(!compile_expr(array, base))
+                    return false;
+            }
+
+            auto index = expr->actuals.front();
+            if(mu::is_constant_expr(index)) {
+                emit_move(target, base + member_offset(array->type, constant_index(index)), count);
+                release(save);
+                return true;
+            }
+
+            u32 offset = 0;
+            if(!compile_offset(expr, offset))
+                return false;
+
+            position = expr->pos();
+            for(u32 i = 0; i < count; ++i)
+                emit(encode_abc(Op_GetX, target + i, base + i, offset));
+            release(save);
+            return true;
+        }
+
+        bool Compiler::compile_offset(ast::Call *expr, u32 &reg) {
+            auto array = strip(expr->name->type)->as<types::Array>();
+            u32 index = 0;
+            if(!compile_operand(expr->actuals.front(), index))
+                return false;
+
+            position = expr->pos();
+            emit(encode_abx(Op_Bound, index, CAST(u32, array->num_elements())));
+
+            // the index is scaled to the registers of an element.
+            auto stride = num_registers(array->get_element_type());
+            if(stride == 1) {
+                reg = index;
+                return true;
+            }
+
+            reg = allocate(1);
+            emit(encode_asbx(Op_LoadI, reg, CAST(i32, stride)));
+            emit(encode_abc(Op_Mul, reg, index, reg));
+            return true;
+        }
+
+        bool Compiler::compile_call(ast::Expr *expr, mu::Function *callee, const ast::NodeList<ast::ExprPtr> &actuals,
+                                    u64 first_actual, u32 target) {
+            auto iter = chunks.find(callee);
+            if(iter == chunks.end()) {
+                report(expr->pos(), "'%s' can not be called by the vm", callee->get_name()->value().c_str());
+                return false;
+            }
+
+            reach(callee);
+
+            // the arguments are the first registers of the frame of the callee, which starts
+            // at the first free register. When the target is the last thing allocated the
+            // frame starts at the target and the results don't have to be moved.
+            auto index = iter->second;
+            auto num_params = program->chunks[index].num_params;
+            auto num_results = program->chunks[index].num_results;
+
+            auto save = top;
+            u32 base = 0;
+            if(num_results > 0 and target + num_results == top) {
+                base = target;
+                allocate(std::max(num_params, num_results) - num_results);
+            }
+            else
+                base = allocate(std::max(num_params, num_results));
+
+            auto offset = base;
+            auto actual = first_actual;
+            for(u64 i = 0; i < callee->num_params(); ++i, ++actual) {
+                auto param = callee->get_param(i);
+
+                ast::ExprPtr init = actual < actuals.size() ? actuals[actual] : nullptr;
+                if(!init and param->get_decl()->kind == ast::ast_procedure_parameter)
+                    init = param->get_decl()->as<ast::ProcedureParameter>()->init;
+
+                if(!init) {
+                    report(expr->pos(), "parameter '%s' of '%s' isn't given a value",
+                           param->get_name()->value().c_str(), callee->get_name()->value().c_str());
+                    return false;
+                }
+
+                if(!compile_expr(init, offset))
+                    return false;
+                offset += num_registers(stored_type(param));
+            }
+
+            position = expr->pos();
+            emit(encode_abx(Op_Call, base, index));
+            emit_move(target, base, num_results);
+            release(save);
+            return true;
+        }
+
+        bool Compiler::compile_block(ast::Block *expr, u32 target) {
+            auto save = top;
+            auto mark = defers.size();
+
+            for(u64 i = 0; i < expr->elements.size(); ++i) {
+                auto stmt = expr->elements[i];
+                switch(stmt->kind) {
+                    case ast::ast_expr: {
+                        auto value = stmt->as<ast::ExprStmt>()->expr;
+                        auto is_last = i + 1 == expr->elements.size();
+                        if(!(is_last ? compile_into(value, expr->type, target) : compile_effect(value)))
+                            return false;
+                    } break;
+                    case ast::ast_decl: {
+                        auto decl = stmt->as<ast::DeclStmt>()->decl;
+                        if(decl->kind != ast::ast_local and decl->kind != ast::ast_mutable) {
+                            report(decl->pos(), "this declaration can not be run by the vm");
+                            return false;
+                        }
+                        if(!compile_local(decl))
+                            return false;
+                    } break;
+                    default:
+                        break;
+                }
+            }
+
+            // the value of the block is computed before the deferred expressions run.
+            if(!run_defers(mark))
+                return false;
+            defers.resize(mark);
+
+            release(save);
+            return true;
+        }
+
+        bool Compiler::compile_if(ast::If *expr, u32 target) {
+            auto save = top;
+            u32 cond = 0;
+            if(!compile_operand(expr->cond, cond))
+                return false;
+            auto skip_then = emit_jump(Op_JumpIfNot, cond);
+            release(save);
+
+            if(!compile_into(expr->body, expr->type, target))
+                return false;
+
+            if(!expr->else_if) {
+                patch_jump(skip_then);
+                return true;
+            }
+
+            auto skip_else = emit_jump(Op_Jump);
+            patch_jump(skip_then);
+            if(!compile_into(expr->else_if, expr->type, target))
+                return false;
+
+            patch_jump(skip_else);
+            return true;
+        }
+
+        bool Compiler::compile_while(ast::While *expr) {
+            auto start = chunk->code.size();
+
+            auto save = top;
+            u32 cond = 0;
+            if(!compile_operand(expr->cond, cond))
+                return false;
+            auto exit = emit_jump(Op_JumpIfNot, cond);
+            release(save);
+
+            if(!compile_effect(expr->body))
+                return false;
+
+            emit_jump_to(Op_Jump, 0, start);
+            patch_jump(exit);
+            return true;
+        }
+
+        bool Compiler::compile_for(ast::For *expr) {
+            auto range = expr->expr->as<ast::Range>();
+            auto type = strip(range->type);
+            auto save = top;
+
+            // the bound is evaluated once, before the first iteration.
+            auto counter = allocate(1);
+            auto end = allocate(1);
+            if(!compile_expr(range->start, counter) or !compile_expr(range->end, end))
+                return false;
+
+            // a small constant step is an immediate.
+            i64 step_value = 1;
+            u32 step = 0;
+            bool immediate = true;
+            if(range->step) {
+                auto constant = mu::is_constant_expr(range->step);
+                if(constant) {
+                    auto val = range->step->operand.val;
+                    val.cast_to(type);
+                    step_value = constant_register(val).i;
+                }
+                immediate = constant and step_value >= -128 and step_value <= 127;
+                if(!immediate) {
+                    step = allocate(1);
+                    if(!compile_expr(range->step, step))
+                        return false;
+                }
+            }
+
+            if(expr->pattern->kind == ast::ast_ident_pattern)
+                locals[expr->pattern->as<ast::IdentPattern>()->entity] = counter;
+
+            auto start = chunk->code.size();
+            auto cond = allocate(1);
+            emit(encode_abc(type->is_signed() ? Op_LtS : Op_LtU, cond, counter, end));
+            auto exit = emit_jump(Op_JumpIfNot, cond);
+
+            if(!compile_effect(expr->body))
+                return false;
+
+            if(immediate)
+                emit(encode_abc(Op_AddI, counter, counter, CAST(u8, CAST(i8, step_value))));
+            else
+                emit(encode_abc(Op_Add, counter, counter, step));
+            emit_narrow(type, counter);
+
+            emit_jump_to(Op_Jump, 0, start);
+            patch_jump(exit);
+            release(save);
+            return true;
+        }
+
+        bool Compiler::compile_match(ast::Match *expr, u32 target) {
+            auto save = top;
+            auto value = allocate(1);
+            if(!compile_expr(expr->cond, value))
+                return false;
+
+            auto type = strip(expr->cond->type);
+            auto compare_le = type->is_signed() ? Op_LeS : Op_LeU;
+
+            // the arms are tested in order, an arm with alternatives matches if any of them do.
+            std::vector<u64> exits;
+            bool exhaustive = false;
+            for(auto member : expr->members) {
+                auto arm = member->as<ast::MatchArm>();
+                auto arm_save = top;
+
+                std::vector<u64> matched;
+                bool always = false;
+                for(auto pattern : arm->patterns) {
+                    i64 literal = 0;
+                    if(pattern_value(pattern, literal)) {
+                        auto constant = allocate(1);
+                        compile_constant(Val(literal), type, constant);
+                        emit(encode_abc(Op_Eq, constant, value, constant));
+                        matched.push_back(emit_jump(Op_JumpIf, constant));
+                    }
+                    else if(pattern->kind == ast::ast_range_pattern) {
+                        // a range includes both of its bounds.
+                        auto range = pattern->as<ast::RangePattern>();
+                        i64 start = 0, end = 0;
+                        if(!pattern_value(range->start, start) or !pattern_value(range->end, end)) {
+                            report(pattern->pos(), "this pattern can not be run by the vm");
+                            return false;
+                        }
+
+                        auto lower = allocate(1);
+                        auto upper = allocate(1);
+                        compile_constant(Val(start), type, lower);
+                        compile_constant(Val(end), type, upper);
+                        emit(encode_abc(compare_le, lower, lower, value));
+                        emit(encode_abc(compare_le, upper, value, upper));
+                        emit(encode_abc(Op_BitAnd, lower, lower, upper));
+                        matched.push_back(emit_jump(Op_JumpIf, lower));
+                    }
+                    else if(pattern->kind == ast::ast_ignore_pattern or pattern->kind == ast::ast_ident_pattern) {
+                        // the rest of the alternatives don't need to be tested.
+                        always = true;
+                        break;
+                    }
+                    else {
+                        report(pattern->pos(), "this pattern can not be run by the vm");
+                        return false;
+                    }
+                    release(arm_save);
+                }
+
+                u64 next = 0;
+                if(!always)
+                    next = emit_jump(Op_Jump);
+                for(auto jump : matched)
+                    patch_jump(jump);
+
+                // a name is bound to the value being matched.
+                for(auto pattern : arm->patterns)
+                    if(pattern->kind == ast::ast_ident_pattern)
+                        locals[pattern->as<ast::IdentPattern>()->entity] = value;
+
+                if(!compile_into(arm->body, expr->type, target))
+                    return false;
+
+                // the arms after one that always matches are never reached.
+                if(always) {
+                    exhaustive = true;
+                    break;
+                }
+
+                exits.push_back(emit_jump(Op_Jump));
+                patch_jump(next);
+            }
+
+            // a match with a value has a default arm so nothing falls through.
+            if(!exhaustive and num_registers(expr->type) > 0)
+                emit(encode_abc(Op_Unreachable, 0, 0, 0));
+
+            for(auto jump : exits)
+                patch_jump(jump);
+
+            release(save);
+            return true;
+        }
+
+        bool Compiler::compile_return(ast::Return *expr) {
+            auto save = top;
+            auto result = allocate(chunk->num_results);
+            if(expr->body) {
+                auto ret = entity->get_ret_type();
+                if(!(ret and chunk->num_results ? compile_into(expr->body, ret, result) : compile_effect(expr->body)))
+                    return false;
+            }
+
+            // every deferred expression of the function runs before it returns.
+            if(!run_defers(0))
+                return false;
+
+            emit(encode_abc(Op_Return, result, chunk->num_results, 0));
+            release(save);
+            return true;
+        }
+
+        bool Compiler::compile_assign(ast::Assign *expr) {
+            auto lvalue = expr->lvalue;
+            auto rvalue = expr->rvalue;
+            auto save = top;
+
+            u32 count = 0;
+            if(!registers_of(lvalue, count))
+                return false;
+
+            u32 place = 0;
+            if(compile_place(lvalue, place)) {
+                if(expr->op != Tkn_Equal) {
+                    if(!compile_compound(expr, place))
+                        return false;
+                    release(save);
+                    return true;
+                }
+
+                // a value computed in a single step is written in place, anything else could
+                // read the place after it has been written.
+                switch(rvalue->kind) {
+                    case ast::ast_binary:
+                        if(rvalue->as<ast::Binary>()->op == Tkn_And or rvalue->as<ast::Binary>()->op == Tkn_Or)
+                            break;
+                        [[fallthrough]];
+                    case ast::ast_unary:
+                    case ast::ast_name:
+                    case ast::ast_accessor:
+                    case ast::ast_tuple_accessor:
+                        if(count == 1) {
+                            auto result = compile_expr(rvalue, place);
+                            release(save);
+                            return result;
+                        }
+                        break;
+                    default:
+                        break;
+                }
+
+                auto value = allocate(count);
+                if(!compile_expr(rvalue, value))
+                    return false;
+                emit_move(place, value, count);
+                release(save);
+                return true;
+            }
+
+            // an element at an index that is only known when the program runs.
+            u32 base = 0;
+            if(is_index(lvalue) and compile_place(lvalue->as<ast::Call>()->name, base)) {
+                u32 offset = 0;
+                if(!compile_offset(lvalue->as<ast::Call>(), offset))
+                    return false;
+
+                auto value = allocate(count);
+                if(expr->op == Tkn_Equal) {
+                    if(!compile_expr(rvalue, value))
+                        return false;
+                }
+                else {
+                    for(u32 i = 0; i < count; ++i)
+                        emit(encode_abc(Op_GetX, value + i, base + i, offset));
+                    if(!compile_compound(expr, value))
+                        return false;
+                }
+
+                for(u32 i = 0; i < count; ++i)
+                    emit(encode_abc(Op_SetX, base + i, offset, value + i));
+                release(save);
+                return true;
+            }
+
+            auto entity = lvalue->operand.entity;
+            if((lvalue->kind == ast::ast_name) and entity and entity->is_global() and globals.count(entity->as<Global>())) {
+                auto index = globals[entity->as<Global>()];
+                auto value = allocate(count);
+                if(expr->op == Tkn_Equal) {
+                    if(!compile_expr(rvalue, value))
+                        return false;
+                }
+                else if(!compile_expr(lvalue, value) or !compile_compound(expr, value))
+                    return false;
+
+                for(u32 i = 0; i < count; ++i)
+                    emit(encode_abx(Op_StoreG, value + i, index + i));
+                release(save);
+                return true;
+            }
+
+            report(lvalue->pos(), "this expression can not be assigned by the vm");
+            return false;
+        }
+
+        bool Compiler::compile_compound(ast::Assign *expr, u32 place) {
+            auto op = compound_operator(expr->op);
+            u32 value = 0;
+            if(strip(expr->lvalue->type)->is_array())
+                return compile_value(expr->rvalue, value) and
+                       emit_elements(op, expr->lvalue->type, expr->rvalue->type, place, place, value);
+            return compile_operand(expr->rvalue, value) and emit_operator(op, expr->lvalue->type, place, place, value);
+        }
+
+        bool Compiler::compile_local(ast::DeclPtr decl) {
+            ast::PatternPtr pattern = nullptr;
+            ast::ExprPtr init = nullptr;
+            if(decl->kind == ast::ast_mutable) {
+                pattern = decl->as<ast::Mutable>()->names;
+                init = decl->as<ast::Mutable>()->init;
+            }
+            else {
+                pattern = decl->as<ast::Local>()->names;
+                init = decl->as<ast::Local>()->init;
+            }
+
+            if(!init) {
+                // a local declared without a value starts zeroed.
+                if(pattern->kind != ast::ast_ident_pattern) {
+                    report(pattern->pos(), "this pattern needs a value to be run by the vm");
+                    return false;
+                }
+
+                auto local = pattern->as<ast::IdentPattern>()->entity;
+                auto count = num_registers(local->get_type());
+                if(count < 0) {
+                    report(pattern->pos(), "a value of type '%s' can not be run by the vm", local->get_type()->str().c_str());
+                    return false;
+                }
+
+                auto reg = allocate(count);
+                for(i64 i = 0; i < count; ++i)
+                    emit(encode_asbx(Op_LoadI, reg + i, 0));
+                return bind_pattern(pattern, local->get_type(), reg);
+            }
+
+            u32 count = 0;
+            if(!registers_of(init, count))
+                return false;
+
+            auto reg = allocate(count);
+            return compile_expr(init, reg) and bind_pattern(pattern, init->type, reg);
+        }
+
+        bool Compiler::bind_pattern(ast::Pattern *pattern, types::Type *type, u32 reg) {
+            switch(pattern->kind) {
+                case ast::ast_ident_pattern:
+                    locals[pattern->as<ast::IdentPattern>()->entity] = reg;
+                    return true;
+                case ast::ast_tuple_desc: {
+                    auto tuple = strip(type)->as<types::Tuple>();
+                    auto& patterns = pattern->as<ast::TuplePattern>()->patterns;
+                    for(u64 i = 0; i < patterns.size(); ++i)
+                        if(!bind_pattern(patterns[i], tuple->get_element_type(i), reg + member_offset(tuple, i)))
+                            return false;
+                    return true;
+                }
+                case ast::ast_ignore_pattern:
+                    return true;
+                default:
+                    report(pattern->pos(), "this pattern can not be run by the vm");
+                    return false;
+            }
+        }
+
+        bool Compiler::run_defers(u64 mark) {
+            // the deferred expressions can defer more, they are above the ones being run.
+            for(u64 i = defers.size(); i > mark; --i)
+                if(!compile_effect(defers[i - 1]))
+                    return false;
+            return true;
+        }
+
+        /*------------------------------Building--------------------------------*/
+
+        void Compiler::emit(Instruction inst) {
+            chunk->code.push_back(inst);
+        }
+
+        void Compiler::emit_move(u32 target, u32 source, u32 count) {
+            if(target == source)
+                return;
+            for(u32 i = 0; i < count; ++i)
+                emit(encode_abc(Op_Move, target + i, source + i, 0));
+        }
+
+        bool Compiler::emit_elements(TokenKind op, types::Type *lhs_type, types::Type *rhs_type,
+                                     u32 target, u32 lhs, u32 rhs) {
+            auto lhs_array = strip(lhs_type)->is_array();
+            auto rhs_array = strip(rhs_type)->is_array();
+            auto array = strip(lhs_array ? lhs_type : rhs_type)->as<types::Array>();
+            auto element = array->get_element_type();
+
+            // the elements are in consecutive registers, a single value is used for each of them.
+            for(u32 i = 0; i < array->num_elements(); ++i)
+                if(!emit_operator(op, element, target + i, lhs + (lhs_array ? i : 0), rhs + (rhs_array ? i : 0)))
+                    return false;
+            return true;
+        }
+
+        bool Compiler::emit_operator(TokenKind op, types::Type *type, u32 target, u32 lhs, u32 rhs) {
+            type = strip(type);
+            if(!type->is_primative()) {
+                report(position, "the operator '%s' can not be applied to '%s' by the vm",
+                       Token::get_string(op).c_str(), type->str().c_str());
+                return false;
+            }
+
+            auto is_float = type->is_float();
+            auto is_signed = type->is_signed();
+
+            // greater than is less than with the operands swapped.
+            bool swap = false;
+            bool is_compare = false;
+            Opcode code = Op_Unreachable;
+            switch(op) {
+                case Tkn_Plus: code = is_float ? Op_AddF : Op_Add; break;
+                case Tkn_Minus: code = is_float ? Op_SubF : Op_Sub; break;
+                case Tkn_Astrick: code = is_float ? Op_MulF : Op_Mul; break;
+                case Tkn_Slash: code = is_float ? Op_DivF : (is_signed ? Op_DivS : Op_DivU); break;
+                case Tkn_Percent: code = is_float ? Op_RemF : (is_signed ? Op_RemS : Op_RemU); break;
+                case Tkn_AstrickAstrick: code = is_float ? Op_PowF : Op_Unreachable; break;
+                case Tkn_LessLess: code = is_float ? Op_Unreachable : Op_Shl; break;
+                case Tkn_GreaterGreater: code = is_float ? Op_Unreachable : (is_signed ? Op_ShrS : Op_ShrU); break;
+                case Tkn_Ampersand: code = is_float ? Op_Unreachable : Op_BitAnd; break;
+                case Tkn_Pipe: code = is_float ? Op_Unreachable : Op_BitOr; break;
+                case Tkn_Carrot: code = is_float ? Op_Unreachable : Op_BitXor; break;
+                case Tkn_EqualEqual: code = is_float ? Op_EqF : Op_Eq; is_compare = true; break;
+                case Tkn_BangEqual: code = is_float ? Op_NeF : Op_Ne; is_compare = true; break;
+                case Tkn_Greater:
+                    swap = true;
+                    [[fallthrough]];
+                case Tkn_Less:
+                    code = is_float ? Op_LtF : (is_signed ? Op_LtS : Op_LtU);
+                    is_compare = true;
+                    break;
+                case Tkn_GreaterEqual:
+                    swap = true;
+                    [[fallthrough]];
+                case Tkn_LessEqual:
+                    code = is_float ? Op_LeF : (is_signed ? Op_LeS : Op_LeU);
+                    is_compare = true;
+                    break;
+                default:
+                    break;
+            }
+
+            if(code == Op_Unreachable) {
+                report(position, "the operator '%s' can not be applied to '%s' by the vm",
+                       Token::get_string(op).c_str(), type->str().c_str());
+                return false;
+            }
+
+            emit(encode_abc(code, target, swap ? rhs : lhs, swap ? lhs : rhs));
+            if(!is_compare)
+                emit_narrow(type, target);
+            return true;
+        }
+
+        void Compiler::emit_narrow(types::Type *type, u32 reg) {
+            NarrowKind kind;
+            switch(strip(type)->kind()) {
+                case types::Primitive_I8: kind = Narrow_I8; break;
+                case types::Primitive_I16: kind = Narrow_I16; break;
+                case types::Primitive_I32: kind = Narrow_I32; break;
+                case types::Primitive_U8:
+                case types::Primitive_Char: kind = Narrow_U8; break;
+                case types::Primitive_U16: kind = Narrow_U16; break;
+                case types::Primitive_U32: kind = Narrow_U32; break;
+                case types::Primitive_Float32: kind = Narrow_F32; break;
+                default:
+                    return;
+            }
+            emit(encode_abc(Op_Narrow, reg, reg, kind));
+        }
+
+        u64 Compiler::emit_jump(Opcode op, u32 reg) {
+            emit(encode_asbx(op, reg, 0));
+            return chunk->code.size() - 1;
+        }
+
+        void Compiler::patch_jump(u64 position) {
+            auto inst = chunk->code[position];
+            auto offset = CAST(i64, chunk->code.size()) - CAST(i64, position) - 1;
+            if(offset > MaxSBx)
+                report(this->position, "'%s' is too large to be run by the vm", chunk->name.c_str());
+            chunk->code[position] = encode_asbx(get_op(inst), get_a(inst), CAST(i32, offset));
+        }
+
+        void Compiler::emit_jump_to(Opcode op, u32 reg, u64 target) {
+            auto offset = CAST(i64, target) - CAST(i64, chunk->code.size()) - 1;
+            if(offset < -MaxSBx)
+                report(position, "'%s' is too large to be run by the vm", chunk->name.c_str());
+            emit(encode_asbx(op, reg, CAST(i32, offset)));
+        }
+    }
+}
@@ -0,0 +1,163 @@
+#ifndef MU_VM_COMPILER_HPP
+#define MU_VM_COMPILER_HPP
+
+#include "common.hpp"
+#include "interpreter.hpp"
+#include "bytecode.hpp"
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mu {
+    namespace vm {
+
+        // Compiles the resolved ast of a module to bytecode.
+        //
+        // Registers are allocated like a stack, a local keeps its registers until the end
+        // of its block and temporaries are released once the expression that needs them is
+        // done. Values are only stored by value, an immutable self is passed as a copy of the
+        // receiver. Other pointers and foreign functions are reported as errors.
+        class Compiler {
+        public:
+            Compiler(Interpreter* interp, Program* program);
+
+            // returns false if something couldn't be compiled, the errors have been reported.
+            bool compile(const std::vector<Entity*>& entities);
+
+            inline bool has_error() { return errors_num > 0; }
+
+        private:
+            void declare_function(mu::Function* entity, const std::string& name);
+
+            // queues the function to be compiled if it hasn't been already.
+            void reach(mu::Function* entity);
+
+            void compile_function(mu::Function* entity);
+
+            /*------------------------------Registers-------------------------------*/
+            u32 allocate(u32 count);
+
+            void release(u32 top);
+
+            // the number of registers of the type of expr, reports an error if it can't be stored.
+            bool registers_of(ast::Expr* expr, u32& count);
+
+            /*-----------------------------Expressions------------------------------*/
+            // writes the value of expr to the registers starting at target.
+            bool compile_expr(ast::Expr* expr, u32 target);
+
+            // compiles expr into target if it is a value of type, otherwise only for its effects.
+            bool compile_into(ast::Expr* expr, types::Type* type, u32 target);
+
+            // compiles expr for its effects, its value is discarded.
+            bool compile_effect(ast::Expr* expr);
+
+            // the register holding the value of a primitive expression, a local is used in place.
+            bool compile_operand(ast::Expr* expr, u32& reg);
+
+            // the first register of a value of any size, a local is used in place.
+            bool compile_value(ast::Expr* expr, u32& reg);
+
+            // the first register of a local, or of a member of a local or an element at a constant index.
+            bool compile_place(ast::Expr* expr, u32& reg);
+
+            void compile_constant(const Val& val, types::Type* type, u32 target);
+
+            bool compile_name(ast::Expr* expr, u32 target);
+
+            bool compile_binary(ast::Binary* expr, u32 target);
+
+            bool compile_logical(ast::Binary* expr, u32 target);
+
+            bool compile_unary(ast::Unary* expr, u32 target);
+
+            // 'x as T', the conversions are the same as C's.
+            bool compile_cast(ast::Expr* expr, u32 target);
+
+            bool compile_aggregate(ast::Expr* expr, u32 target);
+
+            bool compile_accessor(ast::Expr* expr, u32 target);
+
+            // an element of an array, 'v(i)'. An index that isn't a constant is checked against the length.
+            bool compile_index(ast::Call* expr, u32 target);
+
+            // the register holding the offset of the element an index refers to, after the bounds check.
+            bool compile_offset(ast::Call* expr, u32& reg);
+
+            bool compile_call(ast::Expr* expr, mu::Function* callee, const ast::NodeList<ast::ExprPtr>& actuals,
+                              u64 first_actual, u32 target);
+
+            bool compile_block(ast::Block* expr, u32 target);
+
+            bool compile_if(ast::If* expr, u32 target);
+
+            bool compile_while(ast::While* expr);
+
+            bool compile_for(ast::For* expr);
+
+            bool compile_match(ast::Match* expr, u32 target);
+
+            bool compile_return(ast::Return* expr);
+
+            bool compile_assign(ast::Assign* expr);
+
+            // applies the operator of a compound assignment to the value in place, '+=' is '+'.
+            bool compile_compound(ast::Assign* expr, u32 place);
+
+            bool compile_local(ast::DeclPtr decl);
+
+            bool bind_pattern(ast::Pattern* pattern, types::Type* type, u32 reg);
+
+            bool run_defers(u64 mark);
+
+            /*------------------------------Building--------------------------------*/
+            void emit(Instruction inst);
+
+            void emit_move(u32 target, u32 source, u32 count);
+
+            // applies the operator to the registers, the result is narrowed to type.
+            bool emit_operator(TokenKind op, types::Type* type, u32 target, u32 lhs, u32 rhs);
+
+            // an operator applied to each element of an array, a single value is applied to every element.
+            bool emit_elements(TokenKind op, types::Type* lhs_type, types::Type* rhs_type, u32 target, u32 lhs, u32 rhs);
+
+            void emit_narrow(types::Type* type, u32 reg);
+
+            // returns the position of the jump so it can be patched.
+            u64 emit_jump(Opcode op, u32 reg = 0);
+
+            // the jump at position goes to the next instruction emitted.
+            void patch_jump(u64 position);
+
+            void emit_jump_to(Opcode op, u32 reg, u64 target);
+
+            template <typename... Args>
+            void report(const mu::Pos& pos, const std::string& fmt, Args... args) {
+                interp->report_error(pos, fmt, args...);
+                errors_num++;
+            }
+
+            Interpreter* interp{nullptr};
+            Program* program{nullptr};
+
+            std::unordered_map<mu::Function*, u32> chunks;
+            std::unordered_map<mu::Global*, u32> globals;
+            std::map<std::pair<types::Type*, u64>, u16> constants;
+            std::unordered_set<mu::Function*> reached;
+            std::vector<mu::Function*> pending;
+
+            // the state of the function being compiled.
+            mu::Function* entity{nullptr};
+            Chunk* chunk{nullptr};
+            std::unordered_map<Entity*, u32> locals;
+            std::vector<ast::Expr*> defers;
+            u32 top{0};
+
+            mu::Pos position;
+            u32 errors_num{0};
+        };
+    }
+}
+
+#endif //MU_VM_COMPILER_HPP
@@ -0,0 +1,240 @@
+#include "vm.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+// computed goto jumps straight to the next handler, every handler has its own
+// indirect jump instead of sharing the one of the switch.
+#if defined(__GNUC__) || defined(__clang__)
+#define MU_VM_COMPUTED_GOTO 1
+#else
+#define MU_VM_COMPUTED_GOTO 0
+#endif
+
+#if MU_VM_COMPUTED_GOTO
+// labels as values are an extension.
+#pragma GCC diagnostic ignored "-Wpedantic"
+#define CASE(n) op_##n:
+#define DISPATCH() do { inst = *pc++; goto *labels[get_op(inst)]; } while(0)
+#else
+#define CASE(n) case Op_##n:
+#define DISPATCH() continue
+#endif
+
+#define A r[get_a(inst)]
+#define B r[get_b(inst)]
+#define C r[get_c(inst)]
+
+#define BINARY(field, op) A.field = B.field op C.field
+#define COMPARE(field, op) A.i = B.field op C.field
+
+namespace mu {
+    namespace vm {
+
+        Vm::Vm(Interpreter *interp, const Program &program, u64 stack_size) : interp(interp), program(program),
+            stack(stack_size) {
+            constants.reserve(program.constants.size());
+            for(auto& val : program.constants)
+                constants.push_back(constant_register(val));
+
+            globals.reserve(program.globals.size());
+            for(auto& val : program.globals)
+                globals.push_back(constant_register(val));
+        }
+
+        bool Vm::run_main(i32 &exit_code) {
+            if(program.main < 0) {
+                interp->message("The program doesn't have a main");
+                return false;
+            }
+
+            // the program writes to the same stdout as the compiler.
+            interp->out_stream().flush();
+
+            auto main = CAST(u32, program.main);
+            if(!execute(main))
+                return false;
+
+            exit_code = program.chunks[main].num_results ? CAST(i32, stack[0].i) : 0;
+            std::fflush(stdout);
+            return true;
+        }
+
+        bool Vm::execute(u32 entry) {
+#if MU_VM_COMPUTED_GOTO
+            static const void* labels[] = {
+#define OPCODE(n, ...) &&op_##n,
+                OPCODES
+#undef OPCODE
+            };
+#endif
+            const Chunk* chunks = program.chunks.data();
+            const Chunk* chunk = &chunks[entry];
+            const Instruction* pc = chunk->code.data();
+            const Register* k = constants.data();
+            Register* g = globals.data();
+            Register* r = stack.data();
+            Register* stack_end = stack.data() + stack.size();
+            const char* reason = nullptr;
+            Instruction inst;
+
+            frames.clear();
+            if(chunk->num_registers > stack.size()) {
+                reason = "stack overflow";
+                goto trap;
+            }
+
+#if MU_VM_COMPUTED_GOTO
+            DISPATCH();
+#else
+            while(true) {
+                inst = *pc++;
+                switch(get_op(inst)) {
+#endif
+            CASE(Move) A = B; DISPATCH();
+            CASE(LoadK) A = k[get_bx(inst)]; DISPATCH();
+            CASE(LoadI) A.i = get_sbx(inst); DISPATCH();
+            CASE(LoadG) A = g[get_bx(inst)]; DISPATCH();
+            CASE(StoreG) g[get_bx(inst)] = A; DISPATCH();
+            CASE(GetX) A = r[get_b(inst) + C.u]; DISPATCH();
+            CASE(SetX) r[get_a(inst) + B.u] = C; DISPATCH();
+            CASE(Bound) {
+                if(A.u >= get_bx(inst)) {
+                    reason = "index out of bounds";
+                    goto trap;
+                }
+            } DISPATCH();
+
+            // the integer operators wrap, they are done on the unsigned field.
+            CASE(Add) BINARY(u, +); DISPATCH();
+            CASE(Sub) BINARY(u, -); DISPATCH();
+            CASE(Mul) BINARY(u, *); DISPATCH();
+            CASE(DivS) {
+                if(C.i == 0) {
+                    reason = "division by zero";
+                    goto trap;
+                }
+                A.u = C.i == -1 ? 0 - B.u : CAST(u64, B.i / C.i);
+            } DISPATCH();
+            CASE(DivU) {
+                if(C.u == 0) {
+                    reason = "division by zero";
+                    goto trap;
+                }
+                BINARY(u, /);
+            } DISPATCH();
+            CASE(RemS) {
+                if(C.i == 0) {
+                    reason = "division by zero";
+                    goto trap;
+                }
+                A.i = C.i == -1 ? 0 : B.i % C.i;
+            } DISPATCH();
+            CASE(RemU) {
+                if(C.u == 0) {
+                    reason = "division by zero";
+                    goto trap;
+                }
+                BINARY(u, %);
+            } DISPATCH();
+            CASE(Shl) A.u = B.u << (C.u & 63); DISPATCH();
+            CASE(ShrS) A.i = B.i >> (C.u & 63); DISPATCH();
+            CASE(ShrU) A.u = B.u >> (C.u & 63); DISPATCH();
+            CASE(BitAnd) BINARY(u, &); DISPATCH();
+            CASE(BitOr) BINARY(u, |); DISPATCH();
+            CASE(BitXor) BINARY(u, ^); DISPATCH();
+
+            CASE(AddF) BINARY(f, +); DISPATCH();
+            CASE(SubF) BINARY(f, -); DISPATCH();
+            CASE(MulF) BINARY(f, *); DISPATCH();
+            CASE(DivF) BINARY(f, /); DISPATCH();
+            CASE(RemF) A.f = std::fmod(B.f, C.f); DISPATCH();
+            CASE(PowF) A.f = std::pow(B.f, C.f); DISPATCH();
+
+            CASE(AddI) A.u = B.u + CAST(u64, CAST(i64, CAST(i8, get_c(inst)))); DISPATCH();
+            CASE(Neg) A.u = 0 - B.u; DISPATCH();
+            CASE(NegF) A.f = -B.f; DISPATCH();
+            CASE(BitNot) A.u = ~B.u; DISPATCH();
+            CASE(LogicNot) A.i = !B.i; DISPATCH();
+
+            CASE(Eq) COMPARE(u, ==); DISPATCH();
+            CASE(Ne) COMPARE(u, !=); DISPATCH();
+            CASE(LtS) COMPARE(i, <); DISPATCH();
+            CASE(LeS) COMPARE(i, <=); DISPATCH();
+            CASE(LtU) COMPARE(u, <); DISPATCH();
+            CASE(LeU) COMPARE(u, <=); DISPATCH();
+            CASE(EqF) COMPARE(f, ==); DISPATCH();
+            CASE(NeF) COMPARE(f, !=); DISPATCH();
+            CASE(LtF) COMPARE(f, <); DISPATCH();
+            CASE(LeF) COMPARE(f, <=); DISPATCH();
+
+            CASE(Narrow) {
+                switch(get_c(inst)) {
+                    case Narrow_I8: A.i = CAST(i8, B.i); break;
+                    case Narrow_I16: A.i = CAST(i16, B.i); break;
+                    case Narrow_I32: A.i = CAST(i32, B.i); break;
+                    case Narrow_U8: A.u = CAST(u8, B.u); break;
+                    case Narrow_U16: A.u = CAST(u16, B.u); break;
+                    case Narrow_U32: A.u = CAST(u32, B.u); break;
+                    case Narrow_F32: A.f = CAST(f32, B.f); break;
+                }
+            } DISPATCH();
+
+            CASE(IToF) A.f = CAST(f64, B.i); DISPATCH();
+            CASE(UToF) A.f = CAST(f64, B.u); DISPATCH();
+            CASE(FToI) A.i = CAST(i64, B.f); DISPATCH();
+            CASE(FToU) A.u = CAST(u64, B.f); DISPATCH();
+
+            CASE(Jump) pc += get_sbx(inst); DISPATCH();
+            CASE(JumpIf) if(A.i) pc += get_sbx(inst); DISPATCH();
+            CASE(JumpIfNot) if(!A.i) pc += get_sbx(inst); DISPATCH();
+
+            CASE(Call) {
+                auto callee = &chunks[get_bx(inst)];
+                auto base = &A;
+                if(base + callee->num_registers > stack_end) {
+                    reason = "stack overflow";
+                    goto trap;
+                }
+
+                frames.push_back({chunk, pc, r});
+                chunk = callee;
+                pc = callee->code.data();
+                r = base;
+            } DISPATCH();
+            CASE(Return) {
+                // the results are moved to the start of the window, where the caller put the arguments.
+                auto first = get_a(inst);
+                auto count = get_b(inst);
+                for(u32 i = 0; i < count; ++i)
+                    r[i] = r[first + i];
+
+                if(frames.empty())
+                    return true;
+
+                auto& frame = frames.back();
+                chunk = frame.chunk;
+                pc = frame.pc;
+                r = frame.base;
+                frames.pop_back();
+            } DISPATCH();
+            CASE(Unreachable) {
+                reason = "unreachable code was reached";
+                goto trap;
+            }
+#if !MU_VM_COMPUTED_GOTO
+                    default:
+                        reason = "invalid instruction";
+                        goto trap;
+                }
+            }
+#endif
+
+        trap:
+            interp->message("'%s' trapped at %ld: %s", chunk->name.c_str(),
+                            CAST(i64, pc - chunk->code.data()) - 1, reason);
+            frames.clear();
+            return false;
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef MU_VM_HPP
+#define MU_VM_HPP
+
+#include "common.hpp"
+#include "interpreter.hpp"
+#include "bytecode.hpp"
+
+#include <vector>
+
+namespace mu {
+    namespace vm {
+
+        // Runs the bytecode of a program.
+        //
+        // Every call gets a window of the register stack, the window of the callee starts
+        // at the arguments in the window of the caller so they aren't copied. The dispatch
+        // loop uses computed goto when the compiler supports it, a switch otherwise.
+        class Vm {
+        public:
+            Vm(Interpreter* interp, const Program& program, u64 stack_size = 1 << 20);
+
+            // calls the main of the program, exit_code is set to what it returns.
+            // returns false if there is no main or the program trapped, it has been reported.
+            bool run_main(i32& exit_code);
+
+            // calls the chunk with the arguments in the first registers of the stack, the
+            // results are written to the first registers of the stack.
+            bool execute(u32 entry);
+
+            inline Register* registers() { return stack.data(); }
+
+        private:
+            struct Frame {
+                const Chunk* chunk;
+                const Instruction* pc;
+                Register* base;
+            };
+
+            Interpreter* interp{nullptr};
+            const Program& program;
+
+            std::vector<Register> constants;
+            std::vector<Register> globals;
+            std::vector<Register> stack;
+            std::vector<Frame> frames;
+        };
+    }
+}
+
+#endif //MU_VM_HPP
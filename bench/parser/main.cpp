@@ -0,0 +1,121 @@
+// Expression parser benchmark.
+//
+// usage: parse_bench <generated file> [iterations] [functions]
+//
+// A module of functions made of long arithmetic expressions, the shape of
+// generated numeric code, is written to the given file and parsed once per
+// iteration. The file is scanned once more per iteration without parsing, the
+// difference of the two is reported as the time spent in the parser.
+
+#include "interpreter.hpp"
+#include "parser/parser.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static const char* operators[] = {" + ", " - ", " * ", " / "};
+
+// a small generator so every run parses the same module.
+struct Random {
+    u64 state{0x2545f4914f6cdd1d};
+
+    u64 next(u64 n) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return (state >> 33) % n;
+    }
+};
+
+// an expression of about terms operands over the parameters x0..x3, a fourth of
+// the operands are parenthesized subexpressions.
+static void expression(std::ostream& out, Random& random, u64 terms, u64 depth) {
+    for(u64 i = 0; i < terms; ++i) {
+        if(i != 0)
+            out << operators[random.next(4)];
+
+        auto kind = random.next(4);
+        if(kind == 0 and depth < 3) {
+            out << "(";
+            expression(out, random, 2 + random.next(4), depth + 1);
+            out << ")";
+        }
+        else if(kind == 1)
+            out << random.next(1000) << "." << random.next(100);
+        else
+            out << "x" << random.next(4);
+    }
+}
+
+static std::string generate(u64 functions) {
+    Random random;
+    std::stringstream out;
+    for(u64 f = 0; f < functions; ++f) {
+        out << "f" << f << ": (x0 f64, x1 f64, x2 f64, x3 f64) f64 {\n";
+        for(u64 l = 0; l < 8; ++l) {
+            out << "    let t" << l << " = ";
+            expression(out, random, 24 + random.next(24), 0);
+            out << "\n";
+        }
+        out << "    t0 + t1 * t2 - t3 / t4 + t5 * t6 - t7\n}\n\n";
+    }
+    return out.str();
+}
+
+int main(i32 argc, const char** argv) {
+    if(argc < 2) {
+        std::cerr << "usage: parse_bench <generated file> [iterations] [functions]" << std::endl;
+        return 1;
+    }
+
+    u64 iterations = argc > 2 ? strtoull(argv[2], nullptr, 10) : 20;
+    u64 functions = argc > 3 ? strtoull(argv[3], nullptr, 10) : 500;
+
+    {
+        std::ofstream file(argv[1]);
+        if(!file) {
+            std::cerr << "unable to write '" << argv[1] << "'" << std::endl;
+            return 1;
+        }
+        file << generate(functions);
+    }
+
+    // the debug output of the parser is dropped.
+    std::ostream null_stream(nullptr);
+    Interpreter interp({argv[1]});
+    interp.set_stream(&null_stream);
+
+    io::File file(io::Path(argv[1]).get_absolute());
+
+    u64 tokens = 0;
+    std::chrono::duration<f64> scanning(0), parsing(0);
+    for(u64 i = 0; i < iterations; ++i) {
+        {
+            mem::Arena arena;
+            mem::Arena::Scope scope(arena);
+            mu::Scanner scanner(&interp);
+            mu::TokenBuffer buffer;
+
+            auto start = std::chrono::steady_clock::now();
+            if(!scanner.init(&file) or !scanner.tokenize(buffer))
+                interp.fatal("unable to scan '" + std::string(argv[1]) + "'");
+            scanning += std::chrono::steady_clock::now() - start;
+            tokens += buffer.size();
+        }
+
+        mu::Parser parser(&interp);
+        auto start = std::chrono::steady_clock::now();
+        auto module = parser.process(&file);
+        parsing += std::chrono::steady_clock::now() - start;
+        if(!module or parser.has_error())
+            interp.fatal("unable to parse '" + std::string(argv[1]) + "'");
+    }
+
+    auto parse_seconds = parsing.count() - scanning.count();
+    printf("%lu iterations, %lu functions, %lu tokens, %lu bytes\n", iterations, functions, tokens,
+           file.value().size() * iterations);
+    printf("scan %.4fs  scan and parse %.4fs  parse %.4fs\n", scanning.count(), parsing.count(), parse_seconds);
+    printf("%.0f tokens/s parsed\n", tokens / parse_seconds);
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Scanner throughput benchmark.
+//
+// usage: scan_bench <file.mu> [iterations]
+//
+// The file is scanned from start to end once per iteration and the
+// number of tokens produced per second is reported. Loading the file
+// is not included in the measurement.
+
+#include "interpreter.hpp"
+#include "parser/scanner/scanner.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+int main(i32 argc, const char** argv) {
+    if(argc < 2) {
+        std::cerr << "usage: scan_bench <file.mu> [iterations]" << std::endl;
+        return 1;
+    }
+
+    u64 iterations = argc > 2 ? strtoull(argv[2], nullptr, 10) : 100;
+
+    Interpreter interp({argv[1]});
+    interp.set_stream(&std::cout);
+
+    io::File file(io::Path(argv[1]).get_absolute());
+    mu::Scanner scanner(&interp);
+
+    // identifier tokens are made in the current arena, it is emptied every iteration.
+    mem::Arena arena;
+    mem::Arena::Scope scope(arena);
+
+    u64 tokens = 0;
+    u64 bytes = 0;
+    std::chrono::duration<f64> elapsed(0);
+
+    for(u64 i = 0; i < iterations; ++i) {
+        if(!scanner.init(&file))
+            interp.fatal("unable to scan '" + std::string(argv[1]) + "'");
+
+        auto start = std::chrono::steady_clock::now();
+        while(true) {
+            scanner.advance();
+            ++tokens;
+
+            auto kind = scanner.token().kind();
+            if(kind == mu::Tkn_Eof or kind == mu::Tkn_Error)
+                break;
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+        bytes += file.value().size();
+        arena.clear();
+    }
+
+    auto seconds = elapsed.count();
+    printf("%lu iterations, %lu tokens, %lu bytes in %.4fs\n", iterations, tokens, bytes, seconds);
+    printf("%.0f tokens/s, %.2f MB/s\n", tokens / seconds, bytes / seconds / (1024.0 * 1024.0));
+    return 0;
+}
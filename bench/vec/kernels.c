@@ -0,0 +1,50 @@
+// The kernels of the vector benchmark compiled natively, each computes the same
+// value as the Mu kernel of the same name in vec.mu.
+
+#include <stdint.h>
+
+static double dot(const double* a, const double* b, int32_t n) {
+    double r = 0.0;
+    for(int32_t i = 0; i < n; ++i)
+        r += a[i] * b[i];
+    return r;
+}
+
+// y = a * x + y
+static void axpy(double a, const double* x, double* y, int32_t n) {
+    for(int32_t i = 0; i < n; ++i)
+        y[i] += a * x[i];
+}
+
+static void cross(const double* a, const double* b, double* r) {
+    r[0] = a[1] * b[2] - a[2] * b[1];
+    r[1] = a[2] * b[0] - a[0] * b[2];
+    r[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+double vec3_native(int32_t n) {
+    double p[3] = {1.0, 2.0, 3.0};
+    const double q[3] = {0.5, 0.25, 0.125};
+    double acc = 0.0;
+    for(int32_t i = 0; i < n; ++i) {
+        double c[3], r[3] = {q[0], q[1], q[2]};
+        cross(p, q, c);
+        acc += dot(c, c, 3) + dot(p, q, 3);
+        axpy(0.5, p, r, 3);
+        p[0] = r[0], p[1] = r[1], p[2] = r[2];
+    }
+    return acc;
+}
+
+double vec4_native(int32_t n) {
+    double p[4] = {1.0, 2.0, 3.0, 4.0};
+    const double q[4] = {0.5, 0.25, 0.125, 0.0625};
+    double acc = 0.0;
+    for(int32_t i = 0; i < n; ++i) {
+        double r[4] = {q[0], q[1], q[2], q[3]};
+        acc += dot(p, p, 4) - dot(p, q, 4);
+        axpy(0.5, p, r, 4);
+        p[0] = r[0], p[1] = r[1], p[2] = r[2], p[3] = r[3];
+    }
+    return acc;
+}
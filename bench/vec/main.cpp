@@ -0,0 +1,134 @@
+// Small vector benchmark.
+//
+// usage: vec_bench <kernel directory> [iterations]
+//
+// The kernels of vec.mu are compiled to bytecode twice, once with the loops over
+// their fixed length arrays kept and once with them unrolled by the folder. Both
+// are run in the vm and compared with the native kernels from kernels.c. The size
+// of the bytecode of each build is printed with the times.
+
+#include "interpreter.hpp"
+#include "vm/compiler.hpp"
+#include "vm/vm.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <unistd.h>
+
+extern "C" {
+    f64 vec3_native(i32 n);
+    f64 vec4_native(i32 n);
+}
+
+using mu::vm::Register;
+
+struct Kernel {
+    const char* function;
+    i64 arg;
+    f64 (*native)(i32);
+};
+
+static const char* kernel_file = "vec.mu";
+
+static const Kernel kernels[] = {
+    {"vec3", 200000, vec3_native},
+    {"vec4", 200000, vec4_native},
+};
+
+static bool same_result(f64 vm, f64 native) {
+    return std::fabs(vm - native) <= 1e-9 * std::fmax(1.0, std::fabs(native));
+}
+
+// the kernels built with loops of at most limit iterations unrolled.
+static void compile(Interpreter& interp, io::File* file, u64 limit, mu::vm::Program& program) {
+    interp.set_unroll_limit(limit);
+    if(interp.compile_bytecode(file, program) != InterpResult::Success)
+        interp.fatal("unable to compile '" + std::string(kernel_file) + "'");
+}
+
+static i64 find_entry(mu::vm::Program& program, const char* function) {
+    for(u64 i = 0; i < program.chunks.size(); ++i)
+        if(program.chunks[i].name == function)
+            return i;
+    return -1;
+}
+
+static u64 code_size(mu::vm::Program& program) {
+    u64 size = 0;
+    for(auto& chunk : program.chunks)
+        size += chunk.code.size();
+    return size;
+}
+
+// runs function once per iteration, returns the average time.
+static f64 run(Interpreter& interp, mu::vm::Program& program, const Kernel& kernel, u64 iterations, f64& result) {
+    auto entry = find_entry(program, kernel.function);
+    if(entry < 0)
+        interp.fatal("'" + std::string(kernel_file) + "' doesn't define '" + kernel.function + "'");
+
+    mu::vm::Vm vm(&interp, program);
+    std::chrono::duration<f64> elapsed(0);
+    for(u64 i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        vm.registers()[0].i = kernel.arg;
+        if(!vm.execute(CAST(u32, entry)))
+            interp.fatal("'" + std::string(kernel.function) + "' trapped");
+        result = vm.registers()[0].f;
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+    return elapsed.count() / iterations;
+}
+
+int main(i32 argc, const char** argv) {
+    if(argc < 2) {
+        std::cerr << "usage: vec_bench <kernel directory> [iterations]" << std::endl;
+        return 1;
+    }
+
+    u64 iterations = argc > 2 ? strtoull(argv[2], nullptr, 10) : 5;
+
+    // the interpreter finds files relative to the working directory.
+    if(chdir(argv[1]) != 0) {
+        std::cerr << "unable to open '" << argv[1] << "'" << std::endl;
+        return 1;
+    }
+
+    Interpreter interp({kernel_file});
+    interp.set_stream(&std::cout);
+
+    auto file = interp.find_file(kernel_file);
+    if(!file)
+        interp.fatal("unable to find '" + std::string(kernel_file) + "'");
+
+    auto limit = interp.unroll_limit();
+    mu::vm::Program rolled, unrolled;
+    compile(interp, file, 0, rolled);
+    compile(interp, file, limit, unrolled);
+    printf("bytecode  rolled %lu  unrolled %lu instructions\n", code_size(rolled), code_size(unrolled));
+
+    bool failed = false;
+    for(auto& kernel : kernels) {
+        f64 rolled_result = 0, unrolled_result = 0, native_result = 0;
+        auto rolled_seconds = run(interp, rolled, kernel, iterations, rolled_result);
+        auto unrolled_seconds = run(interp, unrolled, kernel, iterations, unrolled_result);
+
+        std::chrono::duration<f64> elapsed(0);
+        for(u64 i = 0; i < iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            native_result = kernel.native(CAST(i32, kernel.arg));
+            elapsed += std::chrono::steady_clock::now() - start;
+        }
+        auto native_seconds = elapsed.count() / iterations;
+
+        printf("%-6s rolled %.4fs  unrolled %.4fs  %.2fx  native %.4fs  result %.9g\n", kernel.function,
+               rolled_seconds, unrolled_seconds, rolled_seconds / unrolled_seconds, native_seconds, unrolled_result);
+
+        if(!same_result(rolled_result, native_result) or !same_result(unrolled_result, native_result)) {
+            printf("%-6s the vm and native results differ\n", kernel.function);
+            failed = true;
+        }
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+// The kernels of the vm benchmark compiled natively, each computes the same
+// value as the Mu kernel of the same name in this directory.
+
+#include <stdint.h>
+
+int64_t fib_native(int64_t n) {
+    if(n < 2)
+        return n;
+    return fib_native(n - 1) + fib_native(n - 2);
+}
+
+static int32_t bucket(int32_t k, int32_t i) {
+    switch(k) {
+        case 0: return i;
+        case 1:
+        case 2: return i * 3;
+        default: return 7;
+    }
+}
+
+int32_t loops_native(int32_t n) {
+    static const int32_t row[8] = {3, 1, 4, 1, 5, 9, 2, 6};
+    // Mu integers wrap, the sum is done unsigned so it does here too.
+    uint32_t total = 0;
+    for(int32_t i = 0; i < n; ++i)
+        for(int32_t j = 0; j < n; ++j)
+            total = total + (uint32_t) bucket((i + j * 3) % 4, row[j % 8] + j) - (uint32_t) (i & j);
+    return (int32_t) total;
+}
+
+typedef struct Body {
+    double x, y, z;
+    double vx, vy, vz;
+    double m;
+} Body;
+
+static double root(double v) {
+    double r = v;
+    if(r < 1.0)
+        r = 1.0;
+    for(int32_t i = 0; i < 16; ++i)
+        r = 0.5 * (r + v / r);
+    return r;
+}
+
+static Body pull(Body a, Body b, double dt) {
+    double dx = a.x - b.x;
+    double dy = a.y - b.y;
+    double dz = a.z - b.z;
+    double d2 = dx * dx + dy * dy + dz * dz + 0.0078125;
+    double mag = dt * b.m / (d2 * root(d2));
+    Body result = {a.x, a.y, a.z, a.vx - dx * mag, a.vy - dy * mag, a.vz - dz * mag, a.m};
+    return result;
+}
+
+static Body move(Body a, double dt) {
+    Body result = {a.x + dt * a.vx, a.y + dt * a.vy, a.z + dt * a.vz, a.vx, a.vy, a.vz, a.m};
+    return result;
+}
+
+double nbody_native(int32_t steps) {
+    Body a = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 10.0};
+    Body b = {1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0};
+    Body c = {0.0, 2.0, 0.0, 0.0 - 1.0, 0.0, 0.5, 0.5};
+    double dt = 0.0009765625;
+    for(int32_t i = 0; i < steps; ++i) {
+        Body na = pull(pull(a, b, dt), c, dt);
+        Body nb = pull(pull(b, a, dt), c, dt);
+        Body nc = pull(pull(c, a, dt), b, dt);
+        a = move(na, dt);
+        b = move(nb, dt);
+        c = move(nc, dt);
+    }
+    return a.x + b.y + c.z + a.vx + b.vy + c.vz;
+}
+
+static int32_t clamp(int32_t x) {
+    if(x < 56)
+        return x;
+    return 56;
+}
+
+int32_t clamped_native(int32_t n) {
+    int32_t total = 0;
+    int32_t calls = 0;
+    for(int32_t i = 0; i < n; ++i) {
+        calls = calls + 1;
+        total = total + clamp(i % 100) * 3;
+    }
+    return total + calls;
+}
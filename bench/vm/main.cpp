@@ -0,0 +1,117 @@
+// Bytecode vm benchmark.
+//
+// usage: vm_bench <kernel directory> [iterations]
+//
+// Every kernel in the directory is compiled to bytecode once, then run in the
+// vm and natively, from kernels.c, once per iteration. The results are compared
+// so a wrong answer isn't reported as a fast one. Compiling the kernels is not
+// included in the measurement.
+
+#include "interpreter.hpp"
+#include "vm/compiler.hpp"
+#include "vm/vm.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <unistd.h>
+
+extern "C" {
+    i64 fib_native(i64 n);
+    i32 loops_native(i32 n);
+    f64 nbody_native(i32 steps);
+    i32 clamped_native(i32 n);
+}
+
+using mu::vm::Register;
+
+struct Kernel {
+    const char* file;
+    const char* function;
+    i64 arg;
+    bool is_float;
+    Register (*native)(i64);
+};
+
+static const Kernel kernels[] = {
+    {"fib.mu", "fib", 27, false, [](i64 n) { Register r; r.i = fib_native(n); return r; }},
+    {"loops.mu", "loops", 600, false, [](i64 n) { Register r; r.i = loops_native(CAST(i32, n)); return r; }},
+    {"nbody.mu", "nbody", 20000, true, [](i64 n) { Register r; r.f = nbody_native(CAST(i32, n)); return r; }},
+    {"clamp.mu", "clamped", 200000, false, [](i64 n) { Register r; r.i = clamped_native(CAST(i32, n)); return r; }},
+};
+
+static bool same_result(const Kernel& kernel, Register vm, Register native) {
+    if(!kernel.is_float)
+        return vm.i == native.i;
+    return std::fabs(vm.f - native.f) <= 1e-9 * std::fmax(1.0, std::fabs(native.f));
+}
+
+int main(i32 argc, const char** argv) {
+    if(argc < 2) {
+        std::cerr << "usage: vm_bench <kernel directory> [iterations]" << std::endl;
+        return 1;
+    }
+
+    u64 iterations = argc > 2 ? strtoull(argv[2], nullptr, 10) : 5;
+
+    // the interpreter finds files relative to the working directory.
+    if(chdir(argv[1]) != 0) {
+        std::cerr << "unable to open '" << argv[1] << "'" << std::endl;
+        return 1;
+    }
+
+    Interpreter interp({kernels[0].file});
+    interp.set_stream(&std::cout);
+
+    bool failed = false;
+    for(auto& kernel : kernels) {
+        auto file = interp.find_file(kernel.file);
+        if(!file)
+            interp.fatal("unable to find '" + std::string(kernel.file) + "'");
+
+        mu::vm::Program program;
+        if(interp.compile_bytecode(file, program) != InterpResult::Success)
+            interp.fatal("unable to compile '" + std::string(kernel.file) + "'");
+
+        i64 entry = -1;
+        for(u64 i = 0; i < program.chunks.size(); ++i)
+            if(program.chunks[i].name == kernel.function)
+                entry = i;
+        if(entry < 0)
+            interp.fatal("'" + std::string(kernel.file) + "' doesn't define '" + kernel.function + "'");
+
+        mu::vm::Vm vm(&interp, program);
+        Register vm_result{}, native_result{};
+        std::chrono::duration<f64> vm_elapsed(0), native_elapsed(0);
+
+        for(u64 i = 0; i < iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            vm.registers()[0].i = kernel.arg;
+            if(!vm.execute(CAST(u32, entry)))
+                interp.fatal("'" + std::string(kernel.function) + "' trapped");
+            vm_result = vm.registers()[0];
+            vm_elapsed += std::chrono::steady_clock::now() - start;
+
+            start = std::chrono::steady_clock::now();
+            native_result = kernel.native(kernel.arg);
+            native_elapsed += std::chrono::steady_clock::now() - start;
+        }
+
+        auto vm_seconds = vm_elapsed.count() / iterations;
+        auto native_seconds = native_elapsed.count() / iterations;
+        printf("%-8s vm %.4fs  native %.4fs  %.1fx", kernel.function, vm_seconds, native_seconds,
+               vm_seconds / native_seconds);
+
+        if(kernel.is_float)
+            printf("  result %.9g\n", vm_result.f);
+        else
+            printf("  result %ld\n", vm_result.i);
+
+        if(!same_result(kernel, vm_result, native_result)) {
+            printf("%-8s the vm and native results differ\n", kernel.function);
+            failed = true;
+        }
+    }
+    return failed ? 1 : 0;
+}
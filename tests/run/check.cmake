@@ -0,0 +1,23 @@
+# Runs FILE with the driver MU in MODE and compares its exit code with the
+# one given by the 'expect:' comment on the first line of the file. A line
+# '// <mode> prints: <text>' is text the output of that mode must contain.
+
+file(STRINGS ${FILE} header LIMIT_COUNT 1)
+if(NOT header MATCHES "expect: *([0-9]+)")
+    message(FATAL_ERROR "${FILE} doesn't say which exit code it expects")
+endif()
+set(expected ${CMAKE_MATCH_1})
+
+execute_process(COMMAND ${MU} ${MODE} ${FILE} RESULT_VARIABLE result OUTPUT_VARIABLE output ERROR_VARIABLE output)
+if(NOT result EQUAL expected)
+    message(FATAL_ERROR "'${MODE} ${FILE}' returned ${result}, expected ${expected}")
+endif()
+
+file(STRINGS ${FILE} prints REGEX "^// ${MODE} prints: ")
+foreach(line ${prints})
+    string(REGEX REPLACE "^// ${MODE} prints: " "" text "${line}")
+    string(FIND "${output}" "${text}" found)
+    if(found EQUAL -1)
+        message(FATAL_ERROR "'${MODE} ${FILE}' didn't print \"${text}\"")
+    endif()
+endforeach()